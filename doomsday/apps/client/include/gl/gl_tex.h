@@ -28,6 +28,16 @@
 #include <doomsday/color.h>
 #include <doomsday/res/colorpalette.h>
 
+/// SSE2 is available for the image manipulation kernels.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DE_GL_TEX_SSE2
+#endif
+
+/// Use the SIMD versions of the image manipulation kernels (cvar "rend-tex-simd").
+/// The results are identical to the scalar versions. Read once per operation and
+/// passed to the kernels, as textures may be prepared in worker threads.
+extern dbyte useSimdKernels;
+
 typedef struct colorpalette_analysis_s {
     colorpaletteid_t paletteId;
 } colorpalette_analysis_t;
@@ -224,7 +234,21 @@ void FindClipRegionNonAlpha(const uint8_t* pixels, int width, int height,
  */
 void SharpenPixels(uint8_t* pixels, int width, int height, int pixelSize);
 
+/**
+ * Scales an image using linear interpolation (magnification) or averaging
+ * (minification).
+ *
+ * @param simd  Use the SIMD versions of the kernels, if available. Normally the
+ *              value of useSimdKernels.
+ */
 uint8_t* GL_ScaleBuffer(const uint8_t* pixels, int width, int height,
+    int pixelSize, int outWidth, int outHeight, bool simd);
+
+/**
+ * Original column-by-column version of GL_ScaleBuffer(), against which the
+ * optimized kernels are checked. Not for general use.
+ */
+uint8_t* GL_ScaleBufferReference(const uint8_t* pixels, int width, int height,
     int pixelSize, int outWidth, int outHeight);
 
 void* GL_ScaleBufferEx(const void* datain, int width, int height, int pixelSize,
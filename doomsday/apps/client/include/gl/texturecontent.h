@@ -24,6 +24,7 @@
 #include "api_gl.h"
 #include "gl/gl_defer.h"
 #include <doomsday/res/texturemanifest.h>
+#include <de/block.h>
 
 /**
  * @defgroup textureContentFlags  Texture Content Flags
@@ -38,6 +39,7 @@
 #define TXCF_UPLOAD_ARG_NOSTRETCH       0x20
 #define TXCF_UPLOAD_ARG_NOSMARTFILTER   0x40
 #define TXCF_NEVER_DEFER                0x80
+#define TXCF_PROCESSED                  0x100 ///< Pixels are ready for uploading as is.
 /*@}*/
 
 /**
@@ -87,6 +89,27 @@ void GL_PrepareTextureContent(texturecontent_t &c,
                               const TextureVariantSpec &spec,
                               const res::TextureManifest &textureManifest);
 
+/**
+ * Sets the sampling parameters of the texture content @a c (filtering and wrapping)
+ * in accordance with the supplied specification. These do not affect the pixel data.
+ *
+ * @param c     Texture content.
+ * @param spec  Specification of the texture variant.
+ */
+void GL_SetTextureContentSampling(texturecontent_t &c, const TextureVariantSpec &spec);
+
+/**
+ * Performs the CPU-side processing of @a content for uploading: conversion to RGB(A),
+ * gamma correction, smart filtering, and resizing to the final texture dimensions.
+ * GL_UploadTextureContent() uploads the processed content as is.
+ *
+ * @param content  Content to process.
+ * @param pixels   The processed pixel data is written here.
+ *
+ * @return  Processed content, flagged with TXCF_PROCESSED. Its pixels point to @a pixels.
+ */
+texturecontent_t GL_ProcessTextureContent(const texturecontent_t &content, de::Block &pixels);
+
 /**
  * @param method  GL upload method. By default the upload is deferred.
  *
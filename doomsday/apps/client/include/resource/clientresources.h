@@ -48,6 +48,7 @@
 #include "framemodeldef.h"
 #include "materialvariantspec.h"
 #include "rawtexture.h"
+#include "texturevariantcache.h"
 
 class ClientMaterial;
 
@@ -373,6 +374,11 @@ public:
      */
     TextureVariantSpec &detailTextureSpec(float contrast);
 
+    /**
+     * Returns the persistent cache of processed texture variants.
+     */
+    TextureVariantCache &textureVariantCache();
+
     AbstractFont *newFontFromDef(const ded_compositefont_t &def);
     AbstractFont *newFontFromFile(const res::Uri &uri, const de::String& filePath);
 
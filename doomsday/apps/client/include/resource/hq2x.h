@@ -48,8 +48,16 @@ void GL_InitSmartFilterHQ2x(void);
  * @param width  Width of the source image in pixels.
  * @param height  Height of the source image in pixels.
  * @param flags  @ref imageConversionFlags
+ * @param simd  Use the SIMD version of the algorithm, if available. Normally the
+ *              value of useSimdKernels.
  */
-uint8_t *GL_SmartFilterHQ2x(const uint8_t *src, int width, int height, int flags);
+uint8_t *GL_SmartFilterHQ2x(const uint8_t *src, int width, int height, int flags, bool simd);
+
+/**
+ * Original version of GL_SmartFilterHQ2x(), against which the optimized version
+ * is checked. Not for general use.
+ */
+uint8_t *GL_SmartFilterHQ2xReference(const uint8_t *src, int width, int height, int flags);
 
 ///@}
 
@@ -0,0 +1,98 @@
+/** @file texturevariantcache.h  Persistent cache of processed texture variants.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DE_CLIENT_RESOURCE_TEXTUREVARIANTCACHE_H
+#define DE_CLIENT_RESOURCE_TEXTUREVARIANTCACHE_H
+
+#include "gl/texturecontent.h"
+#include "resource/image.h"
+#include "resource/texturevariantspec.h"
+
+#include <de/block.h>
+
+/**
+ * Persistent cache of texture variant content that has been processed for uploading.
+ *
+ * Preparing a texture variant involves CPU-heavy processing of the source image
+ * (palette conversion, outline filling, smart filtering, and scaling). The final pixels
+ * are stored in the cache, so later runs only need to load the source image.
+ *
+ * The cache is content-addressed: the key is a hash of the source image pixels, the
+ * variant specification, and the settings that affect the processing. Entries are
+ * never invalidated, only replaced when processed again. When the cache grows larger
+ * than the "rend-tex-cache-size" limit, the least recently used entries are deleted.
+ * The last use times are kept in an index file in the cache folder.
+ *
+ * @ingroup resource
+ */
+class TextureVariantCache
+{
+public:
+    TextureVariantCache();
+
+    /**
+     * Forms the cache key for a texture variant.
+     *
+     * @param image  Source image of the variant, before any processing.
+     * @param spec   Variant specification.
+     *
+     * @return Cache key, or an empty block if the variant should not be cached.
+     */
+    de::Block key(const image_t &image, const TextureVariantSpec &spec) const;
+
+    /**
+     * Finds processed content in the cache.
+     *
+     * @param key      Cache key.
+     * @param image    Size and flags are updated to those of the processed image.
+     * @param content  Processed content (flagged with TXCF_PROCESSED). The GL name
+     *                 and sampling parameters are not set.
+     * @param pixels   Processed pixels. @a content points to this.
+     *
+     * @return @c true, if the content was found.
+     */
+    bool find(const de::Block &key, image_t &image, texturecontent_t &content,
+              de::Block &pixels);
+
+    /**
+     * Stores processed content in the cache.
+     *
+     * @param key      Cache key.
+     * @param image    Prepared image whose content was processed.
+     * @param content  Content processed with GL_ProcessTextureContent().
+     */
+    void store(const de::Block &key, const image_t &image, const texturecontent_t &content);
+
+    /**
+     * Deletes all cached content.
+     */
+    void clear();
+
+    /**
+     * Prints the cache hit and miss statistics to the log.
+     */
+    void printStats() const;
+
+    static void consoleRegister();
+
+private:
+    DE_PRIVATE(d)
+};
+
+#endif // DE_CLIENT_RESOURCE_TEXTUREVARIANTCACHE_H
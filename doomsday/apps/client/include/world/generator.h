@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <de/list.h>
 #include <de/vector.h>
 #include <doomsday/defs/dedtypes.h>
 #include "map.h"
@@ -102,6 +103,15 @@ struct Generator
     /// Unique identifier associated with each generator (1-based).
     typedef int16_t Id;
 
+    /// Particle sound waiting to be played (see moveParticles()).
+    struct PendingSound
+    {
+        int id;
+        de::Vec3d origin;
+        float volume;
+    };
+    typedef de::List<PendingSound> PendingSounds;
+
 public:                                   //! @todo make private:
     thinker_t           thinker;          //  Func = P_PtcGenThinker
     Plane *             plane;            //  Flat-triggered.
@@ -146,6 +156,25 @@ public:
      */
     void runTick();
 
+    /**
+     * Ages the generator, spawns new particles, and advances the stages of the
+     * existing particles. This is the part of runTick() that must be done in the
+     * main thread.
+     *
+     * @return @c false if the generator expired and was deleted.
+     */
+    bool updateParticles();
+
+    /**
+     * Moves the active particles. The map is not modified, so the particles of
+     * different generators can be moved concurrently as long as @a sounds are
+     * collected and played afterwards in the main thread.
+     *
+     * @param sounds  If not @c nullptr, the hit sounds of the particles are
+     *                appended here instead of being played immediately.
+     */
+    void moveParticles(PendingSounds *sounds = nullptr);
+
     /**
      * Run the generator's thinker for the given number of @a tics.
      */
@@ -197,6 +226,12 @@ public:
      */
     const ParticleInfo *particleInfo() const;
 
+    /**
+     * Replaces the state of all the particles, for example to restore a previously
+     * copied state. @a particles must have @ref count elements.
+     */
+    void setParticleInfo(const ParticleInfo *particles);
+
 public: /// @todo make private:
     /**
      * Clears all memory used for manipulating the generated particles.
@@ -216,7 +251,7 @@ public: /// @todo make private:
      * XY movement checks for hits with solid walls (no backsector).
      * This is supposed to be fast and simple (but not too simple).
      */
-    void moveParticle(int index);
+    void moveParticle(int index, PendingSounds *sounds = nullptr);
 
     void spinParticle(ParticleInfo &pt);
 
@@ -245,3 +280,13 @@ typedef Generator::ParticleStage GeneratorParticleStage;
 
 void Generator_Delete(Generator *gen);
 void Generator_Thinker(Generator *gen);
+
+/**
+ * Moves the particles of several generators concurrently (see Generator::moveParticles()).
+ *
+ * @param gens    Generators of the same map.
+ * @param sounds  Hit sounds of the particles are appended here, in the order of @a gens.
+ */
+void Generator_MoveParticles(const de::List<Generator *> &gens, Generator::PendingSounds &sounds);
+
+void Generator_PlaySounds(const Generator::PendingSounds &sounds);
@@ -205,6 +205,12 @@ public:  //- Particle generators -----------------------------------------------
 
     void unlinkGenerator(Generator &generator);
 
+    /**
+     * Moves the particles of all the generators. The generators are processed
+     * concurrently. Called once per tic after all the thinkers have been run.
+     */
+    void moveParticles();
+
 //- Skies -------------------------------------------------------------------------------
 
     SkyDrawable::Animator &skyAnimator() const;
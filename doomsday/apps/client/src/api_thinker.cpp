@@ -23,6 +23,10 @@
 #include <doomsday/world/world.h>
 #include <doomsday/world/thinkers.h>
 
+#ifdef __CLIENT__
+#  include "world/map.h"
+#endif
+
 using namespace de;
 using World = world::World;
 
@@ -86,6 +90,15 @@ void Thinker_Run()
         }
         return LoopContinue;
     });
+
+#ifdef __CLIENT__
+    // Generators only spawn particles when thinking; the particles of all generators
+    // are moved together.
+    if (World::get().hasMap())
+    {
+        World::get().map().as<Map>().moveParticles();
+    }
+#endif
 }
 
 #undef Thinker_Add
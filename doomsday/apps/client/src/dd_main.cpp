@@ -55,6 +55,7 @@
 #include <de/nativepath.h>
 
 #include <doomsday/abstractsession.h>
+#include <doomsday/api_map.h>
 #include <doomsday/console/alias.h>
 #include <doomsday/console/cmd.h>
 #include <doomsday/console/exec.h>
@@ -2524,6 +2525,7 @@ void DD_ConsoleRegister()
 
     Net_Register();
     world::Map::consoleRegister();
+    DMU_ConsoleRegister();
     InFineSystem::consoleRegister();
 }
 
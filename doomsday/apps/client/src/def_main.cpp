@@ -34,6 +34,8 @@
 #endif
 
 #include <doomsday/console/cmd.h>
+#include <doomsday/console/var.h>
+#include <doomsday/defs/dedcache.h>
 #include <doomsday/defs/decoration.h>
 #include <doomsday/defs/dedfile.h>
 #include <doomsday/defs/dedparser.h>
@@ -73,6 +75,7 @@ using namespace res;
 #define LOOPk(n)    for (k = 0; k < (n); ++k)
 
 static bool defsInited;
+static dbyte useDefsCache = true; // cvar
 static mobjinfo_t *gettingFor;
 static Binder *defsBinder;
 
@@ -1214,7 +1217,21 @@ void Def_Read()
 
     // Read all definitions files and lumps.
     LOG_RES_MSG("Parsing definition files...");
-    readAllDefinitions();
+    if (useDefsCache)
+    {
+        // The definitions of the files may be restored from the metadata cache.
+        DEDCache cache(defs);
+        readAllDefinitions();
+        if (!cache.finish())
+        {
+            // Same as when the failed file was parsed by Def_ReadProcessDED().
+            App_FatalError("Def_ReadProcessDED: %s\n", DED_Error());
+        }
+    }
+    else
+    {
+        readAllDefinitions();
+    }
 
     // Any definition hooks?
     DoomsdayApp::plugins().callAllHooks(HOOK_DEFS, 0, &defs);
@@ -1268,6 +1285,10 @@ void Def_Read()
 
     ::runtimeDefs.stateInfo.append(defs.states.size());
 
+    // The things, states, sprites, and materials are now final, so lookups can use
+    // the frozen tables from here on.
+    defs.freeze();
+
     // Mobj info.
     ::runtimeDefs.mobjInfo.append(defs.things.size());
     for (int i = 0; i < runtimeDefs.mobjInfo.size(); ++i)
@@ -2010,6 +2031,8 @@ D_CMD(ListMobjs)
 
 void Def_ConsoleRegister()
 {
+    C_VAR_BYTE("ded-cache", &useDefsCache, 0, 0, 1);
+
     C_CMD("listmobjtypes", "", ListMobjs);
 }
 
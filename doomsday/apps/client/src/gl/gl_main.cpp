@@ -45,11 +45,13 @@
 #include "resource/materialanimator.h"
 #include "resource/materialvariantspec.h"
 #include "resource/clienttexture.h"
+#include "resource/image.h"
 
 #include "api_render.h"
 #include "render/rend_main.h"
 #include "render/r_main.h"
 #include "render/cameralensfx.h"
+#include "render/r_draw.h"
 #include "render/rendersystem.h"
 #include "render/rend_font.h"
 #include "render/rend_model.h"
@@ -70,6 +72,7 @@
 #include <de/glinfo.h>
 #include <de/glstate.h>
 #include <de/logbuffer.h>
+#include <de/time.h>
 
 #include <SDL_video.h>
 
@@ -954,7 +957,7 @@ duint8 *GL_SmartFilter(dint method, const duint8 *src, dint width, dint height,
     default:  // linear interpolation.
         newWidth  = width  * 2;
         newHeight = height * 2;
-        out = GL_ScaleBuffer(src, width, height, 4, newWidth, newHeight);
+        out = GL_ScaleBuffer(src, width, height, 4, newWidth, newHeight, useSimdKernels != 0);
         break;
 
     case 1:  // nearest neighbor.
@@ -966,7 +969,7 @@ duint8 *GL_SmartFilter(dint method, const duint8 *src, dint width, dint height,
     case 2:  // hq2x
         newWidth  = width  * 2;
         newHeight = height * 2;
-        out = GL_SmartFilterHQ2x(src, width, height, flags);
+        out = GL_SmartFilterHQ2x(src, width, height, flags, useSimdKernels != 0);
         break;
     };
 
@@ -1425,6 +1428,136 @@ D_CMD(ListDisplayModes)
     return true;
 }
 
+/**
+ * Runs the image manipulation kernels on the source images of all the textures in the
+ * Patches, Flats, and Textures schemes, using the original reference versions and both
+ * the scalar and the SIMD versions of the optimized kernels, and checks that the
+ * results are identical to the reference. The kernel version is passed to each call,
+ * so textures being prepared meanwhile (e.g., in busy mode) are not affected.
+ */
+D_CMD(BenchmarkImageFilters)
+{
+    DE_UNUSED(src, argc, argv);
+
+    LOG_AS("benchimagefilters (Cmd)");
+
+    enum { HQ2x, Magnify, Minify, KernelCount };
+    static const char *kernelNames[KernelCount] = { "hq2x", "Scale up", "Scale down" };
+
+    enum { Reference, Scalar, Simd, VersionCount };
+    static const char *versionNames[VersionCount] = { "reference", "scalar", "SIMD" };
+
+    const auto &spec = Rend_PatchTextureSpec();
+    ddouble times[VersionCount][KernelCount]{};
+    dint imageCount = 0, mismatchCount = 0;
+    duint64 pixelCount = 0;
+
+    for(res::Texture *texture : App_Resources().textures().allTextures())
+    {
+        const String scheme = texture->manifest().schemeName();
+        if(scheme.compareWithoutCase("Patches") &&
+           scheme.compareWithoutCase("Flats") &&
+           scheme.compareWithoutCase("Textures"))
+        {
+            continue;
+        }
+
+        image_t image;
+        if(GL_LoadSourceImage(image, *static_cast<ClientTexture *>(texture), spec) == res::None)
+        {
+            continue;
+        }
+
+        // The kernels operate on RGBA pixels.
+        if(image.paletteId || image.pixelSize == 3)
+        {
+            duint8 *rgba = GL_ConvertBuffer(image.pixels, image.size.x, image.size.y,
+                                            image.paletteId? ((image.flags & IMGF_IS_MASKED)? 2 : 1) : 3,
+                                            image.paletteId, 4);
+            if(rgba != image.pixels)
+            {
+                M_Free(image.pixels);
+                image.pixels    = rgba;
+                image.pixelSize = 4;
+            }
+        }
+        if(image.pixelSize != 4)
+        {
+            Image_ClearPixelData(image);
+            continue;
+        }
+
+        const dint width  = image.size.x;
+        const dint height = image.size.y;
+        Block results[VersionCount][KernelCount];
+        for(dint version = 0; version < VersionCount; ++version)
+        {
+            const bool simd = (version == Simd);
+            for(dint kernel = 0; kernel < KernelCount; ++kernel)
+            {
+                const dint outWidth  = (kernel == Minify? de::max(1, width  / 2) : width  * 2);
+                const dint outHeight = (kernel == Minify? de::max(1, height / 2) : height * 2);
+
+                const Time startedAt;
+                duint8 *out;
+                if(kernel == HQ2x)
+                {
+                    out = (version == Reference? GL_SmartFilterHQ2xReference(image.pixels, width, height, 0)
+                                               : GL_SmartFilterHQ2x(image.pixels, width, height, 0, simd));
+                }
+                else
+                {
+                    out = (version == Reference? GL_ScaleBufferReference(image.pixels, width, height, 4,
+                                                                         outWidth, outHeight)
+                                               : GL_ScaleBuffer(image.pixels, width, height, 4,
+                                                                outWidth, outHeight, simd));
+                }
+                times[version][kernel] += startedAt.since();
+
+                results[version][kernel] = Block(out, 4 * outWidth * outHeight);
+                M_Free(out);
+            }
+        }
+        for(dint version = Scalar; version < VersionCount; ++version)
+        {
+            for(dint kernel = 0; kernel < KernelCount; ++kernel)
+            {
+                if(results[version][kernel] != results[Reference][kernel])
+                {
+                    LOG_SCR_ERROR("%s (%s) of \"%s\" differs from the reference version")
+                        << kernelNames[kernel] << versionNames[version]
+                        << texture->manifest().composeUri();
+                    mismatchCount++;
+                }
+            }
+        }
+
+        pixelCount += duint64(width) * height;
+        imageCount++;
+        Image_ClearPixelData(image);
+    }
+
+#ifdef DE_GL_TEX_SSE2
+    const char *simdName = "SSE2";
+#else
+    const char *simdName = "none";
+#endif
+    LOG_SCR_MSG(_E(b) "%i images, %.1f megapixels (SIMD: %s):")
+        << imageCount << pixelCount / 1.0e6 << simdName;
+    for(dint kernel = 0; kernel < KernelCount; ++kernel)
+    {
+        LOG_SCR_MSG(_E(l) "%s: " _E(.) "reference %.1f ms, scalar %.1f ms, SIMD %.1f ms")
+            << kernelNames[kernel] << times[Reference][kernel] * 1000
+            << times[Scalar][kernel] * 1000 << times[Simd][kernel] * 1000;
+    }
+    if(mismatchCount)
+    {
+        LOG_SCR_ERROR("%i results differ from the reference versions") << mismatchCount;
+        return false;
+    }
+    return true;
+}
+
 #if 0
 D_CMD(UpdateGammaRamp)
 {
@@ -1548,6 +1681,7 @@ void GL_Register()
 
     // Ccmds
     C_CMD_FLAGS("fog",              nullptr,   Fog,                CMDF_NO_NULLGAME|CMDF_NO_DEDICATED);
+    C_CMD      ("benchimagefilters", "",    BenchmarkImageFilters);
     C_CMD      ("displaymode",      "",     DisplayModeInfo);
     C_CMD      ("listdisplaymodes", "",     ListDisplayModes);
 #if !defined (DE_MOBILE)
@@ -34,6 +34,12 @@
 #include <cmath>
 #include <cctype>
 
+#ifdef DE_GL_TEX_SSE2
+#  include <emmintrin.h>
+#endif
+
+dbyte useSimdKernels = true;
+
 static uint8_t *scratchBuffer;
 static size_t scratchBufferSize;
 
@@ -134,8 +140,195 @@ static void scaleLine(const uint8_t* in, int inStride, uint8_t* out, int outStri
     }
 }
 
+/**
+ * Interpolates linearly between two rows of pixels. The result is identical to
+ * scaleLine(): (row1 * (0x10000 - weight) + row2 * weight) >> 16.
+ *
+ * @param len     Length of the rows in bytes.
+ * @param weight  Weight of @a row2 (0...0xffff).
+ * @param simd    Use the SIMD version, if available.
+ */
+static void lerpRow(const uint8_t *row1, const uint8_t *row2, uint8_t *out, int len, int weight,
+    bool simd)
+{
+    int i = 0;
+#ifdef DE_GL_TEX_SSE2
+    if(simd)
+    {
+        // row1 + ((row2 - row1) * weight) >> 16, with a signed high multiply. Weights
+        // above 0x7fff are negative as 16-bit values, which is compensated for by
+        // adding the difference once more.
+        const __m128i zero    = _mm_setzero_si128();
+        const __m128i weights = _mm_set1_epi16(short(weight));
+        const __m128i fixup   = _mm_set1_epi16(short(weight & 0x8000? -1 : 0));
+        for(; i + 16 <= len; i += 16)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row2 + i));
+            const __m128i aLo = _mm_unpacklo_epi8(a, zero), aHi = _mm_unpackhi_epi8(a, zero);
+            const __m128i dLo = _mm_sub_epi16(_mm_unpacklo_epi8(b, zero), aLo);
+            const __m128i dHi = _mm_sub_epi16(_mm_unpackhi_epi8(b, zero), aHi);
+            const __m128i lo = _mm_add_epi16(_mm_add_epi16(aLo, _mm_mulhi_epi16(dLo, weights)),
+                                             _mm_and_si128(dLo, fixup));
+            const __m128i hi = _mm_add_epi16(_mm_add_epi16(aHi, _mm_mulhi_epi16(dHi, weights)),
+                                             _mm_and_si128(dHi, fixup));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(lo, hi));
+        }
+    }
+#else
+    DE_UNUSED(simd);
+#endif
+    const int invWeight = 0x10000 - weight;
+    for(; i < len; ++i)
+    {
+        out[i] = (uint8_t)((row1[i] * invWeight + row2[i] * weight) >> 16);
+    }
+}
+
+/**
+ * Adds a row of pixels to the per-byte sums in @a cumul.
+ */
+static void accumulateRow(uint32_t *cumul, const uint8_t *row, int len, bool simd)
+{
+    int i = 0;
+#ifdef DE_GL_TEX_SSE2
+    if(simd)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        for(; i + 16 <= len; i += 16)
+        {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+            const __m128i lo = _mm_unpacklo_epi8(in, zero);
+            const __m128i hi = _mm_unpackhi_epi8(in, zero);
+            __m128i *sum = reinterpret_cast<__m128i *>(cumul + i);
+            _mm_storeu_si128(sum,     _mm_add_epi32(_mm_loadu_si128(sum),     _mm_unpacklo_epi16(lo, zero)));
+            _mm_storeu_si128(sum + 1, _mm_add_epi32(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi16(lo, zero)));
+            _mm_storeu_si128(sum + 2, _mm_add_epi32(_mm_loadu_si128(sum + 2), _mm_unpacklo_epi16(hi, zero)));
+            _mm_storeu_si128(sum + 3, _mm_add_epi32(_mm_loadu_si128(sum + 3), _mm_unpackhi_epi16(hi, zero)));
+        }
+    }
+#else
+    DE_UNUSED(simd);
+#endif
+    for(; i < len; ++i)
+    {
+        cumul[i] += row[i];
+    }
+}
+
+/**
+ * Scales an image vertically, processing whole rows at a time. The result is
+ * identical to applying scaleLine() on each column.
+ *
+ * @param rowLen  Length of a row in bytes.
+ * @param simd    Use the SIMD versions of the row kernels, if available.
+ */
+static void scaleRows(const uint8_t *in, uint8_t *out, int rowLen, int outLen, int inLen,
+    bool simd)
+{
+    float inToOutScale = outLen / (float) inLen;
+    int i;
+
+    if(inToOutScale > 1)
+    {
+        // Magnification is done using linear interpolation.
+        fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
+        fixed_t inPos = inPosDelta;
+
+        // The first row.
+        memcpy(out, in, rowLen);
+        out += rowLen;
+
+        for(i = 1; i < outLen - 1; ++i, out += rowLen, inPos += inPosDelta)
+        {
+            const uint8_t *row1 = in + (inPos >> FRACBITS) * rowLen;
+            const int weight = inPos & 0xffff;
+            if(weight)
+                lerpRow(row1, row1 + rowLen, out, rowLen, weight, simd);
+            else
+                memcpy(out, row1, rowLen);
+        }
+
+        // The last row.
+        memcpy(out, in + (inLen - 1) * rowLen, rowLen);
+        return;
+    }
+
+    if(inToOutScale < 1)
+    {
+        // Minification needs to calculate the average of each of
+        // the rows contained by the out row.
+        uint32_t *cumul = (uint32_t *) M_Calloc(sizeof(*cumul) * rowLen);
+        uint count = 0;
+        int outpos = 0, c;
+
+        for(i = 0; i < inLen; ++i, in += rowLen)
+        {
+            if((int) (i * inToOutScale) != outpos)
+            {
+                outpos = (int) (i * inToOutScale);
+
+                for(c = 0; c < rowLen; ++c)
+                {
+                    out[c] = (count? uint8_t(cumul[c] / count) : 0);
+                    cumul[c] = 0;
+                }
+                count = 0;
+                out += rowLen;
+            }
+            accumulateRow(cumul, in, rowLen, simd);
+            count++;
+        }
+        // Fill in the last row, too.
+        if(count)
+            for(c = 0; c < rowLen; ++c)
+                out[c] = (uint8_t)(cumul[c] / count);
+
+        M_Free(cumul);
+        return;
+    }
+
+    // No need for scaling.
+    memcpy(out, in, size_t(rowLen) * outLen);
+}
+
 /// \todo Avoid use of a secondary buffer by scaling directly to output.
 uint8_t* GL_ScaleBuffer(const uint8_t* in, int width, int height, int comps,
+    int outWidth, int outHeight, bool simd)
+{
+    assert(in);
+    {
+    uint inOffsetSize, outOffsetSize;
+    uint8_t* outOff, *buffer;
+    const uint8_t* inOff;
+    uint8_t* out;
+
+    if(width <= 0 || height <= 0)
+        return (uint8_t*)in;
+
+    buffer = GetScratchBuffer(comps * outWidth * height);
+
+    out = (uint8_t *) M_Malloc(comps * outWidth * outHeight);
+
+    // First scale horizontally, to outWidth, into the temporary buffer.
+    inOff = in;
+    outOff = buffer;
+    inOffsetSize = width * comps;
+    outOffsetSize = outWidth * comps;
+    { int i;
+    for(i = 0; i < height; ++i, inOff += inOffsetSize, outOff += outOffsetSize)
+    {
+        scaleLine(inOff, comps, outOff, comps, outWidth, width, comps);
+    }}
+
+    // Then scale vertically, to outHeight, into the out buffer. Whole rows are
+    // processed at once, so the memory is accessed sequentially.
+    scaleRows(buffer, out, outWidth * comps, outHeight, height, simd);
+    return out;
+    }
+}
+
+uint8_t* GL_ScaleBufferReference(const uint8_t* in, int width, int height, int comps,
     int outWidth, int outHeight)
 {
     assert(in);
@@ -354,12 +354,6 @@ void GL_PrepareTextureContent(texturecontent_t &c,
         if (vspec.noStretch)       c.flags |= TXCF_UPLOAD_ARG_NOSTRETCH;
         if (vspec.mipmapped)       c.flags |= TXCF_MIPMAP;
         if (noSmartFilter)         c.flags |= TXCF_UPLOAD_ARG_NOSMARTFILTER;
-
-        c.magFilter   = vspec.glMagFilter();
-        c.minFilter   = vspec.glMinFilter();
-        c.anisoFilter = vspec.logicalAnisoLevel();
-        c.wrap[0]     = vspec.wrapS;
-        c.wrap[1]     = vspec.wrapT;
         break; }
 
     case TST_DETAIL: {
@@ -398,17 +392,37 @@ void GL_PrepareTextureContent(texturecontent_t &c,
         c.width       = image.size.x;
         c.height      = image.size.y;
         c.pixels      = image.pixels;
-        c.anisoFilter = texAniso;
-        c.magFilter   = glmode[texMagMode];
-        c.minFilter   = GL_LINEAR_MIPMAP_LINEAR;
-        c.wrap[0]     = GL_REPEAT;
-        c.wrap[1]     = GL_REPEAT;
         break; }
 
     default:
         // Invalid spec type.
         DE_ASSERT(false);
     }
+
+    GL_SetTextureContentSampling(c, spec);
+}
+
+void GL_SetTextureContentSampling(texturecontent_t &c, const TextureVariantSpec &spec)
+{
+    switch (spec.type)
+    {
+    case TST_GENERAL: {
+        const variantspecification_t &vspec = spec.variant;
+        c.magFilter   = vspec.glMagFilter();
+        c.minFilter   = vspec.glMinFilter();
+        c.anisoFilter = vspec.logicalAnisoLevel();
+        c.wrap[0]     = vspec.wrapS;
+        c.wrap[1]     = vspec.wrapT;
+        break; }
+
+    case TST_DETAIL:
+        c.anisoFilter = texAniso;
+        c.magFilter   = glmode[texMagMode];
+        c.minFilter   = GL_LINEAR_MIPMAP_LINEAR;
+        c.wrap[0]     = GL_REPEAT;
+        c.wrap[1]     = GL_REPEAT;
+        break;
+    }
 }
 
 /**
@@ -742,28 +756,30 @@ static dd_bool uploadTextureGrayMipmap(GLenum         glFormat,
     return true;
 }
 
-/// @note Texture parameters will NOT be set here!
-void GL_UploadTextureContent(const texturecontent_t &content, gfx::UploadMethod method)
+/**
+ * Processes the content pixels for uploading: converts them to RGB(A), applies gamma
+ * correction and smart filtering, and resizes them to the final texture dimensions.
+ *
+ * @param content     Content to process.
+ * @param loadWidth   Width of the processed pixels is written here.
+ * @param loadHeight  Height of the processed pixels is written here.
+ * @param dglFormat   Format of the processed pixels (DGL_RGB or DGL_RGBA) is written here.
+ *
+ * @return  Processed pixels. If not @c content.pixels, the caller must free the buffer
+ * with M_Free().
+ */
+static const uint8_t *processContentPixels(const texturecontent_t &content, int &loadWidth,
+                                           int &loadHeight, dgltexformat_t &dglFormat)
 {
-    if (method == gfx::Deferred)
-    {
-        GL_DeferTextureUpload(&content);
-        return;
-    }
-
-    if (novideo) return;
-
-    // Do this right away. No need to take a copy.
     bool generateMipmaps = (content.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
     bool applyTexGamma   = (content.flags & TXCF_APPLY_GAMMACORRECTION)     != 0;
-    bool noCompression   = (content.flags & TXCF_NO_COMPRESSION)            != 0;
     bool noSmartFilter   = (content.flags & TXCF_UPLOAD_ARG_NOSMARTFILTER)  != 0;
     bool noStretch       = (content.flags & TXCF_UPLOAD_ARG_NOSTRETCH)      != 0;
 
-    int loadWidth             = content.width;
-    int loadHeight            = content.height;
+    loadWidth                 = content.width;
+    loadHeight                = content.height;
     const uint8_t *loadPixels = content.pixels;
-    dgltexformat_t dglFormat  = content.format;
+    dglFormat                 = content.format;
 
     // Convert a paletted source image to truecolor.
     if (dglFormat == DGL_COLOR_INDEX_8 || dglFormat == DGL_COLOR_INDEX_8_PLUS_A8)
@@ -955,7 +971,7 @@ void GL_UploadTextureContent(const texturecontent_t &content, gfx::UploadMethod
         {
             // Stretch into a new power-of-two texture.
             uint8_t *newPixels = GL_ScaleBuffer(loadPixels, width, height, comps,
-                                                loadWidth, loadHeight);
+                                                loadWidth, loadHeight, useSimdKernels != 0);
             if (loadPixels != content.pixels)
             {
                 M_Free(const_cast<uint8_t *>(loadPixels));
@@ -964,6 +980,51 @@ void GL_UploadTextureContent(const texturecontent_t &content, gfx::UploadMethod
         }
     }
 
+    return loadPixels;
+}
+
+texturecontent_t GL_ProcessTextureContent(const texturecontent_t &content, Block &pixels)
+{
+    DE_ASSERT(!(content.flags & TXCF_PROCESSED));
+
+    texturecontent_t processed = content;
+    const uint8_t *loadPixels = processContentPixels(content, processed.width, processed.height,
+                                                     processed.format);
+    pixels = Block(loadPixels, BytesPerPixelFmt(processed.format) * processed.width * processed.height);
+    if (loadPixels != content.pixels)
+    {
+        M_Free(const_cast<uint8_t *>(loadPixels));
+    }
+    processed.pixels = pixels.data();
+    processed.flags |= TXCF_PROCESSED;
+    return processed;
+}
+
+/// @note Texture parameters will NOT be set here!
+void GL_UploadTextureContent(const texturecontent_t &content, gfx::UploadMethod method)
+{
+    if (method == gfx::Deferred)
+    {
+        GL_DeferTextureUpload(&content);
+        return;
+    }
+
+    if (novideo) return;
+
+    // Do this right away. No need to take a copy.
+    bool generateMipmaps = (content.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
+    bool noCompression   = (content.flags & TXCF_NO_COMPRESSION)            != 0;
+
+    int loadWidth             = content.width;
+    int loadHeight            = content.height;
+    const uint8_t *loadPixels = content.pixels;
+    dgltexformat_t dglFormat  = content.format;
+
+    if (!(content.flags & TXCF_PROCESSED))
+    {
+        loadPixels = processContentPixels(content, loadWidth, loadHeight, dglFormat);
+    }
+
     //DE_ASSERT_IN_MAIN_THREAD();
     DE_ASSERT_GL_CONTEXT_ACTIVE();
 
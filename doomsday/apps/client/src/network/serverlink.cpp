@@ -695,13 +695,14 @@ void ServerLink::initiateCommunications()
         // The counterpart (false) call will occur after joining is successfully done.
         gx.NetConnect(true);
 
-        // Connect by issuing: "Join (myname)"
+        // Connect by issuing: "Join (version) (frame dictionary) (myname)"
         String pName = (playerName ? playerName : "");
         if (pName.isEmpty())
         {
             pName = "Player";
         }
-        *this << Stringf("Join %04x %s", SV_VERSION, pName.c_str());
+        const DeflateDictionary *dict = DoomsdayApp::net().frameDictionary();
+        *this << Stringf("Join %04x %08x %s", SV_VERSION, dict? dict->id() : 0, pName.c_str());
 
         d->state = WaitingForJoinResponse;
 
@@ -5862,7 +5862,7 @@ static void drawVertexes(Map &map)
         parms.drawBar   = true;
         parms.drawLabel = parms.drawOrigin = false;
 
-        map.subspaceBlockmap().forAllInBox(box, [&box, &parms] (void *object)
+        map.subspaceBlockmap().forEachInBox(box, [&box, &parms] (void *object)
         {
             // Check the bounds.
             auto &subspace = *(ConvexSubspace *)object;
@@ -5894,7 +5894,7 @@ static void drawVertexes(Map &map)
     parms.drawOrigin = true;
     parms.drawBar    = parms.drawLabel = false;
 
-    map.subspaceBlockmap().forAllInBox(box, [&box, &parms] (void *object)
+    map.subspaceBlockmap().forEachInBox(box, [&box, &parms] (void *object)
     {
         // Check the bounds.
         auto &subspace = *(ConvexSubspace *)object;
@@ -5917,7 +5917,7 @@ static void drawVertexes(Map &map)
         parms.drawLabel = true;
         parms.drawBar   = parms.drawOrigin = false;
 
-        map.subspaceBlockmap().forAllInBox(box, [&box, &parms] (void *object)
+        map.subspaceBlockmap().forEachInBox(box, [&box, &parms] (void *object)
         {
             auto &subspace = *(ConvexSubspace *)object;
             // Check the bounds.
@@ -6340,6 +6340,7 @@ void Rend_Register()
     C_VAR_INT2("rend-tex-mipmap", &mipmapping, CVF_PROTECTED, 0, 5, mipmappingChanged);
     C_VAR_INT2("rend-tex-quality", &texQuality, 0, 0, 8, texQualityChanged);
     C_VAR_INT("rend-tex-shiny", &useShinySurfaces, 0, 0, 1);
+    C_VAR_BYTE("rend-tex-simd", &useSimdKernels, 0, 0, 1);
 
     //C_VAR_BYTE("rend-bias-grid-debug", &devLightGrid, CVF_NO_ARCHIVE, 0, 1);
     //C_VAR_FLOAT("rend-bias-grid-debug-size", &devLightGridSize, 0, .1f, 100);
@@ -52,7 +52,9 @@
 #include <de/folder.h>
 #include <de/glinfo.h>
 #include <de/imagefile.h>
+#include <de/time.h>
 #include <cstdlib>
+#include <cstring>
 
 using namespace de;
 using namespace res;
@@ -72,9 +74,11 @@ struct OrderedParticle
     float distance;
 };
 static OrderedParticle *order;
+static OrderedParticle *sortBuffer;  ///< Scratch space for sorting the order buffer.
 static size_t orderSize;
 
 static size_t numParts;
+static TimeSpan sortTime;            ///< Time taken sorting the visible particles.
 
 /*
  * Console variables:
@@ -83,6 +87,7 @@ dbyte useParticles = true;
 static int maxParticles;           ///< @c 0= Unlimited.
 static int particleNearLimit;
 static float particleDiffuse = 4;
+static dbyte rendInfoParticles;    ///< @c 1= Print particle sort info to the console.
 
 static float pointDist(fixed_t const c[3])
 {
@@ -248,20 +253,65 @@ void Rend_ParticleReleaseExtraTextures()
 }
 
 /**
- * Sorts in descending order.
+ * Radix sort key of a particle. Distances are positive floats, whose IEEE 754
+ * bit patterns order the same way as the values; the bits are inverted so that
+ * ascending keys sort the particles in descending order of distance.
  */
-static int comparePOrder(const void *a, const void *b)
+static inline duint32 particleSortKey(const OrderedParticle &pt)
 {
-    const auto &ptA = *(const OrderedParticle *) a;
-    const auto &ptB = *(const OrderedParticle *) b;
+    duint32 bits;
+    std::memcpy(&bits, &pt.distance, sizeof(bits));
+    return ~bits;
+}
+
+/**
+ * Sorts the order buffer back->front with a least significant digit radix sort.
+ * The sort is stable, so particles at equal distances keep their generator order.
+ */
+static void sortOrderBuffer()
+{
+    const size_t count = ::numParts;
+
+    // Count the occurrences of all the digits in one pass.
+    duint32 histogram[4][256];
+    de::zap(histogram);
+    for(size_t i = 0; i < count; ++i)
+    {
+        const duint32 key = particleSortKey(::order[i]);
+        histogram[0][ key        & 0xff]++;
+        histogram[1][(key >> 8)  & 0xff]++;
+        histogram[2][(key >> 16) & 0xff]++;
+        histogram[3][ key >> 24        ]++;
+    }
+
+    for(int pass = 0; pass < 4; ++pass)
+    {
+        duint32 *digits = histogram[pass];
+        const int shift = pass * 8;
 
-    if(ptA.distance > ptB.distance) return -1;
-    if(ptA.distance < ptB.distance) return 1;
-    return 0;  // Highly unlikely (but possible).
+        // Skip the pass if all the particles have the same digit (e.g., the exponent
+        // of similar distances).
+        if(digits[(particleSortKey(::order[0]) >> shift) & 0xff] == count) continue;
+
+        duint32 offset = 0;
+        for(int d = 0; d < 256; ++d)
+        {
+            const duint32 n = digits[d];
+            digits[d] = offset;
+            offset += n;
+        }
+        for(size_t i = 0; i < count; ++i)
+        {
+            const OrderedParticle &pt = ::order[i];
+            ::sortBuffer[digits[(particleSortKey(pt) >> shift) & 0xff]++] = pt;
+        }
+        std::swap(::order, ::sortBuffer);
+    }
 }
 
 /**
- * Allocate more memory for the particle ordering buffer, if necessary.
+ * Allocate more memory for the particle ordering buffer, if necessary. The buffers
+ * are kept between frames and only grow.
  */
 static void expandOrderBuffer(size_t max)
 {
@@ -282,6 +332,7 @@ static void expandOrderBuffer(size_t max)
     if(orderSize > currentSize)
     {
         order = (OrderedParticle *) Z_Realloc(order, sizeof(OrderedParticle) * orderSize, PU_APPSTATIC);
+        sortBuffer = (OrderedParticle *) Z_Realloc(sortBuffer, sizeof(OrderedParticle) * orderSize, PU_APPSTATIC);
     }
 }
 
@@ -309,6 +360,7 @@ static int listVisibleParticles(Map &map)
     ::hasPoints = ::hasModels = ::hasLines = false;
     ::hasAdditive = ::hasNoBlend = false;
     de::zap(::hasPointTexs);
+    ::sortTime = 0.0;
 
     // Count the total number of particles used by generators marked 'visible'.
     ::numParts = 0;
@@ -394,8 +446,10 @@ static int listVisibleParticles(Map &map)
     // This is the real number of possibly visible particles.
     ::numParts = numVisibleParts;
 
-    // Sort the order list back->front. A quicksort is fast enough.
-    qsort(::order, ::numParts, sizeof(OrderedParticle), comparePOrder);
+    // Sort the order list back->front.
+    const Time sortStartedAt;
+    sortOrderBuffer();
+    ::sortTime = sortStartedAt.since();
 
     return true;
 }
@@ -881,7 +935,15 @@ void Rend_RenderParticles(Map &map)
     if(!useParticles) return;
 
     // No visible particles at all?
-    if (!listVisibleParticles(map)) return;
+    const bool visible = listVisibleParticles(map);
+
+    if(rendInfoParticles)
+    {
+        LOGDEV_GL_MSG("Particles: %i visible, sorted in %.3f ms")
+                << (visible? int(::numParts) : 0) << ::sortTime * 1000.0;
+    }
+
+    if(!visible) return;
 
     // Render all the visible particles.
     if(hasNoBlend)
@@ -904,4 +966,5 @@ void Rend_ParticleRegister()
     C_VAR_INT  ("rend-particle-max",               &maxParticles,      CVF_NO_MAX,     0, 0);
     C_VAR_FLOAT("rend-particle-diffuse",           &particleDiffuse,   CVF_NO_MAX,     0, 0);
     C_VAR_INT  ("rend-particle-visible-near",      &particleNearLimit, CVF_NO_MAX,     0, 0);
+    C_VAR_BYTE ("rend-info-particles",             &rendInfoParticles, CVF_NO_ARCHIVE, 0, 1);
 }
@@ -138,6 +138,8 @@ DE_PIMPL(ClientResources)
     TextureSpecs textureSpecs;
     TextureSpecs detailTextureSpecs[DETAILVARIANT_CONTRAST_HASHSIZE];
 
+    TextureVariantCache textureVariantCache;
+
     struct CacheTask
     {
         virtual ~CacheTask() {}
@@ -1485,6 +1487,11 @@ TextureVariantSpec &ClientResources::detailTextureSpec(dfloat contrast)
     return *d->detailTextureSpec(contrast);
 }
 
+TextureVariantCache &ClientResources::textureVariantCache()
+{
+    return d->textureVariantCache;
+}
+
 FontScheme &ClientResources::fontScheme(const String& name) const
 {
     LOG_AS("ClientResources::fontScheme");
@@ -2214,6 +2221,7 @@ D_CMD(PrintFontStats)
 void ClientResources::consoleRegister() // static
 {
     Resources::consoleRegister();
+    TextureVariantCache::consoleRegister();
 
     C_CMD("listfonts",      "ss",   ListFonts)
     C_CMD("listfonts",      "s",    ListFonts)
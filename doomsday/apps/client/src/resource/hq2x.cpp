@@ -22,12 +22,18 @@
 #include "resource/hq2x.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <de/legacy/memory.h>
 #include "dd_main.h"
 #include "dd_types.h"
 #include "dd_share.h"
+#include "gl/gl_tex.h"  // DE_GL_TEX_SSE2
 #include "resource/image.h"
 
+#ifdef DE_GL_TEX_SSE2
+#  include <emmintrin.h>
+#endif
+
 /*
  * RGB color space.
  */
@@ -102,56 +108,55 @@
 #define trV                 (6)
 
 #define PIXEL00_0         Transl(pOut,       w[5]);
-#define PIXEL00_10       Interp1(pOut,       w[5], w[1]);
-#define PIXEL00_11       Interp1(pOut,       w[5], w[4]);
-#define PIXEL00_12       Interp1(pOut,       w[5], w[2]);
-#define PIXEL00_20       Interp2(pOut,       w[5], w[4], w[2]);
-#define PIXEL00_21       Interp2(pOut,       w[5], w[1], w[2]);
-#define PIXEL00_22       Interp2(pOut,       w[5], w[1], w[4]);
-#define PIXEL00_60       Interp6(pOut,       w[5], w[2], w[4]);
-#define PIXEL00_61       Interp6(pOut,       w[5], w[4], w[2]);
-#define PIXEL00_70       Interp7(pOut,       w[5], w[4], w[2]);
-#define PIXEL00_90       Interp9(pOut,       w[5], w[4], w[2]);
-#define PIXEL00_100     Interp10(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_10       Interp1<Simd>(pOut,       w[5], w[1]);
+#define PIXEL00_11       Interp1<Simd>(pOut,       w[5], w[4]);
+#define PIXEL00_12       Interp1<Simd>(pOut,       w[5], w[2]);
+#define PIXEL00_20       Interp2<Simd>(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_21       Interp2<Simd>(pOut,       w[5], w[1], w[2]);
+#define PIXEL00_22       Interp2<Simd>(pOut,       w[5], w[1], w[4]);
+#define PIXEL00_60       Interp6<Simd>(pOut,       w[5], w[2], w[4]);
+#define PIXEL00_61       Interp6<Simd>(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_70       Interp7<Simd>(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_90       Interp9<Simd>(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_100     Interp10<Simd>(pOut,       w[5], w[4], w[2]);
 #define PIXEL01_0         Transl(pOut+4,     w[5]);
-#define PIXEL01_10       Interp1(pOut+4,     w[5], w[3]);
-#define PIXEL01_11       Interp1(pOut+4,     w[5], w[2]);
-#define PIXEL01_12       Interp1(pOut+4,     w[5], w[6]);
-#define PIXEL01_20       Interp2(pOut+4,     w[5], w[2], w[6]);
-#define PIXEL01_21       Interp2(pOut+4,     w[5], w[3], w[6]);
-#define PIXEL01_22       Interp2(pOut+4,     w[5], w[3], w[2]);
-#define PIXEL01_60       Interp6(pOut+4,     w[5], w[6], w[2]);
-#define PIXEL01_61       Interp6(pOut+4,     w[5], w[2], w[6]);
-#define PIXEL01_70       Interp7(pOut+4,     w[5], w[2], w[6]);
-#define PIXEL01_90       Interp9(pOut+4,     w[5], w[2], w[6]);
-#define PIXEL01_100     Interp10(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_10       Interp1<Simd>(pOut+4,     w[5], w[3]);
+#define PIXEL01_11       Interp1<Simd>(pOut+4,     w[5], w[2]);
+#define PIXEL01_12       Interp1<Simd>(pOut+4,     w[5], w[6]);
+#define PIXEL01_20       Interp2<Simd>(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_21       Interp2<Simd>(pOut+4,     w[5], w[3], w[6]);
+#define PIXEL01_22       Interp2<Simd>(pOut+4,     w[5], w[3], w[2]);
+#define PIXEL01_60       Interp6<Simd>(pOut+4,     w[5], w[6], w[2]);
+#define PIXEL01_61       Interp6<Simd>(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_70       Interp7<Simd>(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_90       Interp9<Simd>(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_100     Interp10<Simd>(pOut+4,     w[5], w[2], w[6]);
 #define PIXEL10_0         Transl(pOut+BpL,   w[5]);
-#define PIXEL10_10       Interp1(pOut+BpL,   w[5], w[7]);
-#define PIXEL10_11       Interp1(pOut+BpL,   w[5], w[8]);
-#define PIXEL10_12       Interp1(pOut+BpL,   w[5], w[4]);
-#define PIXEL10_20       Interp2(pOut+BpL,   w[5], w[8], w[4]);
-#define PIXEL10_21       Interp2(pOut+BpL,   w[5], w[7], w[4]);
-#define PIXEL10_22       Interp2(pOut+BpL,   w[5], w[7], w[8]);
-#define PIXEL10_60       Interp6(pOut+BpL,   w[5], w[4], w[8]);
-#define PIXEL10_61       Interp6(pOut+BpL,   w[5], w[8], w[4]);
-#define PIXEL10_70       Interp7(pOut+BpL,   w[5], w[8], w[4]);
-#define PIXEL10_90       Interp9(pOut+BpL,   w[5], w[8], w[4]);
-#define PIXEL10_100     Interp10(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_10       Interp1<Simd>(pOut+BpL,   w[5], w[7]);
+#define PIXEL10_11       Interp1<Simd>(pOut+BpL,   w[5], w[8]);
+#define PIXEL10_12       Interp1<Simd>(pOut+BpL,   w[5], w[4]);
+#define PIXEL10_20       Interp2<Simd>(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_21       Interp2<Simd>(pOut+BpL,   w[5], w[7], w[4]);
+#define PIXEL10_22       Interp2<Simd>(pOut+BpL,   w[5], w[7], w[8]);
+#define PIXEL10_60       Interp6<Simd>(pOut+BpL,   w[5], w[4], w[8]);
+#define PIXEL10_61       Interp6<Simd>(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_70       Interp7<Simd>(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_90       Interp9<Simd>(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_100     Interp10<Simd>(pOut+BpL,   w[5], w[8], w[4]);
 #define PIXEL11_0         Transl(pOut+BpL+4, w[5]);
-#define PIXEL11_10       Interp1(pOut+BpL+4, w[5], w[9]);
-#define PIXEL11_11       Interp1(pOut+BpL+4, w[5], w[6]);
-#define PIXEL11_12       Interp1(pOut+BpL+4, w[5], w[8]);
-#define PIXEL11_20       Interp2(pOut+BpL+4, w[5], w[6], w[8]);
-#define PIXEL11_21       Interp2(pOut+BpL+4, w[5], w[9], w[8]);
-#define PIXEL11_22       Interp2(pOut+BpL+4, w[5], w[9], w[6]);
-#define PIXEL11_60       Interp6(pOut+BpL+4, w[5], w[8], w[6]);
-#define PIXEL11_61       Interp6(pOut+BpL+4, w[5], w[6], w[8]);
-#define PIXEL11_70       Interp7(pOut+BpL+4, w[5], w[6], w[8]);
-#define PIXEL11_90       Interp9(pOut+BpL+4, w[5], w[6], w[8]);
-#define PIXEL11_100     Interp10(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_10       Interp1<Simd>(pOut+BpL+4, w[5], w[9]);
+#define PIXEL11_11       Interp1<Simd>(pOut+BpL+4, w[5], w[6]);
+#define PIXEL11_12       Interp1<Simd>(pOut+BpL+4, w[5], w[8]);
+#define PIXEL11_20       Interp2<Simd>(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_21       Interp2<Simd>(pOut+BpL+4, w[5], w[9], w[8]);
+#define PIXEL11_22       Interp2<Simd>(pOut+BpL+4, w[5], w[9], w[6]);
+#define PIXEL11_60       Interp6<Simd>(pOut+BpL+4, w[5], w[8], w[6]);
+#define PIXEL11_61       Interp6<Simd>(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_70       Interp7<Simd>(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_90       Interp9<Simd>(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_100     Interp10<Simd>(pOut+BpL+4, w[5], w[6], w[8]);
 
 static uint32_t lutBGR888toYUV888[32*64*32];
-static uint32_t YUV1, YUV2;
 
 void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
     uint32_t f2, uint32_t f3)
@@ -188,16 +193,109 @@ void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
     *((uint32_t*)pc) = ABGR8888_PACK(out[3], out[2], out[1], out[0]);
 }
 
-static __inline int Diff(uint32_t c1, uint32_t c2)
+/**
+ * Weighted average of three colors. The weights must add up to a power of two,
+ * (1 << @a shift), so that the result is identical to LerpColor().
+ */
+template <bool Simd>
+static __inline void Lerp(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
+    uint32_t f2, uint32_t f3, int shift)
+{
+#ifdef DE_GL_TEX_SSE2
+    if(Simd)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(c1)), zero),
+                                      _mm_set1_epi16(short(f1)));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(c2)), zero),
+                                                 _mm_set1_epi16(short(f2))));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(int(c3)), zero),
+                                                 _mm_set1_epi16(short(f3))));
+        sum = _mm_srl_epi16(sum, _mm_cvtsi32_si128(shift));
+        const int out = _mm_cvtsi128_si32(_mm_packus_epi16(sum, zero));
+        std::memcpy(pc, &out, 4);
+        return;
+    }
+#endif
+    DE_UNUSED(shift);
+    LerpColor(pc, c1, c2, c3, f1, f2, f3);
+}
+
+/**
+ * Original version of Diff(), comparing the colors directly. Used by
+ * GL_SmartFilterHQ2xReference().
+ */
+static __inline int DiffReference(uint32_t c1, uint32_t c2)
 {
-    YUV1 = ABGR8888toYUV888(c1);
-    YUV2 = ABGR8888toYUV888(c2);
+    const uint32_t YUV1 = ABGR8888toYUV888(c1);
+    const uint32_t YUV2 = ABGR8888toYUV888(c2);
     return ( ((ABGR8888_COMP(3, c1) != 0) != ((ABGR8888_COMP(3, c2) != 0))) ||
              (abs(int(YUV1 & YUV888_Ymask) - int(YUV2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
              (abs(int(YUV1 & YUV888_Umask) - int(YUV2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
              (abs(int(YUV1 & YUV888_Vmask) - int(YUV2 & YUV888_Vmask)) > ((trV & (int)0xFF)) ));
 }
 
+/**
+ * Key of a pixel for comparisons: the color in the YUV color space, with the top
+ * byte set if the pixel is not fully transparent.
+ */
+static __inline uint32_t PixelKey(uint32_t c)
+{
+    return ABGR8888toYUV888(c) | ((c & ABGR8888_Amask)? 0xff000000 : 0);
+}
+
+/**
+ * Determines whether two pixels differ noticeably, given their keys.
+ */
+static __inline int Diff(uint32_t k1, uint32_t k2)
+{
+    return ( ((k1 ^ k2) & 0xff000000) ||
+             (abs(int(k1 & YUV888_Ymask) - int(k2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
+             (abs(int(k1 & YUV888_Umask) - int(k2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
+             (abs(int(k1 & YUV888_Vmask) - int(k2 & YUV888_Vmask)) > ((trV & (int)0xFF)) ));
+}
+
+/**
+ * Determines which of the neighbors of the center pixel differ from it noticeably.
+ *
+ * @param k  Keys of the 3x3 neighborhood, w1...w9 in indices 1...9.
+ *
+ * @return Bit for each neighbor (w1 is the lowest bit; the center is skipped).
+ */
+template <bool Simd>
+static __inline int Pattern(const uint32_t k[10])
+{
+#ifdef DE_GL_TEX_SSE2
+    if(Simd)
+    {
+        // Per-byte difference limits of the key: V, U, Y, and transparency.
+        const __m128i limits = _mm_set1_epi32((trY << 16) | (trU << 8) | trV);
+        const __m128i center = _mm_set1_epi32(int(k[5]));
+        const __m128i zero   = _mm_setzero_si128();
+        const __m128i n1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&k[1]));
+        const __m128i n2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&k[6]));
+        const __m128i d1 = _mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(n1, center),
+                                                      _mm_subs_epu8(center, n1)), limits);
+        const __m128i d2 = _mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(n2, center),
+                                                      _mm_subs_epu8(center, n2)), limits);
+        const int same1 = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(d1, zero)));
+        const int same2 = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(d2, zero)));
+        return ~(same1 | (same2 << 4)) & 0xff;
+    }
+#endif
+    int pattern = 0, flag = 1;
+    for(int i = 1; i <= 9; ++i)
+    {
+        if(i == 5)
+            continue;
+
+        if(k[i] != k[5] && Diff(k[5], k[i]))
+            pattern |= flag;
+        flag <<= 1;
+    }
+    return pattern;
+}
+
 static __inline void Transl(uint8_t* pc, uint32_t c)
 {
     pc[0] = ABGR8888_COMP(0, c);
@@ -206,6 +304,7 @@ static __inline void Transl(uint8_t* pc, uint32_t c)
     pc[3] = ABGR8888_COMP(3, c);
 }
 
+template <bool Simd>
 static __inline void Interp1(uint8_t* pc, uint32_t c1, uint32_t c2)
 {
     if(c1 == c2)
@@ -213,32 +312,37 @@ static __inline void Interp1(uint8_t* pc, uint32_t c1, uint32_t c2)
         Transl(pc, c1);
         return;
     }
-    LerpColor(pc, c1, c2, 0, 3, 1, 0);
+    Lerp<Simd>(pc, c1, c2, 0, 3, 1, 0, 2);
 }
 
+template <bool Simd>
 static __inline void Interp2(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 2, 1, 1);
+    Lerp<Simd>(pc, c1, c2, c3, 2, 1, 1, 2);
 }
 
+template <bool Simd>
 static __inline void Interp6(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 5, 2, 1);
+    Lerp<Simd>(pc, c1, c2, c3, 5, 2, 1, 3);
 }
 
+template <bool Simd>
 static __inline void Interp7(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 6, 1, 1);
+    Lerp<Simd>(pc, c1, c2, c3, 6, 1, 1, 3);
 }
 
+template <bool Simd>
 static __inline void Interp9(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 2, 3, 3);
+    Lerp<Simd>(pc, c1, c2, c3, 2, 3, 3, 3);
 }
 
+template <bool Simd>
 static __inline void Interp10(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 14, 1, 1);
+    Lerp<Simd>(pc, c1, c2, c3, 14, 1, 1, 4);
 }
 
 void GL_InitSmartFilterHQ2x(void)
@@ -260,32 +364,1742 @@ void GL_InitSmartFilterHQ2x(void)
             }
 }
 
-uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags)
-{
 #define BPP             (4) // Bytes Per Pixel.
-#define OFFSET(x, y)    (BPP*(y)*width + BPP*(x))
 
-    assert(src);
+/**
+ * @param src     R8G8B8A8 source image.
+ * @param keys    PixelKey() of each source pixel.
+ * @param dst     Output buffer (2x the size of the source image).
+ */
+template <bool Simd>
+static void filterHQ2x(const uint8_t* src, const uint32_t* keys, uint8_t* dst,
+    int width, int height, bool wrapH, bool wrapV)
+{
+    const int BpL = BPP * 2 * width; // (Out) Bytes per Line.
+    uint8_t* pOut = dst;
+    uint32_t w[10], k[10];
+
+    for(int y = 0; y < height; ++y)
     {
-    dd_bool wrapH = (flags & ICF_UPSCALE_SAMPLE_WRAPH) != 0;
-    dd_bool wrapV = (flags & ICF_UPSCALE_SAMPLE_WRAPV) != 0;
-    int pattern, flag, BpL, xA, xB, yA, yB;
-    uint8_t* pOut, *dst;
-    uint32_t w[10];
+        // +----+----+----+
+        // | w1 | w2 | w3 |
+        // +----+----+----+
+        // | w4 | w5 | w6 |
+        // +----+----+----+
+        // | w7 | w8 | w9 |
+        // +----+----+----+
 
-    if(width <= 0 || height <= 0)
-        return 0;
+        // Neighbor rows. Without wrapping, the edge pixels are repeated.
+        const int yA = y == 0?          ( wrapV? height-1 : 0) : y-1;
+        const int yB = y == height-1?   (!wrapV? height-1 : 0) : y+1;
+        const int rows[3] = { yA * width, y * width, yB * width };
 
-    // +----+----+----+
-    // | w1 | w2 | w3 |
-    // +----+----+----+
-    // | w4 | w5 | w6 |
-    // +----+----+----+
-    // | w7 | w8 | w9 |
-    // +----+----+----+
+        for(int x = 0; x < width; ++x)
+        {
+            const int xA = x == 0?          ( wrapH? width-1 : 0) : x-1;
+            const int xB = x == width-1?    (!wrapH? width-1 : 0) : x+1;
+            const int cols[3] = { xA, x, xB };
 
-    if(0 == (dst = (uint8_t *) M_Malloc(BPP * 2 * width * height * 2)))
-        App_Error("GL_SmartFilterHQ2x: Failed on allocation of %lu bytes for "
+            for(int i = 0; i < 9; ++i)
+            {
+                const int offset = rows[i / 3] + cols[i % 3];
+                w[i + 1] = DD_ULONG( *( (const uint32_t*)(src + BPP * offset) ) );
+                k[i + 1] = keys[offset];
+            }
+
+            const int pattern = Pattern<Simd>(k);
+
+            switch(pattern)
+            {
+            case 0:
+            case 1:
+            case 4:
+            case 32:
+            case 128:
+            case 5:
+            case 132:
+            case 160:
+            case 33:
+            case 129:
+            case 36:
+            case 133:
+            case 164:
+            case 161:
+            case 37:
+            case 165: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 2:
+            case 34:
+            case 130:
+            case 162: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 16:
+            case 17:
+            case 48:
+            case 49: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_20 PIXEL11_21 break;
+              }
+            case 64:
+            case 65:
+            case 68:
+            case 69: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 8:
+            case 12:
+            case 136:
+            case 140: {
+                    PIXEL00_21 PIXEL01_20 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 3:
+            case 35:
+            case 131:
+            case 163: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 6:
+            case 38:
+            case 134:
+            case 166: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 20:
+            case 21:
+            case 52:
+            case 53: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_21 break;
+              }
+            case 144:
+            case 145:
+            case 176:
+            case 177: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_20 PIXEL11_12 break;
+              }
+            case 192:
+            case 193:
+            case 196:
+            case 197: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 96:
+            case 97:
+            case 100:
+            case 101: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 40:
+            case 44:
+            case 168:
+            case 172: {
+                    PIXEL00_21 PIXEL01_20 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 9:
+            case 13:
+            case 137:
+            case 141: {
+                    PIXEL00_12 PIXEL01_20 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 18:
+            case 50: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 80:
+            case 81: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 72:
+            case 76: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 10:
+            case 138: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 66: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 24: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 7:
+            case 39:
+            case 135: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 148:
+            case 149:
+            case 180: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_12 break;
+              }
+            case 224:
+            case 228:
+            case 225: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 41:
+            case 169:
+            case 45: {
+                    PIXEL00_12 PIXEL01_20 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 22:
+            case 54: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 208:
+            case 209: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 104:
+            case 108: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 11:
+            case 139: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 19:
+            case 51: {
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL00_11 PIXEL01_10}
+                    else {
+                    PIXEL00_60 PIXEL01_90}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 146:
+            case 178: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10 PIXEL11_12}
+                    else {
+                    PIXEL01_90 PIXEL11_61}
+                    PIXEL10_20 break;
+              }
+            case 84:
+            case 85: {
+                    PIXEL00_20 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL01_11 PIXEL11_10}
+                    else {
+                    PIXEL01_60 PIXEL11_90}
+                    PIXEL10_21 break;
+              }
+            case 112:
+            case 113: {
+                    PIXEL00_20 PIXEL01_22 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL10_12 PIXEL11_10}
+                    else {
+                    PIXEL10_61 PIXEL11_90}
+                    break;
+              }
+            case 200:
+            case 204: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10 PIXEL11_11}
+                    else {
+                    PIXEL10_90 PIXEL11_60}
+                    break;
+              }
+            case 73:
+            case 77: {
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL00_12 PIXEL10_10}
+                    else {
+                    PIXEL00_61 PIXEL10_90}
+                    PIXEL01_20 PIXEL11_22 break;
+              }
+            case 42:
+            case 170: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10 PIXEL10_11}
+                    else {
+                    PIXEL00_90 PIXEL10_60}
+                    PIXEL01_21 PIXEL11_20 break;
+              }
+            case 14:
+            case 142: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10 PIXEL01_12}
+                    else {
+                    PIXEL00_90 PIXEL01_61}
+                    PIXEL10_22 PIXEL11_20 break;
+              }
+            case 67: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 70: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 28: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 152: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 194: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 98: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 56: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 25: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 26:
+            case 31: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_22 PIXEL11_21 break;
+              }
+            case 82:
+            case 214: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 88:
+            case 248: {
+                    PIXEL00_21 PIXEL01_22 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 74:
+            case 107: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 27: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 86: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_21 PIXEL11_10 break;
+              }
+            case 216: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_10 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 106: {
+                    PIXEL00_10 PIXEL01_21 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 30: {
+                    PIXEL00_10 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_22 PIXEL11_21 break;
+              }
+            case 210: {
+                    PIXEL00_22 PIXEL01_10 PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 120: {
+                    PIXEL00_21 PIXEL01_22 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 75: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_10 PIXEL11_22 break;
+              }
+            case 29: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 198: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 184: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 99: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 57: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 71: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 156: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 226: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 60: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 195: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 102: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 153: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 58: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 83: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 92: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 202: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_21 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_11 break;
+              }
+            case 78: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_22 break;
+              }
+            case 154: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_22 PIXEL11_12 break;
+              }
+            case 114: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 89: {
+                    PIXEL00_12 PIXEL01_22 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 90: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 55:
+            case 23: {
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL00_11 PIXEL01_0}
+                    else {
+                    PIXEL00_60 PIXEL01_90}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 182:
+            case 150: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0 PIXEL11_12}
+                    else {
+                    PIXEL01_90 PIXEL11_61}
+                    PIXEL10_20 break;
+              }
+            case 213:
+            case 212: {
+                    PIXEL00_20 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL01_11 PIXEL11_0}
+                    else {
+                    PIXEL01_60 PIXEL11_90}
+                    PIXEL10_21 break;
+              }
+            case 241:
+            case 240: {
+                    PIXEL00_20 PIXEL01_22 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL10_12 PIXEL11_0}
+                    else {
+                    PIXEL10_61 PIXEL11_90}
+                    break;
+              }
+            case 236:
+            case 232: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0 PIXEL11_11}
+                    else {
+                    PIXEL10_90 PIXEL11_60}
+                    break;
+              }
+            case 109:
+            case 105: {
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL00_12 PIXEL10_0}
+                    else {
+                    PIXEL00_61 PIXEL10_90}
+                    PIXEL01_20 PIXEL11_22 break;
+              }
+            case 171:
+            case 43: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0 PIXEL10_11}
+                    else {
+                    PIXEL00_90 PIXEL10_60}
+                    PIXEL01_21 PIXEL11_20 break;
+              }
+            case 143:
+            case 15: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0 PIXEL01_12}
+                    else {
+                    PIXEL00_90 PIXEL01_61}
+                    PIXEL10_22 PIXEL11_20 break;
+              }
+            case 124: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 203: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_10 PIXEL11_11 break;
+              }
+            case 62: {
+                    PIXEL00_10 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 211: {
+                    PIXEL00_11 PIXEL01_10 PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 118: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_12 PIXEL11_10 break;
+              }
+            case 217: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_10 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 110: {
+                    PIXEL00_10 PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 155: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 188: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 185: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 61: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 157: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 103: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 227: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 230: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 199: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 220: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 158: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_22 PIXEL11_12 break;
+              }
+            case 234: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_21 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_11 break;
+              }
+            case 242: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 59: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 121: {
+                    PIXEL00_12 PIXEL01_22 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 87: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 79: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_22 break;
+              }
+            case 122: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 94: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 218: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 91: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 229: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 167: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 173: {
+                    PIXEL00_12 PIXEL01_20 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 181: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_12 break;
+              }
+            case 186: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_11 PIXEL11_12 break;
+              }
+            case 115: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 93: {
+                    PIXEL00_12 PIXEL01_11 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 206: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_11 break;
+              }
+            case 205:
+            case 201: {
+                    PIXEL00_12 PIXEL01_20 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_11 break;
+              }
+            case 174:
+            case 46: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_12 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 179:
+            case 147: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_20 PIXEL11_12 break;
+              }
+            case 117:
+            case 116: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 189: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 231: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 126: {
+                    PIXEL00_10 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 219: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 PIXEL10_10 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 125: {
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL00_12 PIXEL10_0}
+                    else {
+                    PIXEL00_61 PIXEL10_90}
+                    PIXEL01_11 PIXEL11_10 break;
+              }
+            case 221: {
+                    PIXEL00_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL01_11 PIXEL11_0}
+                    else {
+                    PIXEL01_60 PIXEL11_90}
+                    PIXEL10_10 break;
+              }
+            case 207: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0 PIXEL01_12}
+                    else {
+                    PIXEL00_90 PIXEL01_61}
+                    PIXEL10_10 PIXEL11_11 break;
+              }
+            case 238: {
+                    PIXEL00_10 PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0 PIXEL11_11}
+                    else {
+                    PIXEL10_90 PIXEL11_60}
+                    break;
+              }
+            case 190: {
+                    PIXEL00_10 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0 PIXEL11_12}
+                    else {
+                    PIXEL01_90 PIXEL11_61}
+                    PIXEL10_11 break;
+              }
+            case 187: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0 PIXEL10_11}
+                    else {
+                    PIXEL00_90 PIXEL10_60}
+                    PIXEL01_10 PIXEL11_12 break;
+              }
+            case 243: {
+                    PIXEL00_11 PIXEL01_10 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL10_12 PIXEL11_0}
+                    else {
+                    PIXEL10_61 PIXEL11_90}
+                    break;
+              }
+            case 119: {
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL00_11 PIXEL01_0}
+                    else {
+                    PIXEL00_60 PIXEL01_90}
+                    PIXEL10_12 PIXEL11_10 break;
+              }
+            case 237:
+            case 233: {
+                    PIXEL00_12 PIXEL01_20 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    PIXEL11_11 break;
+              }
+            case 175:
+            case 47: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    PIXEL01_12 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 183:
+            case 151: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_20 PIXEL11_12 break;
+              }
+            case 245:
+            case 244: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 250: {
+                    PIXEL00_10 PIXEL01_10 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 123: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 95: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_10 PIXEL11_10 break;
+              }
+            case 222: {
+                    PIXEL00_10 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_10 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 252: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 249: {
+                    PIXEL00_12 PIXEL01_22 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 235: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    PIXEL11_11 break;
+              }
+            case 111: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 63: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 159: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_22 PIXEL11_12 break;
+              }
+            case 215: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_21 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 246: {
+                    PIXEL00_22 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 254: {
+                    PIXEL00_10 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 253: {
+                    PIXEL00_12 PIXEL01_11 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 251: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 239: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    PIXEL01_12 if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    PIXEL11_11 break;
+              }
+            case 127: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 191: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_11 PIXEL11_12 break;
+              }
+            case 223: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_10 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 247: {
+                    PIXEL00_11 if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_12 if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 255: {
+                    if(Diff(k[4], k[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(k[2], k[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    if(Diff(k[8], k[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(k[6], k[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            default:
+                App_Error("GL_SmartFilterHQ2x: Invalid pattern %i.", pattern);
+                break;
+            }
+            pOut += 2 * BPP;
+        }
+        pOut += BpL;
+    }
+}
+
+uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags, bool simd)
+{
+    assert(src);
+
+    const bool wrapH = (flags & ICF_UPSCALE_SAMPLE_WRAPH) != 0;
+    const bool wrapV = (flags & ICF_UPSCALE_SAMPLE_WRAPV) != 0;
+    uint8_t* dst;
+
+    if(width <= 0 || height <= 0)
+        return 0;
+
+    if(0 == (dst = (uint8_t *) M_Malloc(BPP * 2 * width * height * 2)))
+        App_Error("GL_SmartFilterHQ2x: Failed on allocation of %lu bytes for "
+                  "output buffer.", (unsigned long) (BPP * 2 * width * height * 2));
+
+    // Each pixel is compared with its neighbors, so convert each one only once.
+    uint32_t* keys = (uint32_t *) M_Malloc(sizeof(uint32_t) * width * height);
+    for(int i = 0; i < width * height; ++i)
+    {
+        keys[i] = PixelKey(DD_ULONG( *( (const uint32_t*)(src + BPP * i) ) ));
+    }
+
+#ifdef DE_GL_TEX_SSE2
+    if(simd)
+    {
+        filterHQ2x<true>(src, keys, dst, width, height, wrapH, wrapV);
+    }
+    else
+#else
+    DE_UNUSED(simd);
+#endif
+    {
+        filterHQ2x<false>(src, keys, dst, width, height, wrapH, wrapV);
+    }
+
+    M_Free(keys);
+    return dst;
+}
+
+#undef BPP
+
+uint8_t* GL_SmartFilterHQ2xReference(const uint8_t* src, int width, int height, int flags)
+{
+#define BPP             (4) // Bytes Per Pixel.
+#define OFFSET(x, y)    (BPP*(y)*width + BPP*(x))
+
+    assert(src);
+    {
+    dd_bool wrapH = (flags & ICF_UPSCALE_SAMPLE_WRAPH) != 0;
+    dd_bool wrapV = (flags & ICF_UPSCALE_SAMPLE_WRAPV) != 0;
+    int pattern, flag, BpL, xA, xB, yA, yB;
+    uint8_t* pOut, *dst;
+    uint32_t w[10];
+    uint32_t YUV1, YUV2;
+    const bool Simd = false; // The PIXEL macros interpolate with LerpColor().
+
+    if(width <= 0 || height <= 0)
+        return 0;
+
+    // +----+----+----+
+    // | w1 | w2 | w3 |
+    // +----+----+----+
+    // | w4 | w5 | w6 |
+    // +----+----+----+
+    // | w7 | w8 | w9 |
+    // +----+----+----+
+
+    if(0 == (dst = (uint8_t *) M_Malloc(BPP * 2 * width * height * 2)))
+        App_Error("GL_SmartFilterHQ2xReference: Failed on allocation of %lu bytes for "
                   "output buffer.", (unsigned long) (BPP * 2 * width * height * 2));
 
     pOut = dst;
@@ -463,7 +2277,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 18:
             case 50: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
@@ -473,7 +2287,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 80:
             case 81: {
-                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -483,7 +2297,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 72:
             case 76: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
@@ -493,7 +2307,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 10:
             case 138: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
@@ -529,7 +2343,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 22:
             case 54: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -539,7 +2353,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 208:
             case 209: {
-                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -549,7 +2363,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 104:
             case 108: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -559,7 +2373,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 11:
             case 139: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
@@ -569,7 +2383,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 19:
             case 51: {
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL00_11 PIXEL01_10}
                     else {
@@ -578,7 +2392,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 146:
             case 178: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10 PIXEL11_12}
                     else {
@@ -587,7 +2401,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 84:
             case 85: {
-                    PIXEL00_20 if(Diff(w[6], w[8]))
+                    PIXEL00_20 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL01_11 PIXEL11_10}
                     else {
@@ -596,7 +2410,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 112:
             case 113: {
-                    PIXEL00_20 PIXEL01_22 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL10_12 PIXEL11_10}
                     else {
@@ -605,7 +2419,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 200:
             case 204: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10 PIXEL11_11}
                     else {
@@ -614,7 +2428,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 73:
             case 77: {
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL00_12 PIXEL10_10}
                     else {
@@ -623,7 +2437,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 42:
             case 170: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10 PIXEL10_11}
                     else {
@@ -632,7 +2446,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 14:
             case 142: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10 PIXEL01_12}
                     else {
@@ -665,13 +2479,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 26:
             case 31: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -681,13 +2495,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 82:
             case 214: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -697,13 +2511,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 88:
             case 248: {
-                    PIXEL00_21 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_22 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -713,13 +2527,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 74:
             case 107: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -728,7 +2542,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 27: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
@@ -737,7 +2551,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_10 PIXEL10_22 PIXEL11_21 break;
               }
             case 86: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -746,7 +2560,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_21 PIXEL11_10 break;
               }
             case 216: {
-                    PIXEL00_21 PIXEL01_22 PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL00_21 PIXEL01_22 PIXEL10_10 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -755,7 +2569,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 106: {
-                    PIXEL00_10 PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_21 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -764,7 +2578,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 30: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -773,7 +2587,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_21 break;
               }
             case 210: {
-                    PIXEL00_22 PIXEL01_10 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_22 PIXEL01_10 PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -782,7 +2596,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 120: {
-                    PIXEL00_21 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_22 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -791,7 +2605,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 75: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
@@ -836,13 +2650,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_12 PIXEL01_22 PIXEL10_22 PIXEL11_12 break;
               }
             case 58: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
@@ -851,13 +2665,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 83: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -866,13 +2680,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 92: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -881,13 +2695,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 202: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
@@ -896,13 +2710,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 78: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
@@ -911,13 +2725,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 154: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
@@ -926,13 +2740,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_12 break;
               }
             case 114: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -941,13 +2755,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 89: {
-                    PIXEL00_12 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_22 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -956,25 +2770,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 90: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -984,7 +2798,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 55:
             case 23: {
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL00_11 PIXEL01_0}
                     else {
@@ -993,7 +2807,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 182:
             case 150: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0 PIXEL11_12}
                     else {
@@ -1002,7 +2816,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 213:
             case 212: {
-                    PIXEL00_20 if(Diff(w[6], w[8]))
+                    PIXEL00_20 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL01_11 PIXEL11_0}
                     else {
@@ -1011,7 +2825,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 241:
             case 240: {
-                    PIXEL00_20 PIXEL01_22 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_22 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL10_12 PIXEL11_0}
                     else {
@@ -1020,7 +2834,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 236:
             case 232: {
-                    PIXEL00_21 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_20 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0 PIXEL11_11}
                     else {
@@ -1029,7 +2843,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 109:
             case 105: {
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL00_12 PIXEL10_0}
                     else {
@@ -1038,7 +2852,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 171:
             case 43: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0 PIXEL10_11}
                     else {
@@ -1047,7 +2861,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 143:
             case 15: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0 PIXEL01_12}
                     else {
@@ -1055,7 +2869,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_20 break;
               }
             case 124: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1064,7 +2878,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 203: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
@@ -1073,7 +2887,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_21 PIXEL10_10 PIXEL11_11 break;
               }
             case 62: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1082,7 +2896,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 211: {
-                    PIXEL00_11 PIXEL01_10 PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL00_11 PIXEL01_10 PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1091,7 +2905,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 118: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1100,7 +2914,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_12 PIXEL11_10 break;
               }
             case 217: {
-                    PIXEL00_12 PIXEL01_22 PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL00_12 PIXEL01_22 PIXEL10_10 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1109,7 +2923,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 110: {
-                    PIXEL00_10 PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1118,7 +2932,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 155: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
@@ -1151,13 +2965,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_11 PIXEL01_12 PIXEL10_21 PIXEL11_11 break;
               }
             case 220: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1166,13 +2980,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 158: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1181,13 +2995,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_12 break;
               }
             case 234: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1196,13 +3010,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 242: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1211,13 +3025,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 59: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
@@ -1226,13 +3040,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 121: {
-                    PIXEL00_12 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_22 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1241,13 +3055,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 87: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1256,13 +3070,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 79: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
@@ -1271,25 +3085,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 122: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1298,25 +3112,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 94: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1325,25 +3139,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 218: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1352,25 +3166,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 91: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1391,13 +3205,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_12 break;
               }
             case 186: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
@@ -1406,13 +3220,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_12 break;
               }
             case 115: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
                     {
                     PIXEL01_70}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1421,13 +3235,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 93: {
-                    PIXEL00_12 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_11 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
                     {
                     PIXEL10_70}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1436,13 +3250,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 206: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
                     {
                     PIXEL00_70}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
@@ -1452,7 +3266,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 205:
             case 201: {
-                    PIXEL00_12 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_20 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_10}
                     else
@@ -1462,7 +3276,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 174:
             case 46: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_10}
                     else
@@ -1472,7 +3286,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 179:
             case 147: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_10}
                     else
@@ -1482,7 +3296,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 117:
             case 116: {
-                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_10}
                     else
@@ -1497,13 +3311,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL00_11 PIXEL01_12 PIXEL10_12 PIXEL11_11 break;
               }
             case 126: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1512,13 +3326,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 219: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_10 PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL01_10 PIXEL10_10 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1527,7 +3341,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 125: {
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL00_12 PIXEL10_0}
                     else {
@@ -1535,7 +3349,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_11 PIXEL11_10 break;
               }
             case 221: {
-                    PIXEL00_12 if(Diff(w[6], w[8]))
+                    PIXEL00_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL01_11 PIXEL11_0}
                     else {
@@ -1543,7 +3357,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_10 break;
               }
             case 207: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0 PIXEL01_12}
                     else {
@@ -1551,7 +3365,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_10 PIXEL11_11 break;
               }
             case 238: {
-                    PIXEL00_10 PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0 PIXEL11_11}
                     else {
@@ -1559,7 +3373,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 190: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0 PIXEL11_12}
                     else {
@@ -1567,7 +3381,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 break;
               }
             case 187: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0 PIXEL10_11}
                     else {
@@ -1575,7 +3389,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL01_10 PIXEL11_12 break;
               }
             case 243: {
-                    PIXEL00_11 PIXEL01_10 if(Diff(w[6], w[8]))
+                    PIXEL00_11 PIXEL01_10 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL10_12 PIXEL11_0}
                     else {
@@ -1583,7 +3397,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 119: {
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL00_11 PIXEL01_0}
                     else {
@@ -1592,7 +3406,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 237:
             case 233: {
-                    PIXEL00_12 PIXEL01_20 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_20 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1602,7 +3416,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 175:
             case 47: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
@@ -1612,7 +3426,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 183:
             case 151: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1622,7 +3436,7 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
               }
             case 245:
             case 244: {
-                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1631,13 +3445,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 250: {
-                    PIXEL00_10 PIXEL01_10 if(Diff(w[8], w[4]))
+                    PIXEL00_10 PIXEL01_10 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1646,13 +3460,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 123: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_10 if(Diff(w[8], w[4]))
+                    PIXEL01_10 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1661,13 +3475,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 95: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1676,13 +3490,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_10 PIXEL11_10 break;
               }
             case 222: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL10_10 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1691,13 +3505,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 252: {
-                    PIXEL00_21 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_21 PIXEL01_11 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1706,13 +3520,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 249: {
-                    PIXEL00_12 PIXEL01_22 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_22 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1721,13 +3535,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 235: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_21 if(Diff(w[8], w[4]))
+                    PIXEL01_21 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1736,13 +3550,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 111: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1751,13 +3565,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_22 break;
               }
             case 63: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1766,13 +3580,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_21 break;
               }
             case 159: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1781,13 +3595,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_22 PIXEL11_12 break;
               }
             case 215: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    PIXEL10_21 if(Diff(w[6], w[8]))
+                    PIXEL10_21 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1796,13 +3610,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 246: {
-                    PIXEL00_22 if(Diff(w[2], w[6]))
+                    PIXEL00_22 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1811,19 +3625,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 254: {
-                    PIXEL00_10 if(Diff(w[2], w[6]))
+                    PIXEL00_10 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_20}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1832,13 +3646,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 253: {
-                    PIXEL00_12 PIXEL01_11 if(Diff(w[8], w[4]))
+                    PIXEL00_12 PIXEL01_11 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1847,19 +3661,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 251: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    PIXEL01_10 if(Diff(w[8], w[4]))
+                    PIXEL01_10 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1868,13 +3682,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 239: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    PIXEL01_12 if(Diff(w[8], w[4]))
+                    PIXEL01_12 if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1883,19 +3697,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_11 break;
               }
             case 127: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_20}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
@@ -1904,13 +3718,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL11_10 break;
               }
             case 191: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
@@ -1919,19 +3733,19 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     PIXEL10_11 PIXEL11_12 break;
               }
             case 223: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_20}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    PIXEL10_10 if(Diff(w[6], w[8]))
+                    PIXEL10_10 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1940,13 +3754,13 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 247: {
-                    PIXEL00_11 if(Diff(w[2], w[6]))
+                    PIXEL00_11 if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    PIXEL10_12 if(Diff(w[6], w[8]))
+                    PIXEL10_12 if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
@@ -1955,25 +3769,25 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             case 255: {
-                    if(Diff(w[4], w[2]))
+                    if(DiffReference(w[4], w[2]))
                     {
                     PIXEL00_0}
                     else
                     {
                     PIXEL00_100}
-                    if(Diff(w[2], w[6]))
+                    if(DiffReference(w[2], w[6]))
                     {
                     PIXEL01_0}
                     else
                     {
                     PIXEL01_100}
-                    if(Diff(w[8], w[4]))
+                    if(DiffReference(w[8], w[4]))
                     {
                     PIXEL10_0}
                     else
                     {
                     PIXEL10_100}
-                    if(Diff(w[6], w[8]))
+                    if(DiffReference(w[6], w[8]))
                     {
                     PIXEL11_0}
                     else
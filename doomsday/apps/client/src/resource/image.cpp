@@ -606,6 +606,7 @@ static Source loadPatch(image_t &image, FileHandle &hndl, int tclass = 0,
                 image.flags |= IMGF_IS_MASKED;
             }
 
+            file.unlock();
             return Original;
         }
         catch (const IByteArray::OffsetError &)
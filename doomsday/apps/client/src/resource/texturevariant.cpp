@@ -25,6 +25,7 @@
 #include "gl/gl_tex.h"
 #include "gl/texturecontent.h"
 
+#include "resource/clientresources.h"
 #include "resource/image.h" // GL_LoadSourceImage
 
 #include "render/rend_main.h" // misc global vars awaiting new home
@@ -534,9 +535,26 @@ uint ClientTexture::Variant::prepare()
         d->texSource = source;
     }
 
-    // Prepare texture content for uploading.
+    // Prepare texture content for uploading. If the variant has been processed
+    // before, the final pixels are in the cache.
+    auto &cache = ClientResources::get().textureVariantCache();
+    const Block cacheKey = cache.key(image, d->spec);
     texturecontent_t c;
-    GL_PrepareTextureContent(c, d->glTexName, image, d->spec, d->texture.manifest());
+    Block processedPixels;
+    if (cacheKey && cache.find(cacheKey, image, c, processedPixels))
+    {
+        c.name = d->glTexName;
+        GL_SetTextureContentSampling(c, d->spec);
+    }
+    else
+    {
+        GL_PrepareTextureContent(c, d->glTexName, image, d->spec, d->texture.manifest());
+        if (cacheKey)
+        {
+            c = GL_ProcessTextureContent(c, processedPixels);
+            cache.store(cacheKey, image, c);
+        }
+    }
 
     /**
      * Calculate GL texture coordinates based on the image dimensions. The
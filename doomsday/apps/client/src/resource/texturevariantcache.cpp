@@ -0,0 +1,435 @@
+/** @file texturevariantcache.cpp  Persistent cache of processed texture variants.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+#include "resource/texturevariantcache.h"
+
+#include "dd_def.h"  // texGamma
+#include "dd_main.h"  // App_Resources()
+#include "render/rend_main.h"  // misc global vars awaiting new home
+#include "sys_system.h"  // novideo
+
+#include <doomsday/console/cmd.h>
+#include <doomsday/console/var.h>
+#include <doomsday/res/colorpalettes.h>
+#include <de/filesystem.h>
+#include <de/folder.h>
+#include <de/glinfo.h>
+#include <de/hash.h>
+#include <de/logbuffer.h>
+#include <de/reader.h>
+#include <de/writer.h>
+
+#include <algorithm>
+
+using namespace de;
+
+DE_STATIC_STRING(TEXTURECACHE_PATH, "/home/cache/textures");
+DE_STATIC_STRING(TEXTURECACHE_INDEX_PATH, "/home/cache/textures/lastused");
+
+/// Changes whenever the texture processing or the serialized format changes.
+static const duint32 TEXTURECACHE_FORMAT = 2;
+
+/// Changes whenever the format of the last use index changes.
+static const duint32 TEXTURECACHE_INDEX_FORMAT = 1;
+
+static dbyte useTextureCache  = true;
+static dint  textureCacheSize = 1024; ///< Megabytes.
+
+DE_PIMPL_NOREF(TextureVariantCache), public Lockable
+{
+    duint hits          = 0;
+    duint misses        = 0;
+    duint stored        = 0;
+    duint64 bytesRead   = 0;
+    duint64 bytesStored = 0;
+    duint   pruned      = 0;
+
+    /// Cached file that may be pruned when the cache grows too large.
+    struct Entry
+    {
+        dsize size;
+        Time  lastUsed; ///< When the file was stored or last found.
+    };
+    bool                indexed   = false;
+    bool                dirty     = false; ///< Last use times need saving.
+    Hash<String, Entry> entries;  ///< Keyed by path.
+    duint64             totalSize = 0;
+
+    ~Impl()
+    {
+        saveLastUsed();
+    }
+
+    /**
+     * Indexes the cached files. The last use times are read from the index saved
+     * by saveLastUsed(); files missing from there are considered last used when
+     * they were modified.
+     */
+    void indexEntries()
+    {
+        if (indexed) return;
+        indexed = true;
+
+        Hash<String, Time> lastUsed;
+        if (const File *file = FS::tryLocate<const File>(TEXTURECACHE_INDEX_PATH()))
+        {
+            try
+            {
+                Block data;
+                *file >> data;
+                Reader reader(data);
+                duint32 format, count;
+                reader >> format;
+                if (format == TEXTURECACHE_INDEX_FORMAT)
+                {
+                    reader >> count;
+                    for (duint32 i = 0; i < count; ++i)
+                    {
+                        String path;
+                        Time   time;
+                        reader >> path >> time;
+                        lastUsed.insert(path, time);
+                    }
+                }
+            }
+            catch (const Error &er)
+            {
+                LOGDEV_RES_WARNING("Ignoring the texture cache index: %s") << er.asText();
+            }
+        }
+
+        if (const Folder *folder = FS::tryLocate<const Folder>(TEXTURECACHE_PATH()))
+        {
+            for (const Folder *sub : folder->subfolders())
+            {
+                sub->forContents([this, &lastUsed] (String, File &file)
+                {
+                    auto found = lastUsed.find(file.path());
+                    addEntry(file.path(), file.size(), found != lastUsed.end()
+                                                           ? found->second
+                                                           : file.status().modifiedAt);
+                    return LoopContinue;
+                });
+            }
+        }
+    }
+
+    /**
+     * Writes the last use times of the cached files, so that the least recently
+     * used files can be pruned in later sessions, too.
+     */
+    void saveLastUsed()
+    {
+        if (!dirty) return;
+        dirty = false;
+        try
+        {
+            Block data;
+            Writer writer(data);
+            writer << TEXTURECACHE_INDEX_FORMAT << duint32(entries.size());
+            for (const auto &entry : entries)
+            {
+                writer << entry.first << entry.second.lastUsed;
+            }
+            const String path = TEXTURECACHE_INDEX_PATH();
+            File &file = FS::get().makeFolder(path.fileNamePath()).replaceFile(path);
+            file << data;
+            file.release();
+        }
+        catch (const Error &er)
+        {
+            LOGDEV_RES_WARNING("Failed to save the texture cache index: %s") << er.asText();
+        }
+    }
+
+    void addEntry(const String &path, dsize size, const Time &lastUsed)
+    {
+        auto found = entries.find(path);
+        if (found != entries.end())
+        {
+            totalSize -= found->second.size;
+        }
+        entries[path] = Entry{size, lastUsed};
+        totalSize += size;
+    }
+
+    /**
+     * Marks a cached file used now, so it is pruned after the files that have
+     * not been needed for longer.
+     */
+    void touch(const String &path)
+    {
+        auto found = entries.find(path);
+        if (found != entries.end())
+        {
+            found->second.lastUsed = Time();
+            dirty = true;
+        }
+    }
+
+    /**
+     * Deletes the least recently used files if the cache has grown larger than
+     * the configured size. Entries whose key has become stale (e.g., because
+     * the settings changed) are never found again, so they eventually age out.
+     */
+    void prune()
+    {
+        const duint64 budget = duint64(textureCacheSize) << 20;
+        if (totalSize <= budget) return;
+
+        typedef std::pair<String, Entry> PathEntry;
+        List<PathEntry> oldest;
+        for (const auto &entry : entries) oldest << entry;
+        std::sort(oldest.begin(), oldest.end(), [] (const PathEntry &a, const PathEntry &b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+
+        // Leave some room so pruning is not needed after every store.
+        const duint64 target = budget - budget / 8;
+        for (const PathEntry &old : oldest)
+        {
+            if (totalSize <= target) break;
+            if (Folder *folder = FS::tryLocate<Folder>(old.first.fileNamePath()))
+            {
+                folder->tryDestroyFile(old.first.fileName());
+            }
+            entries.remove(old.first);
+            totalSize -= old.second.size;
+            pruned++;
+            dirty = true;
+        }
+    }
+
+    static String pathForKey(const Block &key)
+    {
+        const String hex = key.asHexadecimalText();
+        return TEXTURECACHE_PATH() / hex.right(CharPos(1)) / hex;
+    }
+
+    static int pixelDataSize(const image_t &image)
+    {
+        const int comps = (image.paletteId? ((image.flags & IMGF_IS_MASKED)? 2 : 1)
+                                          : image.pixelSize);
+        return comps * image.size.x * image.size.y;
+    }
+};
+
+TextureVariantCache::TextureVariantCache() : d(new Impl)
+{}
+
+Block TextureVariantCache::key(const image_t &image, const TextureVariantSpec &spec) const
+{
+    if (!useTextureCache || novideo || !image.pixels) return Block();
+
+    Block data;
+    Writer writer(data);
+    writer << TEXTURECACHE_FORMAT
+           << image.size.x << image.size.y << dint32(image.pixelSize) << dint32(image.flags);
+
+    // Paletted images are converted to truecolor during processing.
+    if (image.paletteId)
+    {
+        const res::ColorPalette &palette = App_Resources().colorPalettes().colorPalette(image.paletteId);
+        writer << dint32(palette.colorCount());
+        for (int i = 0; i < palette.colorCount(); ++i)
+        {
+            const Vec3ub color = palette.color(i);
+            writer << color.x << color.y << color.z;
+        }
+    }
+
+    writer << dint32(spec.type);
+    if (spec.type == TST_GENERAL)
+    {
+        const variantspecification_t &vspec = spec.variant;
+        writer << dint32(vspec.context) << dint32(vspec.flags) << vspec.border
+               << dbyte(vspec.mipmapped) << dbyte(vspec.gammaCorrection)
+               << dbyte(vspec.noStretch) << dbyte(vspec.toAlpha);
+    }
+    else
+    {
+        writer << spec.detailVariant.contrast;
+    }
+
+    // Settings that affect the processing.
+    writer << dbyte(fillOutlines) << dint32(useSmartFilter) << texGamma << dint32(texQuality)
+           << dint32(ratioLimit) << dint32(GLInfo::limits().maxTexSize);
+
+    data.append(image.pixels, Impl::pixelDataSize(image));
+    return data.md5Hash();
+}
+
+bool TextureVariantCache::find(const Block &key, image_t &image, texturecontent_t &content,
+                               Block &pixels)
+{
+    DE_ASSERT(key);
+    LOG_AS("TextureVariantCache");
+    DE_GUARD(d);
+
+    const File *file = FS::tryLocate<const File>(Impl::pathForKey(key));
+    if (!file)
+    {
+        d->misses++;
+        return false;
+    }
+    try
+    {
+        Block data;
+        *file >> data;
+        d->bytesRead += data.size();
+        data = data.decompressed();
+
+        Reader reader(data);
+        duint32 format;
+        reader >> format;
+        if (format != TEXTURECACHE_FORMAT)
+        {
+            d->misses++;
+            return false;
+        }
+
+        image_t::Size imageSize;
+        dint32 imageFlags, contentFormat, width, height, flags, grayMipmap;
+        reader >> imageSize.x >> imageSize.y >> imageFlags
+               >> contentFormat >> width >> height >> flags >> grayMipmap
+               >> pixels;
+
+        const int comps = (contentFormat == DGL_RGBA? 4 : 3);
+        if ((contentFormat != DGL_RGB && contentFormat != DGL_RGBA) ||
+            width < 1 || height < 1 || pixels.size() != dsize(comps * width * height))
+        {
+            throw Error("TextureVariantCache::find", "Invalid texture content");
+        }
+
+        image.size  = imageSize;
+        image.flags = imageFlags;
+
+        GL_InitTextureContent(&content);
+        content.format     = dgltexformat_t(contentFormat);
+        content.width      = width;
+        content.height     = height;
+        content.flags      = flags | TXCF_PROCESSED;
+        content.grayMipmap = grayMipmap;
+        content.pixels     = pixels.data();
+    }
+    catch (const Error &er)
+    {
+        LOGDEV_RES_WARNING("Corrupt cached texture %s: %s")
+            << key.asHexadecimalText() << er.asText();
+        pixels.clear();
+        d->misses++;
+        return false;
+    }
+    d->indexEntries();
+    d->touch(file->path());
+    d->hits++;
+    return true;
+}
+
+void TextureVariantCache::store(const Block &key, const image_t &image,
+                                const texturecontent_t &content)
+{
+    DE_ASSERT(key);
+    DE_ASSERT(content.flags & TXCF_PROCESSED);
+    LOG_AS("TextureVariantCache");
+
+    const int comps = (content.format == DGL_RGBA? 4 : 3);
+
+    Block data;
+    Writer(data) << TEXTURECACHE_FORMAT
+                 << image.size.x << image.size.y << dint32(image.flags)
+                 << dint32(content.format) << dint32(content.width) << dint32(content.height)
+                 << dint32(content.flags & ~TXCF_PROCESSED) << dint32(content.grayMipmap)
+                 << Block(content.pixels, comps * content.width * content.height);
+    data = data.compressed(1);
+
+    DE_GUARD(d);
+    try
+    {
+        const String path = Impl::pathForKey(key);
+        File &file = FS::get().makeFolder(path.fileNamePath()).replaceFile(path);
+        file << data;
+        file.release();
+
+        d->stored++;
+        d->bytesStored += data.size();
+
+        d->indexEntries();
+        d->addEntry(path, data.size(), Time());
+        d->dirty = true;
+        d->prune();
+    }
+    catch (const Error &er)
+    {
+        LOGDEV_RES_WARNING("Failed to cache texture: %s") << er.asText();
+    }
+}
+
+void TextureVariantCache::clear()
+{
+    DE_GUARD(d);
+    if (Folder *folder = FS::tryLocate<Folder>(TEXTURECACHE_PATH()))
+    {
+        folder->destroyAllFilesRecursively();
+    }
+    d->entries.clear();
+    d->totalSize = 0;
+    d->dirty     = false;
+}
+
+void TextureVariantCache::printStats() const
+{
+    DE_GUARD(d);
+    const duint total = d->hits + d->misses;
+    LOG_RES_MSG(_E(b) "Texture variant cache:");
+    LOG_RES_MSG("  Hits: %u (%.1f%%), misses: %u")
+        << d->hits << (total? 100.0 * d->hits / total : 0.0) << d->misses;
+    LOG_RES_MSG("  Read %.1f KB, stored %u variants (%.1f KB)")
+        << d->bytesRead / 1024.0 << d->stored << d->bytesStored / 1024.0;
+    if (d->indexed)
+    {
+        LOG_RES_MSG("  Size: %.1f MB of %i MB, pruned %u variants")
+            << d->totalSize / 1048576.0 << textureCacheSize << d->pruned;
+    }
+}
+
+D_CMD(PrintTextureCacheStats)
+{
+    DE_UNUSED(src, argc, argv);
+    App_Resources().textureVariantCache().printStats();
+    return true;
+}
+
+D_CMD(ClearTextureCache)
+{
+    DE_UNUSED(src, argc, argv);
+    App_Resources().textureVariantCache().clear();
+    LOG_RES_MSG("Texture variant cache cleared");
+    return true;
+}
+
+void TextureVariantCache::consoleRegister() // static
+{
+    C_VAR_BYTE("rend-tex-cache",      &useTextureCache,  0, 0, 1);
+    C_VAR_INT ("rend-tex-cache-size", &textureCacheSize, 0, 16, 65536);
+
+    C_CMD("texturecachestats", "", PrintTextureCacheStats)
+    C_CMD("cleartexturecache", "", ClearTextureCache)
+}
@@ -93,7 +93,7 @@ struct ContactSpreader
                 _spreadBlocks->setBit(cellIndex, true);
             }
 
-            _blockmap.forAllInCell(cell, [this] (void *element)
+            _blockmap.forEachInCell(cell, [this] (void *element)
             {
                 spreadContact(*static_cast<Contact *>(element));
                 return LoopContinue;
@@ -31,19 +31,26 @@
 #include "dd_def.h"
 #include "clientapp.h"
 
+#include <doomsday/console/cmd.h>
 #include <doomsday/console/var.h>
 #include <doomsday/mesh/face.h>
 #include <doomsday/net.h>
 #include <doomsday/world/bspleaf.h>
+#include <doomsday/world/lineblockmap.h>
+#include <doomsday/world/polyobj.h>
 #include <doomsday/world/thinkers.h>
 #include <doomsday/tab_tables.h>
+#include <de/block.h>
 #include <de/string.h>
+#include <de/taskpool.h>
 #include <de/time.h>
 #include <de/legacy/fixedpoint.h>
 #include <de/legacy/memoryzone.h>
 #include <de/legacy/timer.h>
 #include <de/legacy/vector1.h>
 #include <cmath>
+#include <cstring>
+#include <vector>
 
 using namespace de;
 using world::World;
@@ -235,6 +242,11 @@ const ParticleInfo *Generator::particleInfo() const
     return _pinfo;
 }
 
+void Generator::setParticleInfo(const ParticleInfo *particles)
+{
+    std::memcpy(_pinfo, particles, sizeof(ParticleInfo) * count);
+}
+
 static void setParticleAngles(ParticleInfo *pinfo, int flags)
 {
     DE_ASSERT(pinfo);
@@ -249,20 +261,23 @@ static void setParticleAngles(ParticleInfo *pinfo, int flags)
         pinfo->pitch = RNG_RandFloat() * 65536;
 }
 
-static void particleSound(fixed_t pos[3], ded_embsound_t *sound)
+static void particleSound(fixed_t pos[3], ded_embsound_t *sound,
+                          Generator::PendingSounds *pending = nullptr)
 {
     DE_ASSERT(pos && sound);
 
     // Is there any sound to play?
     if(!sound->id || sound->volume <= 0) return;
 
-    double orig[3];
-    for (int i = 0; i < 3; ++i)
+    const Generator::PendingSound snd{
+        sound->id, Vec3d(FIX2FLT(pos[0]), FIX2FLT(pos[1]), FIX2FLT(pos[2])), sound->volume};
+    if(pending)
     {
-        orig[i] = FIX2FLT(pos[i]);
+        // Played later in the main thread.
+        pending->append(snd);
+        return;
     }
-
-    S_LocalSoundAtVolumeFrom(sound->id, nullptr, orig, sound->volume);
+    Generator_PlaySounds({snd});
 }
 
 int Generator::newParticle()
@@ -563,10 +578,10 @@ static int newGeneratorParticlesWorker(mobj_t *cmo, void *context)
  * Particle touches something solid. Returns false iff the particle dies.
  */
 static int touchParticle(ParticleInfo *pinfo, Generator::ParticleStage *stage,
-    ded_ptcstage_t *stageDef, bool touchWall)
+    ded_ptcstage_t *stageDef, bool touchWall, Generator::PendingSounds *sounds)
 {
     // Play a hit sound.
-    particleSound(pinfo->origin, &stageDef->hitSound);
+    particleSound(pinfo->origin, &stageDef->hitSound, sounds);
 
     if(stage->flags.testFlag(Generator::ParticleStage::DieTouch))
     {
@@ -587,6 +602,33 @@ static int touchParticle(ParticleInfo *pinfo, Generator::ParticleStage *stage,
     return true;
 }
 
+/**
+ * Iterates the lines in the blockmap cells touched by @a box. Unlike
+ * Map::forAllLinesInBox(), this does not mark the visited lines with a validCount,
+ * so it can be called from several threads at once. A line may be visited more
+ * than once, so @a func must give the same result for repeated visits.
+ */
+template <typename Func>
+static LoopResult forAllLinesInBoxConcurrently(const Map &map, const AABoxd &box, Func &&func)
+{
+    if(map.polyobjCount())
+    {
+        if(auto result = map.polyobjBlockmap().forEachInBox(box, [&func] (void *object) -> LoopResult {
+            for(world::Line *line : reinterpret_cast<Polyobj *>(object)->lines())
+            {
+                if(LoopResult result = func(*line)) return result;
+            }
+            return LoopContinue;
+        }))
+        {
+            return result;
+        }
+    }
+    return map.lineBlockmap().forEachInBox(box, [&func] (void *object) -> LoopResult {
+        return func(*reinterpret_cast<world::Line *>(object));
+    });
+}
+
 float Generator::particleZ(const ParticleInfo &pinfo) const
 {
     const auto &subsec = pinfo.bspLeaf->subspace().subsector().as<Subsector>();
@@ -637,7 +679,7 @@ void Generator::spinParticle(ParticleInfo &pinfo)
     pinfo.pitch *= 1 - stDef->spinResistance[1];
 }
 
-void Generator::moveParticle(int index)
+void Generator::moveParticle(int index, PendingSounds *sounds)
 {
     DE_ASSERT(index >= 0 && index < count);
 
@@ -757,7 +799,7 @@ void Generator::moveParticle(int index)
                 return;
             }
 
-            if(!touchParticle(pinfo, st, stDef, false))
+            if(!touchParticle(pinfo, st, stDef, false, sounds))
                 return;
 
             z = FLT2FIX(subsec.visCeiling().heightSmoothed()) - hardRadius;
@@ -774,7 +816,7 @@ void Generator::moveParticle(int index)
                 return;
             }
 
-            if(!touchParticle(pinfo, st, stDef, false))
+            if(!touchParticle(pinfo, st, stDef, false, sounds))
                 return;
 
             z = FLT2FIX(subsec.visFloor().heightSmoothed()) + hardRadius;
@@ -890,9 +932,8 @@ void Generator::moveParticle(int index)
 
     // Iterate the lines in the contacted blocks.
 
-    World::validCount++;
     DE_ASSERT(!clParm.ptcHitLine);
-    map().forAllLinesInBox(clParm.box, [&clParm] (world::Line &line)
+    forAllLinesInBoxConcurrently(map(), clParm.box, [&clParm] (world::Line &line)
     {
         // Does the bounding box miss the line completely?
         if (clParm.box.maxX <= line.bounds().minX || clParm.box.minX >= line.bounds().maxX ||
@@ -963,7 +1004,7 @@ void Generator::moveParticle(int index)
         fixed_t normal[2], dotp;
 
         // Must survive the touch.
-        if(!touchParticle(pinfo, st, stDef, true))
+        if(!touchParticle(pinfo, st, stDef, true, sounds))
             return;
 
         // There was a hit! Calculate bounce vector.
@@ -1016,6 +1057,14 @@ void Generator::moveParticle(int index)
 }
 
 void Generator::runTick()
+{
+    if(updateParticles())
+    {
+        moveParticles();
+    }
+}
+
+bool Generator::updateParticles()
 {
     // Source has been destroyed?
     if(!isUntriggered() && !map().thinkers().isUsedMobjId(srcid))
@@ -1029,7 +1078,7 @@ void Generator::runTick()
     if(++_age > def->maxAge && def->maxAge >= 0)
     {
         Generator_Delete(this);
-        return;
+        return false;
     }
 
     // Spawn new particles?
@@ -1085,7 +1134,7 @@ void Generator::runTick()
         }
     }
 
-    // Move particles.
+    // Advance the stages of the particles.
     ParticleInfo *pinfo = _pinfo;
     for(int i = 0; i < count; ++i, pinfo++)
     {
@@ -1110,15 +1159,113 @@ void Generator::runTick()
             // Play a sound?
             particleSound(pinfo->origin, &def->stages[pinfo->stage].sound);
         }
+    }
+    return true;
+}
+
+void Generator::moveParticles(PendingSounds *sounds)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        if(_pinfo[i].stage < 0) continue; // Not in use.
 
         // Try to move.
-        moveParticle(i);
+        moveParticle(i, sounds);
+    }
+}
+
+/**
+ * Measures how long it takes to move the particles of the current map's generators,
+ * first one generator at a time and then concurrently, and checks that both produce
+ * the same particle state. The particles are restored afterwards.
+ */
+D_CMD(BenchmarkParticles)
+{
+    DE_UNUSED(src);
+
+    LOG_AS("benchparticles (Cmd)");
+
+    if(!World::get().hasMap())
+    {
+        LOG_SCR_WARNING("No map is currently loaded");
+        return false;
     }
+
+    const int tics = (argc > 1? de::max(1, String(argv[1]).toInt()) : 100);
+
+    List<Generator *> gens;
+    int particleCount = 0;
+    World::get().map().as<Map>().forAllGenerators([&gens, &particleCount] (Generator &gen)
+    {
+        gens << &gen;
+        particleCount += gen.activeParticleCount();
+        return LoopContinue;
+    });
+
+    List<Block> original;
+    for(const Generator *gen : gens)
+    {
+        original << Block(gen->particleInfo(), sizeof(ParticleInfo) * gen->count);
+    }
+    auto restore = [&gens, &original] ()
+    {
+        for(dsize i = 0; i < gens.size(); ++i)
+        {
+            gens[i]->setParticleInfo(reinterpret_cast<const ParticleInfo *>(original[i].data()));
+        }
+    };
+    auto particleHash = [&gens] ()
+    {
+        Block state;
+        for(const Generator *gen : gens)
+        {
+            state.append(gen->particleInfo(), int(sizeof(ParticleInfo) * gen->count));
+        }
+        return state.md5Hash();
+    };
+
+    // The sounds are not played.
+    Generator::PendingSounds sounds;
+
+    Time startedAt;
+    for(int tic = 0; tic < tics; ++tic)
+    {
+        for(Generator *gen : gens)
+        {
+            gen->moveParticles(&sounds);
+        }
+    }
+    const ddouble serialTime = startedAt.since();
+    const Block serialHash = particleHash();
+    restore();
+
+    startedAt = Time();
+    for(int tic = 0; tic < tics; ++tic)
+    {
+        Generator_MoveParticles(gens, sounds);
+    }
+    const ddouble concurrentTime = startedAt.since();
+    const Block concurrentHash = particleHash();
+    restore();
+
+    LOG_SCR_MSG(_E(b) "%i generators, %i particles, %i tics:") << gens.size() << particleCount << tics;
+    LOG_SCR_MSG(_E(l) "Serial: "     _E(.) "%.2f ms/tic") << serialTime * 1000 / tics;
+    LOG_SCR_MSG(_E(l) "Concurrent: " _E(.) "%.2f ms/tic (%i pooled threads)")
+        << concurrentTime * 1000 / tics << TaskPool::workerCount();
+    if(serialHash != concurrentHash)
+    {
+        LOG_SCR_ERROR("Concurrent movement produced different particle state");
+        return false;
+    }
+    return true;
 }
 
 void Generator::consoleRegister() //static
 {
     C_VAR_FLOAT("rend-particle-rate", &particleSpawnRate, 0, 0, 5);
+
+    C_CMD("benchparticles", "", BenchmarkParticles);
+    C_CMD("benchparticles", "i", BenchmarkParticles);
 }
 
 void Generator_Delete(Generator *gen)
@@ -1134,5 +1281,31 @@ void Generator_Delete(Generator *gen)
 void Generator_Thinker(Generator *gen)
 {
     DE_ASSERT(gen != 0);
-    gen->runTick();
+    // The particles are moved after all thinkers have run (see Map::moveParticles()).
+    gen->updateParticles();
+}
+
+void Generator_MoveParticles(const List<Generator *> &gens, Generator::PendingSounds &sounds)
+{
+    // Each generator collects its own sounds, so the order does not depend on timing.
+    std::vector<Generator::PendingSounds> pending(gens.size());
+    TaskPool::parallelFor(0, gens.size(), [&gens, &pending] (dsize begin, dsize end) {
+        for(dsize i = begin; i < end; ++i)
+        {
+            gens[i]->moveParticles(&pending[i]);
+        }
+    }, 1);
+    for(const auto &genSounds : pending)
+    {
+        sounds.append(genSounds);
+    }
+}
+
+void Generator_PlaySounds(const Generator::PendingSounds &sounds)
+{
+    for(const auto &snd : sounds)
+    {
+        double origin[3] = { snd.origin.x, snd.origin.y, snd.origin.z };
+        S_LocalSoundAtVolumeFrom(snd.id, nullptr, origin, snd.volume);
+    }
 }
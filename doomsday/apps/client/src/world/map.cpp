@@ -712,7 +712,7 @@ void Map::initRadio()
             // Link the shadowing line to all the subspaces whose axis-aligned bounding box
             // intersects 'bounds'.
             const int localValidCount = ++World::validCount;
-            subspaceBlockmap().forAllInBox(bounds, [&bounds, &side, &localValidCount] (void *object)
+            subspaceBlockmap().forEachInBox(bounds, [&bounds, &side, &localValidCount] (void *object)
             {
                 auto &sub = *reinterpret_cast<world::ConvexSubspace *>(object);
                 if (sub.validCount() != localValidCount)  // not yet processed
@@ -1037,6 +1037,21 @@ void Map::unlinkGenerator(Generator &generator)
     }
 }
 
+void Map::moveParticles()
+{
+    if (!d->generators) return;
+
+    List<Generator *> gens;
+    for (Generator *gen : d->getGenerators().activeGens)
+    {
+        if (gen && !Thinker_InStasis(&gen->thinker)) gens << gen;
+    }
+
+    Generator::PendingSounds sounds;
+    Generator_MoveParticles(gens, sounds);
+    Generator_PlaySounds(sounds);
+}
+
 LoopResult Map::forAllGenerators(const std::function<LoopResult (Generator &)>& func) const
 {
     for (Generator *gen : d->getGenerators().activeGens)
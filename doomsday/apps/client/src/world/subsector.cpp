@@ -822,7 +822,7 @@ DE_PIMPL(Subsector)
         // Link all convex subspaces whose axis-aligned bounding box intersects
         // with the affection bounds to the reverb set.
         const int localValidCount = ++World::validCount;
-        map.subspaceBlockmap().forAllInBox(box, [this, &box, &localValidCount] (void *object)
+        map.subspaceBlockmap().forEachInBox(box, [this, &box, &localValidCount] (void *object)
         {
             auto &sub = *(ConvexSubspace *)object;
             if (sub.validCount() != localValidCount) // not yet processed
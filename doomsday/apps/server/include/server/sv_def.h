@@ -49,6 +49,8 @@ struct material_s;
 extern int svMaxPlayers;
 extern int allowFrames;    ///< Allow sending of frames.
 extern int frameInterval;  ///< In tics.
+extern byte svParallelDeltas;  ///< Generate and rate deltas using multiple threads.
+extern byte svCullDeltas;      ///< Withhold deltas of what the client cannot see or hear.
 //extern int netRemoteUser;  ///< The client who is currently logged in.
 extern char *netPassword;       ///< Remote login password.
 
@@ -23,6 +23,7 @@
 #define SERVER_FRAME_H
 
 #include <de/libcore.h>
+#include <doomsday/console/cmd.h>
 
 #ifndef __cplusplus
 #  error "server/sv_frame.h requires C++"
@@ -31,4 +32,6 @@
 void Sv_TransmitFrame();
 de::dsize Sv_GetMaxFrameSize(int playerNumber);
 
+D_CMD(CaptureFrames);
+
 #endif  // SERVER_FRAME_H
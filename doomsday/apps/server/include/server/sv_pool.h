@@ -25,6 +25,7 @@
 #include "world/p_object.h"
 #include "sv_missile.h"
 
+#include <doomsday/console/cmd.h>
 #include <doomsday/world/plane.h>
 #include <doomsday/world/polyobj.h>
 #include <doomsday/world/surface.h>
@@ -74,9 +75,14 @@ typedef struct delta_s {
     uint            id;
 
     // The priority score tells how badly the delta needs to be sent to
-    // the client.
+    // the client. Does not include the age of the delta.
     float           score;
 
+    // Key of the delta in the pool's priority queue: the score in log2 scale,
+    // minus the creation time in seconds. The score doubles every second, so
+    // the order of the keys does not change as the deltas age.
+    double          priority;
+
     // Deltas can be either New or Unacked. New deltas haven't yet been sent.
     deltastate_t    state;
 
@@ -93,6 +99,21 @@ typedef struct delta_s {
     uint            timeStamp;
 
     int             flags;
+
+    // Position in the pool's priority queue, or -1 if not queued.
+    int             queueIndex;
+
+    // System time when the score was last calculated. Zero means the
+    // delta has changed and needs to be rated again.
+    uint            ratedAt;
+
+    // True if the delta is withheld because the pool owner can't see it.
+    // Withheld deltas are in the pool's withheld list instead of the rating list.
+    dd_bool         withheld;
+
+    // Links in the pool's rating list (least recently rated first) or the
+    // withheld list.
+    struct delta_s* rateNext, *ratePrev;
 } delta_t;
 
 typedef mobj_t  dt_mobj_t;
@@ -220,6 +241,7 @@ typedef struct ownerinfo_s {
     angle_t         angle; // Angle can change rapidly => not very important
     float           speed;
     uint            ackThreshold; // Expected ack time in milliseconds
+    int             sector; // Index of the viewer's sector; -1 if not culling
 } ownerinfo_t;
 
 /**
@@ -248,12 +270,31 @@ typedef struct pool_s {
     // not be sent.
     mislink_t       misHash[POOL_MISSILE_HASH_SIZE];
 
-    // The priority queue (a heap). Built when the pool contents are rated.
-    // Contains pointers to deltas in the hash. Becomes invalid when deltas
-    // are removed from the hash!
+    // The priority queue (a heap). Contains pointers to deltas in the hash;
+    // each queued delta knows its own position so it can be updated when its
+    // score changes or removed when it's removed from the hash.
     int             queueSize;
     int             allocatedSize;
     delta_t**       queue;
+
+    // All deltas of the pool, least recently rated first. Changed deltas are
+    // moved to the front so they are rated again before the next frame.
+    delta_t*        rateFirst, *rateLast;
+
+    // Deltas that the owner can't see. They are not rated again until they
+    // change or the owner moves to a sector from where they can be seen.
+    delta_t*        withheldFirst, *withheldLast;
+
+    // Statistics for the latest frame.
+    uint            ratedCount;     // Deltas (re)rated.
+    uint            queueOps;       // Priority queue insertions, updates and removals.
+    uint            culledCount;    // Deltas withheld because the owner can't see them.
+
+    // Cumulative statistics since the map was loaded.
+    uint            framesSent;
+    uint64_t        bytesSent;      // Total size of the frame packets.
+    uint            deltasCulled;   // Ratings where a delta was withheld as out of sight.
+    uint            soundsCulled;   // Sound deltas dropped as out of earshot.
 } pool_t;
 
 void            Sv_InitPools(void);
@@ -267,6 +308,7 @@ dd_bool         Sv_IsFrameTarget(uint clientNumber);
 uint            Sv_GetTimeStamp(void);
 pool_t*         Sv_GetPool(uint clientNumber);
 void            Sv_RatePool(pool_t* pool);
+void            Sv_RatePools(pool_t** targets);
 delta_t*        Sv_PoolQueueExtract(pool_t* pool);
 void            Sv_AckDeltaSet(uint clientNumber, int set, byte resent);
 uint            Sv_CountUnackedDeltas(uint clientNumber);
@@ -298,4 +340,6 @@ void Sv_NewSoundDelta(int soundId, const mobj_t *emitter, world::Sector *sourceS
 } // extern "C"
 #endif
 
+D_CMD(CheckFrameDeltas);
+
 #endif
@@ -24,6 +24,7 @@
 #include "server/sv_def.h"
 #include "serverapp.h"
 
+#include <doomsday/doomsdayapp.h>
 #include <doomsday/world/map.h>
 #include <doomsday/network/protocol.h>
 
@@ -196,15 +197,34 @@ DE_PIMPL(RemoteUser)
         {
             protocolVersion = String(command.mid(5, 4)).toInt(nullptr, 16);
 
+            // Since version 25, the client also tells which frame dictionary it
+            // has (zero if none).
+            dsize nameStart = 10;
+            duint32 dictId = 0;
+            if (protocolVersion >= 25 && length >= 19 && command[18] == ' ')
+            {
+                dictId = String(command.mid(10, 8)).toUInt32(nullptr, 16);
+                nameStart = 19;
+            }
+
             // Read the client's name and convert the network node into an actual
             // client. Here we also decide if the client's protocol is compatible
             // with ours.
-            name = String::fromUtf8(command.mid(10));
+            name = String::fromUtf8(command.mid(nameStart));
 
             if (App_ServerSystem().isUserAllowedToJoin(self()))
             {
                 state = Joined;
 
+                // Frames can be compressed with a dictionary that both ends have.
+                const DeflateDictionary *dict = DoomsdayApp::net().frameDictionary();
+                if (dict && dictId && dict->id() == dictId)
+                {
+                    LOG_NET_VERBOSE("Using frame dictionary %08x with remote user %s")
+                            << dictId << id;
+                    socket->setDictionary(dict);
+                }
+
                 // Successful! Send a reply.
                 self() << ByteRefArray("Enter", 5);
 
@@ -21,12 +21,18 @@
 #include "server/sv_frame.h"
 #include "def_main.h"
 #include "sys_system.h"
+#include "network/net_buf.h"
 #include "network/net_main.h"
 #include "server/sv_pool.h"
 #include "world/p_players.h"
 
+#include <de/app.h>
+#include <de/byterefarray.h>
 #include <de/logbuffer.h>
+#include <de/nativefile.h>
+#include <de/writer.h>
 #include <cmath>
+#include <memory>
 
 using namespace de;
 
@@ -62,6 +68,9 @@ static dint totalFrameCount;
 
 static dint lastTransmitTic;
 
+/// Sent frame packets are written here, for training a frame dictionary.
+static std::unique_ptr<NativeFile> frameCapture;
+
 /**
  * Send all the relevant information to each client.
  */
@@ -100,6 +109,11 @@ void Sv_TransmitFrame()
     // How many players currently in the game?
     const dint numInGame = Sv_GetNumPlayers();
 
+    // Determine which players will receive a frame now.
+    pool_t *targets[DDMAXPLAYERS + 1];
+    dint targetPlayers[DDMAXPLAYERS];
+    dint numTargets = 0;
+
     dint pCount = 0;
     for (dint i = 0; i < DDMAXPLAYERS; ++i)
     {
@@ -133,7 +147,8 @@ void Sv_TransmitFrame()
             // decrease back to zero.
             //::clients[i].updateCount--;
 
-            Sv_SendFrame(i);
+            targets[numTargets] = Sv_GetPool(i);
+            targetPlayers[numTargets++] = i;
         }
         else
         {
@@ -141,6 +156,16 @@ void Sv_TransmitFrame()
                              ::lastTransmitTic << i << plr.ready);
         }
     }
+    targets[numTargets] = nullptr;
+
+    // The priority queues of the clients need to be rebuilt before
+    // new frames can be sent.
+    Sv_RatePools(targets);
+
+    for (dint i = 0; i < numTargets; ++i)
+    {
+        Sv_SendFrame(targetPlayers[i]);
+    }
 }
 
 /**
@@ -774,9 +799,29 @@ byte Sv_GetNewResendID(pool_t *pool)
     return id;
 }
 
+/**
+ * Writes the frame packet in the message buffer to the capture file.
+ */
+static void Sv_CaptureFrame()
+{
+    try
+    {
+        Block captured;
+        Writer(captured) << ByteRefArray(&::netBuffer.msg,
+                                         ::netBuffer.headerLength + ::netBuffer.length);
+        *::frameCapture << captured;
+    }
+    catch (const Error &er)
+    {
+        LOG_NET_ERROR("Frame capture failed: %s") << er.asText();
+        ::frameCapture.reset();
+    }
+}
+
 /**
  * Send a sv_frame packet to the specified player. The amount of data sent
- * depends on the player's bandwidth rating.
+ * depends on the player's bandwidth rating. The player's pool must have been
+ * rated before calling this.
  */
 void Sv_SendFrame(dint plrNum)
 {
@@ -791,9 +836,7 @@ void Sv_SendFrame(dint plrNum)
         return;
     }
 
-    // The priority queue of the client needs to be rebuilt before
-    // a new frame can be sent.
-    Sv_RatePool(pool);
+    // The priority queue of the pool has already been built by Sv_RatePools().
 
     // This will be a new set.
     DE_ASSERT(pool);
@@ -864,13 +907,65 @@ void Sv_SendFrame(dint plrNum)
         }
     }
 
+    const dsize frameSize = Writer_Size(::msgWriter);
     Msg_End();
 
+    if (::frameCapture)
+    {
+        Sv_CaptureFrame();
+    }
+
     Net_SendBuffer(plrNum, 0);
 
+    pool->framesSent++;
+    pool->bytesSent += frameSize;
+
     // Once sent, the delta set can be discarded.
     Sv_AckDeltaSet(plrNum, pool->setDealer, 0);
 
+    LOGDEV_NET_XVERBOSE("Frame for player %i: %i bytes, %i deltas rated, %i culled, "
+                        "%i queue operations, %i queued")
+        << plrNum << frameSize << pool->ratedCount << pool->culledCount
+        << pool->queueOps << pool->queueSize;
+
     // Now a frame has been sent.
     pool->isFirst = false;
 }
+
+/**
+ * Starts or stops writing the sent frame packets to a file in the runtime
+ * folder. The captured frames are used for training a frame dictionary with
+ * the "framedict" tool.
+ */
+D_CMD(CaptureFrames)
+{
+    DE_UNUSED(src);
+
+    if (argc == 1)
+    {
+        if (!::frameCapture)
+        {
+            LOG_SCR_NOTE("Usage: %s (file)") << argv[0];
+            LOG_SCR_MSG("Without arguments, stops an ongoing capture.");
+            return true;
+        }
+        LOG_NET_MSG("Stopped capturing frames to %s") << ::frameCapture->nativePath();
+        ::frameCapture.reset();
+        return true;
+    }
+
+    try
+    {
+        ::frameCapture.reset(NativeFile::newStandalone(App::app().nativeHomePath() / NativePath(argv[1])));
+        ::frameCapture->setMode(File::Write);
+        ::frameCapture->clear();
+        LOG_NET_MSG("Capturing frames to %s") << ::frameCapture->nativePath();
+        return true;
+    }
+    catch (const Error &er)
+    {
+        LOG_NET_ERROR("Cannot capture frames: %s") << er.asText();
+        ::frameCapture.reset();
+        return false;
+    }
+}
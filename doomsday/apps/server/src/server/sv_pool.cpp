@@ -28,13 +28,21 @@
 #include "world/p_object.h"
 #include "world/p_players.h"
 
+#include <doomsday/world/reject.h>
 #include <doomsday/world/sector.h>
 #include <doomsday/world/thinkers.h>
 #include <de/legacy/mathutil.h>
 #include <de/legacy/timer.h>
 #include <de/legacy/vector1.h>
+#include <de/flatidmap.h>
 #include <de/logbuffer.h>
+#include <de/taskpool.h>
 #include <cmath>
+#include <cstring>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
 
 using namespace de;
 
@@ -44,22 +52,38 @@ using world::Surface;
 
 #define DEFAULT_DELTA_BASE_SCORE    ( 10000 )
 
-#define REG_MOBJ_HASH_SIZE          ( 1024 )
-#define REG_MOBJ_HASH_FUNCTION_MASK ( 0x3ff )
-
 // Maximum difference in plane height where the absolute height doesn't need to be sent.
 #define PLANE_SKIP_LIMIT            ( 40 )
 
-struct reg_mobj_t
-{
-    reg_mobj_t *next;  ///< In the register hash.
-    reg_mobj_t *prev;  ///< In the register hash.
-    dt_mobj_t mo;      ///< The state of the mobj.
-};
+// Number of world elements compared by a single task when generating deltas
+// concurrently. Smaller sets are compared in the calling thread.
+#define DELTA_COMPARE_CHUNK_SIZE    ( 512 )
+
+/// Registered mobjs, stored contiguously and indexed by thinker ID.
+typedef FlatIdMap<thid_t, dt_mobj_t> mobjregister_t;
 
-struct mobjhash_t
+/**
+ * Deltas generated during one frame, in the order they were generated. The batch
+ * is fed to the target pools after all comparisons are done, so each pool can be
+ * processed independently of the others.
+ */
+struct deltabatch_t
 {
-    reg_mobj_t *first, *last;
+    std::deque<mobjdelta_t>   mobjs;
+    std::deque<playerdelta_t> players;
+    std::deque<sectordelta_t> sectors;
+    std::deque<sidedelta_t>   sides;
+    std::deque<polydelta_t>   polys;
+    std::vector<void *>       order;  ///< All of the above, in generation order.
+    bool parallel = false;            ///< Compare the world elements concurrently.
+
+    template <typename DeltaType>
+    void add(std::deque<DeltaType> &store, const DeltaType &delta)
+    {
+        // Deque elements are not moved when appending.
+        store.push_back(delta);
+        order.push_back(&store.back());
+    }
 };
 
 /**
@@ -70,8 +94,8 @@ struct cregister_t
     dint gametic;       ///< The time the register was last updated.
     dd_bool isInitial;  ///< @c true if *this* register contains a read-only copy of the initial state of the world.
 
-    // The mobjs are stored in a hash for efficiency (ID is the key).
-    mobjhash_t mobjs[REG_MOBJ_HASH_SIZE];
+    // The mobjs are stored in a flat map for efficiency (ID is the key).
+    mobjregister_t mobjs;
 
     dt_player_t ddPlayers[DDMAXPLAYERS];
     dt_sector_t *sectors;
@@ -83,7 +107,13 @@ void Sv_RegisterWorld(cregister_t *reg, dd_bool isInitial);
 void Sv_NewDelta(void *deltaPtr, deltatype_t type, duint id);
 dd_bool Sv_IsVoidDelta(const void *delta);
 void Sv_PoolQueueClear(pool_t *pool);
+void Sv_PoolQueueRemove(pool_t *pool, delta_t *delta);
+void Sv_PoolTrackDelta(pool_t *pool, delta_t *delta);
+void Sv_PoolUntrackDelta(pool_t *pool, delta_t *delta);
+void Sv_PoolDeltaChanged(pool_t *pool, delta_t *delta);
+void Sv_PoolOwnerMoved(pool_t *pool);
 void Sv_GenerateNewDeltas(cregister_t *reg, dint clientNumber, dd_bool doUpdate);
+static void Sv_UpdateSectorVisibility();
 
 // The register contains the previous state of the world.
 cregister_t worldRegister;
@@ -97,6 +127,51 @@ static dfloat deltaBaseScores[NUM_DELTA_TYPES];
 // the mobj being compared.
 static ThinkerT<dt_mobj_t> dummyZeroMobj;
 
+// Generate and rate deltas using multiple threads (cvar).
+byte svParallelDeltas = true;
+
+// Withhold deltas that the pool owner cannot possibly see or hear (cvar).
+byte svCullDeltas = false;
+
+/**
+ * Sector visibility being determined in a background thread. The build owns
+ * its copy of the map geometry, so it can be abandoned when the map changes.
+ */
+struct SvSectorVisibilityBuild
+{
+    world::SectorVisibility::Geometry geometry;
+    std::unique_ptr<world::SectorVisibility> result;
+    std::atomic<bool> done { false };
+    TimeSpan duration;
+
+    SvSectorVisibilityBuild(const world::Map &map) : geometry(map) {}
+};
+
+// Visibility between the sectors of the current map, for culling. Nothing is
+// culled until it is ready.
+static std::unique_ptr<world::SectorVisibility> sectorVisibility;
+static std::shared_ptr<SvSectorVisibilityBuild> sectorVisibilityBuild;
+static std::unique_ptr<TaskPool> sectorVisibilityTasks;
+
+/**
+ * Calls @a func for consecutive subranges of [0, @a count). If @a parallel is
+ * true, the subranges are processed concurrently by the shared worker threads and
+ * the call returns when all of them are done.
+ */
+static void Sv_ForAllChunks(dint count, bool parallel, const std::function<void (dint, dint)> &func)
+{
+    if (!parallel || count <= DELTA_COMPARE_CHUNK_SIZE)
+    {
+        func(0, count);
+        return;
+    }
+
+    TaskPool::parallelFor(0, dsize(count), [&func] (dsize begin, dsize end)
+    {
+        func(dint(begin), dint(end));
+    }, DELTA_COMPARE_CHUNK_SIZE);
+}
+
 /**
  * Called once for each map, from R_SetupMap(). Initialize the world
  * register and drain all pools.
@@ -143,10 +218,28 @@ void Sv_InitPools()
         pool.queueSize     = 0;
         pool.allocatedSize = 0;
         pool.queue         = nullptr;
+        pool.rateFirst     = nullptr;
+        pool.rateLast      = nullptr;
+        pool.withheldFirst = nullptr;
+        pool.withheldLast  = nullptr;
+        pool.ratedCount    = 0;
+        pool.queueOps      = 0;
+        pool.culledCount   = 0;
+        pool.framesSent    = 0;
+        pool.bytesSent     = 0;
+        pool.deltasCulled  = 0;
+        pool.soundsCulled  = 0;
+        pool.ownerInfo.sector = -1;
 
         pool.isFirst       = true;  // Set to @c false when a frame is sent.
     }
 
+    // The sector visibility of the previous map is no longer valid. A build that
+    // is still in progress is abandoned.
+    ::sectorVisibility.reset();
+    ::sectorVisibilityBuild.reset();
+    Sv_UpdateSectorVisibility();
+
     // Store the current state of the world into both the registers.
     Sv_RegisterWorld(&::worldRegister, false);
     Sv_RegisterWorld(&::initialRegister, true);
@@ -160,7 +253,53 @@ void Sv_InitPools()
  */
 void Sv_ShutdownPools()
 {
-    // Nothing to do.
+    if (::sectorVisibilityTasks)
+    {
+        ::sectorVisibilityTasks->waitForDone();
+        ::sectorVisibilityTasks.reset();
+    }
+    ::sectorVisibilityBuild.reset();
+    ::sectorVisibility.reset();
+}
+
+/**
+ * Starts determining the visibility between the sectors of the current map in
+ * a background thread, if culling is enabled. When the visibility is ready, it
+ * is taken into use. Called from the main thread.
+ */
+static void Sv_UpdateSectorVisibility()
+{
+    if (::sectorVisibilityBuild)
+    {
+        if (!::sectorVisibilityBuild->done) return;
+
+        ::sectorVisibility = std::move(::sectorVisibilityBuild->result);
+        LOG_MAP_VERBOSE("Sector visibility determined in %.2f seconds: %i sectors, "
+                        "%i isolated groups, %.1f%% of sector pairs visible (%i approximated)")
+            << ::sectorVisibilityBuild->duration << ::sectorVisibility->sectorCount()
+            << ::sectorVisibility->groupCount() << ::sectorVisibility->visibleFraction() * 100
+            << ::sectorVisibility->approximatedCount();
+        ::sectorVisibilityBuild.reset();
+        return;
+    }
+
+    if (!::svCullDeltas || ::sectorVisibility || !ServerWorld::get().hasMap()) return;
+
+    // The geometry is copied here; the search is done in the background.
+    std::shared_ptr<SvSectorVisibilityBuild> build(
+        new SvSectorVisibilityBuild(ServerWorld::get().map()));
+    ::sectorVisibilityBuild = build;
+    if (!::sectorVisibilityTasks)
+    {
+        ::sectorVisibilityTasks.reset(new TaskPool);
+    }
+    ::sectorVisibilityTasks->start([build] ()
+    {
+        Time startedAt;
+        build->result.reset(new world::SectorVisibility(build->geometry));
+        build->duration = startedAt.since();
+        build->done = true;
+    });
 }
 
 /**
@@ -192,91 +331,31 @@ pool_t *Sv_GetPool(duint consoleNumber)
 }
 
 /**
- * The hash function for the register mobj hash.
+ * Returns a pointer to the register map-object, if it already exists. The pointer
+ * remains valid until mobjs are added to or removed from the register.
  */
-duint Sv_RegisterHashFunction(thid_t id)
-{
-    return (duint) id & REG_MOBJ_HASH_FUNCTION_MASK;
-}
-
-/**
- * Returns a pointer to the register map-object, if it already exists.
- */
-reg_mobj_t *Sv_RegisterFindMobj(cregister_t *reg, thid_t id)
+dt_mobj_t *Sv_RegisterFindMobj(cregister_t *reg, thid_t id)
 {
     DE_ASSERT(reg);
-
-    // See if there already is a register-mobj for this id.
-    const mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(id)];
-    for (reg_mobj_t *it = hash.first; it; it = it->next)
-    {
-        if (it->mo.thinker.id == id) return it;
-    }
-
-    return nullptr;  // Not found.
+    return reg->mobjs.find(id);
 }
 
 /**
- * Adds a new reg_mobj_t to the register's mobj hash.
+ * Adds a new register-mobj to the register, or returns the existing one.
  */
-reg_mobj_t *Sv_RegisterAddMobj(cregister_t *reg, thid_t id)
+dt_mobj_t *Sv_RegisterAddMobj(cregister_t *reg, thid_t id)
 {
     DE_ASSERT(reg);
-    mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(id)];
-
-    // Try to find an existing register-mobj.
-    if (reg_mobj_t *newRegMo = Sv_RegisterFindMobj(reg, id))
-        return newRegMo;
-
-    // Allocate the new register-mobj.
-    auto *newRegMo = (reg_mobj_t *) Z_Calloc(sizeof(reg_mobj_t), PU_MAP, 0);
-
-    // Link it to the end of the hash list.
-    if (hash.last)
-    {
-        hash.last->next = newRegMo;
-        newRegMo->prev = hash.last;
-    }
-    hash.last = newRegMo;
-
-    if (!hash.first)
-    {
-        hash.first = newRegMo;
-    }
-
-    return newRegMo;
+    return &reg->mobjs.insert(id);
 }
 
 /**
- * Removes a reg_mobj_t from the register's mobj hash.
+ * Removes a register-mobj from the register.
  */
-void Sv_RegisterRemoveMobj(cregister_t *reg, reg_mobj_t *regMo)
+void Sv_RegisterRemoveMobj(cregister_t *reg, thid_t id)
 {
-    DE_ASSERT(regMo);
-    mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(regMo->mo.thinker.id)];
-
-    // Update the first and last links.
-    if (hash.last == regMo)
-    {
-        hash.last = regMo->prev;
-    }
-    if (hash.first == regMo)
-    {
-        hash.first = regMo->next;
-    }
-
-    // Link out of the list.
-    if (regMo->next)
-    {
-        regMo->next->prev = regMo->prev;
-    }
-    if (regMo->prev)
-    {
-        regMo->prev->next = regMo->next;
-    }
-
-    // Destroy the register-mobj.
-    Z_Free(regMo);
+    DE_ASSERT(reg);
+    reg->mobjs.remove(id);
 }
 
 /**
@@ -496,11 +575,11 @@ dd_bool Sv_RegisterCompareMobj(cregister_t *reg, const mobj_t *s, mobjdelta_t *d
 {
     dint df;
     const dt_mobj_t *r = ::dummyZeroMobj;
-    reg_mobj_t *regMo  = Sv_RegisterFindMobj(reg, s->thinker.id);
+    const dt_mobj_t *regMo = Sv_RegisterFindMobj(reg, s->thinker.id);
     if (regMo)
     {
         // Use the registered data.
-        r  = &regMo->mo;
+        r  = regMo;
         df = 0;
     }
     else
@@ -940,7 +1019,9 @@ void Sv_RegisterWorld(cregister_t *reg, dd_bool isInitial)
 
     world::Map &map = ServerWorld::get().map();
 
-    de::zapPtr(reg);
+    // The old arrays were allocated from PU_MAP and have already been freed.
+    reg->mobjs.clear();
+    de::zap(reg->ddPlayers);
     reg->gametic = SECONDS_TO_TICKS(gameTime);
 
     // Is this the initial state?
@@ -984,11 +1065,13 @@ void Sv_UpdateOwnerInfo(pool_t *pool)
     DE_ASSERT(pool);
     player_t *plr     = DD_Player(pool->owner);
     ownerinfo_t *info = &pool->ownerInfo;
+    const int oldSector = info->sector;
 
     de::zapPtr(info);
 
     // Pointer to the owner's pool.
     info->pool = pool;
+    info->sector = -1;
 
     if (plr->publicData().mo)
     {
@@ -997,6 +1080,19 @@ void Sv_UpdateOwnerInfo(pool_t *pool)
         V3d_Copy(info->origin, mob->origin);
         info->angle = mob->angle;
         info->speed = M_ApproxDistance(mob->mom[0], mob->mom[1]);
+
+        if (::svCullDeltas && ::sectorVisibility)
+        {
+            if (const Sector *sector = Mobj_Sector(mob))
+            {
+                info->sector = sector->indexInMap();
+            }
+        }
+    }
+
+    if (info->sector != oldSector)
+    {
+        Sv_PoolOwnerMoved(pool);
     }
 
     // The acknowledgement threshold is a multiple of the average ack time of the
@@ -1102,6 +1198,27 @@ dd_bool Sv_IsSameDelta(const void *delta1, const void *delta2)
     return (a->type == b->type) && (a->id == b->id);
 }
 
+/**
+ * @return  Size of the delta structure in bytes, or zero if the type is unknown.
+ */
+size_t Sv_DeltaSize(const void *deltaPtr)
+{
+    const delta_t *delta = (const delta_t *) deltaPtr;
+
+    return ( delta->type == DT_MOBJ ?         sizeof(mobjdelta_t)
+           : delta->type == DT_PLAYER ?       sizeof(playerdelta_t)
+           : delta->type == DT_SECTOR ?       sizeof(sectordelta_t)
+           : delta->type == DT_SIDE ?         sizeof(sidedelta_t)
+           : delta->type == DT_POLY ?         sizeof(polydelta_t)
+           : delta->type == DT_SOUND ?        sizeof(sounddelta_t)
+           : delta->type == DT_MOBJ_SOUND ?   sizeof(sounddelta_t)
+           : delta->type == DT_SECTOR_SOUND ? sizeof(sounddelta_t)
+           : delta->type == DT_SIDE_SOUND ?   sizeof(sounddelta_t)
+           : delta->type == DT_POLY_SOUND ?   sizeof(sounddelta_t)
+            /* : delta->type == DT_LUMP?   sizeof(lumpdelta_t) */
+           : 0);
+}
+
 /**
  * Makes a copy of the delta.
  */
@@ -1109,19 +1226,7 @@ void* Sv_CopyDelta(void* deltaPtr)
 {
     void*               newDelta;
     delta_t*            delta = (delta_t *) deltaPtr;
-    size_t              size =
-        ( delta->type == DT_MOBJ ?         sizeof(mobjdelta_t)
-        : delta->type == DT_PLAYER ?       sizeof(playerdelta_t)
-        : delta->type == DT_SECTOR ?       sizeof(sectordelta_t)
-        : delta->type == DT_SIDE ?         sizeof(sidedelta_t)
-        : delta->type == DT_POLY ?         sizeof(polydelta_t)
-        : delta->type == DT_SOUND ?        sizeof(sounddelta_t)
-        : delta->type == DT_MOBJ_SOUND ?   sizeof(sounddelta_t)
-        : delta->type == DT_SECTOR_SOUND ? sizeof(sounddelta_t)
-        : delta->type == DT_SIDE_SOUND ?   sizeof(sounddelta_t)
-        : delta->type == DT_POLY_SOUND ?   sizeof(sounddelta_t)
-         /* : delta->type == DT_LUMP?   sizeof(lumpdelta_t) */
-        : 0);
+    size_t              size = Sv_DeltaSize(delta);
 
     if (size == 0)
     {
@@ -1615,6 +1720,85 @@ coord_t Sv_DeltaDistance(const void *deltaPtr, const ownerinfo_t *info)
     return 1;
 }
 
+/**
+ * @return  Index of the sector where the delta's entity is, or -1 if unknown.
+ */
+dint Sv_DeltaSectorIndex(const void *deltaPtr)
+{
+    const delta_t *delta = (const delta_t *) deltaPtr;
+    const world::Map &map = ServerWorld::get().map();
+    const mobj_t *mob = nullptr;
+
+    switch (delta->type)
+    {
+    case DT_MOBJ:
+        // The registered position may be out of date, so use the real mobj.
+        mob = map.thinkers().mobjById(delta->id);
+        break;
+
+    case DT_MOBJ_SOUND:
+        mob = ((const sounddelta_t *) deltaPtr)->mobj;
+        if (mob && !map.thinkers().isUsedMobjId(mob->thinker.id))
+        {
+            // This mobj does not exist any more!
+            mob = nullptr;
+        }
+        break;
+
+    case DT_SECTOR:
+    case DT_SECTOR_SOUND:
+        return delta->id;
+
+    case DT_SIDE:
+    case DT_SIDE_SOUND: {
+        const auto *side = map.sidePtr(delta->id);
+        return side && side->hasSector()? side->sector().indexInMap() : -1; }
+
+    case DT_POLY:
+    case DT_POLY_SOUND: {
+        const Sector *sector = map.polyobj(delta->id).sectorPtr();
+        return sector? sector->indexInMap() : -1; }
+
+    default:
+        break;
+    }
+
+    if (mob)
+    {
+        if (const Sector *sector = Mobj_Sector(mob))
+        {
+            return sector->indexInMap();
+        }
+    }
+    return -1;
+}
+
+/**
+ * Determines whether the pool owner cannot possibly see the delta's entity, or
+ * hear the delta's sound. Player deltas are never culled.
+ */
+dd_bool Sv_IsCulledDelta(const void *deltaPtr, const ownerinfo_t *info)
+{
+    const delta_t *delta = (const delta_t *) deltaPtr;
+
+    if (info->sector < 0 || !::sectorVisibility || delta->type == DT_PLAYER)
+    {
+        return false;
+    }
+
+    const dint index = Sv_DeltaSectorIndex(delta);
+    if (index < 0 || index >= ::sectorVisibility->sectorCount())
+    {
+        return false;
+    }
+    if (Sv_IsSoundDelta(delta))
+    {
+        // Sounds are heard around corners.
+        return !::sectorVisibility->isAudible(info->sector, index);
+    }
+    return !::sectorVisibility->isVisible(info->sector, index);
+}
+
 /**
  * The hash function for the pool delta hash.
  */
@@ -1652,6 +1836,9 @@ void Sv_RemoveDelta(pool_t* pool, void* deltaPtr)
         delta->prev->next = delta->next;
     }
 
+    // Forget about it in the priority queue and the rating list.
+    Sv_PoolUntrackDelta(pool, delta);
+
     // Destroy it.
     Z_Free(delta);
 }
@@ -1699,6 +1886,8 @@ void Sv_DrainPool(uint clientNumber)
     // Clear all the chains.
     de::zap(pool->hash);
     de::zap(pool->misHash);
+    pool->rateFirst = pool->rateLast = NULL;
+    pool->withheldFirst = pool->withheldLast = NULL;
 }
 
 /**
@@ -1799,6 +1988,13 @@ int Sv_ExcludeDelta(pool_t* pool, const void* deltaPtr)
     }
     else if (Sv_IsSoundDelta(delta))
     {
+        // Sounds from isolated parts of the map cannot be heard.
+        if (!Sv_IsStopSoundDelta(delta) && Sv_IsCulledDelta(delta, &pool->ownerInfo))
+        {
+            pool->soundsCulled++;
+            return 0;
+        }
+
         // Sounds that originate from too far away are not added to a pool.
         // Stop Sound deltas have an infinite max distance, though.
         if (Sv_DeltaDistance(delta, &pool->ownerInfo) >
@@ -1823,18 +2019,18 @@ int Sv_ExcludeDelta(pool_t* pool, const void* deltaPtr)
  * Deltas are unique only in the NEW state. There may be multiple UNACKED
  * deltas for the same entity.
  *
- * The contents of the delta must not be modified.
+ * The contents of the delta are not modified, so the same delta may be added
+ * to several pools concurrently.
  */
-void Sv_AddDelta(pool_t* pool, void* deltaPtr)
+void Sv_AddDelta(pool_t* pool, const void* deltaPtr)
 {
     delta_t*            iter, *next = NULL, *existingNew = NULL;
-    delta_t*            delta = (delta_t *) deltaPtr;
-    deltalink_t*        hash = Sv_PoolHash(pool, delta->id);
-    int                 flags, originalFlags;
+    deltalink_t*        hash = Sv_PoolHash(pool, ((const delta_t *) deltaPtr)->id);
+    int                 flags;
 
     // Sometimes we can exclude a part of the data, if the client has no
     // use for it.
-    flags = Sv_ExcludeDelta(pool, delta);
+    flags = Sv_ExcludeDelta(pool, deltaPtr);
 
     if (!flags)
     {
@@ -1842,8 +2038,12 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
         return;
     }
 
-    // Temporarily use the excluded flags.
-    originalFlags = delta->flags;
+    // The excluded flags apply to this pool only, so they are applied to a
+    // private copy of the delta. Mobj deltas are the largest kind.
+    alignas(mobjdelta_t) byte deltaBuf[sizeof(mobjdelta_t)];
+    DE_ASSERT(Sv_DeltaSize(deltaPtr) <= sizeof(deltaBuf));
+    std::memcpy(deltaBuf, deltaPtr, Sv_DeltaSize(deltaPtr));
+    delta_t *delta = (delta_t *) deltaBuf;
     delta->flags = flags;
 
     // While subtracting from old deltas, we'll look for a pointer to
@@ -1875,6 +2075,7 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
                     Sv_RemoveDelta(pool, iter);
                     continue;
                 }
+                Sv_PoolDeltaChanged(pool, iter);
             }
         }
     }
@@ -1888,6 +2089,10 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
             // The existing delta must be removed.
             Sv_RemoveDelta(pool, existingNew);
         }
+        else
+        {
+            Sv_PoolDeltaChanged(pool, existingNew);
+        }
     }
     else
     {
@@ -1906,12 +2111,10 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
         {
             hash->first = iter;
         }
-    }
 
-    // This delta may yet be added to other pools. They should use the
-    // original flags, not the ones we might've used (hackish: copying the
-    // whole delta is not really an option, though).
-    delta->flags = originalFlags;
+        // It will be rated and queued before the next frame.
+        Sv_PoolTrackDelta(pool, iter);
+    }
 }
 
 /**
@@ -1958,11 +2161,9 @@ void Sv_PoolMobjRemoved(pool_t* pool, thid_t id)
 void Sv_MobjRemoved(thid_t id)
 {
     uint                i;
-    reg_mobj_t*         mo = Sv_RegisterFindMobj(&worldRegister, id);
-
-    if (mo)
+    if (Sv_RegisterFindMobj(&worldRegister, id))
     {
-        Sv_RegisterRemoveMobj(&worldRegister, mo);
+        Sv_RegisterRemoveMobj(&worldRegister, id);
 
         // We must remove all NEW deltas for this mobj from the pools.
         // One possibility: there are mobj deltas waiting in the pool,
@@ -2052,37 +2253,31 @@ int Sv_GetTargetPools(pool_t** targets, int clientsMask)
  *
  * When updating, the destroyed mobjs are removed from the register.
  */
-void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, deltabatch_t &batch)
 {
-    int i;
-    mobjhash_t *hash;
-    reg_mobj_t *obj, *next = 0;
     mobjdelta_t null;
 
-    for (i = 0, hash = reg->mobjs; i < REG_MOBJ_HASH_SIZE; ++i, hash++)
+    // Iterate backwards so that removals don't affect the unvisited mobjs.
+    for (dsize i = reg->mobjs.size(); i-- > 0; )
     {
-        for (obj = hash->first; obj; obj = next)
-        {
-            // This reg_mobj_t might be removed.
-            next = obj->next;
+        const dt_mobj_t &obj = reg->mobjs.valueAt(i);
 
-            /// @todo Do not assume mobj is from the CURRENT map.
-            if (!ServerWorld::get().map().thinkers().isUsedMobjId(obj->mo.thinker.id))
-            {
-                // This object no longer exists!
-                Sv_NewDelta(&null, DT_MOBJ, obj->mo.thinker.id);
-                null.delta.flags = MDFC_NULL;
+        /// @todo Do not assume mobj is from the CURRENT map.
+        if (!ServerWorld::get().map().thinkers().isUsedMobjId(obj.thinker.id))
+        {
+            // This object no longer exists!
+            Sv_NewDelta(&null, DT_MOBJ, obj.thinker.id);
+            null.delta.flags = MDFC_NULL;
 
-                // We need all the data for positioning.
-                memcpy(&null.mo, &obj->mo, sizeof(dt_mobj_t));
+            // We need all the data for positioning.
+            memcpy(&null.mo, &obj, sizeof(dt_mobj_t));
 
-                Sv_AddDeltaToPools(&null, targets);
+            batch.add(batch.mobjs, null);
 
-                if (doUpdate)
-                {
-                    // Keep the register up to date.
-                    Sv_RegisterRemoveMobj(reg, obj);
-                }
+            if (doUpdate)
+            {
+                // Keep the register up to date.
+                Sv_RegisterRemoveMobj(reg, reg->mobjs.idAt(i));
             }
         }
     }
@@ -2091,37 +2286,53 @@ void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
 /**
  * Mobj deltas are generated for all mobjs that have changed.
  */
-void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, deltabatch_t &batch)
 {
+    // Collect the mobjs to compare.
+    std::vector<const mobj_t *> mobjs;
     ServerWorld::get().map().thinkers().forAll(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
-                                       0x1 /*public*/, [&reg, &doUpdate, &targets] (thinker_t *th)
+                                       0x1 /*public*/, [&mobjs] (thinker_t *th)
     {
-        auto &mob = *reinterpret_cast<mobj_t *>(th);
+        const auto &mob = *reinterpret_cast<mobj_t *>(th);
 
         // Some objects should not be processed.
         if (!Sv_IsMobjIgnored(mob))
         {
-            // Compare to produce a delta.
-            mobjdelta_t delta;
-            if (Sv_RegisterCompareMobj(reg, &mob, &delta))
-            {
-                Sv_AddDeltaToPools(&delta, targets);
-
-                if (doUpdate)
-                {
-                    // This'll add a new register-mobj if it doesn't already exist.
-                    Sv_RegisterMobj(&Sv_RegisterAddMobj(reg, mob.thinker.id)->mo, &mob);
-                }
-            }
+            mobjs.push_back(&mob);
         }
         return LoopContinue;
     });
+
+    // Compare to produce deltas. The register is only read here.
+    const dint count = dint(mobjs.size());
+    std::vector<mobjdelta_t> deltas(count);
+    std::vector<char> changed(count);
+    Sv_ForAllChunks(count, batch.parallel, [reg, &mobjs, &deltas, &changed] (dint begin, dint end)
+    {
+        for (dint i = begin; i < end; ++i)
+        {
+            changed[i] = Sv_RegisterCompareMobj(reg, mobjs[i], &deltas[i]);
+        }
+    });
+
+    for (dint i = 0; i < count; ++i)
+    {
+        if (!changed[i]) continue;
+
+        batch.add(batch.mobjs, deltas[i]);
+
+        if (doUpdate)
+        {
+            // This'll add a new register-mobj if it doesn't already exist.
+            Sv_RegisterMobj(Sv_RegisterAddMobj(reg, mobjs[i]->thinker.id), mobjs[i]);
+        }
+    }
 }
 
 /**
  * Player deltas are generated for changed player data.
  */
-void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
+void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, deltabatch_t &batch)
 {
     playerdelta_t player;
     uint i;
@@ -2139,26 +2350,23 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
             // flags).
             if (doUpdate && (player.delta.flags & PDF_MOBJ))
             {
-                reg_mobj_t* registered = Sv_RegisterFindMobj(reg, reg->ddPlayers[i].mobj);
-
-                if (registered)
+                if (dt_mobj_t *registered = Sv_RegisterFindMobj(reg, reg->ddPlayers[i].mobj))
                 {
-                    Sv_RegisterResetMobj(&registered->mo);
+                    Sv_RegisterResetMobj(registered);
                 }
             }
 
-            Sv_AddDeltaToPools(&player, targets);
+            batch.add(batch.players, player);
         }
 
         if (doUpdate)
         {
             Sv_RegisterPlayer(&reg->ddPlayers[i], i);
         }
-
         // What about forced deltas?
+#if 0
         if (Sv_IsPoolTargeted(Sv_GetPool(i), targets))
         {
-#if 0
             if (DD_Player(i).flags & DDPF_FIXANGLES)
             {
                 Sv_NewDelta(&player, DT_PLAYER, i);
@@ -2194,23 +2402,34 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
                 // Doing this once is enough.
                 DD_Player(i).flags &= ~(DDPF_FIXORIGIN | DDPF_FIXMOM);
             }
-#endif
         }
+#endif
     }
 }
 
 /**
  * Sector deltas are generated for changed sectors.
  */
-void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, deltabatch_t &batch)
 {
-    sectordelta_t delta;
+    // Each sector only touches its own register entry, so the sectors can be
+    // compared concurrently.
+    const dint count = ServerWorld::get().map().sectorCount();
+    std::vector<sectordelta_t> deltas(count);
+    std::vector<char> changed(count);
+    Sv_ForAllChunks(count, batch.parallel, [reg, doUpdate, &deltas, &changed] (dint begin, dint end)
+    {
+        for (dint i = begin; i < end; ++i)
+        {
+            changed[i] = Sv_RegisterCompareSector(reg, i, &deltas[i], doUpdate);
+        }
+    });
 
-    for (int i = 0; i < ServerWorld::get().map().sectorCount(); ++i)
+    for (dint i = 0; i < count; ++i)
     {
-        if (Sv_RegisterCompareSector(reg, i, &delta, doUpdate))
+        if (changed[i])
         {
-            Sv_AddDeltaToPools(&delta, targets);
+            batch.add(batch.sectors, deltas[i]);
         }
     }
 }
@@ -2220,7 +2439,7 @@ void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
  * Changes in sides (textures) are so rare that all sides need not be
  * checked on every tic.
  */
-void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, deltabatch_t &batch)
 {
     static uint numShifts = 2, shift = 0;
 
@@ -2245,12 +2464,22 @@ void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
         shift %= numShifts;
     }
 
-    sidedelta_t delta;
-    for (uint i = start; i < end; ++i)
+    const dint count = dint(end - start);
+    std::vector<sidedelta_t> deltas(count);
+    std::vector<char> changed(count);
+    Sv_ForAllChunks(count, batch.parallel, [reg, doUpdate, start, &deltas, &changed] (dint begin, dint end)
+    {
+        for (dint i = begin; i < end; ++i)
+        {
+            changed[i] = Sv_RegisterCompareSide(reg, start + i, &deltas[i], doUpdate);
+        }
+    });
+
+    for (dint i = 0; i < count; ++i)
     {
-        if (Sv_RegisterCompareSide(reg, i, &delta, doUpdate))
+        if (changed[i])
         {
-            Sv_AddDeltaToPools(&delta, targets);
+            batch.add(batch.sides, deltas[i]);
         }
     }
 }
@@ -2258,7 +2487,7 @@ void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
 /**
  * Poly deltas are generated for changed polyobjs.
  */
-void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, deltabatch_t &batch)
 {
     LOG_AS("Sv_NewPolyDeltas");
 
@@ -2271,7 +2500,7 @@ void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
         {
             LOGDEV_NET_XVERBOSE_DEBUGONLY("Change in poly %i", i);
 
-            Sv_AddDeltaToPools(&delta, targets);
+            batch.add(batch.polys, delta);
         }
 
         if (doUpdate)
@@ -2281,6 +2510,40 @@ void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
     }
 }
 
+/**
+ * Adds all the deltas of the batch to the pools in the NULL-terminated array.
+ * Each pool receives the deltas in the order they were generated. The pools are
+ * independent of each other, so they are processed concurrently.
+ */
+void Sv_AddBatchToPools(const deltabatch_t &batch, pool_t **targets)
+{
+    if (batch.order.empty()) return;
+
+    auto addToPool = [&batch] (pool_t *pool)
+    {
+        for (const void *delta : batch.order)
+        {
+            Sv_AddDelta(pool, delta);
+        }
+    };
+
+    if (!::svParallelDeltas || !targets[0] || !targets[1])
+    {
+        for (; *targets; targets++)
+        {
+            addToPool(*targets);
+        }
+        return;
+    }
+
+    dsize count = 0;
+    while (targets[count]) count++;
+    TaskPool::parallelFor(0, count, [&addToPool, targets] (dsize begin, dsize end)
+    {
+        for (dsize i = begin; i < end; ++i) addToPool(targets[i]);
+    }, 1);
+}
+
 void Sv_NewSoundDelta(int soundId, const mobj_t *emitter, world::Sector *sourceSector,
     Polyobj *sourcePoly, world::Plane *sourcePlane, world::Surface *sourceSurface,
     float volume, dd_bool isRepeating, int clientsMask)
@@ -2404,10 +2667,14 @@ dd_bool Sv_IsFrameTarget(duint plrNum)
 void Sv_GenerateNewDeltas(cregister_t* reg, int clientNumber, dd_bool doUpdate)
 {
     pool_t* targets[DDMAXPLAYERS + 1], **pool;
+    deltabatch_t batch;
+    batch.parallel = (::svParallelDeltas != 0);
 
     // Determine the target pools.
     Sv_GetTargetPools(targets, (clientNumber < 0 ? 0xff : (1 << clientNumber)));
 
+    Sv_UpdateSectorVisibility();
+
     // Update the info of the pool owners.
     for (pool = targets; *pool; pool++)
     {
@@ -2415,22 +2682,25 @@ void Sv_GenerateNewDeltas(cregister_t* reg, int clientNumber, dd_bool doUpdate)
     }
 
     // Generate null deltas (removed mobjs).
-    Sv_NewNullDeltas(reg, doUpdate, targets);
+    Sv_NewNullDeltas(reg, doUpdate, batch);
 
     // Generate mobj deltas.
-    Sv_NewMobjDeltas(reg, doUpdate, targets);
+    Sv_NewMobjDeltas(reg, doUpdate, batch);
 
     // Generate player deltas.
-    Sv_NewPlayerDeltas(reg, doUpdate, targets);
+    Sv_NewPlayerDeltas(reg, doUpdate, batch);
 
     // Generate sector deltas.
-    Sv_NewSectorDeltas(reg, doUpdate, targets);
+    Sv_NewSectorDeltas(reg, doUpdate, batch);
 
     // Generate side deltas.
-    Sv_NewSideDeltas(reg, doUpdate, targets);
+    Sv_NewSideDeltas(reg, doUpdate, batch);
 
     // Generate poly deltas.
-    Sv_NewPolyDeltas(reg, doUpdate, targets);
+    Sv_NewPolyDeltas(reg, doUpdate, batch);
+
+    // Distribute the new deltas to the pools.
+    Sv_AddBatchToPools(batch, targets);
 
     if (doUpdate)
     {
@@ -2439,6 +2709,91 @@ void Sv_GenerateNewDeltas(cregister_t* reg, int clientNumber, dd_bool doUpdate)
     }
 }
 
+/**
+ * Determines whether two deltas have the same type, ID, flags, and data. The
+ * data of each delta is applied to a zeroed delta before comparing, so fields not
+ * covered by the flags are ignored.
+ */
+static bool Sv_IsEqualDelta(const void *delta1, const void *delta2)
+{
+    const delta_t *a = (const delta_t *) delta1, *b = (const delta_t *) delta2;
+
+    if (!Sv_IsSameDelta(a, b) || a->flags != b->flags) return false;
+
+    alignas(mobjdelta_t) byte bufA[sizeof(mobjdelta_t)];
+    alignas(mobjdelta_t) byte bufB[sizeof(mobjdelta_t)];
+    const size_t size = Sv_DeltaSize(a);
+    DE_ASSERT(size <= sizeof(bufA));
+    std::memset(bufA, 0, sizeof(bufA));
+    std::memset(bufB, 0, sizeof(bufB));
+    Sv_ApplyDeltaData(bufA, a);
+    Sv_ApplyDeltaData(bufB, b);
+    return !std::memcmp(bufA, bufB, size);
+}
+
+/**
+ * Compares the world with the initial register twice, serially and concurrently,
+ * and checks that the resulting delta lists are identical. The register is not
+ * updated. Used for verifying the concurrent comparisons (cvar
+ * "server-frame-parallel").
+ */
+D_CMD(CheckFrameDeltas)
+{
+    DE_UNUSED(src, argc, argv);
+
+    LOG_AS("checkframedeltas (Cmd)");
+
+    if (!ServerWorld::get().hasMap())
+    {
+        LOG_NET_ERROR("No map loaded");
+        return false;
+    }
+
+    // All sides are compared with the initial register, so both passes see the
+    // same elements.
+    deltabatch_t batches[2];
+    TimeSpan durations[2];
+    for (dint i = 0; i < 2; ++i)
+    {
+        batches[i].parallel = (i == 1);
+
+        const Time startedAt;
+        Sv_NewMobjDeltas  (&::initialRegister, false, batches[i]);
+        Sv_NewSectorDeltas(&::initialRegister, false, batches[i]);
+        Sv_NewSideDeltas  (&::initialRegister, false, batches[i]);
+        durations[i] = startedAt.since();
+    }
+
+    const auto &serial   = batches[0].order;
+    const auto &parallel = batches[1].order;
+    dint mismatchCount = 0;
+    if (serial.size() != parallel.size())
+    {
+        LOG_NET_ERROR("Serial comparison produced %i deltas, concurrent %i")
+            << dint(serial.size()) << dint(parallel.size());
+        mismatchCount++;
+    }
+    for (dsize i = 0; i < de::min(serial.size(), parallel.size()); ++i)
+    {
+        if (!Sv_IsEqualDelta(serial[i], parallel[i]))
+        {
+            const auto *delta = (const delta_t *) serial[i];
+            LOG_NET_ERROR("Delta %i (type %i, ID %i) differs")
+                << dint(i) << dint(delta->type) << dint(delta->id);
+            mismatchCount++;
+        }
+    }
+
+    LOG_NET_MSG("%i deltas; serial %.1f ms, concurrent %.1f ms")
+        << dint(serial.size()) << ddouble(durations[0]) * 1000 << ddouble(durations[1]) * 1000;
+    if (mismatchCount)
+    {
+        LOG_NET_ERROR("%i differences between the serial and concurrent deltas") << mismatchCount;
+        return false;
+    }
+    return true;
+}
+
 /**
  * This is called once for each frame, in Sv_TransmitFrame().
  */
@@ -2453,18 +2808,77 @@ void Sv_GenerateFrameDeltas(void)
  */
 void Sv_PoolQueueClear(pool_t* pool)
 {
+    for (int i = 0; i < pool->queueSize; ++i)
+    {
+        pool->queue[i]->queueIndex = -1;
+    }
     pool->queueSize = 0;
 }
 
 /**
- * Exchanges two elements in the queue.
+ * Places the delta at the given position in the queue.
  */
-void Sv_PoolQueueExchange(pool_t* pool, int index1, int index2)
+static void Sv_PoolQueueSet(pool_t* pool, int index, delta_t* delta)
 {
-    delta_t *temp = pool->queue[index1];
+    pool->queue[index] = delta;
+    delta->queueIndex = index;
+}
+
+/**
+ * Moves the delta toward the root of the heap until the heap property holds.
+ */
+static void Sv_PoolQueueSiftUp(pool_t* pool, int i)
+{
+    delta_t *delta = pool->queue[i];
 
-    pool->queue[index1] = pool->queue[index2];
-    pool->queue[index2] = temp;
+    while (i > 0)
+    {
+        const int parent = HEAP_PARENT(i);
+
+        // Is it good now?
+        if (pool->queue[parent]->priority >= delta->priority)
+            break;
+
+        // Move the parent down.
+        Sv_PoolQueueSet(pool, i, pool->queue[parent]);
+        i = parent;
+    }
+    Sv_PoolQueueSet(pool, i, delta);
+}
+
+/**
+ * Moves the delta toward the leaves of the heap until the heap property holds.
+ * This is O(log n).
+ */
+static void Sv_PoolQueueSiftDown(pool_t* pool, int i)
+{
+    delta_t *delta = pool->queue[i];
+
+    for (;;)
+    {
+        const int left  = HEAP_LEFT(i);
+        const int right = HEAP_RIGHT(i);
+        int big = -1;
+
+        // Which child is more important?
+        if (left < pool->queueSize && pool->queue[left]->priority > delta->priority)
+        {
+            big = left;
+        }
+        if (right < pool->queueSize &&
+            pool->queue[right]->priority > (big >= 0 ? pool->queue[big]->priority : delta->priority))
+        {
+            big = right;
+        }
+
+        // Can we stop now?
+        if (big < 0) break;
+
+        // Move the child up and continue.
+        Sv_PoolQueueSet(pool, i, pool->queue[big]);
+        i = big;
+    }
+    Sv_PoolQueueSet(pool, i, delta);
 }
 
 /**
@@ -2473,7 +2887,7 @@ void Sv_PoolQueueExchange(pool_t* pool, int index1, int index2)
  */
 void Sv_PoolQueueAdd(pool_t* pool, delta_t* delta)
 {
-    int                 i, parent;
+    DE_ASSERT(delta->queueIndex < 0);
 
     // Do we need more memory?
     if (pool->allocatedSize == pool->queueSize)
@@ -2504,38 +2918,69 @@ void Sv_PoolQueueAdd(pool_t* pool, delta_t* delta)
         pool->queue = newQueue;
     }
 
-    // Add the new delta to the end of the queue array.
-    i = pool->queueSize;
-    pool->queue[i] = delta;
-    ++pool->queueSize;
+    // Add the new delta to the end of the queue array and let it
+    // rise in the heap until the correct place is found.
+    pool->queue[pool->queueSize] = delta;
+    Sv_PoolQueueSiftUp(pool, pool->queueSize++);
+    pool->queueOps++;
+}
 
-    // Rise in the heap until the correct place is found.
-    while (i > 0)
+/**
+ * Restores the heap property after the score of a queued delta has changed.
+ */
+void Sv_PoolQueueUpdate(pool_t* pool, delta_t* delta)
+{
+    const int i = delta->queueIndex;
+    DE_ASSERT(i >= 0 && i < pool->queueSize && pool->queue[i] == delta);
+
+    if (i > 0 && pool->queue[HEAP_PARENT(i)]->priority < delta->priority)
+    {
+        Sv_PoolQueueSiftUp(pool, i);
+    }
+    else
     {
-        parent = HEAP_PARENT(i);
+        Sv_PoolQueueSiftDown(pool, i);
+    }
+    pool->queueOps++;
+}
 
-        // Is it good now?
-        if (pool->queue[parent]->score >= delta->score)
-            break;
+/**
+ * Removes the delta from the priority queue, if it is queued.
+ */
+void Sv_PoolQueueRemove(pool_t* pool, delta_t* delta)
+{
+    const int i = delta->queueIndex;
+    if (i < 0) return;
 
-        // Exchange with the parent.
-        Sv_PoolQueueExchange(pool, parent, i);
+    DE_ASSERT(i < pool->queueSize && pool->queue[i] == delta);
+    delta->queueIndex = -1;
+    pool->queueOps++;
 
-        i = parent;
+    // Fill the hole with the last element.
+    delta_t *last = pool->queue[--pool->queueSize];
+    if (last == delta) return;
+
+    Sv_PoolQueueSet(pool, i, last);
+    if (i > 0 && pool->queue[HEAP_PARENT(i)]->priority < last->priority)
+    {
+        Sv_PoolQueueSiftUp(pool, i);
+    }
+    else
+    {
+        Sv_PoolQueueSiftDown(pool, i);
     }
 }
 
 /**
- * Extracts the delta with the highest priority from the queue.
+ * Extracts the delta with the highest priority from the queue. The age of the
+ * deltas is accounted for by the priority keys, so the queued deltas need not be
+ * rated again as time passes. The extracted delta is marked changed, so if it remains in the pool (e.g., it did not fit
+ * in the frame), it will be rated and queued again before the next frame.
  *
  * @return              @c NULL, if there are no more deltas.
  */
 delta_t* Sv_PoolQueueExtract(pool_t* pool)
 {
-    delta_t*            max;
-    int                 i, left, right, big;
-    dd_bool             isDone;
-
     if (!pool->queueSize)
     {
         // There is nothing in the queue.
@@ -2543,47 +2988,121 @@ delta_t* Sv_PoolQueueExtract(pool_t* pool)
     }
 
     // This is what we'll return.
-    max = pool->queue[0];
+    delta_t *max = pool->queue[0];
 
-    // Remove the first element from the queue.
-    pool->queue[0] = pool->queue[--pool->queueSize];
+    Sv_PoolQueueRemove(pool, max);
+    Sv_PoolDeltaChanged(pool, max);
+    return max;
+}
 
-    // Heapify the heap. This is O(log n).
-    i = 0;
-    isDone = false;
-    while (!isDone)
+/**
+ * Unlinks the delta from the pool's rating list, or the withheld list if the
+ * delta is withheld.
+ */
+static void Sv_PoolRateListUnlink(pool_t* pool, delta_t* delta)
+{
+    delta_t **first = (delta->withheld? &pool->withheldFirst : &pool->rateFirst);
+    delta_t **last  = (delta->withheld? &pool->withheldLast  : &pool->rateLast);
+
+    if (delta->ratePrev) delta->ratePrev->rateNext = delta->rateNext;
+    else                 *first = delta->rateNext;
+
+    if (delta->rateNext) delta->rateNext->ratePrev = delta->ratePrev;
+    else                 *last = delta->ratePrev;
+
+    delta->rateNext = delta->ratePrev = NULL;
+}
+
+/**
+ * Links the delta to the beginning (needs rating) or the end (most recently
+ * rated) of the pool's rating list. Withheld deltas are linked to the end of
+ * the withheld list.
+ */
+static void Sv_PoolRateListLink(pool_t* pool, delta_t* delta, dd_bool atEnd)
+{
+    delta_t **first = (delta->withheld? &pool->withheldFirst : &pool->rateFirst);
+    delta_t **last  = (delta->withheld? &pool->withheldLast  : &pool->rateLast);
+
+    if (atEnd || delta->withheld)
+    {
+        delta->ratePrev = *last;
+        delta->rateNext = NULL;
+        if (*last) (*last)->rateNext = delta;
+        else       *first = delta;
+        *last = delta;
+    }
+    else
     {
-        left = HEAP_LEFT(i);
-        right = HEAP_RIGHT(i);
-        big = i;
+        delta->ratePrev = NULL;
+        delta->rateNext = *first;
+        if (*first) (*first)->ratePrev = delta;
+        else        *last = delta;
+        *first = delta;
+    }
+}
 
-        // Which child is more important?
-        if (left < pool->queueSize &&
-           pool->queue[left]->score > pool->queue[i]->score)
-        {
-            big = left;
-        }
-        if (right < pool->queueSize &&
-           pool->queue[right]->score > pool->queue[big]->score)
-        {
-            big = right;
-        }
+/**
+ * Starts tracking a delta that has just been added to the pool's hash.
+ */
+void Sv_PoolTrackDelta(pool_t* pool, delta_t* delta)
+{
+    delta->queueIndex = -1;
+    delta->ratedAt    = 0;
+    delta->withheld   = false;
+    Sv_PoolRateListLink(pool, delta, false);
+}
 
-        // Can we stop now?
-        if (big != i)
+/**
+ * Stops tracking a delta that is about to be removed from the pool's hash.
+ */
+void Sv_PoolUntrackDelta(pool_t* pool, delta_t* delta)
+{
+    Sv_PoolQueueRemove(pool, delta);
+    Sv_PoolRateListUnlink(pool, delta);
+}
+
+/**
+ * The contents of the delta have changed, so its score must be recalculated
+ * before the next frame.
+ */
+void Sv_PoolDeltaChanged(pool_t* pool, delta_t* delta)
+{
+    // Changed deltas are already in the beginning of the list.
+    if (!delta->ratedAt) return;
+
+    delta->ratedAt = 0;
+    Sv_PoolRateListUnlink(pool, delta);
+    delta->withheld = false;
+    Sv_PoolRateListLink(pool, delta, false);
+}
+
+/**
+ * Called when the pool owner has moved to another sector. Only the deltas whose
+ * visibility changes are rated again: withheld deltas that can now be seen, and
+ * queued deltas that can no longer be seen.
+ */
+void Sv_PoolOwnerMoved(pool_t* pool)
+{
+    const ownerinfo_t *info = &pool->ownerInfo;
+    delta_t *next;
+
+    for (delta_t *delta = pool->withheldFirst; delta; delta = next)
+    {
+        next = delta->rateNext;
+        if (!Sv_IsCulledDelta(delta, info))
         {
-            // Exchange and continue.
-            Sv_PoolQueueExchange(pool, i, big);
-            i = big;
+            Sv_PoolDeltaChanged(pool, delta);
         }
-        else
+    }
+
+    for (int i = 0; i < pool->queueSize; ++i)
+    {
+        delta_t *delta = pool->queue[i];
+        if (!Sv_IsSoundDelta(delta) && Sv_IsCulledDelta(delta, info))
         {
-            // Heapifying is complete.
-            isDone = true;
+            Sv_PoolDeltaChanged(pool, delta);
         }
     }
-
-    return max;
 }
 
 /**
@@ -2645,10 +3164,6 @@ dd_bool Sv_RateDelta(void* deltaPtr, ownerinfo_t* info)
     coord_t distance;
     delta_t *delta = (delta_t *) deltaPtr;
     int df = delta->flags;
-    uint age = Sv_DeltaAge(delta);
-
-    // The importance doubles normally in 1 second.
-    float ageScoreDouble = 1.0f;
 
     if (Sv_IsPostponedDelta(delta, info))
     {
@@ -2666,16 +3181,6 @@ dd_bool Sv_RateDelta(void* deltaPtr, ownerinfo_t* info)
     // What is the base score?
     score = deltaBaseScores[delta->type] / distance;
 
-    // It's very important to send sound deltas in time.
-    if (Sv_IsSoundDelta(delta))
-    {
-        // Score doubles very quickly.
-        ageScoreDouble = 1;
-    }
-
-    // Deltas become more important with age (milliseconds).
-    score *= 1 + age / (ageScoreDouble * 1000.0f);
-
     /// @todo Consider viewpoint speed and angle.
 
     // Priority bonuses based on the contents of the delta.
@@ -2737,13 +3242,21 @@ dd_bool Sv_RateDelta(void* deltaPtr, ownerinfo_t* info)
     // This is the final score. Only positive scores are accepted in
     // the frame (deltas with nonpositive scores as ignored).
     delta->score = score;
-    return (score > 0);
+    if (score <= 0) return false;
+
+    // Deltas become more important with age: the importance doubles in 1 second.
+    // All deltas age at the same rate, so the age is applied via the creation
+    // time and the queue order remains valid without rating the deltas again.
+    delta->priority = std::log2(double(score)) - delta->timeStamp / 1000.0;
+    return true;
 }
 
 /**
- * Calculate a priority score for each delta and build the priority queue.
- * The most important deltas will be included in a frame packet.
- * A pool is rated after new deltas have been generated.
+ * Update the priority scores of the deltas and the priority queue. Only the deltas
+ * that have changed since the previous rating are rated again; aging does not
+ * affect the order of the queue (see Sv_RateDelta()). The most important
+ * deltas will be included in a frame packet. A pool is rated after new deltas
+ * have been generated.
  */
 void Sv_RatePool(pool_t* pool)
 {
@@ -2751,7 +3264,7 @@ void Sv_RatePool(pool_t* pool)
     player_t*           plr = DD_Player(pool->owner);
 #endif
     delta_t*            delta;
-    int                 i;
+    const uint          now = de::max(Sv_GetTimeStamp(), 1u);
 
 #ifdef _DEBUG
     if (!plr->publicData().mo)
@@ -2760,21 +3273,97 @@ void Sv_RatePool(pool_t* pool)
     }
 #endif
 
-    // Clear the queue.
-    Sv_PoolQueueClear(pool);
+    pool->ratedCount  = 0;
+    pool->queueOps    = 0;
+    pool->culledCount = 0;
 
-    // We will rate all the deltas in the pool. After each delta
-    // has been rated, it's added to the priority queue.
-    for (i = 0; i < POOL_HASH_SIZE; ++i)
+    // Postponed deltas are rated again in the next frame, as they may become
+    // sendable at any time (e.g., when a Start Sound is acknowledged).
+    delta_t *postponed = NULL;
+
+    // The rating list is ordered by time of rating, with the changed deltas
+    // in the beginning.
+    while ((delta = pool->rateFirst) != NULL && !delta->ratedAt)
     {
-        for (delta = pool->hash[i].first; delta; delta = delta->next)
+        if (Sv_IsPostponedDelta(delta, &pool->ownerInfo))
+        {
+            Sv_PoolQueueRemove(pool, delta);
+            Sv_PoolRateListUnlink(pool, delta);
+            delta->ratedAt  = 0;
+            delta->rateNext = postponed;
+            postponed = delta;
+            pool->ratedCount++;
+            continue;
+        }
+
+        if (!Sv_IsSoundDelta(delta) && Sv_IsCulledDelta(delta, &pool->ownerInfo))
         {
-            if (Sv_RateDelta(delta, &pool->ownerInfo))
+            // The delta remains in the pool (merging with newer changes) until
+            // the owner moves to where the entity can be seen.
+            Sv_PoolQueueRemove(pool, delta);
+            Sv_PoolRateListUnlink(pool, delta);
+            delta->ratedAt  = now;
+            delta->withheld = true;
+            Sv_PoolRateListLink(pool, delta, true);
+            pool->culledCount++;
+            pool->deltasCulled++;
+            pool->ratedCount++;
+            continue;
+        }
+
+        if (Sv_RateDelta(delta, &pool->ownerInfo))
+        {
+            if (delta->queueIndex >= 0)
+            {
+                Sv_PoolQueueUpdate(pool, delta);
+            }
+            else
             {
                 Sv_PoolQueueAdd(pool, delta);
             }
         }
+        else
+        {
+            // Not included at this time.
+            Sv_PoolQueueRemove(pool, delta);
+        }
+
+        // Most recently rated deltas go to the end of the list.
+        delta->ratedAt = now;
+        Sv_PoolRateListUnlink(pool, delta);
+        Sv_PoolRateListLink(pool, delta, true);
+        pool->ratedCount++;
+    }
+
+    // Unrated deltas stay in the beginning of the list.
+    while ((delta = postponed) != NULL)
+    {
+        postponed = delta->rateNext;
+        Sv_PoolRateListLink(pool, delta, false);
+    }
+}
+
+/**
+ * Rates all the pools in the NULL-terminated array. Pools are independent of
+ * each other, so they are rated concurrently.
+ */
+void Sv_RatePools(pool_t** targets)
+{
+    if (!::svParallelDeltas || !targets[0] || !targets[1])
+    {
+        for (; *targets; targets++)
+        {
+            Sv_RatePool(*targets);
+        }
+        return;
     }
+
+    dsize count = 0;
+    while (targets[count]) count++;
+    TaskPool::parallelFor(0, count, [targets] (dsize begin, dsize end)
+    {
+        for (dsize i = begin; i < end; ++i) Sv_RatePool(targets[i]);
+    }, 1);
 }
 
 /**
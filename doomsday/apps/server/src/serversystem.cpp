@@ -26,6 +26,7 @@
 #include "remotefeeduser.h"
 #include "server/sv_def.h"
 #include "server/sv_frame.h"
+#include "server/sv_pool.h"
 #include "network/net_main.h"
 #include "network/net_buf.h"
 #include "network/net_event.h"
@@ -213,6 +214,21 @@ DE_PIMPL(ServerSystem)
         {
             LOG_MSG("No clients connected");
         }
+        else
+        {
+            // Delta pool statistics of the current map.
+            LOG_MSG(_E(m) "P# Frames: KBytes: Culled: Sounds culled:");
+            for (int i = 1; i < DDMAXPLAYERS; ++i)
+            {
+                player_t *plr = DD_Player(i);
+                if (!plr->remoteUserId) continue;
+
+                pool_t &pool = plr->deltaPool();
+                LOG_MSG(_E(m) "%2i %-7i %-7.1f %-7i %i")
+                        << i << pool.framesSent << pool.bytesSent / 1024.0
+                        << pool.deltasCulled << pool.soundsCulled;
+            }
+        }
 
         if (shellUsers.count())
         {
@@ -433,12 +449,16 @@ void Server_Register()
     C_VAR_CHARPTR   ("server-password",         &::netPassword, 0, 0, 0);
     C_VAR_BYTE      ("server-latencies",        &::netShowLatencies, 0, 0, 1);
     C_VAR_INT       ("server-frame-interval",   &::frameInterval, CVF_NO_MAX, 0, 0);
+    C_VAR_BYTE      ("server-frame-parallel",   &::svParallelDeltas, 0, 0, 1);
+    C_VAR_BYTE      ("server-frame-cull",       &::svCullDeltas, 0, 0, 1);
     C_VAR_INT       ("server-player-limit",     &::svMaxPlayers, 0, 0, DDMAXPLAYERS);
 
     C_VAR_CHARPTR   ("net-ip-address", &nptIPAddress, 0, 0, 0);
     C_VAR_INT       ("net-ip-port",    &nptIPPort, CVF_NO_MAX, 0, 0);
 
     C_CMD_FLAGS     ("kick", "i", Kick, CMDF_NO_NULLGAME);
+    C_CMD           ("captureframes", nullptr, CaptureFrames);
+    C_CMD_FLAGS     ("checkframedeltas", nullptr, CheckFrameDeltas, CMDF_NO_NULLGAME);
 }
 
 dd_bool N_ServerOpen()
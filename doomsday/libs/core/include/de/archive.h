@@ -209,6 +209,20 @@ public:
      */
     Block &entryBlock(const Path &path);
 
+    /**
+     * Deserializes and caches the data of several entries at once. The serialized
+     * data of the entries is first read from the source in the calling thread,
+     * after which the entries are deserialized (e.g., decompressed) concurrently
+     * in background threads. Returns when all the entries have been cached.
+     *
+     * Entries that are already cached or do not exist are skipped. If an entry
+     * cannot be deserialized, it is left uncached and the error is thrown when
+     * the entry is accessed with entryBlock().
+     *
+     * @param paths  Paths of the entries to cache.
+     */
+    void prefetch(const List<Path> &paths) const;
+
     /**
      * Release all cached data of a block. Unmodified blocks cannot be uncached.
      * The archive must have a source for uncaching to be possible.
@@ -0,0 +1,116 @@
+/** @file deflatedictionary.h  Preset dictionary for deflating short messages.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBCORE_DEFLATEDICTIONARY_H
+#define LIBCORE_DEFLATEDICTIONARY_H
+
+#include "de/libcore.h"
+#include "de/block.h"
+#include "de/list.h"
+
+namespace de {
+
+/**
+ * Preset dictionary for zlib deflate. Short messages compress poorly with plain
+ * deflate because there is no earlier data to refer to; a dictionary made of
+ * content that typically occurs in the messages provides that history.
+ *
+ * The compressed data is in the zlib format, which identifies the dictionary with
+ * its Adler-32 checksum (the dictionary ID). decompress() looks up the required
+ * dictionary among the registered ones, so the receiver only needs to know the
+ * same dictionary as the sender.
+ *
+ * @ingroup data
+ */
+class DE_PUBLIC DeflateDictionary
+{
+public:
+    /// Default maximum size of a trained dictionary.
+    static constexpr dsize DEFAULT_SIZE = 16384;
+
+public:
+    DeflateDictionary(const Block &data = Block());
+
+    inline bool isEmpty() const { return _data.isEmpty(); }
+    inline const Block &data() const { return _data; }
+
+    /**
+     * Returns the identifier of the dictionary (Adler-32 checksum of the contents).
+     */
+    inline duint32 id() const { return _id; }
+
+    /**
+     * Compresses data using the dictionary.
+     *
+     * @param data   Data to compress.
+     * @param level  Deflate compression level (1...9).
+     *
+     * @return Compressed data in the zlib format. Empty, if compression failed.
+     */
+    Block compress(const Block &data, int level = 1) const;
+
+    /**
+     * Decompresses zlib data. The data may have been compressed with or without
+     * a dictionary; the required dictionary must be registered.
+     *
+     * @param deflated  Compressed data.
+     *
+     * @return Decompressed data. Empty, if decompression failed.
+     */
+    static Block decompress(const Block &deflated);
+
+    /**
+     * Determines whether @a deflated is zlib data that requires a dictionary.
+     */
+    static bool needsDictionary(const Block &deflated);
+
+    /**
+     * Makes a dictionary available for decompression. If a dictionary with the
+     * same identifier has already been registered, that one is kept.
+     *
+     * @return The registered dictionary. Remains valid until the end of the process.
+     */
+    static const DeflateDictionary &registerDictionary(const DeflateDictionary &dictionary);
+
+    /**
+     * Finds a registered dictionary.
+     *
+     * @param id  Dictionary identifier.
+     *
+     * @return The dictionary, or @c nullptr if there is no such dictionary.
+     */
+    static const DeflateDictionary *find(duint32 id);
+
+    /**
+     * Builds a dictionary out of the segments that occur most frequently in a set
+     * of sample messages. Commonly occurring content is placed at the end of the
+     * dictionary, where it can be referred to with the shortest distances.
+     *
+     * @param samples  Representative sample messages.
+     * @param maxSize  Maximum size of the dictionary.
+     */
+    static DeflateDictionary train(const List<Block> &samples, dsize maxSize = DEFAULT_SIZE);
+
+private:
+    Block   _data;
+    duint32 _id;
+};
+
+} // namespace de
+
+#endif // LIBCORE_DEFLATEDICTIONARY_H
@@ -0,0 +1,226 @@
+/** @file flatidmap.h  Open-addressed map from integer identifiers to values.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBCORE_FLATIDMAP_H
+#define LIBCORE_FLATIDMAP_H
+
+#include "de/libcore.h"
+#include <utility>
+#include <vector>
+
+namespace de {
+
+/**
+ * Map from integer identifiers to values, intended for lookup-heavy use with
+ * thousands of entries.
+ *
+ * The values are stored contiguously in insertion order (removal moves the last
+ * value into the freed position). A separate open-addressed index with linear
+ * probing maps identifiers to positions in the value array. The index is kept at
+ * most half full and grows as needed. Removal uses backward-shift deletion, so
+ * no tombstones accumulate.
+ *
+ * Pointers and references to values are invalidated by insertions and removals.
+ * Removing the value at position @em i only moves the value at the last position,
+ * so iterating backwards while removing is allowed.
+ *
+ * @param Id     Unsigned integer identifier type. Identifier zero is reserved
+ *               and cannot be inserted.
+ * @param Value  Value type. Must be default-constructible.
+ */
+template <typename Id, typename Value>
+class FlatIdMap
+{
+public:
+    FlatIdMap() {}
+
+    inline dsize size() const     { return _values.size(); }
+    inline bool  isEmpty() const  { return _values.empty(); }
+    inline dsize indexSize() const { return _slots.size(); }
+
+    void clear()
+    {
+        _values.clear();
+        _ids.clear();
+        _slots.clear();
+        _mask = 0;
+    }
+
+    /**
+     * Returns the value with identifier @a id, or @c nullptr if there isn't one.
+     */
+    inline Value *find(Id id)
+    {
+        const duint32 pos = locate(id);
+        return pos? &_values[pos - 1] : nullptr;
+    }
+
+    inline const Value *find(Id id) const
+    {
+        return const_cast<FlatIdMap *>(this)->find(id);
+    }
+
+    inline bool contains(Id id) const
+    {
+        return locate(id) != 0;
+    }
+
+    /**
+     * Returns the value with identifier @a id. A default-constructed value is
+     * added if one doesn't exist yet.
+     */
+    Value &insert(Id id)
+    {
+        DE_ASSERT(id != 0);
+        if (const duint32 pos = locate(id))
+        {
+            return _values[pos - 1];
+        }
+        if ((_values.size() + 1) * 2 > _slots.size())
+        {
+            rehash(_slots.empty()? 64 : _slots.size() * 2);
+        }
+        _values.push_back(Value());
+        _ids.push_back(id);
+        place(id, duint32(_values.size()));
+        return _values.back();
+    }
+
+    /**
+     * Removes the value with identifier @a id.
+     *
+     * @return @c true, if a value was removed.
+     */
+    bool remove(Id id)
+    {
+        if (_slots.empty()) return false;
+        duint32 slot = home(id);
+        for (;; slot = (slot + 1) & _mask)
+        {
+            if (!_slots[slot].pos) return false;
+            if (_slots[slot].id == id) break;
+        }
+        const duint32 pos = _slots[slot].pos;
+        eraseSlot(slot);
+
+        // Move the last value into the vacated position.
+        const duint32 last = duint32(_values.size());
+        if (pos != last)
+        {
+            _values[pos - 1] = std::move(_values[last - 1]);
+            _ids   [pos - 1] = _ids[last - 1];
+            slotOf(_ids[pos - 1]).pos = pos;
+        }
+        _values.pop_back();
+        _ids.pop_back();
+        return true;
+    }
+
+    // Access by position in the value array.
+    inline Id           idAt   (dsize index) const { return _ids[index]; }
+    inline Value &      valueAt(dsize index)       { return _values[index]; }
+    inline const Value &valueAt(dsize index) const { return _values[index]; }
+
+    inline typename std::vector<Value>::iterator       begin()       { return _values.begin(); }
+    inline typename std::vector<Value>::iterator       end()         { return _values.end(); }
+    inline typename std::vector<Value>::const_iterator begin() const { return _values.begin(); }
+    inline typename std::vector<Value>::const_iterator end()   const { return _values.end(); }
+
+private:
+    struct Slot
+    {
+        Id      id;
+        duint32 pos; ///< Position in the value array plus one; zero if the slot is empty.
+    };
+
+    inline duint32 home(Id id) const
+    {
+        // Fibonacci hashing spreads consecutive identifiers evenly.
+        return duint32((duint64(id) * 0x9e3779b97f4a7c15ull) >> 32) & _mask;
+    }
+
+    /// Returns the value position plus one, or zero if not found.
+    inline duint32 locate(Id id) const
+    {
+        if (_slots.empty()) return 0;
+        for (duint32 slot = home(id); ; slot = (slot + 1) & _mask)
+        {
+            const Slot &s = _slots[slot];
+            if (!s.pos) return 0;
+            if (s.id == id) return s.pos;
+        }
+    }
+
+    inline Slot &slotOf(Id id)
+    {
+        duint32 slot = home(id);
+        while (_slots[slot].id != id || !_slots[slot].pos)
+        {
+            slot = (slot + 1) & _mask;
+        }
+        return _slots[slot];
+    }
+
+    inline void place(Id id, duint32 pos)
+    {
+        duint32 slot = home(id);
+        while (_slots[slot].pos) slot = (slot + 1) & _mask;
+        _slots[slot].id  = id;
+        _slots[slot].pos = pos;
+    }
+
+    void eraseSlot(duint32 hole)
+    {
+        // Shift following entries of the probe sequence backwards so that every
+        // entry remains reachable from its home slot.
+        for (duint32 next = (hole + 1) & _mask; _slots[next].pos; next = (next + 1) & _mask)
+        {
+            const duint32 want = home(_slots[next].id);
+            // Can the entry at 'next' be moved to 'hole'? Only if its home slot is
+            // not cyclically within (hole, next].
+            const bool inRange = (hole <= next)? (hole < want && want <= next)
+                                               : (hole < want || want <= next);
+            if (!inRange)
+            {
+                _slots[hole] = _slots[next];
+                hole = next;
+            }
+        }
+        _slots[hole].pos = 0;
+    }
+
+    void rehash(dsize slotCount)
+    {
+        _slots.assign(slotCount, Slot{0, 0});
+        _mask = duint32(slotCount - 1);
+        for (dsize i = 0; i < _ids.size(); ++i)
+        {
+            place(_ids[i], duint32(i + 1));
+        }
+    }
+
+private:
+    std::vector<Value> _values;
+    std::vector<Id>    _ids;   ///< Identifier of each value (parallel to _values).
+    std::vector<Slot>  _slots; ///< Open-addressed index; size is a power of two.
+    duint32            _mask = 0;
+};
+
+} // namespace de
+
+#endif // LIBCORE_FLATIDMAP_H
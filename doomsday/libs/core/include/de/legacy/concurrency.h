@@ -141,6 +141,13 @@ DE_PUBLIC void Sys_DestroyMutex(mutex_t mutexHandle);
 
 DE_PUBLIC void Sys_Lock(mutex_t mutexHandle);
 
+/**
+ * Attempts to lock a mutex without blocking.
+ *
+ * @return @c true, if the mutex was locked by the calling thread.
+ */
+DE_PUBLIC dd_bool Sys_TryLock(mutex_t mutexHandle);
+
 DE_PUBLIC void Sys_Unlock(mutex_t mutexHandle);
 
 /// @}
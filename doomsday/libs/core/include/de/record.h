@@ -26,6 +26,7 @@
 #include "de/list.h"
 #include "de/log.h"
 #include "de/recordaccessor.h"
+#include "de/recordmembers.h"
 #include "de/cstring.h"
 #include "de/value.h"
 #include "de/variable.h"
@@ -75,7 +76,7 @@ public:
     static const char *VAR_INIT;
     static const char *VAR_NATIVE_SELF;
 
-    typedef Hash<String, Variable *> Members;  // unordered
+    typedef RecordMembers Members;             // unordered
     typedef Hash<String, Record *> Subrecords; // unordered
     typedef std::pair<String, String> KeyValue;
 
@@ -553,6 +554,30 @@ public:
 
     void markAllMembersUnchanged();
 
+    /**
+     * Returns the version of the record's member layout. The version changes when
+     * members are added or removed, or when the super-records variable is assigned a
+     * new value. Modifying the super-records array in place does not change the
+     * version, so callers must check the array separately. Versions are
+     * unique among all records, so a record address and a version together identify
+     * a layout even if the record is deleted and a new one is created at the same
+     * address. Can be called from any thread.
+     */
+    duint64 layoutVersion() const;
+
+    /**
+     * Marks the record as being used as a super-record. Deleting a marked record
+     * changes superRecordEpoch().
+     */
+    void markAsSuperRecord() const;
+
+    /**
+     * Returns a number that changes whenever a record marked as a super-record is
+     * deleted. Caches that refer to super-records without owning them can use this to
+     * detect that the records may no longer exist.
+     */
+    static duint64 superRecordEpoch();
+
     /**
      * Creates a text representation of the record. Each variable name is
      * prefixed with @a prefix.
@@ -0,0 +1,138 @@
+/*
+ * The Doomsday Engine Project -- libcore
+ *
+ * Copyright © 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBCORE_RECORDMEMBERS_H
+#define LIBCORE_RECORDMEMBERS_H
+
+#include "de/string.h"
+
+#include <utility>
+
+namespace de {
+
+class Variable;
+
+/**
+ * Compact hash table of the members of a Record, keyed by member name.
+ *
+ * The members are kept in one contiguous array in no particular order, and the hash
+ * of each name is stored alongside so that lookups compare integers before comparing
+ * any strings. Tables of up to INLINE_CAPACITY members are stored inside the table
+ * object, so small records need no allocations for their members. Larger tables use
+ * a single allocation for the members, the hashes, and an open-addressed index.
+ *
+ * Adding members invalidates iterators. Removing a member moves the last member to
+ * the removed position.
+ *
+ * @ingroup data
+ */
+class DE_PUBLIC RecordMembers
+{
+public:
+    using key_type       = String;
+    using mapped_type    = Variable *;
+    using value_type     = std::pair<String, Variable *>;
+    using iterator       = value_type *;
+    using const_iterator = const value_type *;
+
+    /// Number of members that fit in the table without allocating memory.
+    static constexpr duint32 INLINE_CAPACITY = 4;
+
+public:
+    RecordMembers();
+    RecordMembers(const RecordMembers &other);
+    RecordMembers(RecordMembers &&moved);
+    ~RecordMembers();
+
+    RecordMembers &operator=(const RecordMembers &other);
+    RecordMembers &operator=(RecordMembers &&moved);
+
+    inline iterator       begin()       { return _entries; }
+    inline iterator       end()         { return _entries + _size; }
+    inline const_iterator begin() const { return _entries; }
+    inline const_iterator end() const   { return _entries + _size; }
+
+    inline bool  empty() const   { return _size == 0; }
+    inline bool  isEmpty() const { return _size == 0; }
+    inline dsize size() const    { return _size; }
+    inline int   sizei() const   { return int(_size); }
+
+    iterator       find(const String &key);
+    const_iterator find(const String &key) const;
+    bool           contains(const String &key) const;
+
+    /**
+     * Adds a member, or replaces the variable of an existing member.
+     *
+     * @return Iterator to the member.
+     */
+    iterator insert(const String &key, Variable *value);
+
+    /**
+     * Returns the variable of a member. If the member does not exist, it is added
+     * with a @c nullptr variable.
+     */
+    Variable *&operator[](const String &key);
+
+    /**
+     * Returns the variable of an existing member.
+     */
+    Variable *operator[](const String &key) const;
+
+    /**
+     * Removes a member.
+     *
+     * @return Iterator to the member that was moved to the removed position, or end().
+     */
+    iterator erase(const_iterator pos);
+
+    void remove(const String &key);
+    void clear();
+
+    StringList keys() const;
+
+    /**
+     * Calculates the hash of a member name.
+     */
+    static duint32 hashKey(const String &key);
+
+private:
+    duint32 findPos(const String &key, duint32 hash) const;
+    void    append(const String &key, Variable *value, duint32 hash);
+    void    grow();
+    void    release();
+    void    resetToInline();
+    duint32 indexSize() const { return _capacity * 2; }
+    duint32 indexSlotOf(duint32 pos) const;
+    void    addToIndex(duint32 pos);
+    void    removeFromIndex(duint32 slot);
+
+    value_type *_entries;
+    duint32 *   _hashes;
+    duint32 *   _index;    ///< Entry position + 1 per slot; @c nullptr for small tables.
+    duint32     _size;
+    duint32     _capacity;
+
+    alignas(value_type) dbyte _inlineEntries[INLINE_CAPACITY * sizeof(value_type)];
+    duint32 _inlineHashes[INLINE_CAPACITY];
+};
+
+} // namespace de
+
+#endif // LIBCORE_RECORDMEMBERS_H
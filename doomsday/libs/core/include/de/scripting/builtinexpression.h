@@ -74,6 +74,8 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    const Expression &argument() const { return *_arg; }
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
@@ -0,0 +1,130 @@
+/*
+ * The Doomsday Engine Project -- libcore
+ *
+ * Copyright © 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBCORE_BYTECODE_H
+#define LIBCORE_BYTECODE_H
+
+#include "../libcore.h"
+#include "de/list.h"
+
+namespace de {
+
+class Expression;
+
+/**
+ * Expression compiled into instructions for the register machine of Evaluator.
+ *
+ * Evaluating an expression tree directly requires pushing every subexpression
+ * onto the evaluator's expression stack and every intermediate value onto the
+ * result stack. The compiled form instead keeps intermediate values in a fixed
+ * set of registers, so operators are applied without any stack traffic, constants
+ * are not copied unless modified, and comparisons do not allocate their results.
+ *
+ * The instructions still refer to the original expression nodes: name lookups,
+ * built-in functions, and operators with side effects are done by the nodes
+ * themselves, so the compiled form behaves exactly like the expression tree.
+ *
+ * Expressions are compiled on demand (see Expression::bytecode()). Compiled
+ * bytecode is immutable and may be executed by several evaluators at the same time.
+ *
+ * @ingroup script
+ */
+class DE_PUBLIC Bytecode
+{
+public:
+    enum Opcode {
+        Constant,    ///< dest = constant of @a node (not copied).
+        Name,        ///< dest = @a node evaluated in the namespace of register @a scope.
+        Array,       ///< dest = array of registers [a, a + count).
+        Dictionary,  ///< dest = dictionary of key/value registers [a, a + 2 * count).
+        BuiltIn,     ///< dest = @a node applied to register @a a.
+        VerifyScope, ///< Register @a a must have members.
+        Operate,     ///< dest = @a node operator applied to registers @a a and @a b.
+        Equal,       ///< dest = (a == b)
+        NotEqual,    ///< dest = (a != b)
+        Less,        ///< dest = (a < b)
+        Greater,     ///< dest = (a > b)
+        LessOrEqual, ///< dest = (a <= b)
+        GreaterOrEqual, ///< dest = (a >= b)
+        In,          ///< dest = (a in b)
+        Not,         ///< dest = not b
+        JumpIfFalse, ///< If dest is not true, dest = False and jump to @a count.
+        JumpIfTrue,  ///< If dest is true, dest = True and jump to @a count.
+        Truth,       ///< dest = True if dest is true, otherwise False.
+        Call,        ///< dest = call register @a a with arguments @a b.
+    };
+
+    /// Register index that refers to no register.
+    static constexpr duint8 NoRegister = 0xff;
+
+    struct Instruction
+    {
+        duint8 op;
+        duint8 dest;
+        duint8 a;
+        duint8 b;
+        duint8 scope;  ///< Value in this register becomes the scope of the result.
+        duint16 count; ///< Number of elements, or jump target.
+        const Expression *node;
+    };
+
+    using Instructions = List<Instruction>;
+
+public:
+    /**
+     * Compiles an expression. The result is always placed in register zero.
+     *
+     * @param expression  Expression to compile. Must outlive the bytecode.
+     *
+     * @return Compiled bytecode. If the expression cannot be compiled,
+     * isValid() will return @c false.
+     */
+    static Bytecode *compile(const Expression &expression);
+
+    /**
+     * Determines if the bytecode can be executed. If not, the expression must be
+     * evaluated by traversing the expression tree.
+     */
+    bool isValid() const;
+
+    const Instructions &instructions() const;
+
+    /**
+     * Number of registers needed to execute the bytecode.
+     */
+    dint registerCount() const;
+
+    /**
+     * Enables or disables the execution of compiled bytecode. When disabled,
+     * all expressions are evaluated by traversing the expression tree.
+     * Bytecode is enabled by default; the <tt>-nobytecode</tt> option disables it.
+     */
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled();
+
+private:
+    Bytecode();
+
+    DE_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBCORE_BYTECODE_H
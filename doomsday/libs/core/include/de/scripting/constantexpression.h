@@ -48,6 +48,8 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    const Value &value() const { return *_value; }
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
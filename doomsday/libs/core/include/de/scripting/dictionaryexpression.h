@@ -48,6 +48,12 @@ public:
      */
     void add(Expression *key, Expression *value);
 
+    dsize size() const { return _arguments.size(); }
+
+    const Expression &keyAt(dint pos) const { return *_arguments.at(pos).first; }
+
+    const Expression &valueAt(dint pos) const { return *_arguments.at(pos).second; }
+
     void push(Evaluator &evaluator, Value *scope = 0) const;
 
     /**
@@ -22,8 +22,11 @@
 
 #include "de/iserializable.h"
 
+#include <atomic>
+
 namespace de {
 
+class Bytecode;
 class Evaluator;
 class Value;
 class Record;
@@ -107,6 +110,15 @@ public:
      */
     void setFlags(Flags f, FlagOp operation = ReplaceFlags);
 
+    /**
+     * Returns the expression compiled to bytecode. The expression is compiled when
+     * this is first called, and the bytecode is kept until the expression is
+     * modified or deleted. Can be called from any thread.
+     *
+     * @return Compiled bytecode. Check Bytecode::isValid() before executing it.
+     */
+    const Bytecode &bytecode() const;
+
     /**
      * Subclasses must call this in their serialization method.
      */
@@ -140,7 +152,10 @@ protected:
     };
 
 private:
+    void clearBytecode();
+
     Flags _flags;
+    mutable std::atomic<const Bytecode *> _bytecode;
 };
 
 } // namespace de
@@ -29,9 +29,13 @@ namespace de {
  * Responsible for referencing, creating, and deleting variables and record
  * references based an textual identifier.
  *
+ * Each expression has a small inline cache of the variables it has found. A cached
+ * lookup remains valid as long as the searched namespaces and super-records are the
+ * same and their layouts are unchanged (see Record::layoutVersion()).
+ *
  * @ingroup script
  */
-class NameExpression : public Expression
+class DE_PUBLIC NameExpression : public Expression
 {
 public:
     /// Identifier is not text. @ingroup errors
@@ -47,6 +51,12 @@ public:
     /// expression to start looking in the context's local namespace.
     static const char *LOCAL_SCOPE;
 
+    struct CacheStats
+    {
+        duint64 hits   = 0; ///< Lookups found in the inline cache.
+        duint64 misses = 0; ///< Lookups that had to search the namespaces.
+    };
+
 public:
     NameExpression();
     NameExpression(const String &identifier, Flags flags = ByValue);
@@ -57,6 +67,13 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    /**
+     * Returns the inline cache statistics of all name expressions.
+     */
+    static CacheStats cacheStats();
+
+    static void resetCacheStats();
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
@@ -80,6 +80,30 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    /**
+     * Applies the operator to already evaluated operands. This is the part of
+     * evaluate() that does not depend on the evaluator, so it cannot be used with
+     * the MEMBER, AND, OR, and CALL operators.
+     *
+     * @param leftValue    Left operand, or @c nullptr for unary operators.
+     *                     Ownership given.
+     * @param rightValue   Right operand.
+     * @param rightIsOwned Ownership of @a rightValue is given. Unary operators
+     *                     require ownership.
+     *
+     * @return Result of the operation. Caller gets ownership.
+     */
+    Value *operate(Value *leftValue, Value *rightValue, bool rightIsOwned = true) const;
+
+    Operator op() const { return _op; }
+
+    /**
+     * Returns the left operand, or @c nullptr for unary operators.
+     */
+    const Expression *leftOperand() const { return _leftOperand; }
+
+    const Expression &rightOperand() const { return *_rightOperand; }
+
     /**
      * Verifies that @a value can be used as the l-value of an operator that
      * does assignment.
@@ -88,6 +112,14 @@ public:
      */
     static void verifyAssignable(Value *value);
 
+    /**
+     * Verifies that @a value has members, so it can be used as the left side of
+     * the MEMBER operator.
+     *
+     * @param value  Value to check.
+     */
+    static void verifyScope(const Value &value);
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
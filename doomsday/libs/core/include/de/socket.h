@@ -33,6 +33,7 @@
 
 namespace de {
 
+class DeflateDictionary;
 class Message;
 
 /**
@@ -141,6 +142,21 @@ public:
      */
     void setRetainOrder(bool retainOrder);
 
+    /**
+     * Sets a preset dictionary for compressing outgoing messages. Short messages
+     * are deflated using the dictionary when the result is smaller than with the
+     * other methods. The peer must have the same dictionary registered, so the
+     * use of a dictionary needs to be agreed on beforehand.
+     *
+     * Received messages are decompressed with any registered dictionary regardless
+     * of this setting.
+     *
+     * @param dictionary  Dictionary to use. Must remain valid while the socket
+     *                    exists (see DeflateDictionary::registerDictionary()).
+     *                    Use @c nullptr to stop using a dictionary.
+     */
+    void setDictionary(const DeflateDictionary *dictionary);
+
     // Implements Transmitter.
     /**
      * Sends the given data over the socket.  Copies the data into
@@ -24,6 +24,7 @@
 #include "de/variant.h"
 
 #include <functional>
+#include <vector>
 
 namespace de {
 
@@ -37,6 +38,12 @@ class Task;
  * TaskPool instance for each group of concurrent tasks whose state needs to be
  * observed as a whole.
  *
+ * The number of background threads is based on the number of CPU cores. Each
+ * thread has its own task queues, one per priority. Tasks started in a pooled
+ * thread are queued locally and other threads steal work from the queue when
+ * they run out of tasks. Higher priority tasks are always run before lower
+ * priority ones.
+ *
  * While TaskPool allows the user to monitor whether all tasks are done and
  * block until that time arrives (TaskPool::waitForDone()), no facilities are
  * provided for interrupting any of the started tasks. If that is required, the
@@ -64,6 +71,9 @@ public:
 
     typedef std::function<void ()> TaskFunction;
 
+    /// Processes the indices [begin, end) of a range.
+    typedef std::function<void (dsize begin, dsize end)> RangeFunction;
+
     DE_AUDIENCE(Done, void taskPoolDone(TaskPool &))
 
 public:
@@ -121,6 +131,71 @@ public:
      */
     static void yield(const TimeSpan timeout);
 
+    /**
+     * Processes a range of indices concurrently. The range is divided into chunks
+     * that the calling thread and the pooled threads take turns claiming, so the
+     * work is balanced even if the chunks take different amounts of time. Returns
+     * when all the chunks have been processed.
+     *
+     * If @a func throws an exception, the remaining chunks are still processed and
+     * the first exception is rethrown in the calling thread.
+     *
+     * @param begin      First index.
+     * @param end        End of the range (not included).
+     * @param func       Called for each chunk of the range.
+     * @param grainSize  Number of indices in a chunk. Zero to choose automatically.
+     */
+    static void parallelFor(dsize begin, dsize end, const RangeFunction &func,
+                            dsize grainSize = 0);
+
+    /**
+     * Reduces a range of indices concurrently. Each chunk of the range is mapped to
+     * a partial result, and the partial results are combined in the order of the
+     * chunks, so @a combine does not need to be commutative.
+     *
+     * @param begin      First index.
+     * @param end        End of the range (not included).
+     * @param identity   Initial value of the result.
+     * @param map        Called for each chunk: T map(dsize begin, dsize end).
+     * @param combine    Combines two results: T combine(const T &, const T &).
+     * @param grainSize  Number of indices in a chunk. Zero to choose automatically.
+     *
+     * @return Combined result.
+     */
+    template <typename T, typename MapFunc, typename CombineFunc>
+    static T parallelReduce(dsize begin, dsize end, const T &identity, MapFunc map,
+                            CombineFunc combine, dsize grainSize = 0)
+    {
+        if (end <= begin) return identity;
+        const dsize grain = chunkSize(end - begin, grainSize);
+        // Each chunk writes its own element. The padding keeps the elements on separate
+        // cache lines; it also avoids std::vector<bool>, whose elements share bytes.
+        struct Partial { T value; dbyte padding[64]; };
+        std::vector<Partial> partial((end - begin + grain - 1) / grain, Partial{identity, {}});
+        parallelFor(begin, end, [&partial, &map, begin, grain] (dsize b, dsize e) {
+            partial[(b - begin) / grain].value = map(b, e);
+        }, grain);
+        T result = identity;
+        for (const Partial &p : partial)
+        {
+            result = combine(result, p.value);
+        }
+        return result;
+    }
+
+    /**
+     * Determines the size of the chunks that parallelFor() divides a range into.
+     *
+     * @param count      Number of indices in the range.
+     * @param grainSize  Requested chunk size. Zero to choose automatically.
+     */
+    static dsize chunkSize(dsize count, dsize grainSize = 0);
+
+    /**
+     * Returns the number of pooled background threads.
+     */
+    static int workerCount();
+
     /**
      * Called by de::App at shutdown.
      */
@@ -26,39 +26,336 @@
 #include "de/loop.h"
 #include "de/waitable.h"
 
-#include <the_Foundation/threadpool.h>
+#include "de/thread.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace de {
 namespace internal {
 
-static iThreadPool *s_pool = nullptr;
-
-static iThreadPool *globalThreadPool()
+/**
+ * Work-stealing scheduler that runs the tasks of all TaskPools.
+ *
+ * Each worker thread has its own queues, one per priority. A task started in a
+ * worker thread goes to the worker's own queue, and tasks started in other
+ * threads go to a shared queue. Workers run their own most recently queued tasks
+ * first, and when there are none left, they take the oldest tasks from the shared
+ * queue and from the other workers. A task of a higher priority is always taken
+ * before any task of a lower priority.
+ */
+class Scheduler
 {
-    if (!s_pool)
+public:
+    static constexpr int PRIORITY_COUNT = 3;
+
+    Scheduler()
     {
         /*
-         * The application is assumed to need a few CPU cores for:
-         *  - rendering/input/UI (main thread; most time-consuming)
-         *  - audio: continuous buffer mixing, streaming
-         *  - timer: triggering timer events
-         *  - networking: receiving and sending data via sockets
+         * The application is assumed to need a CPU core for rendering/input/UI
+         * (main thread; most time-consuming). Audio, timer and networking threads
+         * mostly sleep.
          *
-         * Always create at least two threads so the pool is useful for running background tasks.
+         * Always create at least two threads so the pool is useful for running
+         * background tasks.
          */
-        s_pool = newLimits_ThreadPool(2, 3);
+        const int cores = int(std::thread::hardware_concurrency());
+        const int count = de::max(2, cores - 1);
+        for (int i = 0; i < count; ++i)
+        {
+            _queues.emplace_back(new Queue);
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            _workers.emplace_back(new Worker(*this, i));
+            _workers.back()->setName("PooledThread");
+            _workers.back()->start();
+        }
+    }
+
+    ~Scheduler()
+    {
+        // Workers exit after all the queued tasks have been run.
+        {
+            std::lock_guard<std::mutex> g(_sleepMutex);
+            _stopping = true;
+        }
+        _wakeup.notify_all();
+        for (auto &worker : _workers)
+        {
+            worker->join();
+        }
+    }
+
+    int workerCount() const
+    {
+        return int(_workers.size());
+    }
+
+    bool isWorkerThread() const
+    {
+        return t_scheduler == this && t_worker >= 0;
+    }
+
+    void submit(IRunnable *task, int priority)
+    {
+        DE_ASSERT(priority >= 0 && priority < PRIORITY_COUNT);
+        Queue &queue = (isWorkerThread()? *_queues[t_worker] : _shared);
+        {
+            std::lock_guard<std::mutex> g(queue.mutex);
+            queue.tasks[priority].push_back(task);
+        }
+        _pending++;
+        if (_sleeping > 0)
+        {
+            // Make sure the worker is either waiting or will see the pending task.
+            {
+                std::lock_guard<std::mutex> g(_sleepMutex);
+            }
+            _wakeup.notify_one();
+        }
+    }
+
+    /**
+     * Runs one queued task in the calling thread. If there are no queued tasks,
+     * waits at most @a timeout for one to be started.
+     */
+    void help(TimeSpan timeout)
+    {
+        if (IRunnable *task = take())
+        {
+            task->run();
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleeping++;
+            const auto isReady = [this] () { return _pending > 0 || _stopping; };
+            if (timeout > 0.0)
+            {
+                _wakeup.wait_for(lock, std::chrono::microseconds(timeout.asMicroSeconds()), isReady);
+            }
+            else
+            {
+                _wakeup.wait(lock, isReady);
+            }
+            _sleeping--;
+        }
+        if (IRunnable *task = take())
+        {
+            task->run();
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<IRunnable *> tasks[PRIORITY_COUNT];
+    };
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(Scheduler &scheduler, int index) : _scheduler(scheduler), _index(index) {}
+        void run() override { _scheduler.runWorker(_index); }
+
+    private:
+        Scheduler &_scheduler;
+        int _index;
+    };
+
+    static IRunnable *popBack(Queue &queue, int priority)
+    {
+        std::lock_guard<std::mutex> g(queue.mutex);
+        auto &tasks = queue.tasks[priority];
+        if (tasks.empty()) return nullptr;
+        IRunnable *task = tasks.back();
+        tasks.pop_back();
+        return task;
     }
-    return s_pool;
+
+    static IRunnable *popFront(Queue &queue, int priority)
+    {
+        std::lock_guard<std::mutex> g(queue.mutex);
+        auto &tasks = queue.tasks[priority];
+        if (tasks.empty()) return nullptr;
+        IRunnable *task = tasks.front();
+        tasks.pop_front();
+        return task;
+    }
+
+    IRunnable *take()
+    {
+        if (_pending <= 0) return nullptr;
+
+        const int self  = (isWorkerThread()? t_worker : -1);
+        const int count = workerCount();
+
+        for (int priority = PRIORITY_COUNT - 1; priority >= 0; --priority)
+        {
+            IRunnable *task = nullptr;
+            if (self >= 0)
+            {
+                task = popBack(*_queues[self], priority);
+            }
+            if (!task)
+            {
+                task = popFront(_shared, priority);
+            }
+            // Steal from the other workers.
+            for (int i = 1; !task && i <= count; ++i)
+            {
+                const int victim = (self + i) % count;
+                if (victim != self)
+                {
+                    task = popFront(*_queues[victim], priority);
+                }
+            }
+            if (task)
+            {
+                _pending--;
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void runWorker(int index)
+    {
+        t_scheduler = this;
+        t_worker    = index;
+        for (;;)
+        {
+            if (IRunnable *task = take())
+            {
+                task->run();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            if (_stopping && _pending <= 0) break;
+            _sleeping++;
+            _wakeup.wait(lock, [this] () { return _pending > 0 || _stopping; });
+            _sleeping--;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>>  _queues; ///< Worker-specific queues.
+    Queue                                _shared; ///< Tasks started in other threads.
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic_int                      _pending{0};  ///< Number of queued tasks.
+    std::atomic_int                      _sleeping{0}; ///< Number of waiting threads.
+    std::mutex                           _sleepMutex;
+    std::condition_variable              _wakeup;
+    bool                                 _stopping = false;
+
+    static thread_local Scheduler *t_scheduler;
+    static thread_local int        t_worker;
+};
+
+thread_local Scheduler *Scheduler::t_scheduler = nullptr;
+thread_local int        Scheduler::t_worker    = -1;
+
+static std::mutex s_schedulerMutex;
+static Scheduler *s_scheduler = nullptr;
+
+static Scheduler &scheduler()
+{
+    std::lock_guard<std::mutex> g(s_schedulerMutex);
+    if (!s_scheduler)
+    {
+        s_scheduler = new Scheduler;
+    }
+    return *s_scheduler;
 }
 
 static void deleteThreadPool()
 {
-    if (s_pool)
+    Scheduler *sched;
+    {
+        std::lock_guard<std::mutex> g(s_schedulerMutex);
+        sched = s_scheduler;
+    }
+    // Tasks still running may use the scheduler while it is being shut down.
+    delete sched;
     {
-        iRelease(s_pool);
+        std::lock_guard<std::mutex> g(s_schedulerMutex);
+        s_scheduler = nullptr;
     }
 }
 
+/**
+ * State of a parallelFor() loop. Shared by the calling thread and the helper
+ * tasks, some of which may start only after the loop has been completed.
+ */
+struct ParallelLoop
+{
+    const TaskPool::RangeFunction &func;
+    dsize begin;
+    dsize end;
+    dsize grain;
+    dsize chunkCount;
+    std::atomic<dsize> nextChunk{0};
+    std::atomic<dsize> remaining;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+
+    ParallelLoop(const TaskPool::RangeFunction &func, dsize begin, dsize end, dsize grain)
+        : func(func), begin(begin), end(end), grain(grain)
+        , chunkCount((end - begin + grain - 1) / grain)
+        , remaining(chunkCount)
+    {}
+
+    /// Processes chunks until all of them have been claimed.
+    void run()
+    {
+        for (dsize chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+        {
+            const dsize first = begin + chunk * grain;
+            try
+            {
+                func(first, de::min(first + grain, end));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> g(mutex);
+                if (!error) error = std::current_exception();
+            }
+            if (--remaining == 0)
+            {
+                std::lock_guard<std::mutex> g(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] () { return remaining == 0; });
+    }
+};
+
+class ParallelLoopTask : public IRunnable
+{
+    std::shared_ptr<ParallelLoop> _loop;
+
+public:
+    ParallelLoopTask(const std::shared_ptr<ParallelLoop> &loop) : _loop(loop) {}
+
+    void run() override
+    {
+        _loop->run();
+        delete this;
+    }
+};
+
 class CallbackTask : public Task
 {
     TaskPool::TaskFunction _func;
@@ -225,23 +522,10 @@ TaskPool::~TaskPool()
     }
 }
 
-static iThreadResult runTask(iThread *thd)
-{
-    Task *task = static_cast<Task *>(userData_Thread(thd));
-    task->run();
-    iRelease(thd);
-    return 0;
-}
-
 void TaskPool::start(Task *task, Priority priority)
 {
     d->add(task);
-
-    iThread *thd = new_Thread(runTask);
-    setUserData_Thread(thd, task);
-    run_ThreadPool(internal::globalThreadPool(), thd);
-
-    DE_UNUSED(priority);
+    internal::scheduler().submit(task, priority);
 }
 
 void TaskPool::start(TaskFunction taskFunction, Priority priority)
@@ -251,31 +535,20 @@ void TaskPool::start(TaskFunction taskFunction, Priority priority)
 
 void TaskPool::waitForDone()
 {
-    bool allowSleep = true;
-
-    if (const iThread *cur = current_Thread())
+    if (internal::scheduler().isWorkerThread())
     {
-        if (!cmp_String(name_Thread(cur), "PooledThread"))
+        // Pooled threads cannot sleep or otherwise the thread pool would likely
+        // block, if too many / all workers are sleeping. Run other tasks meanwhile.
+        while (!isDone())
         {
-            // Pooled threads cannot sleep or otherwise the thread pool would likely
-            // block, if too many / all workers are sleeping.
-            allowSleep = false;
+            yield(1_ms);
         }
     }
-
-    if (allowSleep)
+    else
     {
         // This thread will block here until tasks are complete.
         d->waitForEmpty();
     }
-    else
-    {
-        // Allow the thread pool to execute other tasks.
-        while (!isDone())
-        {
-            yield(100_ms);
-        }
-    }
 }
 
 bool TaskPool::isDone() const
@@ -290,7 +563,49 @@ void TaskPool::deleteThreadPool() // static
 
 void TaskPool::yield(const TimeSpan timeout) // static
 {
-    yield_ThreadPool(internal::globalThreadPool(), timeout);
+    internal::scheduler().help(timeout);
+}
+
+void TaskPool::parallelFor(dsize begin, dsize end, const RangeFunction &func,
+                           dsize grainSize) // static
+{
+    if (end <= begin) return;
+
+    const dsize grain = chunkSize(end - begin, grainSize);
+    if (end - begin <= grain)
+    {
+        func(begin, end);
+        return;
+    }
+
+    auto &sched = internal::scheduler();
+    std::shared_ptr<internal::ParallelLoop> loop(new internal::ParallelLoop(func, begin, end, grain));
+
+    // The calling thread processes chunks, too.
+    const dsize helpers = de::min(loop->chunkCount - 1, dsize(sched.workerCount()));
+    for (dsize i = 0; i < helpers; ++i)
+    {
+        sched.submit(new internal::ParallelLoopTask(loop), HighPriority);
+    }
+    loop->run();
+    loop->wait();
+
+    if (loop->error)
+    {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+dsize TaskPool::chunkSize(dsize count, dsize grainSize) // static
+{
+    if (grainSize) return grainSize;
+    // A few chunks per thread evens out differences in the chunks' durations.
+    return de::max(dsize(1), count / (4 * dsize(workerCount() + 1)));
+}
+
+int TaskPool::workerCount() // static
+{
+    return internal::scheduler().workerCount();
 }
 
 void TaskPool::async(const std::function<Variant()> &work,
@@ -413,6 +413,12 @@ App::App(const StringList &args)
         d->logBuffer.enableFlushing(true);
     }
 
+    if (d->cmdLine.has("-nobytecode"))
+    {
+        // Scripts are evaluated by traversing the expression trees.
+        Bytecode::setEnabled(false);
+    }
+
     // The log filter will be read from Config, but until that time we can use
     // the options from the command line.
     d->setLogLevelAccordingToOptions();
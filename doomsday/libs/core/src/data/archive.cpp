@@ -17,6 +17,10 @@
  */
 
 #include "de/archive.h"
+#include "de/logbuffer.h"
+#include "de/taskpool.h"
+
+#include <atomic>
 
 namespace de {
 
@@ -212,6 +216,98 @@ Block &Archive::entryBlock(const Path &path)
     return const_cast<Block &>(block);
 }
 
+void Archive::prefetch(const List<Path> &paths) const
+{
+    DE_ASSERT(d->index != 0);
+
+    // Entries are deserialized in batches of roughly this many bytes, so that
+    // each task has enough work to be worth the overhead.
+    static const dsize BATCH_SIZE = 1024 * 1024;
+
+    struct Job
+    {
+        Entry *entry;
+        const Path *path;
+        bool   readForJob; ///< Serialized data was read only for deserializing.
+        std::unique_ptr<Block> data;
+    };
+    List<Job> jobs;
+    jobs.reserve(paths.size());
+
+    // Reading from the source is not thread-safe, so the serialized data is
+    // copied beforehand.
+    for (const Path &path : paths)
+    {
+        auto *entry = static_cast<Entry *>(d->index->tryFind(path, PathTree::MatchFull | PathTree::NoBranch));
+        if (!entry || entry->data) continue;
+
+        Job job{entry, &path, false, nullptr};
+        if (entry->size && !entry->dataInArchive)
+        {
+            if (!d->source) continue;
+            entry->dataInArchive.reset(new Block(*d->source, entry->offset, entry->sizeInArchive));
+            job.readForJob = true;
+        }
+        jobs.push_back(std::move(job));
+    }
+    if (jobs.empty()) return;
+
+    std::atomic_int failures(0);
+    {
+        TaskPool tasks;
+        for (dsize first = 0; first < jobs.size(); )
+        {
+            // Gather a batch.
+            dsize last = first;
+            for (dsize bytes = 0; last < jobs.size() && bytes < BATCH_SIZE; ++last)
+            {
+                bytes += jobs[last].entry->size;
+            }
+            tasks.start([this, &jobs, &failures, first, last] ()
+            {
+                for (dsize i = first; i < last; ++i)
+                {
+                    Job &job = jobs[i];
+                    try
+                    {
+                        job.data.reset(new Block);
+                        if (job.entry->size)
+                        {
+                            readFromSource(*job.entry, *job.path, *job.data);
+                        }
+                    }
+                    catch (const Error &)
+                    {
+                        job.data.reset();
+                        failures++;
+                    }
+                }
+            }, TaskPool::HighPriority);
+            first = last;
+        }
+        tasks.waitForDone();
+    }
+
+    for (Job &job : jobs)
+    {
+        if (job.data)
+        {
+            job.entry->data.reset(job.data.release());
+        }
+        if (job.readForJob)
+        {
+            // The source still has the serialized data.
+            job.entry->dataInArchive.reset();
+        }
+    }
+
+    if (failures)
+    {
+        LOG_AS("Archive");
+        LOGDEV_RES_WARNING("Failed to prefetch %i of %i entries") << int(failures) << jobs.size();
+    }
+}
+
 void Archive::uncacheBlock(const Path &path) const
 {
     if (!d->source) return; // Wouldn't be able to re-cache the data.
@@ -0,0 +1,285 @@
+/** @file deflatedictionary.cpp  Preset dictionary for deflating short messages.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/deflatedictionary.h"
+#include "de/lockable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <zlib.h>
+
+namespace de {
+
+namespace internal {
+
+typedef std::unordered_map<duint32, std::unique_ptr<DeflateDictionary>> Dictionaries;
+
+static LockableT<Dictionaries> &registeredDictionaries()
+{
+    static LockableT<Dictionaries> dicts;
+    return dicts;
+}
+
+/// Length of the substrings whose frequencies are counted when training.
+static const dsize TRAIN_DMER_LENGTH = 8;
+
+/// Length of the segments a trained dictionary is composed of.
+static const dsize TRAIN_SEGMENT_LENGTH = 64;
+
+static inline duint64 dmerAt(const dbyte *ptr)
+{
+    duint64 dmer;
+    std::memcpy(&dmer, ptr, sizeof(dmer));
+    return dmer;
+}
+
+} // namespace internal
+
+DeflateDictionary::DeflateDictionary(const Block &data)
+    : _data(data)
+{
+    _id = duint32(adler32(adler32(0, Z_NULL, 0), _data.cdata(), uInt(_data.size())));
+}
+
+Block DeflateDictionary::compress(const Block &data, int level) const
+{
+    z_stream stream = {};
+    if (deflateInit(&stream, level) != Z_OK)
+    {
+        return {};
+    }
+    if (!_data.isEmpty())
+    {
+        deflateSetDictionary(&stream, _data.cdata(), uInt(_data.size()));
+    }
+
+    Block result(deflateBound(&stream, uLong(data.size())));
+    stream.next_in   = const_cast<Block::Byte *>(data.cdata());
+    stream.avail_in  = uInt(data.size());
+    stream.next_out  = result.data();
+    stream.avail_out = uInt(result.size());
+
+    const int res = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+
+    if (res != Z_STREAM_END)
+    {
+        return {};
+    }
+    result.resize(stream.total_out);
+    return result;
+}
+
+Block DeflateDictionary::decompress(const Block &deflated)
+{
+    Block result(de::max(dsize(1024), deflated.size() * 4));
+
+    z_stream stream = {};
+    stream.next_in   = const_cast<Block::Byte *>(deflated.cdata());
+    stream.avail_in  = uInt(deflated.size());
+    stream.next_out  = result.data();
+    stream.avail_out = uInt(result.size());
+
+    if (inflateInit(&stream) != Z_OK)
+    {
+        return {};
+    }
+
+    int res = 0;
+    do
+    {
+        res = inflate(&stream, 0);
+        switch (res)
+        {
+        case Z_OK:
+            // Allocate more output space, if needed.
+            if (stream.avail_out == 0)
+            {
+                const auto oldSize = result.size();
+                result.resize(result.size() * 2);
+                stream.next_out  = result.data() + oldSize;
+                stream.avail_out = uInt(result.size() - oldSize);
+            }
+            continue;
+
+        case Z_NEED_DICT:
+            // The stream header tells which dictionary was used.
+            if (const DeflateDictionary *dict = find(duint32(stream.adler)))
+            {
+                if (inflateSetDictionary(&stream, dict->_data.cdata(),
+                                         uInt(dict->_data.size())) == Z_OK)
+                {
+                    continue;
+                }
+            }
+            inflateEnd(&stream);
+            return {};
+
+        case Z_STREAM_END:
+            break;
+
+        default:
+            inflateEnd(&stream);
+            return {};
+        }
+    }
+    while (res != Z_STREAM_END);
+
+    // Truncate the extra space.
+    result.resize(result.size() - stream.avail_out);
+
+    inflateEnd(&stream);
+    return result;
+}
+
+bool DeflateDictionary::needsDictionary(const Block &deflated)
+{
+    if (deflated.size() < 6) return false;
+
+    // Check the zlib stream header (RFC 1950): the compression method must be
+    // deflate, the header must have a valid check value, and the FDICT flag
+    // must be set.
+    const duint cmf = deflated.at(0);
+    const duint flg = deflated.at(1);
+    return (cmf & 0x0f) == Z_DEFLATED && ((cmf << 8) | flg) % 31 == 0 && (flg & 0x20);
+}
+
+const DeflateDictionary &DeflateDictionary::registerDictionary(const DeflateDictionary &dictionary)
+{
+    auto &dicts = internal::registeredDictionaries();
+    DE_GUARD(dicts);
+    auto found = dicts.value.find(dictionary.id());
+    if (found != dicts.value.end())
+    {
+        return *found->second;
+    }
+    auto *dict = new DeflateDictionary(dictionary);
+    dicts.value[dict->id()].reset(dict);
+    return *dict;
+}
+
+const DeflateDictionary *DeflateDictionary::find(duint32 id)
+{
+    auto &dicts = internal::registeredDictionaries();
+    DE_GUARD(dicts);
+    auto found = dicts.value.find(id);
+    if (found != dicts.value.end())
+    {
+        return found->second.get();
+    }
+    return nullptr;
+}
+
+DeflateDictionary DeflateDictionary::train(const List<Block> &samples, dsize maxSize)
+{
+    struct Frequency
+    {
+        duint32 count      = 0; ///< Number of samples where the substring occurs.
+        duint32 lastSample = 0; ///< Sample number plus one.
+    };
+    std::unordered_map<duint64, Frequency> freqs;
+
+    // Substrings that occur in many different samples are worth including.
+    Block all;
+    for (dsize i = 0; i < samples.size(); ++i)
+    {
+        const Block &sample = samples[i];
+        for (dsize pos = 0; pos + internal::TRAIN_DMER_LENGTH <= sample.size(); ++pos)
+        {
+            Frequency &freq = freqs[internal::dmerAt(sample.cdata() + pos)];
+            if (freq.lastSample != i + 1)
+            {
+                freq.count++;
+                freq.lastSample = duint32(i + 1);
+            }
+        }
+        all += sample;
+    }
+    if (all.size() < internal::TRAIN_SEGMENT_LENGTH)
+    {
+        return DeflateDictionary(all);
+    }
+
+    auto frequencyAt = [&freqs, &all] (dsize pos) -> duint32 {
+        if (pos + internal::TRAIN_DMER_LENGTH > all.size()) return 0;
+        auto found = freqs.find(internal::dmerAt(all.cdata() + pos));
+        return found != freqs.end()? found->second.count : 0;
+    };
+
+    // The samples are divided into epochs, and the best segment of each epoch is
+    // chosen. The substrings of a chosen segment are not counted again.
+    struct Segment
+    {
+        dsize   pos;
+        duint64 score;
+    };
+    List<Segment> chosen;
+    const dsize segmentCount = de::max(dsize(1), maxSize / internal::TRAIN_SEGMENT_LENGTH);
+    const dsize epochSize    = de::max(internal::TRAIN_SEGMENT_LENGTH, all.size() / segmentCount);
+    const dsize window       = internal::TRAIN_SEGMENT_LENGTH - internal::TRAIN_DMER_LENGTH + 1;
+
+    for (dsize epoch = 0; epoch + internal::TRAIN_SEGMENT_LENGTH <= all.size(); epoch += epochSize)
+    {
+        const dsize last = de::min(epoch + epochSize, all.size()) - internal::TRAIN_SEGMENT_LENGTH;
+
+        // Slide the segment window over the epoch.
+        duint64 score = 0;
+        for (dsize i = 0; i < window; ++i)
+        {
+            score += frequencyAt(epoch + i);
+        }
+        Segment best{epoch, score};
+        for (dsize pos = epoch + 1; pos <= last; ++pos)
+        {
+            score += frequencyAt(pos + window - 1);
+            score -= frequencyAt(pos - 1);
+            if (score > best.score)
+            {
+                best = Segment{pos, score};
+            }
+        }
+        if (!best.score) continue;
+
+        chosen << best;
+        for (dsize i = 0; i < window; ++i)
+        {
+            auto found = freqs.find(internal::dmerAt(all.cdata() + best.pos + i));
+            if (found != freqs.end()) found->second.count = 0;
+        }
+    }
+
+    // The most valuable segments go to the end of the dictionary, closest to the
+    // compressed data.
+    std::sort(chosen.begin(), chosen.end(), [] (const Segment &a, const Segment &b) {
+        return a.score > b.score;
+    });
+    if (chosen.size() > segmentCount)
+    {
+        chosen.resize(segmentCount);
+    }
+    Block dict;
+    for (auto i = chosen.rbegin(); i != chosen.rend(); ++i)
+    {
+        dict += all.mid(i->pos, internal::TRAIN_SEGMENT_LENGTH);
+    }
+    return DeflateDictionary(dict);
+}
+
+} // namespace de
@@ -59,14 +59,22 @@ const char *Record::VAR_NATIVE_SELF = "__self__";
  */
 static std::atomic_uint recordIdCounter;
 
+/// Layout versions are drawn from a single counter so they are unique among all records.
+static std::atomic<duint64> recordLayoutCounter;
+
+static std::atomic<duint64> superRecordDeletionCounter;
+
 DE_PIMPL(Record)
 , public Lockable
 , DE_OBSERVES(Variable, Deletion)
+, DE_OBSERVES(Variable, Change)
 {
     Record::Members members;
     duint32 uniqueId; ///< Identifier to track serialized references.
     duint32 oldUniqueId;
     Flags flags = DefaultFlags;
+    std::atomic<duint64> layoutVersion;
+    std::atomic<bool> isSuperRecord{false};
 
     using RefMap = Hash<duint32, Record *>;
 
@@ -74,8 +82,28 @@ DE_PIMPL(Record)
         : Base(r)
         , uniqueId(++recordIdCounter)
         , oldUniqueId(0)
+        , layoutVersion(++recordLayoutCounter)
     {}
 
+    void layoutChanged()
+    {
+        layoutVersion = ++recordLayoutCounter;
+    }
+
+    /**
+     * Starts observing a variable that has been added as a member.
+     */
+    void memberAdded(Variable &var)
+    {
+        var.audienceForDeletion() += this;
+        if (var.name() == VAR_SUPER)
+        {
+            // The super-records determine which inherited members are found.
+            var.audienceForChange() += this;
+        }
+        layoutChanged();
+    }
+
     struct ExcludeByBehavior {
         Behavior behavior;
         ExcludeByBehavior(Behavior b) : behavior(b) {}
@@ -113,6 +141,7 @@ DE_PIMPL(Record)
                 delete i.second;
             }
             members = std::move(remaining);
+            layoutChanged();
         }
     }
 
@@ -133,7 +162,7 @@ DE_PIMPL(Record)
                 {
                     DE_GUARD(this);
                     var = new Variable(*i_value);
-                    var->audienceForDeletion() += this;
+                    memberAdded(*var);
                     auto iter = members.find(i_key);
                     alreadyExists = (iter != members.end());
                     if (alreadyExists)
@@ -207,7 +236,7 @@ DE_PIMPL(Record)
                     // Add a new one.
                     DE_GUARD(this);
                     var = new Variable(*i->second);
-                    var->audienceForDeletion() += this;
+                    memberAdded(*var);
                     members[i->first] = var;
                 }
             }
@@ -215,16 +244,19 @@ DE_PIMPL(Record)
 
         // Remove variables not present in the other.
         DE_GUARD(this);
-        MutableHashIterator<String, Variable *> iter(members);
-        while (iter.hasNext())
+        for (auto iter = members.begin(); iter != members.end(); )
         {
-            iter.next();
-            if (!excluded(*iter.value()) && !other.hasMember(iter.key()))
+            if (!excluded(*iter->second) && !other.hasMember(iter->first))
             {
-                Variable *var = iter.value();
-                iter.remove();
+                Variable *var = iter->second;
+                iter = members.erase(iter);
                 var->audienceForDeletion() -= this;
                 delete var;
+                layoutChanged();
+            }
+            else
+            {
+                ++iter;
             }
         }
     }
@@ -344,6 +376,13 @@ DE_PIMPL(Record)
         // Remove from our index.
         DE_GUARD(this);
         members.remove(variable.name());
+        layoutChanged();
+    }
+
+    // Observes changes to the value of the super-records variable.
+    void variableValueChanged(Variable &, const Value &)
+    {
+        layoutChanged();
     }
 
     static String memberNameFromPath(const String &path)
@@ -428,6 +467,11 @@ Record::~Record()
         DE_NOTIFY(Deletion, i) i->recordBeingDeleted(*this);
 
         clear();
+
+        if (d->isSuperRecord)
+        {
+            ++superRecordDeletionCounter;
+        }
     }
 }
 
@@ -528,7 +572,7 @@ Variable &Record::add(Variable *variable)
             // Delete the previous variable with this name.
             delete d->members[variable->name()];
         }
-        var->audienceForDeletion() += d;
+        d->memberAdded(*var);
         d->members[variable->name()] = var.release();
     }
 
@@ -542,7 +586,9 @@ Variable *Record::remove(Variable &variable)
     {
         DE_GUARD(d);
         variable.audienceForDeletion() -= d;
+        variable.audienceForChange() -= d;
         d->members.remove(variable.name());
+        d->layoutChanged();
     }
 
     DE_NOTIFY(Removal, i) i->recordMemberRemoved(*this, variable);
@@ -1006,6 +1052,21 @@ bool Record::anyMembersChanged() const
     return false;
 }
 
+duint64 Record::layoutVersion() const
+{
+    return d->layoutVersion.load(std::memory_order_relaxed);
+}
+
+void Record::markAsSuperRecord() const
+{
+    d->isSuperRecord = true;
+}
+
+duint64 Record::superRecordEpoch() // static
+{
+    return superRecordDeletionCounter.load(std::memory_order_relaxed);
+}
+
 void Record::markAllMembersUnchanged()
 {
     DE_GUARD(d);
@@ -1136,6 +1197,7 @@ void Record::addSuperRecord(Value *superValue)
         addArray(VAR_SUPER);
     }
     (*this)[VAR_SUPER].array().add(superValue);
+    d->layoutChanged();
 }
 
 void Record::addSuperRecord(const Record &superRecord)
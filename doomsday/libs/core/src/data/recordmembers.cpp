@@ -0,0 +1,337 @@
+/*
+ * The Doomsday Engine Project -- libcore
+ *
+ * Copyright © 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/recordmembers.h"
+
+#include <cstring>
+#include <new>
+
+namespace de {
+
+/// Tables larger than this have an index; smaller ones are searched linearly.
+static const duint32 MEMBERS_LINEAR_SEARCH_LIMIT = 8;
+
+RecordMembers::RecordMembers()
+{
+    resetToInline();
+}
+
+RecordMembers::RecordMembers(const RecordMembers &other)
+{
+    resetToInline();
+    *this = other;
+}
+
+RecordMembers::RecordMembers(RecordMembers &&moved)
+{
+    resetToInline();
+    *this = std::move(moved);
+}
+
+RecordMembers::~RecordMembers()
+{
+    release();
+}
+
+RecordMembers &RecordMembers::operator=(const RecordMembers &other)
+{
+    if (this != &other)
+    {
+        clear();
+        for (duint32 i = 0; i < other._size; ++i)
+        {
+            append(other._entries[i].first, other._entries[i].second, other._hashes[i]);
+        }
+    }
+    return *this;
+}
+
+RecordMembers &RecordMembers::operator=(RecordMembers &&moved)
+{
+    if (this != &moved)
+    {
+        clear();
+        if (moved._entries != reinterpret_cast<value_type *>(moved._inlineEntries))
+        {
+            // Take over the allocated table.
+            _entries  = moved._entries;
+            _hashes   = moved._hashes;
+            _index    = moved._index;
+            _size     = moved._size;
+            _capacity = moved._capacity;
+            moved.resetToInline();
+        }
+        else
+        {
+            for (duint32 i = 0; i < moved._size; ++i)
+            {
+                new (&_entries[i]) value_type(std::move(moved._entries[i]));
+                _hashes[i] = moved._hashes[i];
+            }
+            _size = moved._size;
+            moved.clear();
+        }
+    }
+    return *this;
+}
+
+RecordMembers::iterator RecordMembers::find(const String &key)
+{
+    return _entries + findPos(key, hashKey(key));
+}
+
+RecordMembers::const_iterator RecordMembers::find(const String &key) const
+{
+    return _entries + findPos(key, hashKey(key));
+}
+
+bool RecordMembers::contains(const String &key) const
+{
+    return findPos(key, hashKey(key)) < _size;
+}
+
+RecordMembers::iterator RecordMembers::insert(const String &key, Variable *value)
+{
+    const duint32 hash = hashKey(key);
+    const duint32 pos  = findPos(key, hash);
+    if (pos < _size)
+    {
+        _entries[pos].second = value;
+        return _entries + pos;
+    }
+    append(key, value, hash);
+    return _entries + _size - 1;
+}
+
+Variable *&RecordMembers::operator[](const String &key)
+{
+    const duint32 hash = hashKey(key);
+    const duint32 pos  = findPos(key, hash);
+    if (pos < _size)
+    {
+        return _entries[pos].second;
+    }
+    append(key, nullptr, hash);
+    return _entries[_size - 1].second;
+}
+
+Variable *RecordMembers::operator[](const String &key) const
+{
+    const_iterator found = find(key);
+    DE_ASSERT(found != end());
+    return found->second;
+}
+
+RecordMembers::iterator RecordMembers::erase(const_iterator pos)
+{
+    const duint32 removed = duint32(pos - _entries);
+    const duint32 last    = _size - 1;
+    DE_ASSERT(removed < _size);
+
+    if (_index)
+    {
+        removeFromIndex(indexSlotOf(removed));
+    }
+    if (removed != last)
+    {
+        // The last member fills the gap.
+        _entries[removed] = std::move(_entries[last]);
+        _hashes[removed]  = _hashes[last];
+        if (_index)
+        {
+            _index[indexSlotOf(last)] = removed + 1;
+        }
+    }
+    _entries[last].~value_type();
+    _size = last;
+    return _entries + removed;
+}
+
+void RecordMembers::remove(const String &key)
+{
+    const duint32 pos = findPos(key, hashKey(key));
+    if (pos < _size)
+    {
+        erase(_entries + pos);
+    }
+}
+
+void RecordMembers::clear()
+{
+    release();
+    resetToInline();
+}
+
+StringList RecordMembers::keys() const
+{
+    StringList names;
+    for (const auto &i : *this)
+    {
+        names << i.first;
+    }
+    return names;
+}
+
+duint32 RecordMembers::hashKey(const String &key) // static
+{
+    // FNV-1a.
+    duint32 hash = 2166136261u;
+    for (const char *c = key.data(), *end = c + key.size(); c != end; ++c)
+    {
+        hash = (hash ^ dbyte(*c)) * 16777619u;
+    }
+    return hash;
+}
+
+duint32 RecordMembers::findPos(const String &key, duint32 hash) const
+{
+    if (!_index)
+    {
+        for (duint32 i = 0; i < _size; ++i)
+        {
+            if (_hashes[i] == hash && _entries[i].first == key) return i;
+        }
+        return _size;
+    }
+    const duint32 mask = indexSize() - 1;
+    for (duint32 slot = hash & mask; _index[slot]; slot = (slot + 1) & mask)
+    {
+        const duint32 pos = _index[slot] - 1;
+        if (_hashes[pos] == hash && _entries[pos].first == key) return pos;
+    }
+    return _size;
+}
+
+void RecordMembers::append(const String &key, Variable *value, duint32 hash)
+{
+    if (_size == _capacity) grow();
+
+    new (&_entries[_size]) value_type(key, value);
+    _hashes[_size] = hash;
+    if (_index) addToIndex(_size);
+    _size++;
+}
+
+void RecordMembers::grow()
+{
+    const duint32 capacity = de::max(_capacity * 2, MEMBERS_LINEAR_SEARCH_LIMIT);
+    const bool    indexed  = capacity > MEMBERS_LINEAR_SEARCH_LIMIT;
+
+    // Members, hashes, and the index share one allocation.
+    dbyte *block = static_cast<dbyte *>(::operator new(
+        capacity * (sizeof(value_type) + sizeof(duint32)) +
+        (indexed? 2 * capacity * sizeof(duint32) : 0)));
+
+    auto *entries = reinterpret_cast<value_type *>(block);
+    auto *hashes  = reinterpret_cast<duint32 *>(block + capacity * sizeof(value_type));
+    for (duint32 i = 0; i < _size; ++i)
+    {
+        new (&entries[i]) value_type(std::move(_entries[i]));
+        _entries[i].~value_type();
+        hashes[i] = _hashes[i];
+    }
+    const duint32 size = _size;
+    _size = 0; // already destroyed
+    release();
+
+    _entries  = entries;
+    _hashes   = hashes;
+    _capacity = capacity;
+    _size     = size;
+    _index    = nullptr;
+    if (indexed)
+    {
+        _index = hashes + capacity;
+        std::memset(_index, 0, indexSize() * sizeof(duint32));
+        for (duint32 i = 0; i < _size; ++i)
+        {
+            addToIndex(i);
+        }
+    }
+}
+
+void RecordMembers::release()
+{
+    for (duint32 i = 0; i < _size; ++i)
+    {
+        _entries[i].~value_type();
+    }
+    _size = 0;
+    if (_entries != reinterpret_cast<value_type *>(_inlineEntries))
+    {
+        ::operator delete(_entries);
+    }
+}
+
+void RecordMembers::resetToInline()
+{
+    _entries  = reinterpret_cast<value_type *>(_inlineEntries);
+    _hashes   = _inlineHashes;
+    _index    = nullptr;
+    _size     = 0;
+    _capacity = INLINE_CAPACITY;
+}
+
+duint32 RecordMembers::indexSlotOf(duint32 pos) const
+{
+    const duint32 mask = indexSize() - 1;
+    duint32 slot = _hashes[pos] & mask;
+    while (_index[slot] != pos + 1)
+    {
+        DE_ASSERT(_index[slot] != 0);
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void RecordMembers::addToIndex(duint32 pos)
+{
+    const duint32 mask = indexSize() - 1;
+    duint32 slot = _hashes[pos] & mask;
+    while (_index[slot])
+    {
+        slot = (slot + 1) & mask;
+    }
+    _index[slot] = pos + 1;
+}
+
+void RecordMembers::removeFromIndex(duint32 slot)
+{
+    // Shift back the following slots of the probe sequence so that lookups do not
+    // stop at the removed slot.
+    const duint32 mask = indexSize() - 1;
+    duint32 next = slot;
+    for (;;)
+    {
+        next = (next + 1) & mask;
+        if (!_index[next]) break;
+
+        const duint32 home = _hashes[_index[next] - 1] & mask;
+        const bool staysInPlace = (slot <= next ? (slot < home && home <= next)
+                                                : (slot < home || home <= next));
+        if (!staysInPlace)
+        {
+            _index[slot] = _index[next];
+            slot = next;
+        }
+    }
+    _index[slot] = 0;
+}
+
+} // namespace de
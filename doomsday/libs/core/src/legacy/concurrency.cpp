@@ -223,6 +223,13 @@ void Sys_Lock(mutex_t handle)
     }
 }
 
+dd_bool Sys_TryLock(mutex_t handle)
+{
+    auto *m = reinterpret_cast<std::recursive_mutex *>(handle);
+    DE_ASSERT(m != nullptr);
+    return m && m->try_lock();
+}
+
 void Sys_Unlock(mutex_t handle)
 {
     auto *m = reinterpret_cast<std::recursive_mutex *>(handle);
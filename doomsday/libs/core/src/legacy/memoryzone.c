@@ -31,6 +31,21 @@
  * all of them efficiently. This is possible because no block inside the
  * sequence could be purged by Z_Malloc() anyway.
  *
+ * @par Thread Arenas
+ * Small allocations with the PU_APPSTATIC, PU_GAMESTATIC, and PU_MAP tags are
+ * served from arenas instead of the volumes, so that threads do not have to
+ * contend for the zone lock and walk the rovers for each of them. Each thread
+ * is assigned one of a fixed number of arenas on its first allocation. An arena
+ * has a separate lock, and it carves blocks of a few size classes out of
+ * chunks that are themselves blocks in a volume. Freed arena blocks are kept
+ * in per-size-class free lists, and a chunk is returned to the zone when all
+ * its blocks have been freed. Arena blocks have regular block headers, so they
+ * can be used with all the Z_* functions; Z_FreeTags() frees the ones in the
+ * tag range like any other block. Arena blocks are never purged by the rover,
+ * though, even if their tag is changed to a purgable level.
+ *
+ * To avoid deadlocks, the zone is never locked while holding an arena lock.
+ *
  * @author Copyright &copy; 1999-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
  * @author Copyright &copy; 2006-2013 Daniel Swanson <danij@dengine.net>
  * @author Copyright &copy; 2006 Jamie Jones <jamie_jones_au@yahoo.com.au>
@@ -69,6 +84,19 @@
 /// Special user pointer for blocks that are in use but have no single owner.
 #define MEMBLOCK_USER_ANONYMOUS    ((void *) 2)
 
+/// Special user pointer for volume blocks that are used as arena chunks.
+#define MEMBLOCK_USER_ARENA        ((void *) 3)
+
+#define ARENA_COUNT         8
+#define ARENA_CHUNK_SIZE    0x10000     // 64 KB
+#define ARENA_LANE_COUNT    3
+
+#if defined(_MSC_VER)
+#  define ZONE_THREAD_LOCAL __declspec(thread)
+#else
+#  define ZONE_THREAD_LOCAL __thread
+#endif
+
 // Used for block allocation of memory from the zone.
 typedef struct zblockset_block_s {
     /// Maximum number of elements.
@@ -84,18 +112,77 @@ typedef struct zblockset_block_s {
     void *elements;
 } zblockset_block_t;
 
+/// Payload sizes of the arena size classes. Larger allocations use the volumes.
+static const size_t arenaClassSizes[] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+#define ARENA_CLASS_COUNT   (sizeof(arenaClassSizes) / sizeof(arenaClassSizes[0]))
+
+/// Tags that are allocated from arenas. Each has its own lane in an arena.
+static const int arenaLaneTags[ARENA_LANE_COUNT] = { PU_APPSTATIC, PU_GAMESTATIC, PU_MAP };
+
+/**
+ * Arena chunk. Located in the beginning of a volume block, followed by the
+ * arena blocks carved out of it.
+ */
+typedef struct zonearenachunk_s {
+    struct zonearenalane_s *lane;
+    struct zonearenachunk_s *next, *prev;
+    byte *top; // Start of the unused space.
+    byte *end;
+    uint liveCount; // Number of allocated blocks in the chunk.
+} zonearenachunk_t;
+
+typedef struct zonearenalane_s {
+    struct zonearena_s *arena;
+    int tag;
+    zonearenachunk_t *chunks; // The first one is used for new blocks.
+    memblock_t *freeBlocks[ARENA_CLASS_COUNT]; // Linked via next/prev.
+} zonearenalane_t;
+
+typedef struct zonearena_s {
+    mutex_t mutex;
+    zonearenalane_t lanes[ARENA_LANE_COUNT];
+    uint chunkCount;
+    size_t usedBytes;
+    uint allocCount;
+    uint freeCount;
+    uint lockCount;
+    uint lockWaits; // Number of times the lock was held by another thread.
+} zonearena_t;
+
+/// Lock contention and allocation statistics of the volumes.
+typedef struct {
+    uint lockCount;
+    uint lockWaits; // Number of times the lock was held by another thread.
+    uint mallocCount;
+    uint64_t roverSteps; // Blocks checked while looking for free space.
+} zonestats_t;
+
 static memvolume_t *volumeRoot;
 static memvolume_t *volumeLast;
 
 static mutex_t zoneMutex = 0;
+static zonestats_t zoneStats;
+
+static zonearena_t arenas[ARENA_COUNT];
+static uint nextArena;
+static ZONE_THREAD_LOCAL zonearena_t *threadArena;
 
 static size_t Z_AllocatedMemory(void);
 static size_t allocatedMemoryInVolume(memvolume_t *volume);
+static void *zoneMalloc(size_t size, int tag, void *user);
 
 static __inline void lockZone(void)
 {
     assert(zoneMutex != 0);
-    Sys_Lock(zoneMutex);
+    if (!Sys_TryLock(zoneMutex))
+    {
+        Sys_Lock(zoneMutex);
+        zoneStats.lockWaits++;
+    }
+    zoneStats.lockCount++;
 }
 
 static __inline void unlockZone(void)
@@ -103,6 +190,308 @@ static __inline void unlockZone(void)
     Sys_Unlock(zoneMutex);
 }
 
+static __inline void lockArena(zonearena_t *arena)
+{
+    if (!Sys_TryLock(arena->mutex))
+    {
+        Sys_Lock(arena->mutex);
+        arena->lockWaits++;
+    }
+    arena->lockCount++;
+}
+
+static __inline void unlockArena(zonearena_t *arena)
+{
+    Sys_Unlock(arena->mutex);
+}
+
+static void initArenas(void)
+{
+    int i, k;
+    memset(arenas, 0, sizeof(arenas));
+    for (i = 0; i < ARENA_COUNT; ++i)
+    {
+        arenas[i].mutex = Sys_CreateMutex("ZONE_ARENA_MUTEX");
+        for (k = 0; k < ARENA_LANE_COUNT; ++k)
+        {
+            arenas[i].lanes[k].arena = &arenas[i];
+            arenas[i].lanes[k].tag = arenaLaneTags[k];
+        }
+    }
+}
+
+static void shutdownArenas(void)
+{
+    int i;
+    // The chunks are destroyed along with the volumes.
+    for (i = 0; i < ARENA_COUNT; ++i)
+    {
+        Sys_DestroyMutex(arenas[i].mutex);
+    }
+    memset(arenas, 0, sizeof(arenas));
+}
+
+/**
+ * Returns the arena of the calling thread. Threads are assigned to the arenas
+ * in round-robin fashion.
+ */
+static zonearena_t *currentArena(void)
+{
+    if (!threadArena)
+    {
+        lockZone();
+        threadArena = &arenas[nextArena++ % ARENA_COUNT];
+        unlockZone();
+    }
+    return threadArena;
+}
+
+static int arenaSizeClass(size_t size)
+{
+    int i;
+    for (i = 0; i < (int) ARENA_CLASS_COUNT; ++i)
+    {
+        if (size <= arenaClassSizes[i]) return i;
+    }
+    return -1;
+}
+
+static int arenaLane(int tag)
+{
+    int i;
+    for (i = 0; i < ARENA_LANE_COUNT; ++i)
+    {
+        if (arenaLaneTags[i] == tag) return i;
+    }
+    return -1;
+}
+
+static __inline byte *chunkBlocks(zonearenachunk_t *chunk)
+{
+    return (byte *) chunk + ALIGNED(sizeof(zonearenachunk_t));
+}
+
+static __inline memblock_t **freeListOf(zonearenalane_t *lane, memblock_t *block)
+{
+    return &lane->freeBlocks[arenaSizeClass(block->size - sizeof(memblock_t))];
+}
+
+static void pushFreeArenaBlock(memblock_t **list, memblock_t *block)
+{
+    block->prev = NULL;
+    block->next = *list;
+    if (*list) (*list)->prev = block;
+    *list = block;
+}
+
+static void unlinkFreeArenaBlock(memblock_t **list, memblock_t *block)
+{
+    if (block->prev) block->prev->next = block->next;
+    else *list = block->next;
+    if (block->next) block->next->prev = block->prev;
+    block->next = block->prev = NULL;
+}
+
+/**
+ * Removes the free blocks of an empty chunk from the free lists. The chunk is
+ * detached from its lane, unless new blocks are being allocated from it.
+ *
+ * @return The detached chunk that should be freed after the arena has been
+ * unlocked, or @c NULL.
+ */
+static zonearenachunk_t *releaseEmptyChunk(zonearenalane_t *lane, zonearenachunk_t *chunk)
+{
+    byte *pos;
+
+    DE_ASSERT(chunk->liveCount == 0);
+
+    for (pos = chunkBlocks(chunk); pos < chunk->top; pos += ((memblock_t *) pos)->size)
+    {
+        memblock_t *block = (memblock_t *) pos;
+        unlinkFreeArenaBlock(freeListOf(lane, block), block);
+    }
+
+    if (chunk == lane->chunks)
+    {
+        // Start over from the beginning of the chunk.
+        chunk->top = chunkBlocks(chunk);
+        return NULL;
+    }
+
+    if (chunk->prev) chunk->prev->next = chunk->next;
+    if (chunk->next) chunk->next->prev = chunk->prev;
+    chunk->next = chunk->prev = NULL;
+    lane->arena->chunkCount--;
+    return chunk;
+}
+
+/**
+ * Marks an arena block free. The arena must be locked.
+ *
+ * @return Chunk to be freed after the arena has been unlocked, or @c NULL.
+ */
+static zonearenachunk_t *freeArenaBlock(memblock_t *block)
+{
+    zonearenachunk_t *chunk = block->chunk;
+    zonearenalane_t *lane = chunk->lane;
+
+    if (block->user > (void **) 0x100) // Smaller values are not pointers.
+        *block->user = 0; // Clear the user's mark.
+    block->user = NULL; // Mark as free.
+    block->tag = 0;
+
+    pushFreeArenaBlock(freeListOf(lane, block), block);
+
+    lane->arena->usedBytes -= block->size;
+    lane->arena->freeCount++;
+
+    if (--chunk->liveCount == 0)
+    {
+        return releaseEmptyChunk(lane, chunk);
+    }
+    return NULL;
+}
+
+static void freeArenaChunks(zonearenachunk_t *chunks)
+{
+    while (chunks)
+    {
+        zonearenachunk_t *next = chunks->next;
+        Z_Free(chunks);
+        chunks = next;
+    }
+}
+
+/**
+ * Allocates a block from the calling thread's arena.
+ *
+ * @return Allocated memory, or @c NULL if the size or tag is not suitable for
+ * the arenas.
+ */
+static void *arenaMalloc(size_t size, int tag, void *user)
+{
+    const int cls = arenaSizeClass(size);
+    const int laneIndex = arenaLane(tag);
+    zonearena_t *arena;
+    zonearenalane_t *lane;
+    memblock_t *block;
+    size_t blockSize;
+
+    if (cls < 0 || laneIndex < 0) return NULL;
+
+    blockSize = sizeof(memblock_t) + arenaClassSizes[cls];
+    arena = currentArena();
+    lane = &arena->lanes[laneIndex];
+
+    lockArena(arena);
+    if (lane->freeBlocks[cls])
+    {
+        block = lane->freeBlocks[cls];
+        unlinkFreeArenaBlock(&lane->freeBlocks[cls], block);
+    }
+    else
+    {
+        zonearenachunk_t *chunk = lane->chunks;
+        if (!chunk || chunk->top + blockSize > chunk->end)
+        {
+            // A new chunk is needed. The zone must not be locked while
+            // holding the arena lock.
+            unlockArena(arena);
+            chunk = zoneMalloc(ARENA_CHUNK_SIZE, tag, MEMBLOCK_USER_ARENA);
+            lockArena(arena);
+
+            chunk->lane = lane;
+            chunk->top = chunkBlocks(chunk);
+            chunk->end = (byte *) chunk + ARENA_CHUNK_SIZE;
+            chunk->liveCount = 0;
+            chunk->prev = NULL;
+            chunk->next = lane->chunks;
+            if (lane->chunks) lane->chunks->prev = chunk;
+            lane->chunks = chunk;
+            arena->chunkCount++;
+        }
+        block = (memblock_t *) chunk->top;
+        chunk->top += blockSize;
+        block->size = blockSize;
+        block->chunk = chunk;
+        block->volume = NULL;
+        block->next = block->prev = NULL;
+        block->seqFirst = block->seqLast = NULL;
+    }
+    block->chunk->liveCount++;
+    block->tag = tag;
+    block->id = DE_ZONEID;
+    if (user)
+    {
+        block->user = user;
+        *(void **) user = (byte *) block + sizeof(memblock_t);
+    }
+    else
+    {
+        block->user = MEMBLOCK_USER_ANONYMOUS;
+    }
+    arena->usedBytes += blockSize;
+    arena->allocCount++;
+    unlockArena(arena);
+
+    return (byte *) block + sizeof(memblock_t);
+}
+
+static void arenaFree(memblock_t *block)
+{
+    zonearena_t *arena = block->chunk->lane->arena;
+    zonearenachunk_t *released;
+
+    lockArena(arena);
+    released = freeArenaBlock(block);
+    unlockArena(arena);
+
+    freeArenaChunks(released);
+}
+
+/**
+ * Frees all arena blocks with a tag in the specified range.
+ */
+static void freeArenaTags(int lowTag, int highTag)
+{
+    int i, k;
+    for (i = 0; i < ARENA_COUNT; ++i)
+    {
+        zonearena_t *arena = &arenas[i];
+        zonearenachunk_t *released = NULL;
+
+        lockArena(arena);
+        for (k = 0; k < ARENA_LANE_COUNT; ++k)
+        {
+            zonearenalane_t *lane = &arena->lanes[k];
+            zonearenachunk_t *chunk, *next;
+
+            for (chunk = lane->chunks; chunk; chunk = next)
+            {
+                byte *pos;
+                next = chunk->next;
+                for (pos = chunkBlocks(chunk); pos < chunk->top; pos += ((memblock_t *) pos)->size)
+                {
+                    memblock_t *block = (memblock_t *) pos;
+                    if (block->user && block->tag >= lowTag && block->tag <= highTag)
+                    {
+                        if (freeArenaBlock(block))
+                        {
+                            // The chunk was detached from the lane.
+                            chunk->next = released;
+                            released = chunk;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        unlockArena(arena);
+
+        freeArenaChunks(released);
+    }
+}
+
 /**
  * Conversion from string to long, with the "k" and "m" suffixes.
  */
@@ -159,6 +548,7 @@ static memvolume_t *createVolume(size_t volumeSize)
 
     block->prev = block->next = &vol->zone->blockList;
     block->user = NULL;         // free block
+    block->chunk = NULL;
     block->seqFirst = block->seqLast = NULL;
     block->size = vol->zone->size - sizeof(memzone_t);
 
@@ -180,6 +570,8 @@ dd_bool Z_IsInited(void)
 int Z_Init(void)
 {
     zoneMutex = Sys_CreateMutex("ZONE_MUTEX");
+    memset(&zoneStats, 0, sizeof(zoneStats));
+    initArenas();
 
     // Create the first volume.
     createVolume(MEMORY_VOLUME_SIZE);
@@ -215,6 +607,7 @@ void Z_Shutdown(void)
     App_Log(DE2_LOG_NOTE,
             "Z_Shutdown: Used %i volumes, total %u bytes.", numVolumes, totalMemory);
 
+    shutdownArenas();
     Sys_DestroyMutex(zoneMutex);
     zoneMutex = 0;
 }
@@ -256,18 +649,23 @@ static void freeBlock(void *ptr, memblock_t **tracked)
 
     if (!ptr) return;
 
-    lockZone();
-
     block = Z_GetBlock(ptr);
     if (block->id != DE_ZONEID)
     {
-        unlockZone();
         DE_ASSERT(block->id == DE_ZONEID);
         App_Log(DE2_LOG_WARNING,
                 "Attempted to free pointer without ZONEID.");
         return;
     }
 
+    if (block->chunk)
+    {
+        arenaFree(block);
+        return;
+    }
+
+    lockZone();
+
     // The block was allocated from this volume.
     volume = block->volume;
 
@@ -430,6 +828,7 @@ static void splitFreeBlock(memblock_t *block, size_t size)
     newBlock->user = NULL;       // free block
     newBlock->tag = 0;
     newBlock->volume = NULL;
+    newBlock->chunk = NULL;
     newBlock->prev = block;
     newBlock->next = block->next;
     newBlock->next->prev = newBlock;
@@ -444,9 +843,6 @@ static void splitFreeBlock(memblock_t *block, size_t size)
 
 void *Z_Malloc(size_t size, int tag, void *user)
 {
-    memblock_t *start, *iter;
-    memvolume_t *volume;
-
     if (tag < PU_APPSTATIC || tag > PU_PURGELEVEL)
     {
         App_Log(DE2_LOG_WARNING, "Z_Malloc: Invalid purgelevel %i, cannot allocate memory.", tag);
@@ -458,8 +854,32 @@ void *Z_Malloc(size_t size, int tag, void *user)
         return NULL;
     }
 
+#ifndef DE_FAKE_MEMORY_ZONE
+    {
+        void *ptr = arenaMalloc(ALIGNED(size), tag, user);
+        if (ptr) return ptr;
+    }
+#endif
+
+    return zoneMalloc(size, tag, user);
+}
+
+/**
+ * Allocates a block from the volumes.
+ *
+ * @param size  Size of the block.
+ * @param tag   Purge level.
+ * @param user  User pointer, or one of the special MEMBLOCK_USER_* values.
+ */
+static void *zoneMalloc(size_t size, int tag, void *user)
+{
+    memblock_t *start, *iter;
+    memvolume_t *volume;
+
     lockZone();
 
+    zoneStats.mallocCount++;
+
     // Align to pointer size.
     size = ALIGNED(size);
 
@@ -561,6 +981,7 @@ void *Z_Malloc(size_t size, int tag, void *user)
             if (iter == start && numChecked > 0)
             {
                 // Scanned all the way through, no suitable space found.
+                zoneStats.roverSteps += numChecked;
                 gotoNextVolume = true;
                 App_Log(DE2_LOG_DEBUG,
                         "Z_Malloc: gave up on volume after %i checks", numChecked);
@@ -573,6 +994,8 @@ void *Z_Malloc(size_t size, int tag, void *user)
 
         if (gotoNextVolume) continue;
 
+        zoneStats.roverSteps += numChecked;
+
         // Found a block big enough.
         if (iter->size - size > MINFRAGMENT)
         {
@@ -584,7 +1007,11 @@ void *Z_Malloc(size_t size, int tag, void *user)
         iter->area = M_Malloc(iter->areaSize);
 #endif
 
-        if (user)
+        if (user == MEMBLOCK_USER_ARENA)
+        {
+            iter->user = user;      // in use as an arena chunk
+        }
+        else if (user)
         {
             iter->user = user;      // mark as an in use block
 #ifdef DE_FAKE_MEMORY_ZONE
@@ -634,6 +1061,7 @@ void *Z_Malloc(size_t size, int tag, void *user)
         volume->allocatedBytes += iter->size;
 
         iter->volume = volume;
+        iter->chunk = NULL;
         iter->id = DE_ZONEID;
 
         unlockZone();
@@ -684,6 +1112,10 @@ void Z_FreeTags(int lowTag, int highTag)
             "MemoryZone: Freeing all blocks in tag range:[%i, %i)",
             lowTag, highTag+1);
 
+#ifndef DE_FAKE_MEMORY_ZONE
+    freeArenaTags(lowTag, highTag);
+#endif
+
     for (volume = volumeRoot; volume; volume = volume->next)
     {
         for (block = volume->zone->blockList.next;
@@ -692,7 +1124,8 @@ void Z_FreeTags(int lowTag, int highTag)
         {
             next = block->next;
 
-            if (block->user) // An allocated block?
+            // An allocated block? Arena chunks are freed when they become empty.
+            if (block->user && block->user != MEMBLOCK_USER_ARENA)
             {
                 if (block->tag >= lowTag && block->tag <= highTag)
 #ifdef DE_FAKE_MEMORY_ZONE
@@ -814,12 +1247,34 @@ void Z_CheckHeap(void)
     unlockZone();
 }
 
-void Z_ChangeTag2(void *ptr, int tag)
+/**
+ * Locks the zone or the arena that the block belongs to.
+ *
+ * @return The locked arena, or @c NULL if the zone was locked.
+ */
+static zonearena_t *lockBlock(memblock_t *block)
 {
-    lockZone();
+    if (block->chunk)
     {
-        memblock_t *block = Z_GetBlock(ptr);
+        zonearena_t *arena = block->chunk->lane->arena;
+        lockArena(arena);
+        return arena;
+    }
+    lockZone();
+    return NULL;
+}
+
+static void unlockBlock(zonearena_t *arena)
+{
+    if (arena) unlockArena(arena);
+    else unlockZone();
+}
 
+void Z_ChangeTag2(void *ptr, int tag)
+{
+    memblock_t *block = Z_GetBlock(ptr);
+    zonearena_t *arena = lockBlock(block);
+    {
         DE_ASSERT(block->id == DE_ZONEID);
 
         if (tag >= PU_PURGELEVEL && PTR2INT(block->user) < 0x100)
@@ -832,18 +1287,18 @@ void Z_ChangeTag2(void *ptr, int tag)
             block->tag = tag;
         }
     }
-    unlockZone();
+    unlockBlock(arena);
 }
 
 void Z_ChangeUser(void *ptr, void *newUser)
 {
-    lockZone();
+    memblock_t *block = Z_GetBlock(ptr);
+    zonearena_t *arena = lockBlock(block);
     {
-        memblock_t *block = Z_GetBlock(ptr);
         DE_ASSERT(block->id == DE_ZONEID);
         block->user = newUser;
     }
-    unlockZone();
+    unlockBlock(arena);
 }
 
 uint Z_GetId(void *ptr)
@@ -1042,10 +1497,47 @@ void Z_PrintStatus(void)
 {
     size_t allocated = Z_AllocatedMemory();
     size_t wasted    = Z_FreeMemory();
+    zonestats_t stats;
+    zonearena_t totals;
+    int i;
 
     App_Log(DE2_LOG_DEBUG,
             "Memory zone status: %u volumes, %u bytes allocated, %u bytes free (%f%% in use)",
             Z_VolumeCount(), (uint)allocated, (uint)wasted, (float)allocated/(float)(allocated+wasted)*100.f);
+
+    lockZone();
+    stats = zoneStats;
+    unlockZone();
+
+    App_Log(DE2_LOG_DEBUG,
+            "Zone contention: %u locks, %u lock waits (%.2f%%), "
+            "%u volume allocations, %.1f rover steps per allocation",
+            stats.lockCount, stats.lockWaits,
+            stats.lockCount? stats.lockWaits * 100.f / stats.lockCount : 0.f,
+            stats.mallocCount,
+            stats.mallocCount? (double) stats.roverSteps / stats.mallocCount : 0.0);
+
+    memset(&totals, 0, sizeof(totals));
+    for (i = 0; i < ARENA_COUNT; ++i)
+    {
+        zonearena_t *arena = &arenas[i];
+        lockArena(arena);
+        totals.chunkCount += arena->chunkCount;
+        totals.usedBytes  += arena->usedBytes;
+        totals.allocCount += arena->allocCount;
+        totals.freeCount  += arena->freeCount;
+        totals.lockCount  += arena->lockCount;
+        totals.lockWaits  += arena->lockWaits;
+        unlockArena(arena);
+    }
+
+    App_Log(DE2_LOG_DEBUG,
+            "Thread arenas: %u chunks, %u bytes in use (%.1f%% of chunks), "
+            "%u allocations, %u frees, %u lock waits (%.2f%%)",
+            totals.chunkCount, (uint)totals.usedBytes,
+            totals.chunkCount? totals.usedBytes * 100.f / (totals.chunkCount * ARENA_CHUNK_SIZE) : 0.f,
+            totals.allocCount, totals.freeCount, totals.lockWaits,
+            totals.lockCount? totals.lockWaits * 100.f / totals.lockCount : 0.f);
 }
 
 void Garbage_Trash(void *ptr)
@@ -56,6 +56,7 @@ typedef struct memblock_s {
     int             tag; // Purge level.
     int             id; // Should be DE_ZONEID.
     struct memvolume_s *volume; // Volume this block belongs to.
+    struct zonearenachunk_s *chunk; // Arena chunk, if allocated from a thread arena.
     struct memblock_s *next, *prev;
     struct memblock_s *seqLast, *seqFirst;
 #ifdef DE_FAKE_MEMORY_ZONE
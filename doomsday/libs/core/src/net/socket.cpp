@@ -38,7 +38,10 @@
  * Very small messages, such as the position updates that a client streams
  * to the server, are encoded with Huffman codes (see huffman.h). If
  * the Huffman coded payload happens to exceed 127 bytes, the message is
- * switched to the medium format (see below). Message structure:
+ * switched to the medium format (see below). If the socket has a preset
+ * dictionary (see DeflateDictionary), a message is instead deflated with
+ * the dictionary if that yields a smaller message, also using the medium
+ * format. Message structure:
  * - 1 byte: payload size
  * - @em n bytes: payload contents (Huffman)
  *
@@ -68,6 +71,7 @@
 
 #include "de/socket.h"
 
+#include "de/deflatedictionary.h"
 #include "de/loop.h"
 #include "de/message.h"
 #include "de/reader.h"
@@ -104,6 +108,10 @@ static const int MAX_SIZE_LARGE  = DE_SOCKET_MAX_PAYLOAD_SIZE;
 /// the Huffman coded payload is used (unless it doesn't fit in a medium-sized packet).
 static const int MAX_HUFFMAN_INPUT_SIZE = 4096; // bytes
 
+/// Threshold for input data size: messages smaller than this are deflated using the
+/// preset dictionary, if there is one.
+static const int MAX_DICTIONARY_INPUT_SIZE = 4096; // bytes
+
 #define TRMF_CONTINUE           0x80
 #define TRMF_DEFLATED           0x40
 #define TRMF_SIZE_MASK          0x7f
@@ -204,6 +212,7 @@ DE_PIMPL_NOREF(Socket)
     Address  peer;
     bool     quiet       = false;
     bool     retainOrder = true;
+    const DeflateDictionary *dictionary = nullptr;
 
     enum ReceptionState { ReceivingHeader, ReceivingPayload };
     ReceptionState receptionState = ReceivingHeader;
@@ -243,7 +252,7 @@ DE_PIMPL_NOREF(Socket)
         if (payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
         {
             huffData = codec::huffmanEncode(payload);
-            if (int(huffData.size()) <= MAX_SIZE_SMALL)
+            if (int(huffData.size()) <= MAX_SIZE_SMALL && !dictionary)
             {
                 // We'll use this.
                 header.isHuffmanCoded = true;
@@ -254,6 +263,29 @@ DE_PIMPL_NOREF(Socket)
             // the deflated payload.
         }
 
+        // With a dictionary, deflate is effective also for very small messages.
+        if (dictionary && payload.size() <= MAX_DICTIONARY_INPUT_SIZE)
+        {
+            const Block deflated = dictionary->compress(payload);
+            const bool smallHuff = huffData.size() && int(huffData.size()) <= MAX_SIZE_SMALL;
+
+            // Deflated data always needs the two-byte medium header, while small
+            // Huffman coded data only needs one byte.
+            if (deflated.size() && int(deflated.size()) <= MAX_SIZE_MEDIUM &&
+                (huffData.isEmpty() || deflated.size() + (smallHuff? 1 : 0) < huffData.size()))
+            {
+                header.isDeflated = true;
+                header.size = deflated.size();
+                payload = deflated;
+            }
+            else if (smallHuff)
+            {
+                header.isHuffmanCoded = true;
+                header.size = huffData.size();
+                payload = huffData;
+            }
+        }
+
         /// @todo Messages broadcasted to multiple recipients are separately
         /// compressed for each TCP send -- should do only one compression per
         /// message.
@@ -414,7 +446,14 @@ DE_PIMPL_NOREF(Socket)
                     }
                     else if (incomingHeader.isDeflated)
                     {
-                        payload = payload.decompressed(); //qUncompress(payload);
+                        if (DeflateDictionary::needsDictionary(payload))
+                        {
+                            payload = DeflateDictionary::decompress(payload);
+                        }
+                        else
+                        {
+                            payload = payload.decompressed(); //qUncompress(payload);
+                        }
                         if (!payload.size())
                         {
                             throw ProtocolError("Socket::Impl::deserializeMessages",
@@ -764,6 +803,11 @@ void Socket::setRetainOrder(bool retainOrder)
     d->retainOrder = retainOrder;
 }
 
+void Socket::setDictionary(const DeflateDictionary *dictionary)
+{
+    d->dictionary = dictionary;
+}
+
 void Socket::send(const IByteArray &packet)
 {
     send(packet, d->activeChannel);
@@ -0,0 +1,227 @@
+/*
+ * The Doomsday Engine Project -- libcore
+ *
+ * Copyright © 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/scripting/bytecode.h"
+#include "de/scripting/arrayexpression.h"
+#include "de/scripting/builtinexpression.h"
+#include "de/scripting/constantexpression.h"
+#include "de/scripting/dictionaryexpression.h"
+#include "de/scripting/nameexpression.h"
+#include "de/scripting/operatorexpression.h"
+#include "de/log.h"
+
+#include <atomic>
+
+namespace de {
+
+static std::atomic<bool> bytecodeEnabled{true};
+
+DE_PIMPL_NOREF(Bytecode)
+{
+    /// Compilation failed because the expression is too large or not supported.
+    DE_ERROR(CompileError);
+
+    Instructions code;
+    dint registerCount = 0;
+    dint top = 0; ///< First free register during compilation.
+    bool valid = false;
+
+    duint8 allocRegister()
+    {
+        if (top >= NoRegister)
+        {
+            throw CompileError("Bytecode::compile", "Out of registers");
+        }
+        registerCount = de::max(registerCount, top + 1);
+        return duint8(top++);
+    }
+
+    dsize emit(Opcode op, duint8 dest, const Expression *node = nullptr,
+               duint8 a = NoRegister, duint8 b = NoRegister, duint8 scope = NoRegister,
+               dsize count = 0)
+    {
+        if (code.size() >= 0xffff || count > 0xffff)
+        {
+            throw CompileError("Bytecode::compile", "Expression is too large");
+        }
+        code.push_back(Instruction{duint8(op), dest, a, b, scope, duint16(count), node});
+        return code.size() - 1;
+    }
+
+    /**
+     * Compiles an expression so that its result is placed in register @a dest.
+     * Registers above @a dest are used for the intermediate values.
+     *
+     * @param expr   Expression to compile.
+     * @param dest   Destination register.
+     * @param scope  Register whose value is the scope of the expression (the left side
+     *               of a MEMBER operator), or NoRegister.
+     */
+    void compile(const Expression &expr, duint8 dest, duint8 scope)
+    {
+        const dint base = top;
+
+        if (const auto *op = maybeAs<OperatorExpression>(expr))
+        {
+            compileOperator(*op, dest, scope);
+        }
+        else if (const auto *name = maybeAs<NameExpression>(expr))
+        {
+            emit(Name, dest, name, NoRegister, NoRegister, scope);
+        }
+        else if (const auto *constant = maybeAs<ConstantExpression>(expr))
+        {
+            emit(Constant, dest, constant, NoRegister, NoRegister, scope);
+        }
+        else if (const auto *array = maybeAs<ArrayExpression>(expr))
+        {
+            const duint8 first = duint8(top);
+            for (dsize i = 0; i < array->size(); ++i)
+            {
+                compile(array->at(dint(i)), allocRegister(), NoRegister);
+            }
+            emit(Array, dest, array, first, NoRegister, scope, array->size());
+        }
+        else if (const auto *dict = maybeAs<DictionaryExpression>(expr))
+        {
+            const duint8 first = duint8(top);
+            for (dsize i = 0; i < dict->size(); ++i)
+            {
+                compile(dict->keyAt(dint(i)),   allocRegister(), NoRegister);
+                compile(dict->valueAt(dint(i)), allocRegister(), NoRegister);
+            }
+            emit(Dictionary, dest, dict, first, NoRegister, scope, dict->size());
+        }
+        else if (const auto *builtIn = maybeAs<BuiltInExpression>(expr))
+        {
+            const duint8 arg = allocRegister();
+            compile(builtIn->argument(), arg, NoRegister);
+            emit(BuiltIn, dest, builtIn, arg, NoRegister, scope);
+        }
+        else
+        {
+            throw CompileError("Bytecode::compile",
+                               "Unsupported expression " + String(DE_TYPE_NAME(expr)));
+        }
+
+        // Intermediate values are no longer needed.
+        top = base;
+    }
+
+    void compileOperator(const OperatorExpression &expr, duint8 dest, duint8 scope)
+    {
+        const Operator op = expr.op();
+        switch (op)
+        {
+        case MEMBER: {
+            // The right side is evaluated in the scope of the left side.
+            const duint8 left = allocRegister();
+            compile(*expr.leftOperand(), left, scope);
+            emit(VerifyScope, dest, &expr, left);
+            compile(expr.rightOperand(), dest, left);
+            break; }
+
+        case AND:
+        case OR: {
+            // Early termination skips the right side.
+            compile(*expr.leftOperand(), dest, scope);
+            const dsize jump = emit(op == AND? JumpIfFalse : JumpIfTrue, dest, &expr);
+            compile(expr.rightOperand(), dest, NoRegister);
+            emit(Truth, dest, &expr);
+            code[jump].count = duint16(code.size());
+            break; }
+
+        default: {
+            // The left side is evaluated first.
+            duint8 left = NoRegister;
+            if (expr.leftOperand())
+            {
+                left = allocRegister();
+                compile(*expr.leftOperand(), left, scope);
+            }
+            const duint8 right = allocRegister();
+            compile(expr.rightOperand(), right, NoRegister);
+            emit(opcodeFor(op), dest, &expr, left, right);
+            break; }
+        }
+    }
+
+    static Opcode opcodeFor(Operator op)
+    {
+        switch (op)
+        {
+        case EQUAL:     return Equal;
+        case NOT_EQUAL: return NotEqual;
+        case LESS:      return Less;
+        case GREATER:   return Greater;
+        case LEQUAL:    return LessOrEqual;
+        case GEQUAL:    return GreaterOrEqual;
+        case IN:        return In;
+        case NOT:       return Not;
+        case CALL:      return Call;
+        default:        return Operate;
+        }
+    }
+};
+
+Bytecode::Bytecode() : d(new Impl)
+{}
+
+Bytecode *Bytecode::compile(const Expression &expression)
+{
+    Bytecode *bytecode = new Bytecode;
+    try
+    {
+        bytecode->d->compile(expression, bytecode->d->allocRegister(), NoRegister);
+        bytecode->d->valid = true;
+    }
+    catch (const Error &er)
+    {
+        LOGDEV_SCR_VERBOSE("Expression evaluated without bytecode: %s") << er.asText();
+        bytecode->d->code.clear();
+    }
+    return bytecode;
+}
+
+bool Bytecode::isValid() const
+{
+    return d->valid;
+}
+
+const Bytecode::Instructions &Bytecode::instructions() const
+{
+    return d->code;
+}
+
+dint Bytecode::registerCount() const
+{
+    return d->registerCount;
+}
+
+void Bytecode::setEnabled(bool enabled)
+{
+    bytecodeEnabled = enabled;
+}
+
+bool Bytecode::isEnabled()
+{
+    return bytecodeEnabled;
+}
+
+} // namespace de
@@ -18,13 +18,23 @@
  */
 
 #include "de/scripting/evaluator.h"
+#include "de/scripting/bytecode.h"
+#include "de/scripting/constantexpression.h"
 #include "de/scripting/expression.h"
 #include "de/scripting/context.h"
+#include "de/scripting/operatorexpression.h"
 #include "de/scripting/process.h"
+#include "de/arrayvalue.h"
+#include "de/dictionaryvalue.h"
+#include "de/numbervalue.h"
 #include "de/value.h"
 
 namespace de {
 
+/// Results of comparisons executed as bytecode. These are never modified.
+static const NumberValue bytecodeFalse(NumberValue::False, NumberValue::Boolean);
+static const NumberValue bytecodeTrue (NumberValue::True,  NumberValue::Boolean);
+
 DE_PIMPL(Evaluator)
 {
     /// The context that owns this evaluator.
@@ -135,6 +145,257 @@ DE_PIMPL(Evaluator)
         return *results.first().result;
     }
 
+    /**
+     * Register of the bytecode machine. Constants and comparison results are
+     * borrowed instead of copied; a borrowed value is duplicated if it needs to be
+     * modified or kept.
+     */
+    struct Register {
+        Value *value = nullptr;
+        Value *scope = nullptr; // owned
+        bool owned = false;
+
+        ~Register() { clear(); }
+
+        void clear()
+        {
+            if (owned) delete value;
+            delete scope;
+            value = nullptr;
+            scope = nullptr;
+            owned = false;
+        }
+
+        void set(Value *v, bool own = true)
+        {
+            clear();
+            value = v;
+            owned = own;
+        }
+
+        void set(const Value &borrowed) { set(const_cast<Value *>(&borrowed), false); }
+
+        void setBoolean(bool isTrue) { set(isTrue? bytecodeTrue : bytecodeFalse); }
+
+        /// Gives ownership of the value to the caller. The scope is kept.
+        Value *take()
+        {
+            Value *v = (owned? value : value->duplicate());
+            value = nullptr;
+            owned = false;
+            return v;
+        }
+
+        Value *takeScope()
+        {
+            Value *s = scope;
+            scope = nullptr;
+            return s;
+        }
+    };
+
+    /// Gives the value of register @a src to register @a dest as its scope.
+    static void moveToScope(Register *regs, duint8 src, Register &dest)
+    {
+        if (src == Bytecode::NoRegister) return;
+        Value *scope = regs[src].take();
+        regs[src].clear();
+        DE_ASSERT(dest.scope == nullptr);
+        dest.scope = scope;
+    }
+
+    void setNames(Register *regs, duint8 scope)
+    {
+        names = (scope != Bytecode::NoRegister? regs[scope].value->memberScope() : nullptr);
+    }
+
+    /**
+     * Executes compiled bytecode. The final result is pushed onto the result stack.
+     */
+    void execute(const Bytecode &bytecode)
+    {
+        const Bytecode::Instructions &code = bytecode.instructions();
+        const dsize count = code.size();
+
+        // Registers are kept in the native stack, unless there are many of them.
+        static constexpr dint LOCAL_REGISTERS = 16;
+        Register localRegs[LOCAL_REGISTERS];
+        std::unique_ptr<Register[]> extraRegs;
+        Register *regs = localRegs;
+        if (bytecode.registerCount() > LOCAL_REGISTERS)
+        {
+            extraRegs.reset(new Register[bytecode.registerCount()]);
+            regs = extraRegs.get();
+        }
+
+        try
+        {
+            for (dsize pc = 0; pc < count; ++pc)
+            {
+                const Bytecode::Instruction &ins = code[pc];
+                Register &dest = regs[ins.dest];
+
+                switch (ins.op)
+                {
+                case Bytecode::Constant:
+                    dest.set(static_cast<const ConstantExpression *>(ins.node)->value());
+                    moveToScope(regs, ins.scope, dest);
+                    break;
+
+                case Bytecode::Name:
+                {
+                    setNames(regs, ins.scope);
+                    Value *result = ins.node->evaluate(self());
+                    names = nullptr;
+                    dest.set(result);
+                    moveToScope(regs, ins.scope, dest);
+                    break;
+                }
+
+                case Bytecode::Array:
+                {
+                    auto *array = new ArrayValue;
+                    dest.set(array);
+                    for (duint i = 0; i < ins.count; ++i)
+                    {
+                        array->add(regs[ins.a + i].take());
+                        regs[ins.a + i].clear();
+                    }
+                    moveToScope(regs, ins.scope, dest);
+                    break;
+                }
+
+                case Bytecode::Dictionary:
+                {
+                    auto *dict = new DictionaryValue;
+                    dest.set(dict);
+                    for (duint i = 0; i < ins.count; ++i)
+                    {
+                        Register &key   = regs[ins.a + 2 * i];
+                        Register &value = regs[ins.a + 2 * i + 1];
+                        dict->add(key.take(), value.take());
+                        key.clear();
+                        value.clear();
+                    }
+                    moveToScope(regs, ins.scope, dest);
+                    break;
+                }
+
+                case Bytecode::BuiltIn:
+                {
+                    // The built-in expression pops its argument from the result stack.
+                    pushResult(regs[ins.a].take());
+                    regs[ins.a].clear();
+                    setNames(regs, ins.scope);
+                    Value *result = ins.node->evaluate(self());
+                    names = nullptr;
+                    dest.set(result);
+                    moveToScope(regs, ins.scope, dest);
+                    break;
+                }
+
+                case Bytecode::VerifyScope:
+                    OperatorExpression::verifyScope(*regs[ins.a].value);
+                    break;
+
+                case Bytecode::Operate:
+                {
+                    const auto *expr = static_cast<const OperatorExpression *>(ins.node);
+                    Value *left = nullptr;
+                    if (ins.a != Bytecode::NoRegister)
+                    {
+                        left = regs[ins.a].take();
+                        regs[ins.a].clear();
+                    }
+                    Register &right = regs[ins.b];
+                    // Unary operators may modify the right side.
+                    const bool rightIsOwned = right.owned || !left;
+                    Value *rightValue = (rightIsOwned? right.take() : right.value);
+                    right.value = nullptr;
+                    right.clear();
+                    dest.set(expr->operate(left, rightValue, rightIsOwned));
+                    break;
+                }
+
+                case Bytecode::Equal:
+                    dest.setBoolean(!regs[ins.a].value->compare(*regs[ins.b].value));
+                    break;
+
+                case Bytecode::NotEqual:
+                    dest.setBoolean(regs[ins.a].value->compare(*regs[ins.b].value) != 0);
+                    break;
+
+                case Bytecode::Less:
+                    dest.setBoolean(regs[ins.a].value->compare(*regs[ins.b].value) < 0);
+                    break;
+
+                case Bytecode::Greater:
+                    dest.setBoolean(regs[ins.a].value->compare(*regs[ins.b].value) > 0);
+                    break;
+
+                case Bytecode::LessOrEqual:
+                    dest.setBoolean(regs[ins.a].value->compare(*regs[ins.b].value) <= 0);
+                    break;
+
+                case Bytecode::GreaterOrEqual:
+                    dest.setBoolean(regs[ins.a].value->compare(*regs[ins.b].value) >= 0);
+                    break;
+
+                case Bytecode::In:
+                    dest.setBoolean(regs[ins.b].value->contains(*regs[ins.a].value));
+                    break;
+
+                case Bytecode::Not:
+                    dest.setBoolean(regs[ins.b].value->isFalse());
+                    break;
+
+                case Bytecode::JumpIfFalse:
+                    if (!dest.value->isTrue())
+                    {
+                        dest.setBoolean(false);
+                        pc = ins.count - 1;
+                    }
+                    break;
+
+                case Bytecode::JumpIfTrue:
+                    if (dest.value->isTrue())
+                    {
+                        dest.setBoolean(true);
+                        pc = ins.count - 1;
+                    }
+                    break;
+
+                case Bytecode::Truth:
+                    dest.setBoolean(dest.value->isTrue());
+                    break;
+
+                case Bytecode::Call:
+                {
+                    // The result comes from whatever is being called.
+                    const dsize resultCount = results.size();
+                    regs[ins.a].value->call(self().process(), *regs[ins.b].value,
+                                            regs[ins.a].takeScope());
+                    Value *resultScope = nullptr;
+                    Value *result = (results.size() > resultCount? self().popResult(&resultScope)
+                                                                 : new NoneValue);
+                    regs[ins.a].clear();
+                    regs[ins.b].clear();
+                    dest.set(result);
+                    dest.scope = resultScope;
+                    break;
+                }
+                }
+            }
+        }
+        catch (...)
+        {
+            names = nullptr;
+            throw;
+        }
+
+        pushResult(regs[0].take(), regs[0].takeScope());
+    }
+
     Value &evaluate(const Expression *expression)
     {
         DE_ASSERT(names == nullptr);
@@ -144,11 +405,26 @@ DE_PIMPL(Evaluator)
 
         // Begin a new evaluation operation.
         current = expression;
-        expression->push(self());
 
         // Clear the result stack.
         clearResults();
 
+        if (Bytecode::isEnabled())
+        {
+            const Bytecode &bytecode = expression->bytecode();
+            if (bytecode.isValid())
+            {
+                execute(bytecode);
+                DE_ASSERT(&self().process().context() == &context);
+                DE_ASSERT(self().hasResult());
+                current = nullptr;
+                return result();
+            }
+        }
+
+        // Evaluate by traversing the expression tree.
+        expression->push(self());
+
         while (!expressions.empty())
         {
             // Continue by processing the next step in the evaluation.
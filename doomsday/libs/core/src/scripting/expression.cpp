@@ -21,6 +21,7 @@
 #include "de/scripting/evaluator.h"
 #include "de/scripting/arrayexpression.h"
 #include "de/scripting/builtinexpression.h"
+#include "de/scripting/bytecode.h"
 #include "de/scripting/constantexpression.h"
 #include "de/scripting/dictionaryexpression.h"
 #include "de/scripting/nameexpression.h"
@@ -30,11 +31,13 @@
 
 using namespace de;
 
-Expression::Expression()
+Expression::Expression() : _bytecode(nullptr)
 {}
 
 Expression::~Expression()
-{}
+{
+    clearBytecode();
+}
 
 void Expression::push(Evaluator &evaluator, Value *scope) const
 {
@@ -96,6 +99,28 @@ void Expression::setFlags(Flags f, FlagOp operation)
     applyFlagOperation(_flags, f, operation);
 }
 
+const Bytecode &Expression::bytecode() const
+{
+    if (const Bytecode *compiled = _bytecode.load(std::memory_order_acquire))
+    {
+        return *compiled;
+    }
+    // Another thread may be compiling the same expression; the first one to finish wins.
+    const Bytecode *compiled = Bytecode::compile(*this);
+    const Bytecode *expected = nullptr;
+    if (!_bytecode.compare_exchange_strong(expected, compiled, std::memory_order_acq_rel))
+    {
+        delete compiled;
+        return *expected;
+    }
+    return *compiled;
+}
+
+void Expression::clearBytecode()
+{
+    delete _bytecode.exchange(nullptr);
+}
+
 void Expression::operator >> (Writer &to) const
 {
     // Save the flags.
@@ -108,4 +133,7 @@ void Expression::operator << (Reader &from)
     duint16 f;
     from >> f;
     _flags = Flags(f);
+
+    // The subexpressions are about to change.
+    clearBytecode();
 }
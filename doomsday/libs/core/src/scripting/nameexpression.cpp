@@ -31,18 +31,137 @@
 #include "de/textvalue.h"
 #include "de/writer.h"
 
+#include <atomic>
+
 namespace de {
 
 const char *NameExpression::LOCAL_SCOPE = "-";
 
+static std::atomic<duint64> nameCacheHits;
+static std::atomic<duint64> nameCacheMisses;
+
 DE_PIMPL_NOREF(NameExpression)
 {
+    /**
+     * Records searched while looking up an identifier, in the order of the search.
+     *
+     * The __super__ array can be modified in place (e.g., "__super__ += [X]") without
+     * the record's layout changing, so the contents of the searched arrays are
+     * remembered as well.
+     */
+    struct LookupPath
+    {
+        struct Step
+        {
+            const Record *  record;
+            duint64         version;
+            int             parent;     ///< Step whose super-records include this, or -1.
+            dsize           index;      ///< Position in the parent's super-records.
+            const Variable *supers;     ///< Super-records variable, if it was searched.
+            dsize           superCount;
+
+            bool isNamespace() const { return parent < 0; }
+        };
+        static constexpr int MAX_STEPS = 6;
+
+        Step steps[MAX_STEPS];
+        int  count     = 0;
+        bool hasSupers = false;
+        bool overflow  = false;
+
+        void add(const Record &record, int parent = -1, dsize index = 0)
+        {
+            if (count == MAX_STEPS)
+            {
+                overflow = true;
+                return;
+            }
+            steps[count++] = Step{&record, record.layoutVersion(), parent, index, nullptr, 0};
+            if (parent >= 0) hasSupers = true;
+        }
+
+        /**
+         * Notes the super-records of the record that was added last.
+         * @return Step of the record.
+         */
+        int setSupers(const Variable &supers)
+        {
+            if (overflow) return -1;
+            steps[count - 1].supers     = &supers;
+            steps[count - 1].superCount = supers.value().as<ArrayValue>().size();
+            return count - 1;
+        }
+    };
+
+    struct CachedLookup
+    {
+        LookupPath path;
+        duint64    superEpoch = 0;
+        Variable * variable   = nullptr; ///< @c nullptr if the entry is unused.
+        Record *   foundIn    = nullptr;
+
+        /**
+         * Checks that the same records would be searched again and none of their
+         * layouts have changed, so the search would find the same variable.
+         */
+        bool isValid(const Evaluator::Namespaces &spaces) const
+        {
+            if (!variable) return false;
+            if (path.hasSupers && superEpoch != Record::superRecordEpoch())
+            {
+                // A super-record may have been deleted.
+                return false;
+            }
+            const ArrayValue *supers[LookupPath::MAX_STEPS];
+            auto ns = spaces.begin();
+            for (int i = 0; i < path.count; ++i)
+            {
+                const auto &step = path.steps[i];
+                if (step.isNamespace())
+                {
+                    if (ns == spaces.end() || ns->names != step.record) return false;
+                    ++ns;
+                }
+                else
+                {
+                    // The parent's array was already checked to be the same size.
+                    const auto *value =
+                        maybeAs<RecordValue>(supers[step.parent]->elements().at(step.index));
+                    if (!value || value->record() != step.record) return false;
+                }
+                // Steps are checked in search order, so a super-record is only
+                // accessed if the record referencing it is unchanged.
+                if (step.record->layoutVersion() != step.version) return false;
+                supers[i] = nullptr;
+                if (step.supers)
+                {
+                    // The variable exists as long as the layout is unchanged, but
+                    // its value may have been replaced or modified.
+                    supers[i] = maybeAs<ArrayValue>(step.supers->value());
+                    if (!supers[i] || supers[i]->size() != step.superCount) return false;
+                }
+            }
+            return true;
+        }
+    };
+
     StringList identifierSequence;
-   
+
+    /// Inline cache of the most recent lookups. Used by one thread at a time.
+    CachedLookup cache[2];
+    int nextCacheEntry = 0;
+    std::atomic<bool> cacheBusy{false};
+
+    void clearCache()
+    {
+        for (auto &entry : cache) entry = CachedLookup();
+    }
+
     Variable *findInRecord(const String & name,
                            const Record & where,
                            Record *&      foundIn,
-                           bool           lookInClass = true) const
+                           bool           lookInClass = true,
+                           LookupPath *   path        = nullptr) const
     {
         if (where.hasMember(name))
         {
@@ -57,10 +176,16 @@ DE_PIMPL_NOREF(NameExpression)
             // super-record in turn. Check in reverse order; the superclass added last
             // overrides earlier ones.
             const ArrayValue &supers = where.geta(Record::VAR_SUPER);
+            const int step = (path? path->setSupers(where[Record::VAR_SUPER]) : -1);
             for (int i = int(supers.size() - 1); i >= 0; --i)
             {
-                if (Variable *found = findInRecord(
-                        name, supers.at(i).as<RecordValue>().dereference(), foundIn))
+                const Record &superRecord = supers.at(i).as<RecordValue>().dereference();
+                if (path)
+                {
+                    superRecord.markAsSuperRecord();
+                    path->add(superRecord, step, dsize(i));
+                }
+                if (Variable *found = findInRecord(name, superRecord, foundIn, true, path))
                 {
                     return found;
                 }
@@ -73,15 +198,17 @@ DE_PIMPL_NOREF(NameExpression)
                                const Evaluator::Namespaces &spaces,
                                bool           localOnly,
                                Record *&      foundInNamespace,
-                               Record **      higherNamespace = 0)
+                               Record **      higherNamespace = 0,
+                               LookupPath *   path            = nullptr)
     {
         DE_FOR_EACH_CONST(Evaluator::Namespaces, i, spaces)
         {
             Record &ns = *i->names;
+            if (path) path->add(ns);
             if (Variable *variable =
                     findInRecord(name, ns, foundInNamespace,
                                    // allow looking in class if local not required:
-                                   !localOnly))
+                                   !localOnly, path))
             {
                 // The name exists in this namespace.
                 // Also note the higher namespace (for export).
@@ -100,6 +227,50 @@ DE_PIMPL_NOREF(NameExpression)
         }
         return 0;
     }
+
+    /**
+     * Same as findInNamespaces(), but uses the inline cache.
+     */
+    Variable *findInNamespacesCached(const String & name,
+                                     const Evaluator::Namespaces &spaces,
+                                     bool           localOnly,
+                                     Record *&      foundInNamespace,
+                                     Record **      higherNamespace)
+    {
+        // If another thread is using the cache, just do a regular lookup.
+        if (!cacheBusy.exchange(true, std::memory_order_acquire))
+        {
+            for (const auto &entry : cache)
+            {
+                if (entry.isValid(spaces))
+                {
+                    Variable *variable = entry.variable;
+                    foundInNamespace = entry.foundIn;
+                    cacheBusy.store(false, std::memory_order_release);
+                    nameCacheHits.fetch_add(1, std::memory_order_relaxed);
+                    return variable;
+                }
+            }
+            cacheBusy.store(false, std::memory_order_release);
+        }
+        nameCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+        CachedLookup lookup;
+        lookup.superEpoch = Record::superRecordEpoch();
+        lookup.variable = findInNamespaces(name, spaces, localOnly, foundInNamespace,
+                                           higherNamespace, &lookup.path);
+        if (lookup.variable && !lookup.path.overflow)
+        {
+            lookup.foundIn = foundInNamespace;
+            if (!cacheBusy.exchange(true, std::memory_order_acquire))
+            {
+                cache[nextCacheEntry] = lookup;
+                nextCacheEntry ^= 1;
+                cacheBusy.store(false, std::memory_order_release);
+            }
+        }
+        return lookup.variable;
+    }
 };
 
 } // namespace de
@@ -156,8 +327,8 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
             // Start with the context's local namespace.
             evaluator.process().namespaces(spaces);
         }
-        variable = d->findInNamespaces(identifier, spaces, flags().testFlag(LocalOnly),
-                                       foundInNamespace, &higherNamespace);
+        variable = d->findInNamespacesCached(identifier, spaces, flags().testFlag(LocalOnly),
+                                             foundInNamespace, &higherNamespace);
     }
     else
     {
@@ -296,6 +467,20 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
                         "' does not exist");
 }
 
+NameExpression::CacheStats NameExpression::cacheStats() // static
+{
+    CacheStats stats;
+    stats.hits   = nameCacheHits.load(std::memory_order_relaxed);
+    stats.misses = nameCacheMisses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void NameExpression::resetCacheStats() // static
+{
+    nameCacheHits   = 0;
+    nameCacheMisses = 0;
+}
+
 void NameExpression::operator >> (Writer &to) const
 {
     to << SerialId(NAME);
@@ -322,6 +507,8 @@ void NameExpression::operator << (Reader &from)
 
     Expression::operator << (from);
 
+    d->clearCache();
+
     if (from.version() < DE_PROTOCOL_2_2_0_NameExpression_identifier_sequence)
     {
         String ident, scopeIdent;
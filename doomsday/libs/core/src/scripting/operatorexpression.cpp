@@ -112,6 +112,16 @@ void OperatorExpression::verifyAssignable(Value *value)
     }
 }
 
+void OperatorExpression::verifyScope(const Value &value)
+{
+    if (!value.memberScope())
+    {
+        throw ScopeError("OperatorExpression::verifyScope",
+            "Left side of " + operatorToText(MEMBER) + " does not have members [" +
+                         DE_TYPE_NAME(value) + "]");
+    }
+}
+
 Value *OperatorExpression::evaluate(Evaluator &evaluator) const
 {
     //qDebug() << "OperatorExpression:" << operatorToText(_op);
@@ -120,7 +130,6 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
     Value *rightValue = (_op == MEMBER || _op == AND || _op == OR? nullptr : evaluator.popResult());
     Value *leftScopePtr = nullptr;
     Value *leftValue = (_leftOperand? evaluator.popResult(&leftScopePtr) : nullptr);
-    Value *result = (leftValue? leftValue : rightValue);
 
     std::unique_ptr<Value> leftScope(leftScopePtr); // will be deleted if not needed
 
@@ -128,6 +137,63 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
                  (!isUnary(_op) && leftValue && rightValue) ||
                  ( isUnary(_op) && rightValue));
 
+    switch (_op)
+    {
+    case AND:
+    case OR:
+    {
+        std::unique_ptr<Value> left(leftValue);
+        if (left->isTrue() == (_op == OR))
+        {
+            // Early termination.
+            return newBooleanValue(_op == OR);
+        }
+        isResultTrue.push(evaluator);
+        _rightOperand->push(evaluator);
+        return nullptr;
+    }
+
+    case CALL:
+    {
+        std::unique_ptr<Value> left(leftValue);
+        std::unique_ptr<Value> right(rightValue);
+        left->call(evaluator.process(), *right, leftScope.release());
+        // Result comes from whatever is being called.
+        return nullptr;
+    }
+
+    case MEMBER:
+        try
+        {
+            verifyScope(*leftValue);
+        }
+        catch (const Error &)
+        {
+            delete leftValue;
+            throw;
+        }
+
+        // Now that we know what the scope is, push the rest of the expression
+        // for evaluation (in this specific scope).
+        _rightOperand->push(evaluator, leftValue);
+
+        // The MEMBER operator does not evaluate to any result.
+        // Whatever is on the right side will be the result.
+        DE_ASSERT(rightValue == nullptr);
+        return nullptr;
+
+    default:
+        return operate(leftValue, rightValue);
+    }
+}
+
+Value *OperatorExpression::operate(Value *leftValue, Value *rightValue, bool rightIsOwned) const
+{
+    DE_ASSERT(rightValue != nullptr);
+    DE_ASSERT(rightIsOwned || leftValue);
+
+    Value *result = (leftValue? leftValue : rightValue);
+
     try
     {
         switch (_op)
@@ -216,34 +282,6 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
             result = new NumberValue(~rightValue->asUInt());
             break;
 
-        case AND:
-            if (!leftValue->isTrue())
-            {
-                // Early termination.
-                result = newBooleanValue(false);
-            }
-            else
-            {
-                isResultTrue.push(evaluator);
-                _rightOperand->push(evaluator);
-                result = nullptr;
-            }
-            break;
-
-        case OR:
-            if (leftValue->isTrue())
-            {
-                // Early termination.
-                result = newBooleanValue(true);
-            }
-            else
-            {
-                isResultTrue.push(evaluator);
-                _rightOperand->push(evaluator);
-                result = nullptr;
-            }
-            break;
-
         case EQUAL:
             result = newBooleanValue(!leftValue->compare(*rightValue));
             break;
@@ -272,12 +310,6 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
             result = newBooleanValue(rightValue->contains(*leftValue));
             break;
 
-        case CALL:
-            leftValue->call(evaluator.process(), *rightValue, leftScope.release());
-            // Result comes from whatever is being called.
-            result = nullptr;
-            break;
-
         case INDEX:
         {
             /*
@@ -304,44 +336,21 @@ Value *OperatorExpression::evaluate(Evaluator &evaluator) const
             result = performSlice(*leftValue, *rightValue);
             break;
 
-        case MEMBER:
-        {
-            Record *scope = (leftValue? leftValue->memberScope() : nullptr);
-            if (!scope)
-            {
-                throw ScopeError("OperatorExpression::evaluate",
-                    "Left side of " + operatorToText(_op) + " does not have members [" +
-                                 DE_TYPE_NAME(*leftValue) + "]");
-            }
-
-            // Now that we know what the scope is, push the rest of the expression
-            // for evaluation (in this specific scope).
-            _rightOperand->push(evaluator, leftValue);
-
-            // Cleanup.
-            //delete leftValue;
-            DE_ASSERT(rightValue == nullptr);
-
-            // The MEMBER operator does not evaluate to any result.
-            // Whatever is on the right side will be the result.
-            return nullptr;
-        }
-
         default:
-            throw Error("OperatorExpression::evaluate",
+            throw Error("OperatorExpression::operate",
                 "Operator " + operatorToText(_op) + " not implemented");
         }
     }
     catch (const Error &)
     {
-        delete rightValue;
+        if (rightIsOwned) delete rightValue;
         delete leftValue;
         throw;
     }
 
     // Delete the unnecessary values.
-    if (result != rightValue) delete rightValue;
-    if (result != leftValue)  delete leftValue;
+    if (rightIsOwned && result != rightValue) delete rightValue;
+    if (result != leftValue) delete leftValue;
 
     return result;
 }
@@ -273,6 +273,52 @@ LIBDOOMSDAY_PUBLIC coord_t         Line_PointOnSide(const world_Line *line, coor
 LIBDOOMSDAY_PUBLIC int             Line_TouchingMobjsIterator(world_Line *line, int (*callback) (struct mobj_s *, void *), void *context);
 LIBDOOMSDAY_PUBLIC void            Line_Opening(world_Line *line, LineOpening *opening);
 
+/**
+ * @defgroup mapAccessors Typed Map Accessors
+ * @ingroup world
+ *
+ * Direct accessors for the most frequently used properties of lines and sectors.
+ * The results are the same as with the corresponding P_Get*p() calls (noted
+ * below), but there is no runtime lookup of the element type or dispatch on the
+ * property, so these are preferable on hot paths of the playsim.
+ */
+///@{
+
+/// Public DDLF_* flags of the line (DMU_FLAGS).
+LIBDOOMSDAY_PUBLIC int             Line_Flags(const world_Line *line);
+
+/// Axis-aligned bounding box of the line (DMU_BOUNDING_BOX).
+LIBDOOMSDAY_PUBLIC const AABoxd   *Line_Bounds(const world_Line *line);
+
+/// Direction vector of the line, from the "from" vertex to the "to" vertex (DMU_DXY).
+LIBDOOMSDAY_PUBLIC void            Line_Direction(const world_Line *line, coord_t direction[2]);
+
+/// Origin of one of the vertices of the line (DMU_VERTEX0 or DMU_VERTEX1, and DMU_XY).
+LIBDOOMSDAY_PUBLIC void            Line_VertexOrigin(const world_Line *line, int to, coord_t origin[2]);
+
+/// Sector on the front side of the line, or @c NULL (DMU_FRONT_SECTOR).
+LIBDOOMSDAY_PUBLIC world_Sector   *Line_FrontSector(const world_Line *line);
+
+/// Sector on the back side of the line, or @c NULL (DMU_BACK_SECTOR).
+LIBDOOMSDAY_PUBLIC world_Sector   *Line_BackSector(const world_Line *line);
+
+/// Current height of the floor plane (DMU_FLOOR_HEIGHT).
+LIBDOOMSDAY_PUBLIC coord_t         Sector_FloorHeight(const world_Sector *sector);
+
+/// Current height of the ceiling plane (DMU_CEILING_HEIGHT).
+LIBDOOMSDAY_PUBLIC coord_t         Sector_CeilingHeight(const world_Sector *sector);
+
+/// Material of the floor, or @c NULL (DMU_FLOOR_MATERIAL).
+LIBDOOMSDAY_PUBLIC world_Material *Sector_FloorMaterial(const world_Sector *sector);
+
+/// Material of the ceiling, or @c NULL (DMU_CEILING_MATERIAL).
+LIBDOOMSDAY_PUBLIC world_Material *Sector_CeilingMaterial(const world_Sector *sector);
+
+/// Ambient light level of the sector (DMU_LIGHT_LEVEL).
+LIBDOOMSDAY_PUBLIC float           Sector_LightLevel(const world_Sector *sector);
+
+///@}
+
 // Sectors
 
 /**
@@ -476,6 +522,11 @@ LIBDOOMSDAY_PUBLIC dd_bool         Interceptor_AdjustOpening(world_Interceptor *
  */
 LIBDOOMSDAY_PUBLIC const char *    DMU_Str(uint prop);
 
+/**
+ * Registers the console commands for profiling DMU usage.
+ */
+LIBDOOMSDAY_PUBLIC void            DMU_ConsoleRegister(void);
+
 /**
  * Determines the type of the map data object.
  *
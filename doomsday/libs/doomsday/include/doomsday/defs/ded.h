@@ -29,6 +29,7 @@
 
 #include "dedtypes.h"
 #include "dedregister.h"
+#include "frozendefs.h"
 
 // Version 6 does not require semicolons.
 #define DED_VERSION 6
@@ -124,6 +125,9 @@ struct LIBDOOMSDAY_PUBLIC ded_s
     // Composite fonts.
     DEDArray<ded_compositefont_t> compositeFonts;
 
+    // Tables for runtime lookups (see freeze()).
+    FrozenDefs frozen;
+
 public:
     /**
      * Constructor initializes everything to zero.
@@ -132,6 +136,14 @@ public:
 
     void clear();
 
+    /**
+     * Compiles the things, states, sprites, and materials into tables that are used
+     * for the lookups done at runtime. Should be called after all definitions have
+     * been read. If the definitions are modified afterwards, the lookups fall back
+     * to searching the registers.
+     */
+    void freeze();
+
     int addFlag(const de::String &id, int value);
 
     int addEpisode();
@@ -190,6 +202,30 @@ public:
     int getStateNum(const char *id) const;
     int getStateNum(const de::String &id) const;
 
+    /**
+     * Returns the action function name of a state. The returned text remains valid
+     * until the definitions are modified.
+     */
+    const char *getStateAction(int num) const;
+
+    /**
+     * Returns the console command executed when a map object enters a state.
+     * The returned text remains valid until the definitions are modified.
+     */
+    const char *getStateExecute(int num) const;
+
+    /**
+     * Returns the script source executed when a thing is touched. The returned
+     * text remains valid until the definitions are modified.
+     */
+    const char *getThingOnTouch(int num) const;
+
+    /**
+     * Returns the script source executed when a thing dies. The returned text
+     * remains valid until the definitions are modified.
+     */
+    const char *getThingOnDeath(int num) const;
+
     int getTextNum(const char *id) const;
 
     int getValueNum(const char *id) const;
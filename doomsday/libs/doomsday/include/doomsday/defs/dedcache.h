@@ -0,0 +1,124 @@
+/** @file dedcache.h  Persistent cache of parsed definitions.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDOOMSDAY_DEDCACHE_H
+#define LIBDOOMSDAY_DEDCACHE_H
+
+#include "../libdoomsday.h"
+#include "ded.h"
+
+#include <de/block.h>
+
+/**
+ * Persistent cache of parsed definitions.
+ *
+ * While a DEDCache exists, the texts given to DED_ReadData() are collected instead
+ * of being parsed. When finish() is called, the collected texts are identified by a
+ * hash of their contents and source paths, the loaded game, and the definitions that
+ * existed before collecting began. If the metadata cache has the result of parsing
+ * the same texts, the definitions are restored from there. Otherwise the texts are
+ * parsed and the resulting definitions are stored in the cache.
+ *
+ * The files included while parsing, the results of the SkipIf/IncludeIf conditions,
+ * and the model paths are stored with the definitions. Restoring fails if an included
+ * file or the result of a condition has changed.
+ *
+ * Errors in the collected texts are found when they are parsed in finish(). Texts
+ * collected while errors are fatal (see setErrorsFatal()) stop the parsing, and
+ * finish() reports the failure to the caller. Errors in other texts are logged.
+ */
+class LIBDOOMSDAY_PUBLIC DEDCache
+{
+public:
+    /**
+     * Begins collecting the definition texts that are read into @a defs.
+     */
+    DEDCache(ded_t &defs);
+
+    /**
+     * Texts that have not been parsed when the cache is deleted are discarded.
+     */
+    ~DEDCache();
+
+    /**
+     * Returns the cache that is collecting or parsing the texts of @a defs, if any.
+     */
+    static DEDCache *active(const ded_t *defs);
+
+    /**
+     * Called by DED_ReadData() when a text is read.
+     *
+     * @return @c true, if the text was collected for finish(). @c false, if the text
+     * needs to be parsed immediately (e.g., it is included by a collected text).
+     */
+    bool collect(const char *buffer, const de::String &sourceFile, bool sourceIsCustom);
+
+    /**
+     * Called by the parser when the condition of a SkipIf or IncludeIf is checked.
+     */
+    void conditionChecked(const de::String &cond, bool value);
+
+    /**
+     * Called by the parser when a model path is added.
+     */
+    void modelPathAdded(const de::String &nativePath);
+
+    /**
+     * Determines whether parse errors in the texts collected from now on are fatal.
+     * Def_ReadProcessDED() uses this for the definition files it reads.
+     */
+    void setErrorsFatal(bool errorsFatal);
+
+    /**
+     * Restores the definitions of the collected texts from the cache, or parses the
+     * texts. Collecting stops. Parse errors in texts that are not fatal are logged.
+     *
+     * @return @c false, if parsing stopped because of a fatal error. DED_Error()
+     * describes the error.
+     */
+    bool finish();
+
+    /**
+     * Determines if the definitions were restored from the cache in finish().
+     */
+    bool isRestored() const;
+
+    /**
+     * Serializes all the definitions of @a defs.
+     */
+    static de::Block serialize(const ded_t &defs);
+
+    /**
+     * Replaces the definitions of @a defs with serialized ones.
+     *
+     * @param defs  Definitions.
+     * @param data  Data written by serialize().
+     */
+    static void deserialize(ded_t &defs, const de::Block &data);
+
+    /**
+     * Calculates a hash of all the definitions of @a defs. Unlike the serialized
+     * data, the hash does not change when the same definitions are created again.
+     */
+    static de::Block digest(const ded_t &defs);
+
+private:
+    DE_PRIVATE(d)
+};
+
+#endif // LIBDOOMSDAY_DEDCACHE_H
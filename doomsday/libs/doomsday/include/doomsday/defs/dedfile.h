@@ -24,6 +24,7 @@
 
 #include "../libdoomsday.h"
 #include "ded.h"
+#include <de/block.h>
 #include <de/string.h>
 
 LIBDOOMSDAY_PUBLIC void Def_ReadProcessDED(ded_t *defs, const de::String& path);
@@ -49,6 +50,17 @@ LIBDOOMSDAY_PUBLIC int DED_ReadData(ded_t *ded, const char *buffer, de::String s
  */
 int DED_Read(ded_t *ded, const de::String& path);
 
+/**
+ * Reads the text of a definition file without parsing it. The file is located in
+ * the same way as in Def_ReadProcessDED().
+ *
+ * @param path  Path of the file.
+ * @param text  The text is written here.
+ *
+ * @return @c true, if the file was found.
+ */
+LIBDOOMSDAY_PUBLIC bool DED_ReadFileText(const de::String &path, de::Block &text);
+
 void DED_SetError(const de::String &message);
 
 LIBDOOMSDAY_PUBLIC const char *DED_Error();
@@ -39,6 +39,20 @@ public:
 
     int parse(const char *buffer, de::String sourceFile, bool sourceIsCustom);
 
+    /**
+     * Evaluates a condition of the SkipIf and IncludeIf directives.
+     *
+     * @param cond  Command line option (beginning with a hyphen) or a game ID.
+     *
+     * @return @c true, if the option is present or the game is loaded.
+     */
+    static bool checkCondition(const char *cond);
+
+    /**
+     * Adds a search path for model files, as done by the ModelPath directive.
+     */
+    static void addModelPath(const de::String &nativePath);
+
 private:
     DE_PRIVATE(d)
 };
@@ -114,6 +114,13 @@ public:
      */
     const de::DictionaryValue &lookup(const de::String &key) const;
 
+    /**
+     * Returns a number that changes whenever definitions are added or cleared, or
+     * the lookup dictionaries change. Data derived from the register can use this
+     * to check that it is still up to date.
+     */
+    de::duint32 version() const;
+
 private:
     DE_PRIVATE(d)
 };
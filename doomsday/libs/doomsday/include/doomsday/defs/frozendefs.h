@@ -0,0 +1,104 @@
+/** @file frozendefs.h  Definitions compiled into tables for runtime lookups.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDOOMSDAY_FROZENDEFS_H
+#define LIBDOOMSDAY_FROZENDEFS_H
+
+#include "../libdoomsday.h"
+#include <de/string.h>
+
+struct ded_s;
+
+/**
+ * Immutable tables compiled from the things, states, sprites, and materials of a
+ * ded_t, for the lookups done at runtime.
+ *
+ * The registers store each definition as a Record and find definitions with
+ * dictionaries of lower-cased text keys, so every lookup allocates and compares
+ * strings. The frozen tables are arrays addressed by definition index, and the
+ * IDs are found with open-addressed hash indices that hash the IDs case
+ * insensitively without allocating memory.
+ *
+ * The tables are a snapshot: if definitions are later added to the registers or
+ * their lookup keys change, the tables are no longer current and the lookups
+ * return Unavailable, so that the caller uses the registers instead. Changes to
+ * other values of existing definitions are not noticed. IDs that contain non-ASCII
+ * characters are not indexed.
+ */
+class LIBDOOMSDAY_PUBLIC FrozenDefs
+{
+public:
+    /// Returned by lookups that the tables cannot answer.
+    static constexpr int Unavailable = -2;
+
+    /// Per-state values used at runtime. Texts are offsets in the text table.
+    struct State
+    {
+        de::duint32 action;
+        de::duint32 execute;
+    };
+
+    /// Per-thing values used at runtime. Texts are offsets in the text table.
+    struct Thing
+    {
+        de::duint32 onTouch;
+        de::duint32 onDeath;
+    };
+
+public:
+    FrozenDefs();
+
+    /**
+     * Compiles the tables from the current definitions. @a defs must remain in
+     * existence until the tables are cleared.
+     */
+    void freeze(const ded_s &defs);
+
+    void clear();
+
+    /**
+     * Determines if the tables have been compiled and still match the definitions
+     * they were compiled from.
+     */
+    bool isCurrent() const;
+
+    /**
+     * Returns the runtime values of a state, or @c nullptr if @a stateNum is out
+     * of range or the tables are not current.
+     */
+    const State *state(int stateNum) const;
+
+    const Thing *thing(int thingNum) const;
+
+    /**
+     * Returns a text from the text table. Offset zero is an empty string.
+     */
+    const char *text(de::duint32 offset) const;
+
+    // Lookups return the definition index, -1 if not found, or Unavailable.
+    int stateNum(const char *id) const;
+    int thingNum(const char *id) const;
+    int thingNumForName(const char *name) const;
+    int spriteNum(const char *id) const;
+    int materialNum(const char *uri) const;
+
+private:
+    DE_PRIVATE(d)
+};
+
+#endif // LIBDOOMSDAY_FROZENDEFS_H
@@ -112,6 +112,21 @@ public:
      */
     FileHandle &rewind();
 
+    /**
+     * Maps the contents of the native file into memory (read-only). The mapping
+     * remains valid until the handle is closed. Mapping is only possible for
+     * handles opened on a native file; the mapping is created on the first call.
+     *
+     * @return  Start of the file contents (at baseOffset()), or @c nullptr if the
+     *      file could not be mapped.
+     */
+    const uint8_t *map();
+
+    /**
+     * @return  Number of bytes accessible via map(), starting at baseOffset().
+     */
+    size_t mappedSize() const;
+
 public:
     /**
      * Create a new handle on the File @a file.
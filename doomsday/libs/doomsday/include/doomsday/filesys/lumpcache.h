@@ -25,35 +25,36 @@
 #include <vector>
 
 /**
+ * Cache of lump data for a single file (e.g., a WAD or ZIP). Lumps are
+ * identified by their index in the file.
+ *
+ * All lump caches share a process-wide memory budget. Cached data is either
+ * locked, meaning it is in use and must stay in memory, or unlocked. Locks are
+ * counted, so the data is unlocked when each lock has been released. When the
+ * total size of the cached data exceeds the budget, the least recently used
+ * unlocked data is evicted (in any of the caches).
+ *
+ * The cached data must be allocated from the memory zone; the cache takes
+ * ownership of it.
+ *
  * @ingroup fs
  */
 class LIBDOOMSDAY_PUBLIC LumpCache
 {
-private:
-    /**
-     * Data item. Represents a lump of data in the cache.
-     */
-    class Data
-    {
-    public:
-        explicit Data(uint8_t *data = 0);
-
-        ~Data();
-
-        uint8_t *data() const;
-
-        const uint8_t *replaceData(uint8_t *newData);
-
-        Data &clearData(bool *retCleared = 0);
-
-        Data &lock();
-
-        Data &unlock();
+public:
+    /// Default memory budget, in bytes.
+    static const de::dsize DEFAULT_BUDGET = 256 * 1024 * 1024;
 
-    private:
-        uint8_t *data_;
+    struct Statistics
+    {
+        de::dsize   budget;
+        de::dsize   totalBytes;  ///< Size of all cached data.
+        de::dsize   lockedBytes; ///< Size of the locked data.
+        de::duint   lumpCount;   ///< Number of cached lumps.
+        de::duint64 hits;
+        de::duint64 misses;
+        de::duint64 evictions;
     };
-    typedef std::vector<Data> DataCache;
 
 public:
     explicit LumpCache(uint size);
@@ -63,11 +64,52 @@ public:
 
     bool isValidIndex(uint idx) const;
 
+    /**
+     * Returns the cached data of a lump, or @c nullptr if it is not in the cache.
+     * Unlocked data may be evicted at any time, even by other threads; use read()
+     * or lockData() instead to access the data.
+     */
     const uint8_t *data(uint lumpIdx) const;
 
-    LumpCache &insert(uint lumpIdx, uint8_t *data);
+    /**
+     * Copies a range of the cached data of a lump. The cache stays locked during
+     * the copy, so the data cannot be evicted while it is being read.
+     *
+     * @param lumpIdx       Lump index.
+     * @param buffer        Data is copied here.
+     * @param offset        Offset in the lump data.
+     * @param length        Maximum number of bytes to copy.
+     * @param retBytesRead  Number of bytes copied is written here.
+     *
+     * @return @c true, if the lump was in the cache.
+     */
+    bool read(uint lumpIdx, uint8_t *buffer, de::dsize offset, de::dsize length,
+              de::dsize *retBytesRead = 0) const;
 
-    LumpCache &insertAndLock(uint lumpIdx, uint8_t *data);
+    /**
+     * Returns the cached data of a lump and locks it, or @c nullptr if the lump is
+     * not in the cache.
+     */
+    const uint8_t *lockData(uint lumpIdx);
+
+    /**
+     * Adds the data of a lump to the cache as unlocked. Any previously cached data
+     * of the lump is freed, unless it is locked: then @a data is freed instead.
+     *
+     * @param lumpIdx  Lump index.
+     * @param data     Data allocated with Z_Malloc(). The cache takes ownership.
+     * @param size     Size of the data in bytes.
+     */
+    LumpCache &insert(uint lumpIdx, uint8_t *data, de::dsize size);
+
+    /**
+     * Adds the data of a lump to the cache and locks it. If another copy of the
+     * data is already cached and locked (e.g., another thread cached the lump at
+     * the same time), that copy is locked instead and @a data is freed.
+     *
+     * @return The locked data.
+     */
+    const uint8_t *insertAndLock(uint lumpIdx, uint8_t *data, de::dsize size);
 
     LumpCache &lock(uint lumpIdx);
 
@@ -77,7 +119,37 @@ public:
 
     LumpCache &clear();
 
-protected:
+public:
+    /**
+     * Sets the maximum total size of the data in all lump caches. Unlocked data
+     * is evicted if necessary.
+     *
+     * @param bytes  Memory budget.
+     */
+    static void setBudget(de::dsize bytes);
+
+    static de::dsize budget();
+
+    static Statistics statistics();
+
+private:
+    /**
+     * Data item. Represents a lump of data in the cache.
+     */
+    struct Data
+    {
+        uint8_t * data      = nullptr;
+        de::dsize size      = 0;
+        int       lockCount = 0;
+        Data *    older     = nullptr; ///< Unlocked data in least recently used order.
+        Data *    newer     = nullptr;
+    };
+    typedef std::vector<Data> DataCache;
+
+    struct Shared;
+
+    const uint8_t *store(uint lumpIdx, uint8_t *data, de::dsize size, bool locked);
+
     Data *cacheRecord(uint lumpIdx);
 
     const Data *cacheRecord(uint lumpIdx) const;
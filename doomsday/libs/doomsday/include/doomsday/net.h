@@ -21,6 +21,7 @@
 #pragma once
 
 #include "libdoomsday.h"
+#include <de/deflatedictionary.h>
 #include <de/ibytearray.h>
 #include <de/legacy/types.h>
 #include <de/transmitter.h>
@@ -55,6 +56,14 @@ public:
      */
     void sendDataToPlayer(int player, const de::IByteArray &data);
 
+    /**
+     * Returns the preset dictionary for compressing frame packets, or @c nullptr
+     * if there isn't one. The dictionary is trained from captured frames and
+     * read from "network/frames.dict" in the base package. The server uses it
+     * for sending if the client has the same dictionary.
+     */
+    const de::DeflateDictionary *frameDictionary() const;
+
 private:
     DE_PRIVATE(d)
 };
@@ -29,7 +29,7 @@
  * Server protocol version number.
  * @deprecated Will be replaced with the libcore serialization protocol version.
  */
-#define SV_VERSION          24
+#define SV_VERSION          25
 
 // Packet types.
 // PKT = sent by anyone
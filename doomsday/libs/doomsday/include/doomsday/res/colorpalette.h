@@ -130,6 +130,8 @@ public:
 
     /**
      * Given an R8G8B8 color triplet return the closet matching color index.
+     * The first lookup builds a lookup table for the palette, after which only a
+     * few candidate colors need to be checked. Can be called from any thread.
      *
      * @param rgb  R8G8B8 color to be matched.
      *
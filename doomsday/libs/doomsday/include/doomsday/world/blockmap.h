@@ -34,11 +34,61 @@ class BlockmapDebugVisual;
 
 namespace world {
 
+/**
+ * Grid of cells, each of which has a list of the map elements linked to it.
+ *
+ * The cells are stored in a dense array. Each cell has room for a few elements
+ * inline; more space is allocated only for crowded cells, so linking and
+ * unlinking usually requires no memory allocation.
+ *
+ * Elements may be linked and unlinked while iterating.
+ */
 class LIBDOOMSDAY_PUBLIC Blockmap
 {
 public:
     typedef de::Vec2ui Cell;
 
+    /// Maximum number of cells visited by forEachInPath().
+    static constexpr int MAX_PATH_CELLS = 64;
+
+    /**
+     * Elements linked to a cell. Unlinking leaves a vacant slot behind, which is
+     * reused by the next link, so that iteration over the slots remains valid
+     * while elements are being linked and unlinked.
+     */
+    class LIBDOOMSDAY_PUBLIC CellElements
+    {
+    public:
+        CellElements();
+        CellElements(CellElements &&moved);
+        ~CellElements();
+
+        /// Number of slots in use, including vacant ones.
+        inline de::duint slotCount() const { return _slotCount; }
+
+        /// Returns the element in slot @a index, or @c nullptr if the slot is vacant.
+        inline void *at(de::duint index) const { return (_heap? _heap : _inline)[index]; }
+
+        /// Number of linked elements.
+        inline de::dint count() const { return _count; }
+
+        void link(void *elem);
+        bool unlink(void *elem);
+        void clear();
+
+    private:
+        CellElements(const CellElements &) = delete;
+        CellElements &operator = (const CellElements &) = delete;
+
+        static constexpr de::duint INLINE_CAPACITY = 3;
+
+        void *    _inline[INLINE_CAPACITY];
+        void **   _heap = nullptr; ///< Used instead of _inline when more space is needed.
+        de::duint _capacity  = INLINE_CAPACITY;
+        de::duint _slotCount = 0;
+        de::dint  _count     = 0;
+    };
+
     /**
      * POD structure for representing an inclusive-exclusive rectangular range
      * of cells.
@@ -128,6 +178,25 @@ public:
      */
     CellBlock toCellBlock(const AABoxd &box, bool *didClip = 0) const;
 
+    /**
+     * Returns the elements linked to @a cell, or @c nullptr if the cell is outside
+     * the blockmap.
+     */
+    const CellElements *cellElements(const Cell &cell) const;
+
+    /**
+     * Determines which cells are intercepted by the line specified by the two map
+     * space points @a from and @a to. See forAllInPath().
+     *
+     * @param from   Map space point defining the origin of the line.
+     * @param to     Map space point defining the destination of the line.
+     * @param cells  The intercepted cells are written here, in order from @a from
+     *               to @a to. Must have room for MAX_PATH_CELLS cells.
+     *
+     * @return Number of cells written to @a cells.
+     */
+    int cellsInPath(const de::Vec2d &from, const de::Vec2d &to, Cell *cells) const;
+
     /**
      * Retrieve the number of elements linked in the specified @a cell.
      *
@@ -147,6 +216,65 @@ public:
 
     void unlinkAll();
 
+    /**
+     * Iterate through all objects in the given @a cell. Unlike forAllInCell(), the
+     * callback can be inlined.
+     *
+     * @param cell  Cell to iterate.
+     * @param func  Callback that returns a LoopResult (or something convertible).
+     */
+    template <typename Func>
+    de::LoopResult forEachInCell(const Cell &cell, Func &&func) const
+    {
+        if (const CellElements *elems = cellElements(cell))
+        {
+            // Elements may be linked and unlinked by the callback.
+            for (de::duint i = 0; i < elems->slotCount(); ++i)
+            {
+                if (void *object = elems->at(i))
+                {
+                    if (auto result = de::LoopResult(func(object))) return result;
+                }
+            }
+        }
+        return de::LoopContinue;
+    }
+
+    /**
+     * Iterate through all objects in all cells which intercept the given map
+     * space, axis-aligned bounding @a box. Unlike forAllInBox(), the callback can
+     * be inlined.
+     */
+    template <typename Func>
+    de::LoopResult forEachInBox(const AABoxd &box, Func &&func) const
+    {
+        const CellBlock cellBlock = toCellBlock(box);
+        Cell cell;
+        for (cell.y = cellBlock.min.y; cell.y < cellBlock.max.y; ++cell.y)
+        for (cell.x = cellBlock.min.x; cell.x < cellBlock.max.x; ++cell.x)
+        {
+            if (auto result = forEachInCell(cell, func)) return result;
+        }
+        return de::LoopContinue;
+    }
+
+    /**
+     * Iterate over all objects in cells which intercept the line specified by the
+     * two map space points @a from and @a to. Unlike forAllInPath(), the callback
+     * can be inlined.
+     */
+    template <typename Func>
+    de::LoopResult forEachInPath(const de::Vec2d &from, const de::Vec2d &to, Func &&func) const
+    {
+        Cell cells[MAX_PATH_CELLS];
+        const int count = cellsInPath(from, to, cells);
+        for (int i = 0; i < count; ++i)
+        {
+            if (auto result = forEachInCell(cells[i], func)) return result;
+        }
+        return de::LoopContinue;
+    }
+
     /**
      * Iterate through all objects in the given @a cell.
      */
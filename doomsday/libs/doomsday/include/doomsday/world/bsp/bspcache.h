@@ -0,0 +1,103 @@
+/** @file bspcache.h  Persistent cache of built BSP trees and map geometry.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#pragma once
+
+#include "../bspnode.h"
+#include "../../mesh/mesh.h"
+
+#include <de/block.h>
+#include <de/list.h>
+#include <de/set.h>
+#include <de/vector.h>
+
+namespace world {
+
+class Line;
+class Sector;
+
+namespace bsp {
+
+/**
+ * Persistent cache for the output of Partitioner: the BSP tree, the vertices added
+ * to the map mesh, the convex subspaces with their half-edge geometry, and the line
+ * side segments.
+ *
+ * The cached data is kept in the MetadataBank. It is identified by a hash of all the
+ * input used by the partitioner (vertex coordinates, line connectivity, sectors, and
+ * the split cost factor), so any change to the map geometry results in a new build.
+ *
+ * @ingroup bsp
+ */
+class BspCache
+{
+public:
+    /// Unclosed sector encountered during the build.
+    struct UnclosedSector
+    {
+        Sector *sector;
+        de::Vec2d nearPoint;
+    };
+    typedef de::List<UnclosedSector> UnclosedSectors;
+
+public:
+    /**
+     * Identifies the geometry of a map. Must be constructed before partitioning,
+     * because the partitioner adds new vertices to the mesh.
+     *
+     * @param lines            All lines of the map, in index order.
+     * @param linesToBuildFor  Lines that the BSP is built for.
+     * @param sectors          All sectors of the map, in index order.
+     * @param mesh             Map mesh.
+     * @param splitCostFactor  Split cost factor of the partitioner.
+     */
+    BspCache(const de::List<Line *> &lines, const de::Set<Line *> &linesToBuildFor,
+             const de::List<Sector *> &sectors, mesh::Mesh &mesh, int splitCostFactor);
+
+    /**
+     * Identifier of the map geometry in the cache.
+     */
+    de::Block key() const;
+
+    /**
+     * Restores a previously built BSP tree from the cache. New vertices, half-edges,
+     * faces, and line side segments are added to the map.
+     *
+     * @param unclosedSectors  Unclosed sectors found when the tree was built.
+     *
+     * @return New BSP tree (ownership given to caller), or @c nullptr if the geometry
+     * is not in the cache or the cached data is unusable. In that case the map is left
+     * unmodified.
+     */
+    BspTree *restore(UnclosedSectors &unclosedSectors);
+
+    /**
+     * Stores a newly built BSP tree in the cache.
+     *
+     * @param tree             BSP tree built by Partitioner.
+     * @param unclosedSectors  Unclosed sectors found during the build.
+     */
+    void store(const BspTree &tree, const UnclosedSectors &unclosedSectors);
+
+private:
+    DE_PRIVATE(d)
+};
+
+}  // namespace bsp
+}  // namespace world
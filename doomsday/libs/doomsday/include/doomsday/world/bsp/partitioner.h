@@ -50,7 +50,7 @@ static const double DIST_EPSILON        = 1.0 / 128.0;
  *
  * @ingroup bsp
  */
-class Partitioner
+class LIBDOOMSDAY_PUBLIC Partitioner
 {
 public:
     /// Notified when an unclosed sector is first found.
@@ -71,6 +71,12 @@ public:
      */
     void setSplitCostFactor(int newFactor);
 
+    /**
+     * Enable or disable the concurrent evaluation of partition candidates (enabled by
+     * default). The built tree is identical in both cases.
+     */
+    void setConcurrent(bool enabled);
+
     /**
      * Build a new BspTree for the given geometry.
      *
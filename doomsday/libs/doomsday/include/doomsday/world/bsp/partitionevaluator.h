@@ -34,8 +34,10 @@ class PartitionEvaluator
 public:
     /**
      * @param splitCostFactor  Split cost multiplier.
+     * @param concurrent       Evaluate the candidates using the shared thread pool.
+     *                         The chosen partition is the same either way.
      */
-    PartitionEvaluator(int splitCostFactor);
+    PartitionEvaluator(int splitCostFactor, bool concurrent = true);
 
     /**
      * Find the best line segment to use as the next partition.
@@ -23,7 +23,12 @@
 #ifndef DE_WORLD_REJECT_H
 #define DE_WORLD_REJECT_H
 
-#if 0 // Needs updating
+#include "../libdoomsday.h"
+#include <de/list.h>
+#include <de/vector.h>
+
+namespace world {
+
 class Map;
 
 /**
@@ -64,14 +69,118 @@ class Map;
  *
  *     ceiling(numSectors^2)
  *
- * For now we only do very basic reject processing, limited to determining
- * all isolated sector groups (islands that are surrounded by void space).
+ * The table is computed from the map geometry, assuming that all the sectors
+ * are open (i.e., heights and closed doors are ignored) and that everything
+ * inside a sector can be seen from everywhere in it.
  *
  * @note Algorithm:
- * Initially all sectors are in individual groups. Next, we scan the line
- * list. For each 2-sectored line, merge the two sector groups into one.
+ * Sectors are connected by portals, i.e., two-sided lines that have a different
+ * sector on each side. Starting from each sector in turn, the portal graph is
+ * searched. A sector can be seen if there is a chain of portals
+ * leading to it that can be crossed by a single straight line, in the direction
+ * of travel. For a chain of portals (p1, q1) ... (pn, qn), oriented so that the
+ * line goes from the left side to the right side of each portal, this is the
+ * case if there is a normal vector a for which a · (qj - pi) >= 0 for all i
+ * and j. The possible normals form an arc of directions, which is narrowed as
+ * the chain grows; when the arc becomes empty, the chain ends there. To keep
+ * the search fast, each new portal is only checked against the first and the
+ * previous portal of the chain, and a portal is not searched again with
+ * directions that have already been searched from it. This can only make more
+ * sectors visible.
+ *
+ * If the search from a sector takes too long, all the sectors connected to it
+ * are considered visible. The results are made symmetric.
+ *
+ * Sounds travel around corners, so for hearing only the isolated sector groups
+ * (islands that are surrounded by void space) are considered.
  */
-byte *BuildRejectForMap(const Map &map);
-#endif
+class LIBDOOMSDAY_PUBLIC SectorVisibility
+{
+public:
+    /// Two-sided line between two different sectors.
+    struct Portal
+    {
+        de::Vec2d from;
+        de::Vec2d to;
+        int line;  ///< Index of the line.
+        int front; ///< Index of the sector on the right side.
+        int back;  ///< Index of the sector on the left side.
+    };
+
+    /**
+     * The parts of a map that the visibility depends on. The geometry is copied
+     * so that the visibility can be determined in a background thread while the
+     * map is in use.
+     */
+    struct Geometry
+    {
+        int sectorCount = 0;
+        int lineCount   = 0;
+        de::List<Portal> portals;
+
+        Geometry(const Map &map);
+    };
+
+public:
+    /**
+     * Determines the visibility between the sectors of @a map.
+     */
+    SectorVisibility(const Map &map);
+
+    /**
+     * Determines the visibility between the sectors of a map. This can be a
+     * lengthy operation, and may be done in any thread.
+     */
+    SectorVisibility(const Geometry &geometry);
+
+    inline int sectorCount() const { return _groups.sizei(); }
+
+    /**
+     * Returns the isolated group of the sector with index @a sectorIndex. Group
+     * numbers are in the range [0, groupCount()).
+     */
+    inline int group(int sectorIndex) const { return _groups[sectorIndex]; }
+
+    inline int groupCount() const { return _groupCount; }
+
+    /**
+     * Returns the number of sectors whose visibility was approximated with
+     * their group, because searching the portals took too long.
+     */
+    inline int approximatedCount() const { return _approximatedCount; }
+
+    /**
+     * Determines whether something in sector @a b might be visible from sector
+     * @a a. Negative sector indices are considered visible from everywhere.
+     */
+    inline bool isVisible(int a, int b) const
+    {
+        if (a < 0 || b < 0) return true;
+        return (_visible[de::dsize(a) * _rowWords + (b >> 5)] & (1u << (b & 31))) != 0;
+    }
+
+    /**
+     * Determines whether a sound in sector @a b might be heard in sector @a a.
+     * Negative sector indices are considered audible from everywhere.
+     */
+    inline bool isAudible(int a, int b) const
+    {
+        return a < 0 || b < 0 || _groups[a] == _groups[b];
+    }
+
+    /**
+     * Returns the fraction of sector pairs that might see each other.
+     */
+    double visibleFraction() const;
+
+private:
+    de::List<int> _groups;
+    int _groupCount = 0;
+    int _approximatedCount = 0;
+    de::dsize _rowWords = 0;
+    de::List<de::duint32> _visible; ///< Bit matrix of sector pairs, one row per sector.
+};
+
+} // namespace world
 
 #endif // DE_WORLD_REJECT_H
@@ -45,6 +45,14 @@
 #include <doomsday/world/plane.h>
 #include <doomsday/world/sector.h>
 #include <doomsday/world/thinkers.h>
+#include <doomsday/console/cmd.h>
+
+#include <de/hash.h>
+#include <de/lockable.h>
+#include <de/logbuffer.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 using namespace de;
 
@@ -363,6 +371,58 @@ int P_Callbackp(int type, void *elPtr, int (*callback)(void *p, void *ctx), void
     return false; // Continue iteration.
 }
 
+/**
+ * Call counts of the DMU properties accessed by the games. Used for finding out
+ * which properties deserve typed accessors (see the "dmuprofile" command).
+ */
+struct DmuProfile : public Lockable
+{
+    struct Counts
+    {
+        duint64 gets = 0;
+        duint64 sets = 0;
+    };
+
+    std::atomic<bool> enabled { false };  // checked without locking
+    Hash<duint64, Counts> counts; // (type << 32) | modifiers | prop
+
+    static DmuProfile &get()
+    {
+        static DmuProfile profile;
+        return profile;
+    }
+
+    static inline void count(const world::DmuArgs &args, bool set)
+    {
+        DmuProfile &profile = get();
+        if (!profile.enabled) return;
+
+        DE_GUARD(profile);
+        Counts &c = profile.counts[(duint64(args.type) << 32) | duint(args.modifiers) | args.prop];
+        (set? c.sets : c.gets)++;
+    }
+
+    static String propertyName(duint64 key)
+    {
+        static const struct { duint flag; const char *name; } modifiers[] = {
+            { DMU_BACK_OF_LINE,      "back" },
+            { DMU_FRONT_OF_LINE,     "front" },
+            { DMU_TOP_OF_SIDE,       "top" },
+            { DMU_MIDDLE_OF_SIDE,    "middle" },
+            { DMU_BOTTOM_OF_SIDE,    "bottom" },
+            { DMU_FLOOR_OF_SECTOR,   "floor" },
+            { DMU_CEILING_OF_SECTOR, "ceiling" },
+        };
+        const duint prop = duint(key);
+        String name = DMU_Str(duint(key >> 32));
+        for (const auto &mod : modifiers)
+        {
+            if (prop & mod.flag) name += Stringf(".%s", mod.name);
+        }
+        return name + Stringf(".%s", DMU_Str(prop & ~DMU_FLAG_MASK));
+    }
+};
+
 /**
  * Only those properties that are writable by outside parties (such as games)
  * are included here. Attempting to set a non-writable property causes a
@@ -380,6 +440,8 @@ static void setProperty(world::MapElement *elem, world::DmuArgs &args)
     
     DE_ASSERT(elem != 0);
 
+    DmuProfile::count(args, true);
+
     /**
      * @par Algorithm
      * When setting a property, reference resolution is done hierarchically so
@@ -491,6 +553,8 @@ static void getProperty(const world::MapElement *elem, world::DmuArgs &args)
 
     DE_ASSERT(elem != 0);
 
+    DmuProfile::count(args, false);
+
     // Dereference where necessary. Note the order, these cascade.
     if(args.type == DMU_SECTOR)
     {
@@ -1322,7 +1386,7 @@ int Mobj_BoxIterator(const AABoxd *box,
         const auto &map           = world::World::get().map();
         const int localValidCount = world::World::validCount;
 
-        result = map.mobjBlockmap().forAllInBox(*box, [&callback, &context, &localValidCount] (void *object)
+        result = map.mobjBlockmap().forEachInBox(*box, [&callback, &context, &localValidCount] (void *object)
         {
             mobj_t &mob = *reinterpret_cast<mobj_t *>(object);
             if(mob.validCount != localValidCount) // not yet processed
@@ -1347,7 +1411,7 @@ int Polyobj_BoxIterator(const AABoxd *box,
         const auto &map            = world::World::get().map();
         const dint localValidCount = world::World::validCount;
 
-        result = map.polyobjBlockmap().forAllInBox(*box, [&callback, &context, &localValidCount] (void *object)
+        result = map.polyobjBlockmap().forEachInBox(*box, [&callback, &context, &localValidCount] (void *object)
         {
             auto &pob = *reinterpret_cast<Polyobj *>(object);
             if(pob.validCount != localValidCount) // not yet processed
@@ -1382,7 +1446,7 @@ int Subspace_BoxIterator(const AABoxd *box,
     const dint localValidCount = world::World::validCount;
 
     return world::World::get().map().subspaceBlockmap()
-        .forAllInBox(*box, [&box, &callback, &context, &localValidCount] (void *object)
+        .forEachInBox(*box, [&box, &callback, &context, &localValidCount] (void *object)
     {
                          auto &sub = *(world::ConvexSubspace *)object;
         if (sub.validCount() != localValidCount) // not yet processed
@@ -1560,6 +1624,81 @@ void Line_Opening(world_Line *line, LineOpening *opening)
     *opening = LineOpening(*line);
 }
 
+int Line_Flags(const world_Line *line)
+{
+    DE_ASSERT(line);
+    return line->flags();
+}
+
+const AABoxd *Line_Bounds(const world_Line *line)
+{
+    DE_ASSERT(line);
+    return &line->bounds();
+}
+
+void Line_Direction(const world_Line *line, coord_t direction[2])
+{
+    DE_ASSERT(line && direction);
+    direction[0] = line->direction().x;
+    direction[1] = line->direction().y;
+}
+
+void Line_VertexOrigin(const world_Line *line, int to, coord_t origin[2])
+{
+    DE_ASSERT(line && origin);
+    const Vec2d &pos = line->vertex(to).origin();
+    origin[0] = pos.x;
+    origin[1] = pos.y;
+}
+
+world_Sector *Line_FrontSector(const world_Line *line)
+{
+    DE_ASSERT(line);
+    return line->front().sectorPtr();
+}
+
+world_Sector *Line_BackSector(const world_Line *line)
+{
+    DE_ASSERT(line);
+    return line->back().sectorPtr();
+}
+
+coord_t Sector_FloorHeight(const world_Sector *sector)
+{
+    DE_ASSERT(sector);
+    return sector->floor().height();
+}
+
+coord_t Sector_CeilingHeight(const world_Sector *sector)
+{
+    DE_ASSERT(sector);
+    return sector->ceiling().height();
+}
+
+static world_Material *surfaceMaterial(const world::Surface &surface)
+{
+    // Fix materials are not visible to the games (cf. Surface::property()).
+    return surface.hasFixMaterial()? nullptr : surface.materialPtr();
+}
+
+world_Material *Sector_FloorMaterial(const world_Sector *sector)
+{
+    DE_ASSERT(sector);
+    return surfaceMaterial(sector->floor().surface());
+}
+
+world_Material *Sector_CeilingMaterial(const world_Sector *sector)
+{
+    DE_ASSERT(sector);
+    return surfaceMaterial(sector->ceiling().surface());
+}
+
+float Sector_LightLevel(const world_Sector *sector)
+{
+    DE_ASSERT(sector);
+    return sector->lightLevel();
+}
+
 /*
  * Locates a mobj by it's unique identifier in the CURRENT map.
  */
@@ -1570,3 +1709,58 @@ struct mobj_s *Mobj_ById(dint id)
     if (!world::World::get().hasMap()) return nullptr;
     return world::World::get().map().thinkers().mobjById(id);
 }
+
+/**
+ * Console command for profiling the DMU property accesses of the game.
+ *
+ * - dmuprofile on   (clears the counts and starts counting)
+ * - dmuprofile off  (stops counting)
+ * - dmuprofile      (prints the counts, most frequently used properties first)
+ */
+D_CMD(DmuProfile)
+{
+    DE_UNUSED(src);
+
+    DmuProfile &profile = DmuProfile::get();
+    DE_GUARD(profile);
+
+    if (argc > 1)
+    {
+        const String arg = argv[1];
+        if (!arg.compareWithoutCase("on"))
+        {
+            profile.counts.clear();
+            profile.enabled = true;
+        }
+        else if (!arg.compareWithoutCase("off"))
+        {
+            profile.enabled = false;
+        }
+        else
+        {
+            LOG_SCR_NOTE("Usage: %s (on|off)") << argv[0];
+            return false;
+        }
+        LOG_SCR_MSG("DMU profiling %s") << (profile.enabled? "enabled" : "disabled");
+        return true;
+    }
+
+    typedef std::pair<duint64, DmuProfile::Counts> Entry;
+    std::vector<Entry> entries(profile.counts.begin(), profile.counts.end());
+    std::sort(entries.begin(), entries.end(), [] (const Entry &a, const Entry &b) {
+        return a.second.gets + a.second.sets > b.second.gets + b.second.sets;
+    });
+
+    LOG_SCR_MSG(_E(b) "DMU property accesses%s:") << (profile.enabled? "" : " (profiling off)");
+    for (const Entry &entry : entries)
+    {
+        LOG_SCR_MSG("%10i get %10i set  " _E(>) "%s")
+            << entry.second.gets << entry.second.sets << DmuProfile::propertyName(entry.first);
+    }
+    return true;
+}
+
+void DMU_ConsoleRegister()
+{
+    C_CMD("dmuprofile", nullptr, DmuProfile);
+}
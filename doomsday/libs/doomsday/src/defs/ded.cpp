@@ -27,6 +27,7 @@
 #include <de/arrayvalue.h>
 #include <de/numbervalue.h>
 #include <de/recordvalue.h>
+#include <de/textvalue.h>
 
 #include "doomsday/defs/decoration.h"
 #include "doomsday/defs/episode.h"
@@ -178,8 +179,14 @@ int ded_s::addSky()
     return def.geti(defn::Definition::VAR_ORDER);
 }
 
+void ded_s::freeze()
+{
+    frozen.freeze(*this);
+}
+
 void ded_s::release()
 {
+    frozen.clear();
     flags.clear();
     episodes.clear();
     things.clear();
@@ -362,6 +369,9 @@ int DED_AddLineType(ded_t* ded, int id)
 
 int ded_s::getMobjNum(const String &id) const
 {
+    const int frozenNum = frozen.thingNum(id.c_str());
+    if (frozenNum != FrozenDefs::Unavailable) return frozenNum;
+
     if (const Record *def = things.tryFind(defn::Definition::VAR_ID, id))
     {
         return def->geti(defn::Definition::VAR_ORDER);
@@ -379,6 +389,9 @@ int ded_s::getMobjNumForName(const char *name) const
     if (!name || !name[0])
         return -1;
 
+    const int frozenNum = frozen.thingNumForName(name);
+    if (frozenNum != FrozenDefs::Unavailable) return frozenNum;
+
     /*
     for (int i = mobjs.size() - 1; i >= 0; --i)
         if (!iCmpStrCase(mobjs[i].name, name))
@@ -400,16 +413,71 @@ String ded_s::getMobjName(int num) const
 
 int ded_s::getStateNum(const String &id) const
 {
-    if (const Record *def = states.tryFind(defn::Definition::VAR_ID, id))
+    return getStateNum(id.c_str());
+}
+
+int ded_s::getStateNum(const char *id) const
+{
+    const int frozenNum = frozen.stateNum(id);
+    if (frozenNum != FrozenDefs::Unavailable) return frozenNum;
+
+    if (const Record *def = states.tryFind(defn::Definition::VAR_ID, String(id)))
     {
         return def->geti(defn::Definition::VAR_ORDER);
     }
     return -1;
 }
 
-int ded_s::getStateNum(const char *id) const
+/**
+ * Returns the text of a definition member, pointing to the member's value. Used when
+ * the frozen tables are not available.
+ */
+static const char *dedMemberText(const Record &def, const char *name)
+{
+    if (def.has(name))
+    {
+        if (const auto *text = maybeAs<TextValue>(def[name].value()))
+        {
+            return static_cast<const String &>(*text).c_str();
+        }
+    }
+    return "";
+}
+
+const char *ded_s::getStateAction(int num) const
 {
-    return getStateNum(String(id));
+    if (const auto *state = frozen.state(num))
+    {
+        return frozen.text(state->action);
+    }
+    return dedMemberText(states[num], "action");
+}
+
+const char *ded_s::getStateExecute(int num) const
+{
+    if (const auto *state = frozen.state(num))
+    {
+        return frozen.text(state->execute);
+    }
+    return dedMemberText(states[num], "execute");
+}
+
+const char *ded_s::getThingOnTouch(int num) const
+{
+    if (const auto *thing = frozen.thing(num))
+    {
+        return frozen.text(thing->onTouch);
+    }
+    return dedMemberText(things[num], "onTouch");
+}
+
+const char *ded_s::getThingOnDeath(int num) const
+{
+    if (const auto *thing = frozen.thing(num))
+    {
+        return frozen.text(thing->onDeath);
+    }
+    return dedMemberText(things[num], "onDeath");
 }
 
 dint ded_s::evalFlags(const char *ptr) const
@@ -478,7 +546,11 @@ int ded_s::getMaterialNum(const res::Uri &uri) const
         /*if (idx >= 0)*/ return idx;
     }
 
-    if (const Record *def = materials.tryFind(defn::Definition::VAR_ID, uri.compose()))
+    const String composed = uri.compose();
+    const int frozenNum = frozen.materialNum(composed.c_str());
+    if (frozenNum != FrozenDefs::Unavailable) return frozenNum;
+
+    if (const Record *def = materials.tryFind(defn::Definition::VAR_ID, composed))
     {
         return def->geti(defn::Definition::VAR_ORDER);
     }
@@ -559,6 +631,9 @@ int ded_s::getSpriteNum(const String &id) const
 
 int ded_s::getSpriteNum(const char *id) const
 {
+    const int frozenNum = frozen.spriteNum(id);
+    if (frozenNum != FrozenDefs::Unavailable) return frozenNum;
+
     if (id && id[0])
     {
         for (dint i = 0; i < sprites.size(); ++i)
@@ -0,0 +1,735 @@
+/** @file dedcache.cpp  Persistent cache of parsed definitions.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "doomsday/defs/dedcache.h"
+#include "doomsday/defs/dedfile.h"
+#include "doomsday/defs/dedparser.h"
+#include "doomsday/doomsdayapp.h"
+#include "doomsday/game.h"
+
+#include <de/arrayvalue.h>
+#include <de/dictionaryvalue.h>
+#include <de/logbuffer.h>
+#include <de/metadatabank.h>
+#include <de/numbervalue.h>
+#include <de/reader.h>
+#include <de/recordvalue.h>
+#include <de/time.h>
+#include <de/writer.h>
+
+#include <cstring>
+#include <memory>
+
+using namespace de;
+
+DE_STATIC_STRING(DEDCACHE_CATEGORY, "DedCache");
+
+/// Changes whenever the parser output or the serialized format changes.
+static const duint32 DEDCACHE_FORMAT = 1;
+
+static DEDCache *activeDEDCache = nullptr;
+
+/// Registers of ded_t, in serialization order.
+static List<DEDRegister *> dedCacheRegisters(ded_t &defs)
+{
+    return {&defs.flags, &defs.episodes, &defs.things, &defs.states, &defs.materials,
+            &defs.models, &defs.skies, &defs.musics, &defs.mapInfos, &defs.finales,
+            &defs.decorations};
+}
+
+static Block dedCacheTextHash(const char *text)
+{
+    return Block(text).md5Hash();
+}
+
+//---------------------------------------------------------------------------------------
+
+/*
+ * The elements of the definition arrays are plain structs that also own memory via
+ * URIs, strings, and nested arrays. Each element is serialized as its raw bytes with
+ * the pointers cleared, followed by the owned data. These functions list the fields
+ * that own memory.
+ */
+
+template <typename Fields> static void dedElementFields(Fields &, ded_sprid_t &) {}
+template <typename Fields> static void dedElementFields(Fields &, ded_ptcstage_t &) {}
+template <typename Fields> static void dedElementFields(Fields &, ded_sectortype_t &) {}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_uri_t &e)
+{
+    f.uri(e.uri);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_light_t &e)
+{
+    f.uri(e.up);
+    f.uri(e.down);
+    f.uri(e.sides);
+    f.uri(e.flare);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_sound_t &e)
+{
+    f.uri(e.ext);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_text_t &e)
+{
+    f.text(e.text);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_tenviron_t &e)
+{
+    f.array(e.materials);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_value_t &e)
+{
+    f.text(e.id);
+    f.text(e.text);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_detailtexture_t &e)
+{
+    f.uri(e.material1);
+    f.uri(e.material2);
+    f.uri(e.stage.texture);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_ptcgen_t &e)
+{
+    f.link(e.stateNext); // set at runtime
+    f.uri(e.material);
+    f.uri(e.map);
+    f.array(e.stages);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_reflection_t &e)
+{
+    f.uri(e.material);
+    f.uri(e.stage.texture);
+    f.uri(e.stage.maskTexture);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_group_member_t &e)
+{
+    f.uri(e.material);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_group_t &e)
+{
+    f.array(e.members);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_linetype_t &e)
+{
+    f.uri(e.actMaterial);
+    f.uri(e.deactMaterial);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_compositefont_mappedcharacter_t &e)
+{
+    f.uri(e.path);
+}
+
+template <typename Fields> static void dedElementFields(Fields &f, ded_compositefont_t &e)
+{
+    f.uri(e.uri);
+    f.array(e.charMap);
+}
+
+/// Clears the pointers of an element, without releasing anything.
+struct DEDElementClearer
+{
+    void uri(res::Uri *&uri) { uri = nullptr; }
+    void text(char *&text) { text = nullptr; }
+    template <typename Type> void link(Type *&ptr) { ptr = nullptr; }
+    template <typename Type> void array(DEDArray<Type> &array)
+    {
+        array.elements  = nullptr;
+        array.count.num = array.count.max = 0;
+    }
+};
+
+template <typename Type> static void writeDEDArray(Writer &to, const DEDArray<Type> &array);
+template <typename Type> static void readDEDArray(Reader &from, DEDArray<Type> &array);
+
+struct DEDElementWriter
+{
+    Writer &to;
+
+    void uri(const res::Uri *uri)
+    {
+        to << dbyte(uri? 1 : 0);
+        if (uri) to << *uri;
+    }
+    void text(const char *text)
+    {
+        to << dbyte(text? 1 : 0);
+        if (text) to << String(text);
+    }
+    template <typename Type> void link(Type *) {}
+    template <typename Type> void array(const DEDArray<Type> &array)
+    {
+        writeDEDArray(to, array);
+    }
+};
+
+struct DEDElementReader
+{
+    Reader &from;
+
+    void uri(res::Uri *&uri)
+    {
+        dbyte present;
+        from >> present;
+        if (present)
+        {
+            std::unique_ptr<res::Uri> read(new res::Uri);
+            from >> *read;
+            uri = read.release();
+        }
+    }
+    void text(char *&text)
+    {
+        dbyte present;
+        from >> present;
+        if (present)
+        {
+            String str;
+            from >> str;
+            text = M_StrDup(str.c_str());
+        }
+    }
+    template <typename Type> void link(Type *&ptr) { ptr = nullptr; }
+    template <typename Type> void array(DEDArray<Type> &array)
+    {
+        readDEDArray(from, array);
+    }
+};
+
+template <typename Type>
+static void writeDEDArray(Writer &to, const DEDArray<Type> &array)
+{
+    DEDElementWriter writer{to};
+    to << dint32(array.size());
+    for (int i = 0; i < array.size(); ++i)
+    {
+        Block raw(&array[i], sizeof(Type));
+        DEDElementClearer clearer;
+        dedElementFields(clearer, *reinterpret_cast<Type *>(raw.data()));
+        to << raw;
+        dedElementFields(writer, array[i]);
+    }
+}
+
+template <typename Type>
+static void readDEDArray(Reader &from, DEDArray<Type> &array)
+{
+    dint32 count;
+    from >> count;
+    if (count < 0 || dsize(count) * sizeof(Type) > from.remainingSize())
+    {
+        throw Error("readDEDArray", "Invalid number of elements");
+    }
+    DEDElementReader reader{from};
+    Type *elements = array.append(count);
+    for (int i = 0; i < count; ++i)
+    {
+        Block raw;
+        from >> raw;
+        if (raw.size() != sizeof(Type))
+        {
+            throw Error("readDEDArray", "Invalid element size");
+        }
+        std::memcpy(&elements[i], raw.data(), sizeof(Type));
+
+        // The element must be valid to release even if reading fails.
+        DEDElementClearer clearer;
+        dedElementFields(clearer, elements[i]);
+        dedElementFields(reader, elements[i]);
+    }
+}
+
+struct DEDArrayWriter
+{
+    Writer &to;
+    template <typename Type> void operator()(const DEDArray<Type> &array) const
+    {
+        writeDEDArray(to, array);
+    }
+};
+
+struct DEDArrayReader
+{
+    Reader &from;
+    template <typename Type> void operator()(DEDArray<Type> &array) const
+    {
+        readDEDArray(from, array);
+    }
+};
+
+/// Writes the sizes of the element structs.
+struct DEDArrayLayoutWriter
+{
+    Writer &to;
+    template <typename Type> void operator()(const DEDArray<Type> &) const
+    {
+        to << duint32(sizeof(Type));
+    }
+};
+
+/// Calls @a op for each definition array of @a defs (const or non-const ded_t).
+template <typename Defs, typename Op>
+static void forDEDArrays(Defs &defs, Op op)
+{
+    op(defs.sprites);
+    op(defs.lights);
+    op(defs.sounds);
+    op(defs.text);
+    op(defs.textureEnv);
+    op(defs.values);
+    op(defs.details);
+    op(defs.ptcGens);
+    op(defs.reflections);
+    op(defs.groups);
+    op(defs.lineTypes);
+    op(defs.sectorTypes);
+    op(defs.compositeFonts);
+}
+
+static void writeDEDHeader(Writer &to, const ded_t &defs)
+{
+    to << dint32(defs.version) << dint32(defs.modelFlags) << defs.modelScale
+       << defs.modelOffset;
+}
+
+static void writeValueDigest(Writer &to, const Value &value);
+
+static void writeRecordDigest(Writer &to, const Record &record)
+{
+    to << duint32(record.members().size());
+    for (const auto &i : record.members())
+    {
+        to << i.first;
+        writeValueDigest(to, i.second->value());
+    }
+}
+
+static void writeValueDigest(Writer &to, const Value &value)
+{
+    if (const auto *recValue = maybeAs<RecordValue>(value))
+    {
+        // Referenced records are not part of the definition.
+        if (recValue->record() && recValue->hasOwnership())
+        {
+            writeRecordDigest(to, *recValue->record());
+        }
+        else
+        {
+            to << dbyte(0);
+        }
+    }
+    else if (const auto *array = maybeAs<ArrayValue>(value))
+    {
+        to << duint32(array->size());
+        for (const Value *element : array->elements())
+        {
+            writeValueDigest(to, *element);
+        }
+    }
+    else if (const auto *dict = maybeAs<DictionaryValue>(value))
+    {
+        to << duint32(dict->size());
+        for (const auto &i : dict->elements())
+        {
+            writeValueDigest(to, *i.first.value);
+            writeValueDigest(to, *i.second);
+        }
+    }
+    else if (is<NumberValue>(value))
+    {
+        to << value.asNumber();
+    }
+    else
+    {
+        to << value.asText();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+DE_PIMPL_NOREF(DEDCache)
+{
+    enum State { Collecting, Parsing, Finished };
+
+    struct Text
+    {
+        Block  text;
+        String sourceFile;
+        bool   custom;
+        bool   errorsFatal;
+    };
+
+    enum DependencyType : dbyte { IncludedFile = 0, Condition = 1, ModelPath = 2 };
+
+    struct Dependency
+    {
+        DependencyType type;
+        String         name;
+        Block          hash;  ///< Included file text.
+        bool           value; ///< Condition result.
+    };
+
+    ded_t &          defs;
+    State            state = Collecting;
+    Block            preState; ///< Definitions that existed before collecting.
+    Block            preStateDigest;
+    List<Text>       texts;
+    List<Dependency> dependencies;
+    bool             restored    = false;
+    bool             errorsFatal = false; ///< Applies to texts collected next.
+
+    Impl(ded_t &defs) : defs(defs)
+    {}
+
+    Block key() const
+    {
+        Block data;
+        Writer writer(data);
+        writer << DEDCACHE_FORMAT << dint32(DED_VERSION)
+               << (DoomsdayApp::game().isNull()? String() : DoomsdayApp::game().id())
+               << preStateDigest;
+
+        // The element structs are stored as raw bytes.
+        forDEDArrays(defs, DEDArrayLayoutWriter{writer});
+
+        writer << duint32(texts.size());
+        for (const Text &text : texts)
+        {
+            writer << text.sourceFile << dbyte(text.custom) << text.text.md5Hash();
+        }
+        return data.md5Hash();
+    }
+
+    bool restore(const Block &key, TimeSpan &parseTime)
+    {
+        try
+        {
+            Block data = MetadataBank::get().check(DEDCACHE_CATEGORY(), key);
+            if (!data) return false;
+
+            data = data.decompressed();
+            Reader reader(data);
+            duint32 format, count;
+            reader >> format;
+            if (format != DEDCACHE_FORMAT) return false;
+
+            ddouble seconds;
+            reader >> seconds >> count;
+            parseTime = seconds;
+
+            StringList modelPaths;
+            while (count-- > 0)
+            {
+                dbyte type;
+                String name;
+                reader >> type >> name;
+                switch (type)
+                {
+                case IncludedFile: {
+                    Block hash, text;
+                    reader >> hash;
+                    if (!DED_ReadFileText(name, text) || dedCacheTextHash(text.c_str()) != hash)
+                    {
+                        LOGDEV_RES_VERBOSE("\"%s\" has changed") << name;
+                        return false;
+                    }
+                    break; }
+
+                case Condition: {
+                    dbyte value;
+                    reader >> value;
+                    if (DEDParser::checkCondition(name.c_str()) != bool(value))
+                    {
+                        LOGDEV_RES_VERBOSE("Condition \"%s\" has changed") << name;
+                        return false;
+                    }
+                    break; }
+
+                case ModelPath:
+                    modelPaths << name;
+                    break;
+
+                default:
+                    throw Error("DEDCache::restore", "Invalid dependency");
+                }
+            }
+
+            Block serialized;
+            reader >> serialized;
+            try
+            {
+                DEDCache::deserialize(defs, serialized);
+            }
+            catch (const Error &)
+            {
+                // Go back to the original definitions.
+                DEDCache::deserialize(defs, preState);
+                throw;
+            }
+
+            for (const String &path : modelPaths)
+            {
+                DEDParser::addModelPath(path);
+            }
+            return true;
+        }
+        catch (const Error &er)
+        {
+            LOGDEV_RES_WARNING("Corrupt cached definitions: %s") << er.asText();
+        }
+        return false;
+    }
+
+    /**
+     * Parses the collected texts. Stops at the first text whose errors are fatal.
+     *
+     * @param fatalError  Set to @c true if the parsing stopped because of an error.
+     *
+     * @return @c true, if all texts were parsed without errors.
+     */
+    bool parse(bool &fatalError)
+    {
+        bool ok = true;
+        fatalError = false;
+        for (const Text &text : texts)
+        {
+            if (!DEDParser(&defs).parse(text.text.c_str(), text.sourceFile, text.custom))
+            {
+                if (text.errorsFatal)
+                {
+                    // DED_Error() describes the error.
+                    fatalError = true;
+                    return false;
+                }
+                LOG_RES_ERROR("DED parse error: %s") << DED_Error();
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void store(const Block &key, TimeSpan parseTime)
+    {
+        Block data;
+        Writer writer(data);
+        writer << DEDCACHE_FORMAT << ddouble(parseTime) << duint32(dependencies.size());
+        for (const Dependency &dep : dependencies)
+        {
+            writer << dbyte(dep.type) << dep.name;
+            if (dep.type == IncludedFile) writer << dep.hash;
+            if (dep.type == Condition)    writer << dbyte(dep.value);
+        }
+        writer << DEDCache::serialize(defs);
+
+        try
+        {
+            MetadataBank::get().setMetadata(DEDCACHE_CATEGORY(), key, data.compressed());
+        }
+        catch (const Error &er)
+        {
+            LOGDEV_RES_WARNING("Failed to cache definitions: %s") << er.asText();
+        }
+    }
+};
+
+DEDCache::DEDCache(ded_t &defs)
+    : d(new Impl(defs))
+{
+    DE_ASSERT(!activeDEDCache);
+
+    d->preState       = serialize(defs);
+    d->preStateDigest = digest(defs);
+    activeDEDCache    = this;
+}
+
+DEDCache::~DEDCache()
+{
+    if (activeDEDCache == this)
+    {
+        activeDEDCache = nullptr;
+    }
+}
+
+DEDCache *DEDCache::active(const ded_t *defs) // static
+{
+    if (activeDEDCache && &activeDEDCache->d->defs == defs)
+    {
+        return activeDEDCache;
+    }
+    return nullptr;
+}
+
+bool DEDCache::collect(const char *buffer, const String &sourceFile, bool sourceIsCustom)
+{
+    if (d->state == Impl::Collecting)
+    {
+        d->texts << Impl::Text{Block(buffer), sourceFile, sourceIsCustom, d->errorsFatal};
+        return true;
+    }
+    if (d->state == Impl::Parsing)
+    {
+        // Included by one of the collected texts.
+        d->dependencies << Impl::Dependency{Impl::IncludedFile, sourceFile,
+                                            dedCacheTextHash(buffer), false};
+    }
+    return false;
+}
+
+void DEDCache::conditionChecked(const String &cond, bool value)
+{
+    if (d->state == Impl::Parsing)
+    {
+        d->dependencies << Impl::Dependency{Impl::Condition, cond, Block(), value};
+    }
+}
+
+void DEDCache::modelPathAdded(const String &nativePath)
+{
+    if (d->state == Impl::Parsing)
+    {
+        d->dependencies << Impl::Dependency{Impl::ModelPath, nativePath, Block(), false};
+    }
+}
+
+void DEDCache::setErrorsFatal(bool errorsFatal)
+{
+    d->errorsFatal = errorsFatal;
+}
+
+bool DEDCache::finish()
+{
+    LOG_AS("DEDCache");
+    DE_ASSERT(d->state == Impl::Collecting);
+
+    const Block key = d->key();
+
+    Time startedAt;
+    TimeSpan parseTime;
+    if (d->restore(key, parseTime))
+    {
+        d->state    = Impl::Finished;
+        d->restored = true;
+        activeDEDCache = nullptr;
+
+        LOG_RES_MSG("Definitions of %i files restored from the cache in %.1f ms "
+                    "(parsing took %.1f ms)")
+            << d->texts.size() << startedAt.since() * 1000 << parseTime * 1000;
+        return true;
+    }
+
+    startedAt = Time();
+    d->state = Impl::Parsing;
+    bool fatalError;
+    const bool ok = d->parse(fatalError);
+    d->state = Impl::Finished;
+    activeDEDCache = nullptr;
+    parseTime = startedAt.since();
+
+    if (fatalError) return false;
+
+    LOG_RES_MSG("Definitions of %i files parsed in %.1f ms")
+        << d->texts.size() << parseTime * 1000;
+
+    if (ok)
+    {
+        d->store(key, parseTime);
+    }
+    return true;
+}
+
+bool DEDCache::isRestored() const
+{
+    return d->restored;
+}
+
+Block DEDCache::serialize(const ded_t &defs) // static
+{
+    Block data;
+    Writer writer(data);
+    writeDEDHeader(writer, defs);
+    for (const DEDRegister *reg : dedCacheRegisters(const_cast<ded_t &>(defs)))
+    {
+        writer << dint32(reg->size());
+        for (int i = 0; i < reg->size(); ++i)
+        {
+            writer << (*reg)[i];
+        }
+    }
+    forDEDArrays(defs, DEDArrayWriter{writer});
+    return data;
+}
+
+void DEDCache::deserialize(ded_t &defs, const Block &data) // static
+{
+    defs.clear();
+
+    Reader reader(data);
+    dint32 version, modelFlags;
+    reader >> version >> modelFlags >> defs.modelScale >> defs.modelOffset;
+    defs.version    = version;
+    defs.modelFlags = modelFlags;
+
+    for (DEDRegister *reg : dedCacheRegisters(defs))
+    {
+        dint32 count;
+        reader >> count;
+        if (count < 0 || dsize(count) > reader.remainingSize())
+        {
+            throw Error("DEDCache::deserialize", "Invalid number of definitions");
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            // The register indexes the definition as its members are added.
+            reader >> reg->append();
+        }
+    }
+    forDEDArrays(defs, DEDArrayReader{reader});
+    if (!reader.atEnd())
+    {
+        throw Error("DEDCache::deserialize", "Unexpected data after the definitions");
+    }
+}
+
+Block DEDCache::digest(const ded_t &defs) // static
+{
+    Block data;
+    Writer writer(data);
+    writeDEDHeader(writer, defs);
+    for (const DEDRegister *reg : dedCacheRegisters(const_cast<ded_t &>(defs)))
+    {
+        writer << dint32(reg->size());
+        for (int i = 0; i < reg->size(); ++i)
+        {
+            writeRecordDigest(writer, (*reg)[i]);
+        }
+    }
+    forDEDArrays(defs, DEDArrayWriter{writer});
+    return data.md5Hash();
+}
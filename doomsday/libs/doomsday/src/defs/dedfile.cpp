@@ -23,6 +23,7 @@
 #include <de/app.h>
 #include <de/folder.h>
 #include <de/logbuffer.h>
+#include "doomsday/defs/dedcache.h"
 #include "doomsday/defs/dedparser.h"
 #include "doomsday/filesys/fs_main.h"
 #include "doomsday/filesys/fs_util.h"
@@ -40,12 +41,33 @@ void DED_SetError(const String &message)
     strncpy(dedReadError, msg, sizeof(dedReadError));
 }
 
+/**
+ * Parse errors are fatal also in the texts that the definition cache collects to be
+ * parsed later.
+ */
+struct DEDFatalErrors
+{
+    DEDCache *cache;
+
+    DEDFatalErrors(const ded_t *defs) : cache(DEDCache::active(defs))
+    {
+        if (cache) cache->setErrorsFatal(true);
+    }
+
+    ~DEDFatalErrors()
+    {
+        if (cache) cache->setErrorsFatal(false);
+    }
+};
+
 void Def_ReadProcessDED(ded_t *defs, const String& sourcePath)
 {
      LOG_AS("Def_ReadProcessDED");
 
      if (sourcePath.isEmpty()) return;
 
+     DEDFatalErrors fatalErrors(defs);
+
      // Try FS2 first.
      try
      {
@@ -140,8 +162,40 @@ int DED_Read(ded_t *ded, const String& path)
     return false;
 }
 
+bool DED_ReadFileText(const String &path, Block &text)
+{
+    if (const auto *file = App::rootFolder().tryLocate<File const>(path))
+    {
+        *file >> text;
+        return true;
+    }
+    try
+    {
+        String fullPath = (NativePath::workPath() / NativePath(path).expand()).withSeparators('/');
+        std::unique_ptr<FileHandle> hndl(&App_FileSystem().openFile(fullPath, "rb"));
+
+        hndl->seek(0, SeekEnd);
+        text.resize(hndl->tell());
+        hndl->rewind();
+
+        File1 &file = hndl->file();
+        hndl->read(text.data(), text.size());
+        App_FileSystem().releaseFile(file);
+        return true;
+    }
+    catch (const FS1::NotFoundError &)
+    {} // Ignore.
+
+    return false;
+}
+
 int DED_ReadData(ded_t *ded, const char *buffer, String sourceFile, bool sourceIsCustom)
 {
+    if (DEDCache *cache = DEDCache::active(ded))
+    {
+        // The cache may parse the text later, if at all.
+        if (cache->collect(buffer, sourceFile, sourceIsCustom)) return true;
+    }
     return DEDParser(ded).parse(buffer, sourceFile, sourceIsCustom);
 }
 
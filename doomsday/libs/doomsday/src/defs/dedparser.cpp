@@ -55,6 +55,7 @@
 
 #include "doomsday/defs/decoration.h"
 #include "doomsday/defs/ded.h"
+#include "doomsday/defs/dedcache.h"
 #include "doomsday/defs/dedfile.h"
 #include "doomsday/defs/episode.h"
 #include "doomsday/defs/finale.h"
@@ -783,20 +784,14 @@ DE_PIMPL(DEDParser)
      */
     dd_bool DED_CheckCondition(const char *cond, dd_bool expected)
     {
-        dd_bool value = false;
+        const bool value = DEDParser::checkCondition(cond);
 
-        if (cond[0] == '-')
+        // The cached definitions are only valid if the conditions are unchanged.
+        if (DEDCache *cache = DEDCache::active(ded))
         {
-            // A command line option.
-            value = (CommandLine_Check(token) != 0);
+            cache->conditionChecked(cond, value);
         }
-        else if (isalnum(cond[0]) && !DoomsdayApp::game().isNull())
-        {
-            // A game mode.
-            value = !String(cond).compareWithoutCase(DoomsdayApp::game().id());
-        }
-
-        return value == expected;
+        return value == CPP_BOOL(expected);
     }
 
     int readData(const char *buffer, String sourceFile, bool sourceIsCustom)
@@ -909,9 +904,11 @@ DE_PIMPL(DEDParser)
                 READSTR(label);
                 CHECKSC;
 
-                res::Uri newSearchPath = res::Uri::fromNativeDirPath(NativePath(label));
-                FS1::Scheme& scheme = App_FileSystem().scheme(ResourceClass::classForId(RC_MODEL).defaultScheme());
-                scheme.addSearchPath(reinterpret_cast<res::Uri const&>(newSearchPath), FS1::ExtraPaths);
+                DEDParser::addModelPath(label);
+                if (DEDCache *cache = DEDCache::active(ded))
+                {
+                    cache->modelPathAdded(label);
+                }
             }
 
             if (ISTOKEN("Header"))
@@ -3087,3 +3084,25 @@ int DEDParser::parse(const char *buffer, String sourceFile, bool sourceIsCustom)
 {
     return d->readData(buffer, sourceFile, sourceIsCustom);
 }
+
+bool DEDParser::checkCondition(const char *cond) // static
+{
+    if (cond[0] == '-')
+    {
+        // A command line option.
+        return CommandLine_Check(cond) != 0;
+    }
+    if (isalnum(cond[0]) && !DoomsdayApp::game().isNull())
+    {
+        // A game mode.
+        return !String(cond).compareWithoutCase(DoomsdayApp::game().id());
+    }
+    return false;
+}
+
+void DEDParser::addModelPath(const String &nativePath) // static
+{
+    res::Uri newSearchPath = res::Uri::fromNativeDirPath(NativePath(nativePath));
+    FS1::Scheme& scheme = App_FileSystem().scheme(ResourceClass::classForId(RC_MODEL).defaultScheme());
+    scheme.addSearchPath(reinterpret_cast<res::Uri const&>(newSearchPath), FS1::ExtraPaths);
+}
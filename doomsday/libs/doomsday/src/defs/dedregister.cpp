@@ -46,6 +46,7 @@ DE_PIMPL(DEDRegister)
     typedef KeyMap<String, Key> Keys;
     Keys keys;
     KeyMap<Variable *, Record *> parents;
+    duint32 version = 0;
 
     Impl(Public *i, Record &rec) : Base(i), names(&rec)
     {
@@ -67,6 +68,7 @@ DE_PIMPL(DEDRegister)
         // As a side-effect, the lookups will be cleared, too, as the members of
         // each definition record are deleted.
         order().clear();
+        version++;
 
 #ifdef DE_DEBUG
         DE_ASSERT(parents.isEmpty());
@@ -81,6 +83,7 @@ DE_PIMPL(DEDRegister)
     {
         keys.insert(name, Key(flags));
         names->addDictionary(name + "Lookup");
+        version++;
     }
 
     ArrayValue &order()
@@ -152,6 +155,7 @@ DE_PIMPL(DEDRegister)
         sub->audienceForRemoval()  += this;
 
         order().add(new RecordValue(sub, RecordValue::OwnsRecord));
+        version++;
         return *sub;
     }
 
@@ -192,6 +196,7 @@ DE_PIMPL(DEDRegister)
 
         // Index definition using its current value.
         dict.add(new TextValue(valText), new RecordValue(&def));
+        version++;
         return true;
     }
 
@@ -224,6 +229,7 @@ DE_PIMPL(DEDRegister)
                 // This is the definition that was indexed using the key value.
                 // Let's remove it.
                 dict.remove(TextValue(valText));
+                version++;
 
                 /// @todo Should now index any other definitions with this key value;
                 /// needs to add a lookup of which other definitions have this value.
@@ -370,3 +376,8 @@ const DictionaryValue &DEDRegister::lookup(const String &key) const
     }
     return d->lookup(key);
 }
+
+duint32 DEDRegister::version() const
+{
+    return d->version;
+}
@@ -0,0 +1,317 @@
+/** @file frozendefs.cpp  Definitions compiled into tables for runtime lookups.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "doomsday/defs/frozendefs.h"
+#include "doomsday/defs/ded.h"
+#include "doomsday/defs/definition.h"
+
+#include <de/block.h>
+#include <de/dictionaryvalue.h>
+#include <de/recordvalue.h>
+
+#include <cstring>
+
+using namespace de;
+
+static inline dbyte frozenFoldCase(char ch)
+{
+    return dbyte(ch >= 'A' && ch <= 'Z'? ch + ('a' - 'A') : ch);
+}
+
+/**
+ * Calculates a case-insensitive FNV-1a hash of a key.
+ *
+ * @return @c false, if the key contains non-ASCII characters. These are folded
+ * with Unicode rules by the registers, so the tables cannot find them.
+ */
+static bool frozenKeyHash(const char *key, duint32 &hash)
+{
+    hash = 2166136261u;
+    for (const char *c = key; *c; ++c)
+    {
+        if (dbyte(*c) >= 0x80) return false;
+        hash = (hash ^ frozenFoldCase(*c)) * 16777619u;
+    }
+    return true;
+}
+
+static bool frozenKeyEquals(const char *a, const char *b)
+{
+    for (; *a && *b; ++a, ++b)
+    {
+        if (frozenFoldCase(*a) != frozenFoldCase(*b)) return false;
+    }
+    return *a == *b;
+}
+
+/**
+ * Open-addressed hash index from text keys to definition indices. The keys are
+ * stored in the text table of the frozen definitions.
+ */
+struct FrozenIndex
+{
+    struct Slot
+    {
+        duint32 hash;
+        duint32 key;   ///< Offset in the text table.
+        dint32  value; ///< Negative if the slot is unused.
+    };
+    List<Slot> slots;
+
+    void clear()
+    {
+        slots.clear();
+    }
+
+    void reserve(dsize count)
+    {
+        // Keep the load factor at or below one half.
+        dsize size = 16;
+        while (size < count * 2) size *= 2;
+        slots = List<Slot>(size, Slot{0, 0, -1});
+    }
+
+    /// Returns the slot that has @a key, or the unused slot where it belongs.
+    const Slot &slotFor(const char *key, duint32 hash, const Block &text) const
+    {
+        const dsize mask = slots.size() - 1;
+        dsize pos = hash & mask;
+        while (slots[pos].value >= 0)
+        {
+            const Slot &slot = slots[pos];
+            if (slot.hash == hash &&
+                frozenKeyEquals(text.c_str() + slot.key, key))
+            {
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+        return slots[pos];
+    }
+
+    /**
+     * Adds a key to the index, unless the key is already there. Keys that cannot
+     * be hashed are left out.
+     */
+    template <typename AddText>
+    void insert(const char *key, int value, const Block &text, AddText addText)
+    {
+        duint32 hash;
+        if (!key[0] || !frozenKeyHash(key, hash)) return;
+
+        Slot &slot = const_cast<Slot &>(slotFor(key, hash, text));
+        if (slot.value < 0)
+        {
+            slot = Slot{hash, addText(key), value};
+        }
+    }
+
+    int find(const char *key, const Block &text) const
+    {
+        if (!key) return FrozenDefs::Unavailable;
+
+        duint32 hash;
+        if (!frozenKeyHash(key, hash)) return FrozenDefs::Unavailable;
+        if (slots.isEmpty()) return -1;
+
+        return slotFor(key, hash, text).value;
+    }
+};
+
+DE_PIMPL_NOREF(FrozenDefs)
+{
+    const ded_s *defs = nullptr;
+
+    // The definitions that the tables were compiled from.
+    duint32 thingsVersion    = 0;
+    duint32 statesVersion    = 0;
+    duint32 materialsVersion = 0;
+    const ded_sprid_t *spriteElements = nullptr;
+    int spriteCount = 0;
+
+    Block text;
+    List<State> states;
+    List<Thing> things;
+    FrozenIndex stateIds;
+    FrozenIndex thingIds;
+    FrozenIndex thingNames;
+    FrozenIndex spriteIds;
+    FrozenIndex materialIds;
+
+    void clear()
+    {
+        defs = nullptr;
+        text.clear();
+        states.clear();
+        things.clear();
+        stateIds.clear();
+        thingIds.clear();
+        thingNames.clear();
+        spriteIds.clear();
+        materialIds.clear();
+    }
+
+    bool isCurrent() const
+    {
+        return defs &&
+               defs->things.version()    == thingsVersion &&
+               defs->states.version()    == statesVersion &&
+               defs->materials.version() == materialsVersion &&
+               defs->sprites.size()      == spriteCount &&
+               defs->sprites.elements    == spriteElements;
+    }
+
+    duint32 addText(const char *str)
+    {
+        if (!str[0]) return 0;
+        const duint32 offset = duint32(text.size());
+        text.append(str, int(std::strlen(str)) + 1);
+        return offset;
+    }
+
+    duint32 addMemberText(const Record &def, const char *name)
+    {
+        if (!def.has(name)) return 0;
+        return addText(def.gets(name).c_str());
+    }
+
+    /// Indexes the lookup dictionary of a register. The registers' lookup keys are
+    /// all case insensitive, so the dictionary keys are in lower case.
+    void indexLookup(FrozenIndex &index, const DEDRegister &reg, const String &key)
+    {
+        const DictionaryValue &lookup = reg.lookup(key);
+        index.reserve(lookup.size());
+        for (const auto &i : lookup.elements())
+        {
+            if (const Record *def = i.second->as<RecordValue>().record())
+            {
+                index.insert(i.first.value->asText().c_str(), def->geti(defn::Definition::VAR_ORDER),
+                             text, [this] (const char *k) { return addText(k); });
+            }
+        }
+    }
+
+    void freeze(const ded_s &source)
+    {
+        clear();
+        defs = &source;
+        thingsVersion    = source.things.version();
+        statesVersion    = source.states.version();
+        materialsVersion = source.materials.version();
+        spriteElements   = source.sprites.elements;
+        spriteCount      = source.sprites.size();
+
+        text.append("", 1); // offset zero is an empty text
+
+        states.resize(source.states.size());
+        for (int i = 0; i < source.states.size(); ++i)
+        {
+            const Record &def = source.states[i];
+            states[i].action  = addMemberText(def, "action");
+            states[i].execute = addMemberText(def, "execute");
+        }
+        things.resize(source.things.size());
+        for (int i = 0; i < source.things.size(); ++i)
+        {
+            const Record &def = source.things[i];
+            things[i].onTouch = addMemberText(def, "onTouch");
+            things[i].onDeath = addMemberText(def, "onDeath");
+        }
+
+        indexLookup(stateIds,    source.states,    defn::Definition::VAR_ID);
+        indexLookup(thingIds,    source.things,    defn::Definition::VAR_ID);
+        indexLookup(thingNames,  source.things,    "name");
+        indexLookup(materialIds, source.materials, defn::Definition::VAR_ID);
+
+        // The first sprite with an ID is the one that is found.
+        spriteIds.reserve(dsize(spriteCount));
+        for (int i = 0; i < spriteCount; ++i)
+        {
+            spriteIds.insert(source.sprites[i].id, i, text,
+                             [this] (const char *k) { return addText(k); });
+        }
+    }
+
+    int find(const FrozenIndex &index, const char *key) const
+    {
+        if (!isCurrent()) return Unavailable;
+        return index.find(key, text);
+    }
+};
+
+FrozenDefs::FrozenDefs()
+    : d(new Impl)
+{}
+
+void FrozenDefs::freeze(const ded_s &defs)
+{
+    d->freeze(defs);
+}
+
+void FrozenDefs::clear()
+{
+    d->clear();
+}
+
+bool FrozenDefs::isCurrent() const
+{
+    return d->isCurrent();
+}
+
+const FrozenDefs::State *FrozenDefs::state(int stateNum) const
+{
+    if (stateNum < 0 || stateNum >= int(d->states.size()) || !d->isCurrent()) return nullptr;
+    return &d->states[stateNum];
+}
+
+const FrozenDefs::Thing *FrozenDefs::thing(int thingNum) const
+{
+    if (thingNum < 0 || thingNum >= int(d->things.size()) || !d->isCurrent()) return nullptr;
+    return &d->things[thingNum];
+}
+
+const char *FrozenDefs::text(duint32 offset) const
+{
+    DE_ASSERT(offset < d->text.size());
+    return d->text.c_str() + offset;
+}
+
+int FrozenDefs::stateNum(const char *id) const
+{
+    return d->find(d->stateIds, id);
+}
+
+int FrozenDefs::thingNum(const char *id) const
+{
+    return d->find(d->thingIds, id);
+}
+
+int FrozenDefs::thingNumForName(const char *name) const
+{
+    return d->find(d->thingNames, name);
+}
+
+int FrozenDefs::spriteNum(const char *id) const
+{
+    return d->find(d->spriteIds, id);
+}
+
+int FrozenDefs::materialNum(const char *uri) const
+{
+    return d->find(d->materialIds, uri);
+}
@@ -27,6 +27,13 @@
 #include <cctype>
 #include <ctime>
 #include <sys/stat.h>
+#ifdef WIN32
+#  include <windows.h>
+#  include <io.h>
+#endif
+#ifdef UNIX
+#  include <sys/mman.h>
+#endif
 
 #include <de/legacy/memory.h>
 #include <de/legacy/memoryblockset.h>
@@ -49,6 +56,7 @@ DE_PIMPL_NOREF(FileHandle)
         uint open:1;       ///< Presently open.
         uint eof:1;        ///< Reader has reached the end of the stream.
         uint reference:1;  ///< This handle is a reference to another dfile instance.
+        uint mapTried:1;   ///< Memory mapping of the native file has been attempted.
     } flags;
 
     /// Offset from start of owning package.
@@ -59,11 +67,61 @@ DE_PIMPL_NOREF(FileHandle)
     uint8_t *data;
     uint8_t *pos;
 
+    /// Memory mapping of the entire native file (if mapped).
+    uint8_t *mapping;
+    size_t mappingSize;
+
     Impl() : file(0), list(0), baseOffset(0), hndl(0), size(0), data(0), pos(0)
+           , mapping(0), mappingSize(0)
     {
         flags.eof  = false;
         flags.open = false;
         flags.reference = false;
+        flags.mapTried = false;
+    }
+
+    void mapNativeFile()
+    {
+        flags.mapTried = true;
+        if (!hndl) return;
+#ifdef UNIX
+        const int fd = fileno(hndl);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) return;
+        void *ptr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) return;
+        mapping     = reinterpret_cast<uint8_t *>(ptr);
+        mappingSize = size_t(st.st_size);
+#endif
+#ifdef WIN32
+        HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(hndl)));
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) ||
+            fileSize.QuadPart <= 0)
+        {
+            return;
+        }
+        HANDLE fileMapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!fileMapping) return;
+        void *ptr = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(fileMapping); // The view keeps the mapping alive.
+        if (!ptr) return;
+        mapping     = reinterpret_cast<uint8_t *>(ptr);
+        mappingSize = size_t(fileSize.QuadPart);
+#endif
+    }
+
+    void unmapNativeFile()
+    {
+        if (!mapping) return;
+#ifdef UNIX
+        munmap(mapping, mappingSize);
+#endif
+#ifdef WIN32
+        UnmapViewOfFile(mapping);
+#endif
+        mapping     = 0;
+        mappingSize = 0;
     }
 };
 
@@ -91,6 +149,7 @@ FileHandle::~FileHandle()
 FileHandle &FileHandle::close()
 {
     if (!d->flags.open) return *this;
+    d->unmapNativeFile();
     if (d->hndl)
     {
         fclose(d->hndl); d->hndl = 0;
@@ -275,6 +334,23 @@ FileHandle &FileHandle::rewind()
     return *this;
 }
 
+const uint8_t *FileHandle::map()
+{
+    if (d->flags.reference || !d->flags.open) return nullptr;
+    if (!d->flags.mapTried)
+    {
+        d->mapNativeFile();
+    }
+    if (!d->mapping || d->baseOffset >= d->mappingSize) return nullptr;
+    return d->mapping + d->baseOffset;
+}
+
+size_t FileHandle::mappedSize() const
+{
+    if (!d->mapping || d->baseOffset >= d->mappingSize) return 0;
+    return d->mappingSize - d->baseOffset;
+}
+
 FileHandle *FileHandle::fromFile(File1 &file) // static
 {
     FileHandle *hndl = new FileHandle();
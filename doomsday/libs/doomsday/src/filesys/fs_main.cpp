@@ -25,9 +25,11 @@
 #include "doomsday/filesys/fs_util.h"
 #include "doomsday/console/exec.h"
 #include "doomsday/console/cmd.h"
+#include "doomsday/console/var.h"
 #include "doomsday/filesys/file.h"
 #include "doomsday/filesys/fileid.h"
 #include "doomsday/filesys/fileinfo.h"
+#include "doomsday/filesys/lumpcache.h"
 #include "doomsday/filesys/lumpindex.h"
 #include "doomsday/filesys/wad.h"
 #include "doomsday/filesys/zip.h"
@@ -49,6 +51,13 @@ using namespace de;
 
 static FS1 *fileSystem;
 
+static int lumpCacheBudget = int(LumpCache::DEFAULT_BUDGET >> 20); // cvar (MB)
+
+static void lumpCacheBudgetChanged()
+{
+    LumpCache::setBudget(dsize(lumpCacheBudget) << 20);
+}
+
 typedef List<FileId> FileIds;
 
 /**
@@ -1193,6 +1202,24 @@ D_CMD(ListLumps)
     return true;
 }
 
+/// Print the statistics of the lump caches.
+D_CMD(LumpCacheStats)
+{
+    DE_UNUSED(src, argc, argv);
+
+    const auto stats = LumpCache::statistics();
+    const duint64 lookups = stats.hits + stats.misses;
+
+    LOG_RES_MSG(_E(b) "Lump cache:");
+    LOG_RES_MSG(_E(l) "Budget: " _E(.) "%.1f MB") << stats.budget / 1048576.0;
+    LOG_RES_MSG(_E(l) "Cached: " _E(.) "%i lumps, %.1f MB (%.1f MB locked)")
+        << stats.lumpCount << stats.totalBytes / 1048576.0 << stats.lockedBytes / 1048576.0;
+    LOG_RES_MSG(_E(l) "Hits: " _E(.) "%i " _E(l) "Misses: " _E(.) "%i (%.1f%% hit rate)")
+        << stats.hits << stats.misses << (lookups? stats.hits * 100.0 / lookups : 0.0);
+    LOG_RES_MSG(_E(l) "Evictions: " _E(.) "%i") << stats.evictions;
+    return true;
+}
+
 /// List presently loaded files in original load order.
 D_CMD(ListFiles)
 {
@@ -1254,6 +1281,9 @@ void res::FS1::consoleRegister()
     C_CMD("dump",      "s", DumpLump);
     C_CMD("listfiles", "",  ListFiles);
     C_CMD("listlumps", "",  ListLumps);
+    C_CMD("lumpcachestats", "", LumpCacheStats);
+
+    C_VAR_INT2("file-cache-budget", &res::lumpCacheBudget, CVF_NO_MAX, 8, 0, res::lumpCacheBudgetChanged);
 }
 
 res::FS1 &App_FileSystem()
@@ -504,10 +504,12 @@ dd_bool F_DumpFile(File1 &file, const char *outputPath)
     String dumpPath = "/home" / ((!outputPath || !outputPath[0])? file.name() : String(outputPath));
     try
     {
+        const Block data(file.cache(), file.info().size);
+        file.unlock();
+
         File &out = App::rootFolder().replaceFile(dumpPath);
-        out << Block(file.cache(), file.info().size);
+        out << data;
         out.release();
-        file.unlock();
         LOG_RES_VERBOSE("%s dumped to %s") << file.name() << out.description();
         return true;
     }
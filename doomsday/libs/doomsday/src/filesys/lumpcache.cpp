@@ -18,85 +18,119 @@
  */
 
 #include "doomsday/filesys/lumpcache.h"
-#include <de/legacy/memory.h>
 #include <de/legacy/memoryzone.h>
 #include <de/error.h>
+#include <de/guard.h>
+#include <de/lockable.h>
 #include <de/log.h>
 
-using namespace de;
+#include <cstring>
 
-LumpCache::Data::Data(uint8_t *data)
-    : data_(data)
-{}
+using namespace de;
 
-LumpCache::Data::~Data()
+/**
+ * State shared by all lump caches. Also guards the records of all the caches.
+ */
+struct LumpCache::Shared : public Lockable
 {
-    clearData();
-}
+    dsize   budget      = DEFAULT_BUDGET;
+    dsize   totalBytes  = 0;
+    dsize   lockedBytes = 0;
+    duint   lumpCount   = 0;
+    duint64 hits        = 0;
+    duint64 misses      = 0;
+    duint64 evictions   = 0;
+    Data *  oldest      = nullptr;
+    Data *  newest      = nullptr;
 
-uint8_t *LumpCache::Data::data() const
-{
-    if (data_ && Z_GetTag(data_) == PU_PURGELEVEL)
+    static Shared &get()
     {
-        // Reaquire the data.
-        Z_ChangeTag2(data_, PU_APPSTATIC);
-        Z_ChangeUser(data_, (void*)&data_);
+        static Shared shared;
+        return shared;
     }
-    return data_;
-}
 
-const uint8_t *LumpCache::Data::replaceData(uint8_t *newData)
-{
-    clearData();
-    data_ = newData;
-    if (data_)
+    void unlinkRecent(Data &rec)
     {
-        Z_ChangeUser(data_, &data_);
+        if (rec.older) rec.older->newer = rec.newer; else oldest = rec.newer;
+        if (rec.newer) rec.newer->older = rec.older; else newest = rec.older;
+        rec.older = rec.newer = nullptr;
     }
-    return newData;
-}
 
-LumpCache::Data &LumpCache::Data::clearData(bool *retCleared)
-{
-    bool hasData = !!data_;
-    if (hasData)
+    void linkNewest(Data &rec)
     {
-        /// @todo Implement a proper thread-safe locking mechanism.
+        rec.older = newest;
+        rec.newer = nullptr;
+        if (newest) newest->newer = &rec; else oldest = &rec;
+        newest = &rec;
+    }
 
-        // Elevate the cached data to purge level so it will be explicitly
-        // free'd by the Zone the next time the rover passes it.
-        if (Z_GetTag(data_) != PU_PURGELEVEL)
+    void touch(Data &rec)
+    {
+        if (!rec.lockCount && newest != &rec)
         {
-            Z_ChangeTag2(data_, PU_PURGELEVEL);
+            unlinkRecent(rec);
+            linkNewest(rec);
         }
-        // Mark the data as unowned.
-        Z_ChangeUser(data_, (void *) 0x2);
     }
-    if (retCleared) *retCleared = hasData;
-    return *this;
-}
 
-LumpCache::Data &LumpCache::Data::lock()
-{
-    /// @todo Implement a proper thread-safe locking mechanism.
-    return *this;
-}
+    void lock(Data &rec)
+    {
+        if (rec.data && rec.lockCount++ == 0)
+        {
+            unlinkRecent(rec);
+            lockedBytes += rec.size;
+        }
+    }
 
-LumpCache::Data &LumpCache::Data::unlock()
-{
-    /// @todo Implement a proper thread-safe locking mechanism.
-    if (data_)
+    void unlock(Data &rec)
     {
-        Z_ChangeTag2(data_, PU_PURGELEVEL);
+        if (rec.data && rec.lockCount > 0 && --rec.lockCount == 0)
+        {
+            lockedBytes -= rec.size;
+            linkNewest(rec);
+        }
     }
-    return *this;
-}
+
+    /// Frees the data of a record.
+    bool drop(Data &rec)
+    {
+        if (!rec.data) return false;
+        if (rec.lockCount)
+        {
+            lockedBytes -= rec.size;
+        }
+        else
+        {
+            unlinkRecent(rec);
+        }
+        Z_Free(rec.data);
+        totalBytes -= rec.size;
+        lumpCount--;
+        rec = Data();
+        return true;
+    }
+
+    /**
+     * Evicts unlocked data until the cached data fits in the budget.
+     *
+     * @param reserved  Number of bytes that are about to be added to the cache.
+     */
+    void evictOverBudget(dsize reserved = 0)
+    {
+        while (totalBytes + reserved > budget && oldest)
+        {
+            drop(*oldest);
+            evictions++;
+        }
+    }
+};
 
 LumpCache::LumpCache(uint size) : _size(size), _dataCache(0)
 {}
 
 LumpCache::~LumpCache()
 {
+    clear();
     if (_dataCache) delete _dataCache;
 }
 
@@ -113,15 +147,63 @@ bool LumpCache::isValidIndex(uint idx) const
 const uint8_t *LumpCache::data(uint lumpIdx) const
 {
     LOG_AS("LumpCache::data");
-    Data const* record = cacheRecord(lumpIdx);
-    return record? record->data() : 0;
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    Data *record = const_cast<Data *>(cacheRecord(lumpIdx));
+    if (record && record->data)
+    {
+        shared.hits++;
+        shared.touch(*record);
+        return record->data;
+    }
+    shared.misses++;
+    return nullptr;
 }
 
-LumpCache &LumpCache::insert(uint lumpIdx, uint8_t *data)
+const uint8_t *LumpCache::lockData(uint lumpIdx)
+{
+    LOG_AS("LumpCache::lockData");
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    Data *record = cacheRecord(lumpIdx);
+    if (record && record->data)
+    {
+        shared.hits++;
+        shared.lock(*record);
+        return record->data;
+    }
+    shared.misses++;
+    return nullptr;
+}
+
+bool LumpCache::read(uint lumpIdx, uint8_t *buffer, dsize offset, dsize length,
+                     dsize *retBytesRead) const
+{
+    LOG_AS("LumpCache::read");
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    Data *record = const_cast<Data *>(cacheRecord(lumpIdx));
+    if (record && record->data)
+    {
+        shared.hits++;
+        shared.touch(*record);
+        const dsize bytes = de::min(record->size - de::min(record->size, offset), length);
+        std::memcpy(buffer, record->data + de::min(record->size, offset), bytes);
+        if (retBytesRead) *retBytesRead = bytes;
+        return true;
+    }
+    shared.misses++;
+    if (retBytesRead) *retBytesRead = 0;
+    return false;
+}
+
+const uint8_t *LumpCache::store(uint lumpIdx, uint8_t *data, dsize size, bool locked)
 {
-    LOG_AS("LumpCache::insert");
     if (!isValidIndex(lumpIdx)) throw Error("LumpCache::insert", stringf("Invalid index %u", lumpIdx));
 
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+
     // Time to allocate the data cache?
     if (!_dataCache)
     {
@@ -129,21 +211,58 @@ LumpCache &LumpCache::insert(uint lumpIdx, uint8_t *data)
     }
 
     Data *record = cacheRecord(lumpIdx);
-    record->replaceData(data);
+    if (record->lockCount)
+    {
+        // The cached data is in use, so keep it.
+        if (data) Z_Free(data);
+        if (locked)
+        {
+            shared.lock(*record);
+        }
+        return record->data;
+    }
+    shared.drop(*record);
+    if (data)
+    {
+        // Make room first, so that the new data itself is not evicted.
+        shared.evictOverBudget(size);
+
+        record->data = data;
+        record->size = size;
+        shared.totalBytes += size;
+        shared.lumpCount++;
+        shared.linkNewest(*record);
+        if (locked)
+        {
+            shared.lock(*record);
+        }
+    }
+    return record->data;
+}
+
+LumpCache &LumpCache::insert(uint lumpIdx, uint8_t *data, dsize size)
+{
+    LOG_AS("LumpCache::insert");
+    store(lumpIdx, data, size, false);
     return *this;
 }
 
-LumpCache &LumpCache::insertAndLock(uint lumpIdx, uint8_t *data)
+const uint8_t *LumpCache::insertAndLock(uint lumpIdx, uint8_t *data, dsize size)
 {
-    return insert(lumpIdx, data).lock(lumpIdx);
+    LOG_AS("LumpCache::insertAndLock");
+    return store(lumpIdx, data, size, true);
 }
 
 LumpCache &LumpCache::lock(uint lumpIdx)
 {
     LOG_AS("LumpCache::lock");
     if (!isValidIndex(lumpIdx)) throw Error("LumpCache::lock", stringf("Invalid index %u", lumpIdx));
-    Data* record = cacheRecord(lumpIdx);
-    record->lock();
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    if (Data *record = cacheRecord(lumpIdx))
+    {
+        shared.lock(*record);
+    }
     return *this;
 }
 
@@ -151,22 +270,26 @@ LumpCache &LumpCache::unlock(uint lumpIdx)
 {
     LOG_AS("LumpCache::unlock");
     if (!isValidIndex(lumpIdx)) throw Error("LumpCache::unlock", stringf("Invalid index %u", lumpIdx));
-    Data* record = cacheRecord(lumpIdx);
-    record->unlock();
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    if (Data *record = cacheRecord(lumpIdx))
+    {
+        shared.unlock(*record);
+        shared.evictOverBudget();
+    }
     return *this;
 }
 
 LumpCache &LumpCache::remove(uint lumpIdx, bool *retRemoved)
 {
-    Data *record = cacheRecord(lumpIdx);
-    if (record)
-    {
-        record->clearData(retRemoved);
-    }
-    else if (retRemoved)
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    bool removed = false;
+    if (Data *record = cacheRecord(lumpIdx))
     {
-        *retRemoved = false;
+        removed = shared.drop(*record);
     }
+    if (retRemoved) *retRemoved = removed;
     return *this;
 }
 
@@ -174,14 +297,46 @@ LumpCache &LumpCache::clear()
 {
     if (_dataCache)
     {
-        DE_FOR_EACH(DataCache, i, *_dataCache)
+        Shared &shared = Shared::get();
+        DE_GUARD(shared);
+        for (Data &record : *_dataCache)
         {
-            i->clearData();
+            shared.drop(record);
         }
     }
     return *this;
 }
 
+void LumpCache::setBudget(dsize bytes)
+{
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    shared.budget = bytes;
+    shared.evictOverBudget();
+}
+
+dsize LumpCache::budget()
+{
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    return shared.budget;
+}
+
+LumpCache::Statistics LumpCache::statistics()
+{
+    Shared &shared = Shared::get();
+    DE_GUARD(shared);
+    Statistics stats;
+    stats.budget      = shared.budget;
+    stats.totalBytes  = shared.totalBytes;
+    stats.lockedBytes = shared.lockedBytes;
+    stats.lumpCount   = shared.lumpCount;
+    stats.hits        = shared.hits;
+    stats.misses      = shared.misses;
+    stats.evictions   = shared.evictions;
+    return stats;
+}
+
 LumpCache::Data *LumpCache::cacheRecord(uint lumpIdx)
 {
     if (!isValidIndex(lumpIdx)) return 0;
@@ -25,6 +25,7 @@
 #include "doomsday/doomsdayapp.h"
 #include "doomsday/filesys/lumpcache.h"
 #include <de/byteorder.h>
+#include <de/c_wrapper.h>
 #include <de/nativepath.h>
 #include <de/logbuffer.h>
 #include <de/legacy/memoryzone.h>
@@ -177,8 +178,24 @@ DE_PIMPL_NOREF(Wad)
 {
     LumpTree entries;                     ///< Directory structure and entry records for all lumps.
     std::unique_ptr<LumpCache> dataCache;  ///< Data payload cache.
+    const uint8_t *mapped = nullptr;       ///< Memory-mapped contents of a native WAD file.
+    size_t mappedSize = 0;
 
     Impl() : entries(PathTree::MultiLeaf) {}
+
+    /**
+     * Returns a pointer to the data of a lump in the memory-mapped file, or
+     * @c nullptr if the file is not mapped.
+     */
+    const uint8_t *mappedLump(const LumpFile &lumpFile) const
+    {
+        const auto &info = lumpFile.info();
+        if (mapped && info.baseOffset <= mappedSize && info.size <= mappedSize - info.baseOffset)
+        {
+            return mapped + info.baseOffset;
+        }
+        return nullptr;
+    }
 };
 
 Wad::Wad(FileHandle &hndl, String path, const FileInfo &info, File1 *container)
@@ -220,6 +237,20 @@ Wad::Wad(FileHandle &hndl, String path, const FileInfo &info, File1 *container)
 
         catalogLump(*lumpFile);
     }
+
+    // Lumps of native WAD files can be accessed directly in a memory mapping,
+    // which avoids both the reads and the cached copies. WADs inside other
+    // containers are read normally.
+    if (!CommandLine_Exists("-nowadmmap"))
+    {
+        d->mapped     = handle_->map();
+        d->mappedSize = handle_->mappedSize();
+        if (d->mapped)
+        {
+            LOGDEV_RES_VERBOSE("Mapped \"%s\" (%zu bytes)")
+                << NativePath(composePath()).pretty() << d->mappedSize;
+        }
+    }
 }
 
 Wad::~Wad()
@@ -264,14 +295,21 @@ const uint8_t *Wad::cacheLump(int lumpIndex)
             << lumpFile.info().size
             << (lumpFile.info().isCompressed()? ", compressed" : ""));
 
+    if (const uint8_t *data = d->mappedLump(lumpFile))
+    {
+        return data;
+    }
+
     // Time to create the cache?
     if (!d->dataCache)
     {
         d->dataCache.reset(new LumpCache(LumpIndex::size()));
     }
 
-    const uint8_t *data = d->dataCache->data(lumpIndex);
-    if (data) return data;
+    if (const uint8_t *data = d->dataCache->lockData(lumpIndex))
+    {
+        return data;
+    }
 
     uint8_t *region = (uint8_t *) Z_Malloc(lumpFile.info().size, PU_APPSTATIC, 0);
     if (!region)
@@ -281,9 +319,9 @@ const uint8_t *Wad::cacheLump(int lumpIndex)
                             lumpIndex));
 
     readLump(lumpIndex, region, false);
-    d->dataCache->insert(lumpIndex, region);
 
-    return region;
+    // Another thread may have cached the lump meanwhile.
+    return d->dataCache->insertAndLock(lumpIndex, region, lumpFile.info().size);
 }
 
 void Wad::unlockLump(int lumpIndex)
@@ -329,16 +367,32 @@ size_t Wad::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     // Try to avoid a file system read by checking for a cached copy.
     if (tryCache)
     {
-        const uint8_t *data = (d->dataCache ? d->dataCache->data(lumpIndex) : 0);
-        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (data? "hit" : "miss") << lumpIndex);
-        if (data)
+        dsize readBytes = 0;
+        const bool hit = (d->dataCache && d->dataCache->read(lumpIndex, buffer, startOffset,
+                                                              length, &readBytes));
+        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (hit? "hit" : "miss") << lumpIndex);
+        if (hit)
         {
-            size_t readBytes = de::min(size_t(lumpFile.size()), length);
-            std::memcpy(buffer, data + startOffset, readBytes);
             return readBytes;
         }
     }
 
+    if (d->mappedLump(lumpFile))
+    {
+        // Copy from the mapped file.
+        const size_t offset    = lumpFile.info().baseOffset + startOffset;
+        const size_t available = d->mappedSize - de::min(d->mappedSize, offset);
+        const size_t readBytes = de::min(available, length);
+        std::memcpy(buffer, d->mapped + de::min(d->mappedSize, offset), readBytes);
+
+        /// @todo Do not check the read length here.
+        if (readBytes < length)
+            throw Error(
+                "Wad::readLumpSection",
+                stringf("Only read %zu of %zu bytes of lump #%i", readBytes, length, lumpIndex));
+        return readBytes;
+    }
+
     handle_->seek(lumpFile.info().baseOffset + startOffset, SeekSet);
     size_t readBytes = handle_->read(buffer, length);
 
@@ -580,17 +580,19 @@ const uint8_t *Zip::cacheLump(int lumpIndex)
         d->dataCache.reset(new LumpCache(lumpCount()));
     }
 
-    const uint8_t *data = d->dataCache->data(lumpIndex);
-    if (data) return data;
+    if (const uint8_t *data = d->dataCache->lockData(lumpIndex))
+    {
+        return data;
+    }
 
     uint8_t *region = (uint8_t *) Z_Malloc(lumpFile.info().size, PU_APPSTATIC, 0);
     if (!region) throw Error("Zip::cacheLump", stringf("Failed on allocation of %zu bytes for cache copy of lump #%i",
                                                        lumpFile.info().size, lumpIndex));
 
     readLump(lumpIndex, region, false);
-    d->dataCache->insert(lumpIndex, region);
 
-    return region;
+    // Another thread may have cached the lump meanwhile.
+    return d->dataCache->insertAndLock(lumpIndex, region, lumpFile.info().size);
 }
 
 void Zip::unlockLump(int lumpIndex)
@@ -635,12 +637,12 @@ size_t Zip::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     // Try to avoid a file system read by checking for a cached copy.
     if (tryCache)
     {
-        const uint8_t *data = (d->dataCache ? d->dataCache->data(lumpIndex) : 0);
-        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (data? "hit" : "miss") << lumpIndex);
-        if (data)
+        dsize readBytes = 0;
+        const bool hit = (d->dataCache && d->dataCache->read(lumpIndex, buffer, startOffset,
+                                                              length, &readBytes));
+        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (hit? "hit" : "miss") << lumpIndex);
+        if (hit)
         {
-            size_t readBytes = de::min(size_t(lumpFile.size()), length);
-            std::memcpy(buffer, data + startOffset, readBytes);
             return readBytes;
         }
     }
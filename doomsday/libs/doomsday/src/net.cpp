@@ -21,7 +21,10 @@
 #include "doomsday/net.h"
 #include "doomsday/players.h"
 #include "doomsday/doomsdayapp.h"
+#include <de/app.h>
+#include <de/folder.h>
 #include <de/list.h>
+#include <de/packageloader.h>
 
 using namespace de;
 
@@ -33,6 +36,8 @@ netstate_t netState = {
 DE_PIMPL(Net)
 {
     std::function<Transmitter *(int player)> transmitter;
+    bool frameDictLoaded = false;
+    const DeflateDictionary *frameDict = nullptr;
 
     Impl(Public *i) : Base(i)
     {}
@@ -81,3 +86,26 @@ void Net::sendDataToPlayer(int player, const IByteArray &data)
         *transmit << data;
     }
 }
+
+const DeflateDictionary *Net::frameDictionary() const
+{
+    if (!d->frameDictLoaded)
+    {
+        d->frameDictLoaded = true;
+        try
+        {
+            if (const auto *file = App::packageLoader().package("net.dengine.base").root()
+                                       .tryLocate<const File>("network/frames.dict"))
+            {
+                d->frameDict = &DeflateDictionary::registerDictionary(Block(*file));
+                LOG_NET_VERBOSE("Frame dictionary %08x (%i bytes)")
+                        << d->frameDict->id() << d->frameDict->data().size();
+            }
+        }
+        catch (const Error &er)
+        {
+            LOG_NET_WARNING("Failed to load frame dictionary: %s") << er.asText();
+        }
+    }
+    return d->frameDict;
+}
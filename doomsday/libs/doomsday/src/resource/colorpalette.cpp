@@ -20,15 +20,26 @@
 
 #include "doomsday/res/colorpalette.h"
 
+#include <de/guard.h>
 #include <de/log.h>
 #include <de/range.h>
 #include <de/keymap.h>
 #include <de/legacy/reader.h>
 #include <de/legacy/mathutil.h>
 
+#include <atomic>
+#include <cstdlib>
+
 using namespace de;
 
-#define RGB18(r, g, b)      ((r)+((g)<<6)+((b)<<12))
+/// Each cell of the nearest color table covers 8x8x8 colors.
+#define NEAREST_CELL_BITS   5
+#define NEAREST_CELL_SIZE   (1 << (8 - NEAREST_CELL_BITS))
+#define NEAREST_CELL_COUNT  (1 << (3 * NEAREST_CELL_BITS))
+#define NEAREST_CELL(r, g, b) \
+    ( ((r) >> (8 - NEAREST_CELL_BITS)) | \
+     (((g) >> (8 - NEAREST_CELL_BITS)) << NEAREST_CELL_BITS) | \
+     (((b) >> (8 - NEAREST_CELL_BITS)) << (2 * NEAREST_CELL_BITS)) )
 
 namespace res {
 
@@ -160,7 +171,7 @@ ColorTable ColorTableReader::read(String format, int colorCount,
     return colors;
 }
 
-DE_PIMPL(ColorPalette)
+DE_PIMPL(ColorPalette), public Lockable
 {
     typedef Vec3ub Color;
     typedef List<Color> ColorTable;
@@ -169,14 +180,22 @@ DE_PIMPL(ColorPalette)
     typedef KeyMap<String, Translation> Translations;
     Translations translations;
 
-    /// 18-bit to 8-bit, nearest color translation table.
-    typedef List<int> XLat18To8;
-    std::unique_ptr<XLat18To8> xlat18To8;
-    bool need18To8Update = false;  // Table built only when needed.
+    /**
+     * Nearest color lookup table. The RGB space is divided into cells, and each cell
+     * has a list of the palette colors that can be the nearest one to some color
+     * inside the cell. Only those need to be checked to find the exact nearest color.
+     */
+    struct NearestTable
+    {
+        List<duint32> cellBegin;  ///< Index of the first candidate of each cell.
+        List<duint16> candidates; ///< Palette indices, in ascending order per cell.
+    };
+    std::unique_ptr<NearestTable> nearestTable;
+    std::atomic<const NearestTable *> nearest; ///< Built table, or @c nullptr.
 
     Id id;
 
-    Impl(Public *i) : Base(i)
+    Impl(Public *i) : Base(i), nearest(nullptr)
     {
         LOG_RES_VERBOSE("New color palette %s") << id;
     }
@@ -199,42 +218,98 @@ DE_PIMPL(ColorPalette)
         }
     }
 
-    /// @note A time-consuming operation.
-    void prepareNearestLUT()
+    void clearNearestTable()
     {
-#define COLORS18BIT 262144
+        DE_GUARD(this);
+        nearest = nullptr;
+        nearestTable.reset();
+    }
+
+    /**
+     * Returns the nearest color lookup table, building it if necessary. The table
+     * is shared by all threads.
+     */
+    const NearestTable &nearestLUT()
+    {
+        if (const NearestTable *table = nearest.load(std::memory_order_acquire))
+        {
+            return *table;
+        }
+        DE_GUARD(this);
+        if (!nearestTable)
+        {
+            nearestTable.reset(new NearestTable);
+            buildNearestTable(*nearestTable);
+            nearest.store(nearestTable.get(), std::memory_order_release);
+        }
+        return *nearestTable;
+    }
 
-        need18To8Update = false;
+    /// @note A time-consuming operation.
+    void buildNearestTable(NearestTable &table) const
+    {
+        const int cellsPerAxis = 1 << NEAREST_CELL_BITS;
+        const int count = colors.count();
 
-        if (!xlat18To8)
+        // Squared distances along each axis from each color to the nearest and the
+        // farthest point of each cell.
+        List<int> minDist(3 * cellsPerAxis * count), maxDist(3 * cellsPerAxis * count);
+        for (int axis = 0; axis < 3; ++axis)
         {
-            xlat18To8.reset(new XLat18To8(COLORS18BIT));
+            for (int cell = 0; cell < cellsPerAxis; ++cell)
+            {
+                const int low  = cell * NEAREST_CELL_SIZE;
+                const int high = low + NEAREST_CELL_SIZE - 1;
+                for (int i = 0; i < count; ++i)
+                {
+                    const int c = colors[i][axis];
+                    const int nearDelta = (c < low? low - c : c > high? c - high : 0);
+                    const int farDelta  = de::max(std::abs(c - low), std::abs(c - high));
+                    const int at = (axis * cellsPerAxis + cell) * count + i;
+                    minDist[at] = nearDelta * nearDelta;
+                    maxDist[at] = farDelta  * farDelta;
+                }
+            }
         }
 
-        for (int r = 0; r < 64; ++r)
-        for (int g = 0; g < 64; ++g)
-        for (int b = 0; b < 64; ++b)
+        table.cellBegin.resize(NEAREST_CELL_COUNT + 1);
+        table.candidates.clear();
+
+        List<int> cellMinDist(count);
+        for (int b = 0; b < cellsPerAxis; ++b)
+        for (int g = 0; g < cellsPerAxis; ++g)
+        for (int r = 0; r < cellsPerAxis; ++r)
         {
-            int nearest = 0;
-            int smallestDiff = DDMAXINT;
-            for (int i = 0; i < colors.count(); ++i)
+            const int *minR = &minDist[(0 * cellsPerAxis + r) * count];
+            const int *minG = &minDist[(1 * cellsPerAxis + g) * count];
+            const int *minB = &minDist[(2 * cellsPerAxis + b) * count];
+            const int *maxR = &maxDist[(0 * cellsPerAxis + r) * count];
+            const int *maxG = &maxDist[(1 * cellsPerAxis + g) * count];
+            const int *maxB = &maxDist[(2 * cellsPerAxis + b) * count];
+
+            // No color in the cell is farther from its nearest palette color than
+            // this, so colors nearer than this to the cell are the only candidates.
+            int bound = DDMAXINT;
+            for (int i = 0; i < count; ++i)
             {
-                const Color &color = colors[i];
-                int diff = (color.x - (r << 2)) * (color.x - (r << 2)) +
-                           (color.y - (g << 2)) * (color.y - (g << 2)) +
-                           (color.z - (b << 2)) * (color.z - (b << 2));
+                cellMinDist[i] = minR[i] + minG[i] + minB[i];
+                bound = de::min(bound, maxR[i] + maxG[i] + maxB[i]);
+            }
 
-                if (diff < smallestDiff)
+            table.cellBegin[r | (g << NEAREST_CELL_BITS) | (b << (2 * NEAREST_CELL_BITS))] =
+                duint32(table.candidates.size());
+            for (int i = 0; i < count; ++i)
+            {
+                if (cellMinDist[i] <= bound)
                 {
-                    smallestDiff = diff;
-                    nearest = i;
+                    table.candidates << duint16(i);
                 }
             }
-
-            (*xlat18To8)[RGB18(r, g, b)] = nearest;
         }
+        table.cellBegin[NEAREST_CELL_COUNT] = duint32(table.candidates.size());
 
-#undef COLORS18BIT
+        LOGDEV_RES_VERBOSE("Nearest color table of palette %s has %.1f candidates per cell")
+            << id << double(table.candidates.size()) / NEAREST_CELL_COUNT;
     }
 };
 
@@ -263,11 +338,9 @@ ColorPalette &ColorPalette::replaceColorTable(const ColorTable &colorTable)
 
     const int colorCountBefore = colorCount();
 
-    // We may need a new 18 => 8 bit xlat table.
-    d->need18To8Update = true;
-
-    // Replace the whole color table.
+    // Replace the whole color table. The nearest color table is rebuilt when needed.
     d->colors = colorTable;
+    d->clearNearestTable();
 
     // Notify interested parties.
     d->notifyColorTableChanged();
@@ -307,17 +380,29 @@ Vec3f ColorPalette::colorf(int colorIdx) const
 
 int ColorPalette::nearestIndex(const Vec3ub &rgb) const
 {
-    LOG_AS("ColorPalette");
-
     if (d->colors.isEmpty()) return -1;
 
-    // Ensure we've prepared the 18 to 8 table.
-    if (d->need18To8Update || !d->xlat18To8)
+    const auto &table = d->nearestLUT();
+    const int cell    = NEAREST_CELL(rgb.x, rgb.y, rgb.z);
+    const duint16 *candidate = table.candidates.data() + table.cellBegin[cell];
+    const duint16 *end       = table.candidates.data() + table.cellBegin[cell + 1];
+
+    int nearest = *candidate;
+    int smallestDiff = DDMAXINT;
+    for (; candidate != end; ++candidate)
     {
-        d->prepareNearestLUT();
+        const Impl::Color &color = d->colors[*candidate];
+        const int dr = int(color.x) - rgb.x;
+        const int dg = int(color.y) - rgb.y;
+        const int db = int(color.z) - rgb.z;
+        const int diff = dr * dr + dg * dg + db * db;
+        if (diff < smallestDiff)
+        {
+            smallestDiff = diff;
+            nearest = *candidate;
+        }
     }
-
-    return (*d->xlat18To8)[RGB18(rgb.x >> 2, rgb.y >> 2, rgb.z >> 2)];
+    return nearest;
 }
 
 void ColorPalette::clearTranslations()
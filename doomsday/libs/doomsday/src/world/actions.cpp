@@ -107,7 +107,7 @@ void P_SetCurrentAction(const String &name)
 
 void P_SetCurrentActionState(int state)
 {
-    P_SetCurrentAction(DED_Definitions()->states[state].gets(DE_STR("action")));
+    P_SetCurrentAction(DED_Definitions()->getStateAction(state));
 }
 
 acfnptr_t P_GetAction(const String &name)
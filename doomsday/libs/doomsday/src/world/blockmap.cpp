@@ -22,181 +22,96 @@
 #include "doomsday/world/blockmap.h"
 
 #include <de/vector.h>
-#include <de/legacy/memoryzone.h>
 #include <de/legacy/vector1.h>
 #include <cmath>
-#include <list>
+#include <cstring>
+#include <vector>
 
 using namespace de;
 
 namespace world {
 
-struct RingNode {
-    void *    elem;
-    RingNode *prev;
-    RingNode *next;
-};
+Blockmap::CellElements::CellElements()
+{}
 
-struct CellData {
-    RingNode *ringNodes;
-    dint      elemCount; ///< Total number of linked elements.
-    
-    bool unlink(void *elem)
-    {
-        if (RingNode *node = findNode(elem))
-        {
-            clearElement(*node);
-            return true;
-        }
-        return false;
-    }
-    
-    void unlinkAll()
-    {
-        for (RingNode *node = ringNodes; node; node = node->next)
-        {
-            clearElement(*node);
-        }
-    }
-    
-    bool link(void *elem)
-    {
-        addElement(newNode(), elem);
-        return true;
-    }
-    
-private:
-    RingNode &newNode()
-    {
-        RingNode *node = nullptr;
-        
-        if (!ringNodes)
-        {
-            // Create a new root node.
-            node       = reinterpret_cast<RingNode *>(Z_Malloc(sizeof(*node), PU_MAP, nullptr));
-            node->next = nullptr;
-            node->prev = nullptr;
-            node->elem = nullptr;
-            
-            ringNodes = node;
-            
-            return *node;
-        }
-        
-        // Is there an available node in the ring we can reuse?
-        for (node = ringNodes; node->next && node->elem; node = node->next)
-        {
-        }
-        
-        if (!node->elem)
-        {
-            // This will do nicely.
-            return *node;
-        }
-        
-        // Add a new node to the ring.
-        node->next       = reinterpret_cast<RingNode *>(Z_Malloc(sizeof(*node), PU_MAP, nullptr));
-        node->next->next = nullptr;
-        node->next->prev = node;
-        node->next->elem = nullptr;
-        
-        return *node->next;
-    }
-    
-    RingNode *findNode(void *elem)
+Blockmap::CellElements::CellElements(CellElements &&moved)
+    : _heap     (moved._heap)
+    , _capacity (moved._capacity)
+    , _slotCount(moved._slotCount)
+    , _count    (moved._count)
+{
+    std::memcpy(_inline, moved._inline, sizeof(_inline));
+    moved._heap      = nullptr;
+    moved._capacity  = INLINE_CAPACITY;
+    moved._slotCount = 0;
+    moved._count     = 0;
+}
+
+Blockmap::CellElements::~CellElements()
+{
+    delete [] _heap;
+}
+
+void Blockmap::CellElements::link(void *elem)
+{
+    DE_ASSERT(elem);
+    void **slots = (_heap? _heap : _inline);
+    if (duint(_count) < _slotCount)
     {
-        if (elem)
+        // Reuse a vacant slot.
+        for (duint i = 0; i < _slotCount; ++i)
         {
-            for (RingNode *found = ringNodes; found; found = found->next)
+            if (!slots[i])
             {
-                if (found->elem == elem) return found;
+                slots[i] = elem;
+                _count++;
+                return;
             }
         }
-        return nullptr;
     }
-    
-    void clearElement(RingNode &node)
+    if (_slotCount == _capacity)
     {
-        if (!node.elem) return;
-        
-        node.elem = nullptr;
-        elemCount--;
+        void **enlarged = new void *[_capacity * 2];
+        std::memcpy(enlarged, slots, sizeof(void *) * _slotCount);
+        delete [] _heap;
+        _heap = slots = enlarged;
+        _capacity *= 2;
     }
-    
-    void addElement(RingNode &node, void *elem)
-    {
-        DE_ASSERT(node.elem == nullptr);
-        node.elem = elem;
-        elemCount++;
-    }
-};
+    slots[_slotCount++] = elem;
+    _count++;
+}
 
-DE_PIMPL(Blockmap)
+bool Blockmap::CellElements::unlink(void *elem)
 {
-    /**
-     * Quadtree node.
-     */
-    struct Node
+    if (!elem) return false;
+    void **slots = (_heap? _heap : _inline);
+    for (duint i = 0; i < _slotCount; ++i)
     {
-        /// Logical child quadrant identifiers.
-        enum Quadrant
+        if (slots[i] == elem)
         {
-            TopLeft,
-            TopRight,
-            BottomLeft,
-            BottomRight
-        };
-
-        Cell cell;   ///< Cell coordinates for this node.
-        duint size;  ///< Size of the cell at this node (width=height).
-        union {
-            Node *children[4];   /* One per quadrant (if any, not owned). */
-            CellData *leafData;  /* Data associated with the leaf cell.
-                                    Allocated from the zone; not freed by BlockMap. */
-        };
-
-        /**
-         * Construct a new node.
-         *
-         * @param cell  Cell coordinates for the node.
-         * @param size  Size of the cell.
-         */
-        Node(const Cell &cell, duint size)
-            : cell(cell)
-            , size(size)
-        {
-            zap(children);
+            slots[i] = nullptr;
+            _count--;
+            // Trailing vacant slots are not needed.
+            while (_slotCount > 0 && !slots[_slotCount - 1]) _slotCount--;
+            return true;
         }
+    }
+    return false;
+}
 
-        /**
-         * Returns @c true iff the cell is a leaf (i.e., equal to a unit in the
-         * gridmap coordinate space).
-         */
-        inline bool isLeaf() const { return size == 1; }
-
-        /**
-         * In which child quadrant is the given @a point?
-         */
-        Quadrant quadrant(const Cell &point) const
-        {
-            const duint subSize = size >> 1;
-            if(point.x < cell.x + subSize)
-            {
-                return (point.y < cell.y + subSize)? TopLeft  : BottomLeft;
-            }
-            else
-            {
-                return (point.y < cell.y + subSize)? TopRight : BottomRight;
-            }
-        }
-    };
-    typedef std::list<Node> Nodes;
+void Blockmap::CellElements::clear()
+{
+    _slotCount = 0;
+    _count     = 0;
+}
 
+DE_PIMPL(Blockmap)
+{
     AABoxd bounds;    ///< Map space units.
     duint cellSize;   ///< Map space units.
     Cell dimensions;  ///< Dimensions of the indexed space, in cells.
 
-    Nodes nodes;      ///< Quadtree nodes. The first being the root.
+    std::vector<CellElements> cells; ///< Row-major order; one per cell.
 
     Impl(Public *i, const AABoxd &bounds, duint cellSize)
         : Base(i)
@@ -204,10 +119,8 @@ DE_PIMPL(Blockmap)
         , cellSize  (cellSize)
         , dimensions(Vec2ui(de::ceil((bounds.maxX - bounds.minX) / cellSize),
                             de::ceil((bounds.maxY - bounds.minY) / cellSize)))
-    {
-        // Quadtree must subdivide the space equally into 1x1 unit cells.
-        newNode(Cell(0, 0), ceilPow2(de::max(dimensions.x, dimensions.y)));
-    }
+        , cells     (dsize(dimensions.x) * dimensions.y)
+    {}
 
     inline dint toCellIndex(duint cellX, duint cellY)
     {
@@ -298,88 +211,17 @@ DE_PIMPL(Blockmap)
         return didClipMin | didClipMax;
     }
 
-    Node *newNode(const Cell &at, duint size)
-    {
-        nodes.emplace_back(at, size);
-        return &nodes.back();
-    }
-
-    Node *findLeaf(Node *node, const Cell &at, bool canSubdivide)
-    {
-        if(node->isLeaf()) return node;
-
-        // Into which quadrant do we need to descend?
-        Node::Quadrant q = node->quadrant(at);
-
-        // Has this quadrant been initialized yet?
-        Node **childAdr = &node->children[q];
-        if(!*childAdr)
-        {
-            if(!canSubdivide) return nullptr;
-
-            // Subdivide the space.
-            const duint subSize = node->size >> 1;
-            switch(q)
-            {
-            case Node::TopLeft:
-                *childAdr = newNode(node->cell, subSize);
-                break;
-
-            case Node::TopRight:
-                *childAdr = newNode(Cell(node->cell.x + subSize, node->cell.y), subSize);
-                break;
-
-            case Node::BottomLeft:
-                *childAdr = newNode(Cell(node->cell.x, node->cell.y + subSize), subSize);
-                break;
-            case Node::BottomRight:
-                *childAdr = newNode(Cell(node->cell.x + subSize, node->cell.y + subSize), subSize);
-                break;
-            }
-        }
-
-        return findLeaf(*childAdr, at, canSubdivide);
-    }
-
-    inline Node *findLeaf(const Cell &at, bool canCreate = false)
-    {
-        return findLeaf(&nodes.front(), at, canCreate);
-    }
-
     /**
-     * Retrieve the user data associated with the identified cell.
-     *
-     * @param cell       Cell coordinates to retrieve user data for.
-     * @param canCreate  @c true= allocate new data if not already present
-     *                   for the referenced cell.
-     *
-     * @return  User data for the identified cell else @c 0if an invalid
-     *          reference or no there is no data present (and not allocating).
+     * Returns the elements of the identified cell, or @c nullptr if the cell is
+     * outside the blockmap.
      */
-    CellData *cellData(const Cell &cell, bool canCreate = false)
+    inline CellElements *cellElements(const Cell &cell)
     {
-        // Outside our boundary?
-        if(cell.x >= dimensions.x || cell.y >= dimensions.y)
+        if (cell.x >= dimensions.x || cell.y >= dimensions.y)
         {
             return nullptr;
         }
-
-        // Try to locate this leaf (may fail if not present and we are
-        // not allocating user data (there will be no corresponding cell)).
-        if(Node *node = findLeaf(cell, canCreate))
-        {
-            // Exisiting user data for this cell?
-            if(!node->leafData)
-            {
-                // Can we allocate new user data?
-                if(canCreate)
-                {
-                    node->leafData = (CellData *)Z_Calloc(sizeof(CellData), PU_MAPSTATIC, nullptr);
-                }
-            }
-            return node->leafData;
-        }
-        return nullptr;
+        return &cells[dsize(cell.y) * dimensions.x + cell.x];
     }
 };
 
@@ -432,13 +274,19 @@ BlockmapCellBlock Blockmap::toCellBlock(const AABoxd &box, bool *retDidClip) con
     return block;
 }
 
+const Blockmap::CellElements *Blockmap::cellElements(const Cell &cell) const
+{
+    return d->cellElements(cell);
+}
+
 bool Blockmap::link(const Cell &cell, void *elem)
 {
     if(!elem) return false; // Huh?
 
-    if(auto *cellData = d->cellData(cell, true /*can create*/))
+    if(auto *elems = d->cellElements(cell))
     {
-        return cellData->link(elem);
+        elems->link(elem);
+        return true;
     }
     return false; // Outside the blockmap?
 }
@@ -456,12 +304,10 @@ bool Blockmap::link(const AABoxd &region, void *elem)
     for(cell.y = cellBlock.min.y; cell.y < cellBlock.max.y; ++cell.y)
     for(cell.x = cellBlock.min.x; cell.x < cellBlock.max.x; ++cell.x)
     {
-        if(auto *cellData = d->cellData(cell, true))
+        if(auto *elems = d->cellElements(cell))
         {
-            if(cellData->link(elem))
-            {
-                didLink = true;
-            }
+            elems->link(elem);
+            didLink = true;
         }
     }
 
@@ -472,9 +318,9 @@ bool Blockmap::unlink(const Cell &cell, void *elem)
 {
     if(!elem) return false; // Huh?
 
-    if(auto *cellData = d->cellData(cell))
+    if(auto *elems = d->cellElements(cell))
     {
-        return cellData->unlink(elem);
+        return elems->unlink(elem);
     }
     return false;
 }
@@ -492,9 +338,9 @@ bool Blockmap::unlink(const AABoxd &region, void *elem)
     for(cell.y = cellBlock.min.y; cell.y < cellBlock.max.y; ++cell.y)
     for(cell.x = cellBlock.min.x; cell.x < cellBlock.max.x; ++cell.x)
     {
-        if(auto *cellData = d->cellData(cell))
+        if(auto *elems = d->cellElements(cell))
         {
-            if(cellData->unlink(elem))
+            if(elems->unlink(elem))
             {
                 didUnlink = true;
             }
@@ -506,61 +352,38 @@ bool Blockmap::unlink(const AABoxd &region, void *elem)
 
 void Blockmap::unlinkAll()
 {
-    for (const auto &node : d->nodes)
+    for (auto &elems : d->cells)
     {
-        // Only leafs with user data.
-        if (!node.isLeaf()) continue;
-
-        if (auto *cellData = node.leafData)
-        {
-            cellData->unlinkAll();
-        }
+        elems.clear();
     }
 }
 
 dint Blockmap::cellElementCount(const Cell &cell) const
 {
-    if(auto *cellData = d->cellData(cell))
+    if(const auto *elems = d->cellElements(cell))
     {
-        return cellData->elemCount;
+        return elems->count();
     }
     return 0;
 }
 
 LoopResult Blockmap::forAllInCell(const Cell &cell, std::function<LoopResult (void *object)> func) const
 {
-    if(auto *cellData = d->cellData(cell))
-    {
-        RingNode *node = cellData->ringNodes;
-        while(node)
-        {
-            RingNode *next = node->next;
-            if(node->elem)
-            {
-                if(auto result = func(node->elem)) return result;
-            }
-            node = next;
-        }
-    }
-    return LoopContinue;
+    return forEachInCell(cell, func);
 }
 
 LoopResult Blockmap::forAllInBox(const AABoxd &box, std::function<LoopResult (void *object)> func) const
 {
-    CellBlock cellBlock = toCellBlock(box);
-    d->clipBlock(cellBlock);
-
-    Cell cell;
-    for(cell.y = cellBlock.min.y; cell.y < cellBlock.max.y; ++cell.y)
-    for(cell.x = cellBlock.min.x; cell.x < cellBlock.max.x; ++cell.x)
-    {
-        if(auto result = forAllInCell(cell, func)) return result;
-    }
-    return LoopContinue;
+    return forEachInBox(box, func);
 }
 
-LoopResult Blockmap::forAllInPath(const Vec2d &from_, const Vec2d &to_,
+LoopResult Blockmap::forAllInPath(const Vec2d &from, const Vec2d &to,
     std::function<LoopResult (void *object)> func) const
+{
+    return forEachInPath(from, to, func);
+}
+
+int Blockmap::cellsInPath(const Vec2d &from_, const Vec2d &to_, Cell *cells) const
 {
     // We may need to clip and/or adjust these points.
     Vec2d from = from_;
@@ -570,7 +393,7 @@ LoopResult Blockmap::forAllInPath(const Vec2d &from_, const Vec2d &to_,
     if(!(from.x >= d->bounds.minX && from.x <= d->bounds.maxX &&
          from.y >= d->bounds.minY && from.y <= d->bounds.maxY))
     {
-        return LoopContinue;
+        return 0;
     }
 
     // Check the easy case of a trace line completely outside the blockmap.
@@ -579,7 +402,7 @@ LoopResult Blockmap::forAllInPath(const Vec2d &from_, const Vec2d &to_,
        (from.y < d->bounds.minY && to.y < d->bounds.minY) ||
        (from.y > d->bounds.maxY && to.y > d->bounds.maxY))
     {
-        return LoopContinue;
+        return 0;
     }
 
     /*
@@ -687,11 +510,11 @@ LoopResult Blockmap::forAllInPath(const Vec2d &from_, const Vec2d &to_,
 
     // Walk the cells of the blockmap.
     BlockmapCell cell = originCell;
-    for(int pass = 0; pass < 64; ++pass) // Prevent a round off error leading us into
-                                         // an infinite loop...
+    int count = 0;
+    while(count < MAX_PATH_CELLS) // Prevent a round off error leading us into
+                                  // an infinite loop...
     {
-        if(auto result = forAllInCell(cell, func))
-            return result;
+        cells[count++] = cell;
 
         if(cell == destCell) break;
 
@@ -707,7 +530,7 @@ LoopResult Blockmap::forAllInPath(const Vec2d &from_, const Vec2d &to_,
         }
     }
 
-    return LoopContinue;
+    return count;
 }
 
 }  // namespace world
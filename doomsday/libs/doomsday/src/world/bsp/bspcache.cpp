@@ -0,0 +1,633 @@
+/** @file bspcache.cpp  Persistent cache of built BSP trees and map geometry.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "doomsday/world/bsp/bspcache.h"
+
+#include "doomsday/world/bspleaf.h"
+#include "doomsday/world/convexsubspace.h"
+#include "doomsday/world/line.h"
+#include "doomsday/world/sector.h"
+#include "doomsday/world/vertex.h"
+#include "doomsday/mesh/face.h"
+#include "doomsday/mesh/hedge.h"
+
+#include <de/logbuffer.h>
+#include <de/metadatabank.h>
+#include <de/reader.h>
+#include <de/writer.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace de;
+
+namespace world {
+namespace bsp {
+
+DE_STATIC_STRING(BSPCACHE_CATEGORY, "BspCache");
+
+/// Changes whenever the partitioner output or the serialized format changes.
+static const duint32 BSPCACHE_FORMAT = 1;
+
+DE_PIMPL_NOREF(BspCache)
+{
+    /// Twin of a half-edge in the serialized data.
+    enum TwinRef : dint32 { NoTwin = -2, FreeTwin = -1 };
+
+    /// Node kinds in the serialized tree.
+    enum NodeKind : dbyte { PartitionNode = 0, LeafNode = 1 };
+
+    /// Serialized half-edge.
+    struct HEdgeRecord
+    {
+        dint32  vertex;
+        dint32  twin;           ///< Half-edge index, or a TwinRef.
+        dint32  twinVertex;     ///< Vertex of a twin that is not part of any face.
+        dint32  line;           ///< Line of the attributed segment, or -1.
+        dbyte   side;
+        ddouble lineSideOffset;
+        ddouble length;
+    };
+
+    /// Serialized face: a ring of consecutive half-edges.
+    struct FaceRecord
+    {
+        dint32 firstHEdge;
+        dint32 hedgeCount;
+    };
+
+    struct NodeRecord
+    {
+        NodeKind  kind;
+        Partition partition;
+        dint32    sector;          ///< Leaves only.
+        bool      hasSubspace;     ///< Leaves only.
+        FaceRecord face;
+        List<List<FaceRecord>> extraMeshes;
+        bool      hasRight;
+        bool      hasLeft;
+    };
+
+    const List<Line *> &  lines;
+    const List<Sector *> &sectors;
+    mesh::Mesh &          mesh;
+    int                   firstNewVertex;
+    Block                 key;
+
+    std::unordered_map<const Vertex *, dint32> vertexIndices;
+    std::unordered_map<const Line *, dint32>   lineIndices;
+    std::unordered_map<const Sector *, dint32> sectorIndices;
+
+    // Deserialized data:
+    List<Vec2d>       newVertices;
+    List<HEdgeRecord> hedgeRecords;
+    List<NodeRecord>  nodeRecords;
+
+    // Map elements constructed while restoring (owned until the tree is complete):
+    List<BspElement *>     builtElements;
+    List<ConvexSubspace *> builtSubspaces;
+
+    Impl(const List<Line *> &lines, const List<Sector *> &sectors, mesh::Mesh &mesh)
+        : lines(lines), sectors(sectors), mesh(mesh), firstNewVertex(mesh.vertexCount())
+    {}
+
+    dint32 vertexIndex(const Vertex &vertex)
+    {
+        if (vertexIndices.size() != dsize(mesh.vertexCount()))
+        {
+            vertexIndices.clear();
+            for (int i = 0; i < mesh.vertexCount(); ++i)
+            {
+                vertexIndices[mesh.vertices().at(i)] = i;
+            }
+        }
+        auto found = vertexIndices.find(&vertex);
+        return found != vertexIndices.end()? found->second : -1;
+    }
+
+    dint32 sectorIndex(const Sector *sector) const
+    {
+        if (!sector) return -1;
+        auto found = sectorIndices.find(sector);
+        return found != sectorIndices.end()? found->second : -1;
+    }
+
+    void makeKey(const Set<Line *> &linesToBuildFor, int splitCostFactor)
+    {
+        for (int i = 0; i < sectors.sizei(); ++i) sectorIndices[sectors.at(i)] = i;
+        for (int i = 0; i < lines.sizei(); ++i)   lineIndices[lines.at(i)] = i;
+
+        Block input;
+        Writer writer(input);
+        writer << BSPCACHE_FORMAT << dint32(splitCostFactor)
+               << duint32(mesh.vertexCount()) << duint32(lines.size()) << duint32(sectors.size());
+        for (const Vertex *vertex : mesh.vertices())
+        {
+            writer << vertex->origin().x << vertex->origin().y;
+        }
+        for (const Line *line : lines)
+        {
+            writer << vertexIndex(line->from())
+                   << vertexIndex(line->to())
+                   << sectorIndex(line->front().sectorPtr())
+                   << sectorIndex(line->back().sectorPtr())
+                   << dbyte(linesToBuildFor.contains(const_cast<Line *>(line)))
+                   << dbyte(line->isBspWindow());
+        }
+        key = input.md5Hash();
+    }
+
+    //- Serialization -----------------------------------------------------------------
+
+    /**
+     * Assigns indices to the half-edges of the faces in the order they will be
+     * written. Returns @c false if the geometry cannot be represented.
+     */
+    bool indexFaces(const BspTree &tree, std::unordered_map<const mesh::HEdge *, dint32> &indices)
+    {
+        auto indexFace = [&indices] (const mesh::Face &face)
+        {
+            const mesh::HEdge *hedge = face.hedge();
+            if (!hedge) return false;
+            do
+            {
+                const dint32 idx = dint32(indices.size());
+                indices[hedge] = idx;
+                if (!hedge->hasNext()) return false;
+            }
+            while ((hedge = &hedge->next()) != face.hedge());
+            return true;
+        };
+
+        if (!tree.userData()) return false;
+        if (tree.isLeaf())
+        {
+            const auto &leaf = tree.userData()->as<BspLeaf>();
+            if (!leaf.hasSubspace()) return true;
+            if (!indexFace(leaf.subspace().poly())) return false;
+            bool ok = true;
+            leaf.subspace().forAllExtraMeshes([&ok, &indexFace] (mesh::Mesh &extra)
+            {
+                for (const mesh::Face *face : extra.faces())
+                {
+                    if (!indexFace(*face)) { ok = false; return LoopAbort; }
+                }
+                return LoopContinue;
+            });
+            return ok;
+        }
+        if (tree.hasRight() && !indexFaces(*tree.rightPtr(), indices)) return false;
+        if (tree.hasLeft()  && !indexFaces(*tree.leftPtr(),  indices)) return false;
+        return true;
+    }
+
+    bool writeFace(Writer &writer, const mesh::Face &face,
+                   const std::unordered_map<const mesh::HEdge *, dint32> &indices)
+    {
+        writer << dint32(face.hedgeCount());
+        dint32 count = 0;
+        const mesh::HEdge *hedge = face.hedge();
+        do
+        {
+            HEdgeRecord rec{vertexIndex(hedge->vertex()), NoTwin, -1, -1, 0, 0, 0};
+            if (rec.vertex < 0) return false;
+
+            if (hedge->hasTwin())
+            {
+                const mesh::HEdge &twin = hedge->twin();
+                if (twin.hasFace())
+                {
+                    auto found = indices.find(&twin);
+                    if (found == indices.end()) return false; // Not part of the tree.
+                    rec.twin = found->second;
+                }
+                else
+                {
+                    rec.twin       = FreeTwin;
+                    rec.twinVertex = vertexIndex(twin.vertex());
+                    if (rec.twinVertex < 0 || &twin.mesh() != &hedge->mesh()) return false;
+                }
+            }
+            if (hedge->hasMapElement() && hedge->mapElement().type() == DMU_SEGMENT)
+            {
+                const auto &seg = hedge->mapElementAs<LineSideSegment>();
+                auto found = lineIndices.find(&seg.line());
+                if (found == lineIndices.end()) return false;
+                rec.line           = found->second;
+                rec.side           = dbyte(seg.lineSide().sideId());
+                rec.lineSideOffset = seg.lineSideOffset();
+                rec.length         = seg.length();
+            }
+            writer << rec.vertex << rec.twin << rec.twinVertex << rec.line << rec.side
+                   << rec.lineSideOffset << rec.length;
+            count++;
+        }
+        while ((hedge = &hedge->next()) != face.hedge());
+        return count == face.hedgeCount();
+    }
+
+    bool writeTree(Writer &writer, const BspTree &tree,
+                   const std::unordered_map<const mesh::HEdge *, dint32> &indices)
+    {
+        if (tree.isLeaf())
+        {
+            const auto &leaf = tree.userData()->as<BspLeaf>();
+            writer << dbyte(LeafNode) << sectorIndex(leaf.sectorPtr()) << dbyte(leaf.hasSubspace());
+            if (!leaf.hasSubspace()) return true;
+
+            const ConvexSubspace &subspace = leaf.subspace();
+            if (!writeFace(writer, subspace.poly(), indices)) return false;
+
+            List<const mesh::Mesh *> extraMeshes;
+            subspace.forAllExtraMeshes([&extraMeshes] (mesh::Mesh &extra) {
+                extraMeshes << &extra;
+                return LoopContinue;
+            });
+            writer << duint32(extraMeshes.size());
+            for (const mesh::Mesh *extra : extraMeshes)
+            {
+                writer << duint32(extra->faceCount());
+                for (const mesh::Face *face : extra->faces())
+                {
+                    if (!writeFace(writer, *face, indices)) return false;
+                }
+            }
+            return true;
+        }
+
+        const auto &node = tree.userData()->as<BspNode>();
+        writer << dbyte(PartitionNode)
+               << node.origin.x << node.origin.y << node.direction.x << node.direction.y
+               << dbyte(tree.hasRight()) << dbyte(tree.hasLeft());
+        if (tree.hasRight() && !writeTree(writer, *tree.rightPtr(), indices)) return false;
+        if (tree.hasLeft()  && !writeTree(writer, *tree.leftPtr(),  indices)) return false;
+        return true;
+    }
+
+    //- Deserialization ---------------------------------------------------------------
+
+    FaceRecord readFace(Reader &reader)
+    {
+        dint32 count;
+        reader >> count;
+        if (count < 1 || count > 1000000)
+        {
+            throw Error("BspCache::readFace", "Invalid face");
+        }
+        FaceRecord face{hedgeRecords.sizei(), count};
+        for (dint32 i = 0; i < count; ++i)
+        {
+            HEdgeRecord rec;
+            reader >> rec.vertex >> rec.twin >> rec.twinVertex >> rec.line >> rec.side
+                   >> rec.lineSideOffset >> rec.length;
+            hedgeRecords << rec;
+        }
+        return face;
+    }
+
+    void readTree(Reader &reader)
+    {
+        NodeRecord node{};
+        dbyte kind;
+        reader >> kind;
+        node.kind = NodeKind(kind);
+        if (node.kind == LeafNode)
+        {
+            dbyte hasSubspace;
+            reader >> node.sector >> hasSubspace;
+            node.hasSubspace = hasSubspace != 0;
+            if (node.hasSubspace)
+            {
+                node.face = readFace(reader);
+                duint32 meshCount;
+                reader >> meshCount;
+                for (duint32 i = 0; i < meshCount; ++i)
+                {
+                    duint32 faceCount;
+                    reader >> faceCount;
+                    List<FaceRecord> faces;
+                    for (duint32 k = 0; k < faceCount; ++k)
+                    {
+                        faces << readFace(reader);
+                    }
+                    node.extraMeshes << faces;
+                }
+            }
+            nodeRecords << node;
+        }
+        else if (node.kind == PartitionNode)
+        {
+            dbyte hasRight, hasLeft;
+            reader >> node.partition.origin.x >> node.partition.origin.y
+                   >> node.partition.direction.x >> node.partition.direction.y
+                   >> hasRight >> hasLeft;
+            node.hasRight = hasRight != 0;
+            node.hasLeft  = hasLeft  != 0;
+            nodeRecords << node;
+            if (node.hasRight) readTree(reader);
+            if (node.hasLeft)  readTree(reader);
+        }
+        else
+        {
+            throw Error("BspCache::readTree", "Invalid node");
+        }
+    }
+
+    /// Checks that all references in the deserialized data are valid.
+    void validate() const
+    {
+        const dint32 vertexCount = firstNewVertex + newVertices.sizei();
+        for (const HEdgeRecord &rec : hedgeRecords)
+        {
+            const dint32 index = dint32(&rec - hedgeRecords.data());
+            if (rec.vertex < 0 || rec.vertex >= vertexCount ||
+                rec.twin < NoTwin || rec.twin >= hedgeRecords.sizei() || rec.twin == index ||
+                (rec.twin >= 0 && hedgeRecords.at(rec.twin).twin != index) ||
+                (rec.twin == FreeTwin && (rec.twinVertex < 0 || rec.twinVertex >= vertexCount)) ||
+                rec.line < -1 || rec.line >= lines.sizei() || rec.side > 1)
+            {
+                throw Error("BspCache::validate", "Invalid half-edge");
+            }
+        }
+        for (const NodeRecord &node : nodeRecords)
+        {
+            if (node.kind == LeafNode && (node.sector < -1 || node.sector >= sectors.sizei()))
+            {
+                throw Error("BspCache::validate", "Invalid sector");
+            }
+            // ConvexSubspace::newFromConvexPoly() rejects degenerate polygons.
+            if (node.kind == LeafNode && node.hasSubspace && node.face.hedgeCount < 3)
+            {
+                throw Error("BspCache::validate", "Invalid subspace polygon");
+            }
+        }
+    }
+
+    mesh::Face *buildFace(mesh::Mesh &owner, const FaceRecord &rec,
+                          std::vector<mesh::HEdge *> &hedges)
+    {
+        mesh::Face *face = owner.newFace();
+        for (dint32 i = 0; i < rec.hedgeCount; ++i)
+        {
+            const HEdgeRecord &hrec = hedgeRecords.at(rec.firstHEdge + i);
+            mesh::HEdge *hedge = owner.newHEdge(*mesh.vertices().at(hrec.vertex));
+            hedges[rec.firstHEdge + i] = hedge;
+
+            if (hrec.line >= 0)
+            {
+                LineSideSegment *seg = lines.at(hrec.line)->side(hrec.side).addSegment(*hedge);
+                seg->setLineSideOffset(hrec.lineSideOffset);
+                seg->setLength(hrec.length);
+            }
+        }
+        // Link the ring.
+        for (dint32 i = 0; i < rec.hedgeCount; ++i)
+        {
+            mesh::HEdge *hedge = hedges[rec.firstHEdge + i];
+            mesh::HEdge *next  = hedges[rec.firstHEdge + (i + 1) % rec.hedgeCount];
+            hedge->setNext(next);
+            next->setPrev(hedge);
+            hedge->setFace(face);
+            face->incrementHedgeCount();
+        }
+        face->setHEdge(hedges[rec.firstHEdge]);
+        face->updateBounds();
+        face->updateCenter();
+        return face;
+    }
+
+    BspTree *buildTree(int &pos, std::vector<mesh::HEdge *> &hedges)
+    {
+        const NodeRecord &node = nodeRecords.at(pos++);
+        if (node.kind == LeafNode)
+        {
+            auto *leaf = new BspLeaf(node.sector >= 0? sectors.at(node.sector) : nullptr);
+            builtElements << leaf;
+            if (node.hasSubspace)
+            {
+                mesh::Face *poly = buildFace(mesh, node.face, hedges);
+                ConvexSubspace *subspace = ConvexSubspace::newFromConvexPoly(*poly);
+                builtSubspaces << subspace;
+                leaf->setSubspace(subspace);
+                for (const auto &extraFaces : node.extraMeshes)
+                {
+                    std::unique_ptr<mesh::Mesh> extra(new mesh::Mesh);
+                    for (const FaceRecord &face : extraFaces)
+                    {
+                        buildFace(*extra, face, hedges);
+                    }
+                    subspace->assignExtraMesh(*extra.release());
+                }
+            }
+            return new BspTree(leaf);
+        }
+        // Subtrees already built are deleted if a later one fails.
+        std::unique_ptr<BspTree> right(node.hasRight? buildTree(pos, hedges) : nullptr);
+        std::unique_ptr<BspTree> left (node.hasLeft?  buildTree(pos, hedges) : nullptr);
+        auto *bspNode = new BspNode(node.partition);
+        builtElements << bspNode;
+        auto *subtree = new BspTree(bspNode, nullptr, right.get(), left.get());
+        if (right) right.release()->setParent(subtree);
+        if (left)  left.release()->setParent(subtree);
+        return subtree;
+    }
+
+    /**
+     * Undoes a partially completed restore: everything added to the map geometry
+     * after the given element counts is destroyed.
+     */
+    void discardRestored(int firstNewHEdge, int firstNewFace)
+    {
+        deleteAll(builtSubspaces); // Along with their extra meshes.
+        builtSubspaces.clear();
+        deleteAll(builtElements);
+        builtElements.clear();
+
+        for (const HEdgeRecord &rec : hedgeRecords)
+        {
+            if (rec.line >= 0) lines.at(rec.line)->side(rec.side).clearSegments();
+        }
+        while (mesh.faceCount() > firstNewFace)
+        {
+            mesh.removeFace(*mesh.faces().last());
+        }
+        while (mesh.hedgeCount() > firstNewHEdge)
+        {
+            mesh.removeHEdge(*mesh.hedges().last());
+        }
+        while (mesh.vertexCount() > firstNewVertex)
+        {
+            mesh.removeVertex(*mesh.vertices().last());
+        }
+    }
+
+    void linkTwins(const std::vector<mesh::HEdge *> &hedges)
+    {
+        for (dsize i = 0; i < hedges.size(); ++i)
+        {
+            const HEdgeRecord &rec = hedgeRecords.at(i);
+            mesh::HEdge *hedge = hedges[i];
+            if (rec.twin >= 0)
+            {
+                hedge->setTwin(hedges[rec.twin]);
+            }
+            else if (rec.twin == FreeTwin)
+            {
+                // Allocate the twin from the same mesh.
+                mesh::HEdge *twin = hedge->mesh().newHEdge(*mesh.vertices().at(rec.twinVertex));
+                twin->setTwin(hedge);
+                hedge->setTwin(twin);
+            }
+        }
+    }
+};
+
+BspCache::BspCache(const List<Line *> &lines, const Set<Line *> &linesToBuildFor,
+                   const List<Sector *> &sectors, mesh::Mesh &mesh, int splitCostFactor)
+    : d(new Impl(lines, sectors, mesh))
+{
+    d->makeKey(linesToBuildFor, splitCostFactor);
+}
+
+Block BspCache::key() const
+{
+    return d->key;
+}
+
+BspTree *BspCache::restore(UnclosedSectors &unclosedSectors)
+{
+    LOG_AS("BspCache");
+
+    Block data;
+    try
+    {
+        data = MetadataBank::get().check(BSPCACHE_CATEGORY(), d->key);
+        if (!data) return nullptr;
+
+        // Read everything before modifying the map.
+        data = data.decompressed();
+        Reader reader(data);
+        duint32 format, vertexCount, unclosedCount;
+        reader >> format;
+        if (format != BSPCACHE_FORMAT) return nullptr;
+
+        reader >> vertexCount;
+        for (duint32 i = 0; i < vertexCount; ++i)
+        {
+            Vec2d origin;
+            reader >> origin.x >> origin.y;
+            d->newVertices << origin;
+        }
+        reader >> unclosedCount;
+        for (duint32 i = 0; i < unclosedCount; ++i)
+        {
+            dint32 sector;
+            Vec2d nearPoint;
+            reader >> sector >> nearPoint.x >> nearPoint.y;
+            if (sector < 0 || sector >= d->sectors.sizei())
+            {
+                throw Error("BspCache::restore", "Invalid unclosed sector");
+            }
+            unclosedSectors << UnclosedSector{d->sectors.at(sector), nearPoint};
+        }
+        d->readTree(reader);
+        if (!reader.atEnd())
+        {
+            throw Error("BspCache::restore", "Unexpected data after the tree");
+        }
+        d->validate();
+    }
+    catch (const Error &er)
+    {
+        LOGDEV_MAP_WARNING("Corrupt cached BSP: %s") << er.asText();
+        unclosedSectors.clear();
+        return nullptr;
+    }
+
+    const int firstNewHEdge = d->mesh.hedgeCount();
+    const int firstNewFace  = d->mesh.faceCount();
+    try
+    {
+        for (const Vec2d &origin : d->newVertices)
+        {
+            d->mesh.newVertex(origin);
+        }
+        std::vector<mesh::HEdge *> hedges(d->hedgeRecords.size());
+        int pos = 0;
+        BspTree *tree = d->buildTree(pos, hedges);
+        d->linkTwins(hedges);
+
+        // The caller takes ownership of the tree and its elements.
+        d->builtElements.clear();
+        d->builtSubspaces.clear();
+        return tree;
+    }
+    catch (const Error &er)
+    {
+        // The map is left as it was, so a new tree can be built instead.
+        LOGDEV_MAP_WARNING("Failed to restore cached BSP: %s") << er.asText();
+        d->discardRestored(firstNewHEdge, firstNewFace);
+        unclosedSectors.clear();
+        return nullptr;
+    }
+}
+
+void BspCache::store(const BspTree &tree, const UnclosedSectors &unclosedSectors)
+{
+    LOG_AS("BspCache");
+
+    std::unordered_map<const mesh::HEdge *, dint32> indices;
+    if (!d->indexFaces(tree, indices))
+    {
+        LOGDEV_MAP_VERBOSE("BSP geometry cannot be cached");
+        return;
+    }
+
+    Block data;
+    Writer writer(data);
+    writer << BSPCACHE_FORMAT << duint32(d->mesh.vertexCount() - d->firstNewVertex);
+    for (int i = d->firstNewVertex; i < d->mesh.vertexCount(); ++i)
+    {
+        const Vec2d &origin = d->mesh.vertices().at(i)->origin();
+        writer << origin.x << origin.y;
+    }
+    writer << duint32(unclosedSectors.size());
+    for (const UnclosedSector &unclosed : unclosedSectors)
+    {
+        writer << d->sectorIndex(unclosed.sector) << unclosed.nearPoint.x << unclosed.nearPoint.y;
+    }
+    if (!d->writeTree(writer, tree, indices))
+    {
+        LOGDEV_MAP_VERBOSE("BSP geometry cannot be cached");
+        return;
+    }
+
+    try
+    {
+        MetadataBank::get().setMetadata(BSPCACHE_CATEGORY(), d->key, data.compressed());
+    }
+    catch (const Error &er)
+    {
+        LOGDEV_MAP_WARNING("Failed to cache BSP: %s") << er.asText();
+    }
+}
+
+}  // namespace bsp
+}  // namespace world
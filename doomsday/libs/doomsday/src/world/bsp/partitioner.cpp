@@ -58,6 +58,7 @@ using EdgeTipSetMap    = Hash<Vertex *, EdgeTips>;
 DE_PIMPL(Partitioner)
 {
     int splitCostFactor = 7; ///< Cost of splitting a line segment.
+    bool concurrent = true;  ///< Evaluate partition candidates concurrently.
     
     Lines lines;          ///< Set of map lines to build from (in index order, not owned).
     mesh::Mesh *mesh = nullptr; ///< Provider of map geometries (cf. Factory).
@@ -841,7 +842,7 @@ DE_PIMPL(Partitioner)
 
     LineSegmentSide *choosePartition(LineSegmentBlockTreeNode &candidateSet)
     {
-        return PartitionEvaluator(splitCostFactor).choose(candidateSet);
+        return PartitionEvaluator(splitCostFactor, concurrent).choose(candidateSet);
     }
 
     /**
@@ -1107,6 +1108,11 @@ void Partitioner::setSplitCostFactor(int newFactor)
     d->splitCostFactor = newFactor;
 }
 
+void Partitioner::setConcurrent(bool enabled)
+{
+    d->concurrent = enabled;
+}
+
 static AABox blockmapBounds(const AABoxd &mapBounds)
 {
     AABox mapBoundsi;
@@ -27,7 +27,6 @@
 
 #include <de/log.h>
 #include <de/string.h>
-#include <de/task.h>
 #include <de/taskpool.h>
 
 namespace world {
@@ -174,9 +173,14 @@ namespace internal
 
 using namespace internal;
 
+/// Minimum amount of work (candidates times line segments) worth evaluating
+/// concurrently. Smaller sets are evaluated faster in the calling thread.
+static const dsize PARALLEL_EVALUATION_THRESHOLD = 4096;
+
 DE_PIMPL_NOREF(PartitionEvaluator)
 {
     int splitCostFactor = 7;
+    bool concurrent = true;
 
     LineSegmentBlockTreeNode *rootNode = nullptr; ///< Current block tree root node.
 
@@ -188,23 +192,20 @@ DE_PIMPL_NOREF(PartitionEvaluator)
         PartitionCandidate(LineSegmentSide &partition) : line(&partition)
         {}
     };
-    typedef List<PartitionCandidate *> Candidates;
+    typedef List<PartitionCandidate> Candidates;
     Candidates candidates;
 
-    PartitionCandidate *nextCandidate()
-    {
-        DE_ASSERT(costTaskPool.isDone());
-        if (candidates.isEmpty()) return nullptr;
-        return candidates.takeFirst();
-    }
-
-    class CostTask : public Task
+    /**
+     * Determines the cost of a single partition candidate. Only reads the block tree,
+     * so any number of candidates can be evaluated concurrently.
+     */
+    class CostEvaluator
     {
     public:
-        Impl &evaluator;
+        const Impl &evaluator;
         PartitionCandidate &candidate;
 
-        CostTask(Impl &evaluator, PartitionCandidate &candidate)
+        CostEvaluator(const Impl &evaluator, PartitionCandidate &candidate)
             : evaluator(evaluator), candidate(candidate)
         {}
 
@@ -215,7 +216,7 @@ DE_PIMPL_NOREF(PartitionEvaluator)
          * determined) then @var partition is zeroed. Otherwise the candidate is
          * suitable and @var cost contains valid costing metrics.
          */
-        void runTask()
+        void evaluate()
         {
             LineSegmentSide **partition = &candidate.line;
             PartitionCost &cost         = candidate.cost;
@@ -379,24 +380,37 @@ DE_PIMPL_NOREF(PartitionEvaluator)
             }
         }
     };
-    TaskPool costTaskPool;
 
     /**
-     * @param line  Partition line to evaluate.
+     * Evaluates all the candidates, concurrently if there is enough work.
+     *
+     * @param segmentCount  Number of line segments in the block tree.
      */
-    void beginPartitionCosting(LineSegmentSide *line)
+    void evaluateCandidates(dsize segmentCount)
     {
-        DE_ASSERT(line && line->hasMapSide());
-        // Run a new partition cost task.
-        PartitionCandidate *newCandidate = new PartitionCandidate(*line);
-        candidates << newCandidate;
-        costTaskPool.start(new CostTask(*this, *newCandidate));
+        auto evaluateRange = [this] (dsize begin, dsize end)
+        {
+            for (dsize i = begin; i < end; ++i)
+            {
+                CostEvaluator(*this, candidates[i]).evaluate();
+            }
+        };
+        if (concurrent && candidates.size() > 1 &&
+            candidates.size() * segmentCount >= PARALLEL_EVALUATION_THRESHOLD)
+        {
+            TaskPool::parallelFor(0, candidates.size(), evaluateRange);
+        }
+        else
+        {
+            evaluateRange(0, candidates.size());
+        }
     }
 };
 
-PartitionEvaluator::PartitionEvaluator(int splitCostFactor) : d(new Impl)
+PartitionEvaluator::PartitionEvaluator(int splitCostFactor, bool concurrent) : d(new Impl)
 {
     d->splitCostFactor = splitCostFactor;
+    d->concurrent      = concurrent;
 }
 
 LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
@@ -441,8 +455,8 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
                 // Don't consider further segments of the candidate.
                 candidate->mapLine().setValidCount(World::validCount);
 
-                // Determine candidate suitability and cost.
-                d->beginPartitionCosting(candidate);
+                // Determine candidate suitability and cost later.
+                d->candidates << Impl::PartitionCandidate(*candidate);
             }
 
             if(prev == cur->parentPtr())
@@ -473,28 +487,27 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
         }
     }
 
+    d->evaluateCandidates(dsize(node.userData()->totalCount()));
+
+    // The first candidate with the lowest cost is chosen, regardless of the order
+    // in which the candidates were evaluated.
     LineSegmentSide *best = nullptr;
-    if(!d->candidates.isEmpty())
+    PartitionCost bestCost;
+    for(const Impl::PartitionCandidate &candidate : d->candidates)
     {
-        d->costTaskPool.waitForDone();
-        PartitionCost bestCost;
-        while(Impl::PartitionCandidate *candidate = d->nextCandidate())
-        {
-            //LOG_DEBUG("%p: %s") << candidate->line << candidate->cost.asText();
-
-            if(candidate->line && (!best || candidate->cost < bestCost))
-            {
-                // We have a new better choice.
-                best     = candidate->line;
-                bestCost = candidate->cost;
-            }
+        //LOG_DEBUG("%p: %s") << candidate.line << candidate.cost.asText();
 
-            delete candidate;
+        if(candidate.line && (!best || candidate.cost < bestCost))
+        {
+            // We have a new better choice.
+            best     = candidate.line;
+            bestCost = candidate.cost;
         }
-
-        //LOG_DEBUG("best %p score: %d.%02d")
-        //        << best << bestCost.total / 100 << bestCost.total % 100;
     }
+    d->candidates.clear();
+
+    //LOG_DEBUG("best %p score: %d.%02d")
+    //        << best << bestCost.total / 100 << bestCost.total % 100;
 
     return best;
 }
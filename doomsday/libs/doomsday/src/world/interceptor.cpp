@@ -281,7 +281,7 @@ DE_PIMPL_NOREF(Interceptor)
             // Process polyobj lines.
             if(map->polyobjCount())
             {
-                map->polyobjBlockmap().forAllInPath(from, to, [this, &localValidCount] (void *object)
+                map->polyobjBlockmap().forEachInPath(from, to, [this, &localValidCount] (void *object)
                 {
                     auto &pob = *(Polyobj *)object;
                     if(pob.validCount != localValidCount)  // not yet processed
@@ -301,7 +301,7 @@ DE_PIMPL_NOREF(Interceptor)
             }
 
             // Process sector lines.
-            map->lineBlockmap().forAllInPath(from, to, [this, &localValidCount] (void *object)
+            map->lineBlockmap().forEachInPath(from, to, [this, &localValidCount] (void *object)
             {
                 auto &line = *(Line *)object;
                 if(line.validCount() != localValidCount)  // not yet processed
@@ -316,7 +316,7 @@ DE_PIMPL_NOREF(Interceptor)
         if(flags & PTF_MOBJ)
         {
             // Process map objects.
-            map->mobjBlockmap().forAllInPath(from, to, [this, &localValidCount] (void *object)
+            map->mobjBlockmap().forEachInPath(from, to, [this, &localValidCount] (void *object)
             {
                 auto &mob = *(mobj_t *)object;
                 if(mob.validCount != localValidCount)  // not yet processed
@@ -27,6 +27,7 @@
 #include "doomsday/world/lineowner.h"
 #include "doomsday/world/bspleaf.h"
 #include "doomsday/world/convexsubspace.h"
+#include "doomsday/world/bsp/bspcache.h"
 #include "doomsday/world/bsp/partitioner.h"
 #include "doomsday/world/factory.h"
 #include "doomsday/world/thinkers.h"
@@ -46,12 +47,15 @@
 #include <de/charsymbols.h>
 #include <de/rectangle.h>
 #include <de/logbuffer.h>
+#include <de/time.h>
 
 using namespace de;
 
+
 namespace world {
 
 static int bspSplitFactor = 7;  // cvar
+static int bspCache       = 1;  // cvar
 
 /*
  * Additional data for all dummy elements.
@@ -168,6 +172,8 @@ DE_PIMPL(Map)
     nodepile_t                    lineNodes;
     nodeindex_t *                 lineLinks = nullptr; ///< Indices to roots.
 
+    bsp::BspCache::UnclosedSectors *bspUnclosedSectors = nullptr; ///< Collected during a BSP build.
+
     Impl(Public *i) : Base(i)
     {
         sky.reset(Factory::newSky(nullptr));
@@ -250,6 +256,11 @@ DE_PIMPL(Map)
     // Observes bsp::Partitioner UnclosedSectorFound.
     void unclosedSectorFound(Sector &sector, const Vec2d &nearPoint)
     {
+        if (bspUnclosedSectors)
+        {
+            bspUnclosedSectors->append({&sector, nearPoint});
+        }
+
         // Notify interested parties that an unclosed sector was found.
         DE_NOTIFY_PUBLIC(UnclosedSectorFound, i) i->unclosedSectorFound(sector, nearPoint);
     }
@@ -467,20 +478,52 @@ DE_PIMPL(Map)
             }
         }
 
+        bool restoredFromCache = false;
         try
         {
-            // Configure a space partitioner.
-            world::bsp::Partitioner partitioner(bspSplitFactor);
-            partitioner.audienceForUnclosedSectorFound += this;
+            world::bsp::BspCache cache(lines, linesToBuildFor, sectors, mesh, bspSplitFactor);
+            world::bsp::BspCache::UnclosedSectors unclosedSectors;
 
-            // Build a new BSP tree.
-            bsp.tree = partitioner.makeBspTree(linesToBuildFor, mesh);
-            DE_ASSERT(bsp.tree);
+            if (bspCache)
+            {
+                bsp.tree = cache.restore(unclosedSectors);
+            }
+            if (bsp.tree)
+            {
+                restoredFromCache = true;
+
+                // The same problems are reported as when the tree was built.
+                for (const auto &unclosed : unclosedSectors)
+                {
+                    unclosedSectorFound(*unclosed.sector, unclosed.nearPoint);
+                }
 
-            LOG_MAP_VERBOSE("BSP built: %s. With %d Segments and %d Vertexes.")
-                << bsp.tree->summary()
-                << partitioner.segmentCount()
-                << partitioner.vertexCount();
+                LOG_MAP_VERBOSE("BSP restored from cache: %s. With %d Vertexes.")
+                    << bsp.tree->summary()
+                    << mesh.vertexCount() - nextVertexOrd;
+            }
+            else
+            {
+                // Configure a space partitioner.
+                world::bsp::Partitioner partitioner(bspSplitFactor);
+                partitioner.audienceForUnclosedSectorFound += this;
+
+                // Build a new BSP tree.
+                bspUnclosedSectors = &unclosedSectors;
+                bsp.tree = partitioner.makeBspTree(linesToBuildFor, mesh);
+                bspUnclosedSectors = nullptr;
+                DE_ASSERT(bsp.tree);
+
+                LOG_MAP_VERBOSE("BSP built: %s. With %d Segments and %d Vertexes.")
+                    << bsp.tree->summary()
+                    << partitioner.segmentCount()
+                    << partitioner.vertexCount();
+
+                if (bspCache)
+                {
+                    cache.store(*bsp.tree, unclosedSectors);
+                }
+            }
 
             // Attribute an index to any new vertexes.
             for (int i = nextVertexOrd; i < mesh.vertexCount(); ++i)
@@ -575,11 +618,19 @@ DE_PIMPL(Map)
         }
         catch (const Error &er)
         {
+            bspUnclosedSectors = nullptr;
             LOG_MAP_WARNING("%s.") << er.asText();
         }
 
         // How much time did we spend?
-        LOGDEV_MAP_VERBOSE("BSP built in %.2f seconds") << begunAt.since();
+        if (restoredFromCache)
+        {
+            LOGDEV_MAP_VERBOSE("BSP restored from cache in %.2f seconds") << begunAt.since();
+        }
+        else
+        {
+            LOGDEV_MAP_VERBOSE("BSP built in %.2f seconds") << begunAt.since();
+        }
 
         return bsp.tree != nullptr;
     }
@@ -1372,7 +1423,7 @@ LoopResult Map::forAllLinesInBox(const AABoxd &box, int flags,
     if ((flags & LIF_POLYOBJ) && polyobjCount())
     {
         const int localValidCount = World::validCount;
-        result = polyobjBlockmap().forAllInBox(box, [&func, &localValidCount](void *object) {
+        result = polyobjBlockmap().forEachInBox(box, [&func, &localValidCount](void *object) {
             auto &pob = *reinterpret_cast<Polyobj *>(object);
             if (pob.validCount != localValidCount) // not yet processed
             {
@@ -1394,7 +1445,7 @@ LoopResult Map::forAllLinesInBox(const AABoxd &box, int flags,
     if (!result && (flags & LIF_SECTOR))
     {
         const int localValidCount = World::validCount;
-        result = lineBlockmap().forAllInBox(box, [&func, &localValidCount](void *object) {
+        result = lineBlockmap().forEachInBox(box, [&func, &localValidCount](void *object) {
             auto &line = *reinterpret_cast<Line *>(object);
             if (line.validCount() != localValidCount) // not yet processed
             {
@@ -2604,6 +2655,7 @@ void Map::consoleRegister() // static
     Sector::consoleRegister();
 
     C_VAR_INT("bsp-factor", &bspSplitFactor, CVF_NO_MAX, 0, 0);
+    C_VAR_INT("bsp-cache",  &bspCache,       0,          0, 1);
 
     C_CMD("inspectmap", "", InspectMap);
 }
@@ -108,8 +108,8 @@ void Mobj_SetState(mobj_t *mob, int statenum)
 
     if (!(mob->ddFlags & DDMF_REMOTE))
     {
-        const String exec = DED_Definitions()->states[statenum].gets("execute");
-        if (!exec.isEmpty())
+        const char *exec = DED_Definitions()->getStateExecute(statenum);
+        if (exec[0])
         {
             Con_Execute(CMDS_SCRIPT, exec, true, false);
         }
@@ -58,7 +58,7 @@ bool Polyobj::blocked() const
         const dint localValidCount = ++world::World::validCount;
 
         bool collision = false;
-        map().mobjBlockmap().forAllInBox(AABoxd(line->bounds().minX - DDMOBJ_RADIUS_MAX,
+        map().mobjBlockmap().forEachInBox(AABoxd(line->bounds().minX - DDMOBJ_RADIUS_MAX,
                                                 line->bounds().minY - DDMOBJ_RADIUS_MAX,
                                                 line->bounds().maxX + DDMOBJ_RADIUS_MAX,
                                                 line->bounds().maxY + DDMOBJ_RADIUS_MAX)
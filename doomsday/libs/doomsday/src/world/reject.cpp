@@ -23,92 +23,386 @@
  * 02110-1301 USA</small>
  */
 
-#if 0 // Needs updating.
-#include <cmath>
+#include "doomsday/world/reject.h"
+#include "doomsday/world/map.h"
+#include "doomsday/world/line.h"
+#include "doomsday/world/sector.h"
+
+#include <de/taskpool.h>
+#include <de/vector.h>
 
-#include "de_base.h"
-#include "world/map.h"
+#include <cmath>
+#include <queue>
 
 using namespace de;
 
-void BuildRejectForMap(const Map &map)
+namespace world {
+
+/// Maximum number of portals crossed when searching the sectors visible from
+/// one sector.
+static const dsize REJECT_SEARCH_BUDGET = 200000;
+
+/// Tolerance of the sight line directions, in radians.
+static const double REJECT_ARC_EPSILON = 1.0e-6;
+
+/**
+ * Two-sided line as seen from one of its sectors. The sector is on the left
+ * side of the portal when looking from @a from to @a to.
+ */
+struct RejectPortal
 {
-    int *secGroups = M_Malloc(sizeof(int) * map.sectorCount());
-    int group = 0;
+    Vec2d from;
+    Vec2d to;
+    int id;     ///< Index of the portal (each line has two).
+    int line;   ///< Index of the line.
+    int sector; ///< Sector on the other side.
+};
+
+/**
+ * Arc of possible normals of the sight lines crossing a chain of portals.
+ */
+struct RejectSightArc
+{
+    double center = 0;
+    double halfWidth = PI; ///< PI when nothing restricts the sight lines.
+
+    /**
+     * Narrows the arc to the normals that have a nonnegative dot product
+     * with @a vec. If the result would be two separate arcs, the arc covering
+     * both of them is used.
+     *
+     * @return @c false, if the arc becomes empty.
+     */
+    bool narrow(const Vec2d &vec)
+    {
+        if (std::abs(vec.x) + std::abs(vec.y) < 1.0e-9) return true;
+
+        // Intersect with the half circle around @a vec, relative to the current
+        // center. Each copy of the half circle around the full circle is checked.
+        const double delta = std::remainder(std::atan2(vec.y, vec.x) - center, 2 * PI);
+        double low  =  PI;
+        double high = -PI;
+        for (int turn = -1; turn <= 1; ++turn)
+        {
+            const double mid = delta + turn * 2 * PI;
+            const double l = de::max(-halfWidth, mid - PI / 2);
+            const double h = de::min( halfWidth, mid + PI / 2);
+            if (l <= h + REJECT_ARC_EPSILON)
+            {
+                low  = de::min(low,  de::min(l, h));
+                high = de::max(high, de::max(l, h));
+            }
+        }
+        if (low > high) return false;
+
+        center   += (low + high) / 2;
+        halfWidth = (high - low) / 2;
+        return true;
+    }
 
-    for(uint i = 0; i < map.sectorCount(); ++i)
+    bool contains(const RejectSightArc &other) const
     {
-        Sector &sector = map.sectors[i];
-        secGroups[i] = group++;
-        sector.rejNext = sector.rejPrev = &sector;
+        if (halfWidth >= PI) return true;
+        const double delta = std::remainder(other.center - center, 2 * PI);
+        return std::abs(delta) + other.halfWidth <= halfWidth + REJECT_ARC_EPSILON;
+    }
+
+    /**
+     * Extends the arc to also cover @a other.
+     */
+    void extend(const RejectSightArc &other)
+    {
+        if (halfWidth >= PI) return;
+        const double delta = std::remainder(other.center - center, 2 * PI);
+        const double low   = de::min(-halfWidth, delta - other.halfWidth);
+        const double high  = de::max( halfWidth, delta + other.halfWidth);
+        if (high - low >= 2 * PI)
+        {
+            halfWidth = PI;
+            return;
+        }
+        center   += (low + high) / 2;
+        halfWidth = (high - low) / 2;
     }
+};
 
-    for(uint i = 0; i < map.lineCount(); ++i)
+/**
+ * Search of the sectors visible from one sector, through each of its portals
+ * in turn.
+ *
+ * To keep the search from exploding in open areas that consist of many small
+ * sectors, only the first portal, the previous portal, and the directions of the
+ * sight lines are remembered of a chain of portals. A portal is explored again
+ * only if the directions are not covered by the earlier visits of the portal,
+ * and the widest directions are explored first. This only makes the results more
+ * conservative.
+ */
+struct RejectPortalFlow
+{
+    struct Step
     {
-        Line *line = &map.lines[i];
+        const RejectPortal *portal;
+        RejectSightArc arc;
+        duint32 version;
 
-        if(!line->front().hasSector() || !line->back().hasSector())
-            continue;
+        bool operator < (const Step &other) const
+        {
+            return arc.halfWidth < other.arc.halfWidth;
+        }
+    };
 
-        Sector *sec1 = line->front().sectorPtr();
-        Sector *sec2 = line->back().sectorPtr();
+    struct Explored
+    {
+        RejectSightArc arc;
+        duint32 stamp   = 0; ///< Valid if equal to the current stamp.
+        duint32 version = 0; ///< Incremented when the arc is extended.
+    };
 
-        if(!sec1 || !sec2 || sec1 == sec2)
-            continue;
+    const List<List<RejectPortal>> &portals;
+    duint32 *row = nullptr;
+    List<Explored> explored; ///< Directions explored via each portal.
+    std::priority_queue<Step> steps;
+    duint32 stamp = 0;
+    dsize budget = 0;
+    int unseen = 0; ///< Sectors of the group not yet found visible.
 
-        // Already in the same group?
-        if(secGroups[sec1->index] == secGroups[sec2->index])
-            continue;
+    RejectPortalFlow(const List<List<RejectPortal>> &portals, int portalCount)
+        : portals(portals)
+        , explored(portalCount)
+    {}
+
+    void markVisible(int sector)
+    {
+        duint32 &word = row[sector >> 5];
+        const duint32 bit = 1u << (sector & 31);
+        if (!(word & bit))
+        {
+            word |= bit;
+            unseen--;
+        }
+    }
 
-        // Swap sectors so that the smallest group is added to the biggest
-        // group. This is based on the assumption that sector numbers in
-        // wads will generally increase over the set of lines, and so
-        // (by swapping) we'll tend to add small groups into larger
-        // groups, thereby minimising the updates to 'rej_group' fields
-        // that is required when merging.
-        Sector *p = 0;
-        if(secGroups[sec1->index] > secGroups[sec2->index])
+    void addStep(const RejectPortal &portal, const RejectSightArc &arc)
+    {
+        Explored &ex = explored[portal.id];
+        if (ex.stamp == stamp)
+        {
+            if (ex.arc.contains(arc)) return;
+            ex.arc.extend(arc);
+            ex.version++;
+        }
+        else
         {
-            p = sec1;
-            sec1 = sec2;
-            sec2 = p;
+            ex.stamp = stamp;
+            ex.arc   = arc;
         }
+        steps.push(Step{&portal, ex.arc, ex.version});
+    }
 
-        // Update the group numbers in the second group
-        secGroups[sec2->index] = secGroups[sec1->index];
-        for(p = sec2->rejNext; p != sec2; p = p->rejNext)
+    /**
+     * Searches the sectors visible through the portal @a first.
+     *
+     * @return @c false, if the search was stopped.
+     */
+    bool flow(const RejectPortal &first)
+    {
+        ++stamp;
+        steps = std::priority_queue<Step>();
         {
-            secGroups[p->index] = secGroups[sec1->index];
+            RejectSightArc arc;
+            arc.narrow(first.to - first.from);
+            addStep(first, arc);
         }
+        while (!steps.empty())
+        {
+            const Step step = steps.top();
+            steps.pop();
+            if (step.version != explored[step.portal->id].version)
+            {
+                continue; // Superseded by a wider arc.
+            }
 
-        // Merge 'em baby...
-        sec1->rejNext->rejPrev = sec2;
-        sec2->rejNext->rejPrev = sec1;
+            const RejectPortal &current = *step.portal;
+            for (const RejectPortal &next : portals[current.sector])
+            {
+                // A straight line does not cross the same line twice.
+                if (next.line == current.line || next.line == first.line) continue;
+                if (!budget--) return false;
 
-        p = sec1->rejNext;
-        sec1->rejNext = sec2->rejNext;
-        sec2->rejNext = p;
+                RejectSightArc arc = step.arc;
+                if (!arc.narrow(next.to - next.from)    ||
+                    !arc.narrow(next.to - current.from) ||
+                    !arc.narrow(current.to - next.from) ||
+                    !arc.narrow(next.to - first.from)   ||
+                    !arc.narrow(first.to - next.from))
+                {
+                    continue;
+                }
+
+                markVisible(next.sector);
+                if (!unseen) return false; // Nothing more to find.
+
+                addStep(next, arc);
+            }
+        }
+        return true;
     }
 
-    size_t rejectSize = (map.sectorCount() * map.sectorCount() + 7) / 8;
-    byte *matrix = Z_Calloc(rejectSize, PU_MAPSTATIC, 0);
+    /**
+     * Finds the sectors visible from @a sector.
+     *
+     * @param sector      Sector to search from.
+     * @param groupSize   Number of sectors in the group of @a sector.
+     * @param visibleRow  Bits of the visible sectors are set here.
+     *
+     * @return @c false, if the search ran out of budget.
+     */
+    bool search(int sector, int groupSize, duint32 *visibleRow)
+    {
+        row    = visibleRow;
+        budget = REJECT_SEARCH_BUDGET;
+        unseen = groupSize;
+        markVisible(sector);
+        for (const RejectPortal &portal : portals[sector])
+        {
+            if (!unseen) break;
+            markVisible(portal.sector);
+            if (!flow(portal)) break;
+        }
+        return !unseen || budget != dsize(-1);
+    }
+};
+
+SectorVisibility::Geometry::Geometry(const Map &map)
+    : sectorCount(map.sectorCount())
+    , lineCount(map.lineCount())
+{
+    map.forAllLines([this] (Line &line)
+    {
+        const Sector *front = line.front().sectorPtr();
+        const Sector *back  = line.back().sectorPtr();
+        if (front && back && front != back)
+        {
+            portals.push_back(Portal{line.from().origin(), line.to().origin(),
+                                     line.indexInMap(), front->indexInMap(),
+                                     back->indexInMap()});
+        }
+        return LoopContinue;
+    });
+}
+
+SectorVisibility::SectorVisibility(const Map &map)
+    : SectorVisibility(Geometry(map))
+{}
+
+SectorVisibility::SectorVisibility(const Geometry &geometry)
+{
+    const int sectorCount = geometry.sectorCount;
 
-    for(int view = 0; view < map.sectorCount(); ++view)
-    for(int target = 0; target < view; ++target)
+    // Initially all sectors are in individual groups. Each group is represented
+    // by one of its sectors.
+    List<int> parent(sectorCount);
+    for (int i = 0; i < sectorCount; ++i)
     {
-        if(secGroups[view] == secGroups[target])
-            continue;
+        parent[i] = i;
+    }
+
+    auto findRoot = [&parent] (int i)
+    {
+        while (parent[i] != i)
+        {
+            // Halve the path while we're here.
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
 
-        // For symmetry, do two bits at a time.
-        int p1 = view * map.sectorCount() + target;
-        int p2 = target * map.sectorCount() + view;
+    // Merge the groups on both sides of each portal.
+    List<List<RejectPortal>> portals(sectorCount);
+    for (const Portal &portal : geometry.portals)
+    {
+        // The front sector is on the right side of the line.
+        const int id = portal.line * 2;
+        portals[portal.front].push_back(RejectPortal{portal.to, portal.from, id,     portal.line, portal.back});
+        portals[portal.back] .push_back(RejectPortal{portal.from, portal.to, id + 1, portal.line, portal.front});
 
-        matrix[p1 >> 3] |= (1 << (p1 & 7));
-        matrix[p2 >> 3] |= (1 << (p2 & 7));
+        const int a = findRoot(portal.front);
+        const int b = findRoot(portal.back);
+        if (a != b)
+        {
+            // The smaller number represents the merged group.
+            parent[de::max(a, b)] = de::min(a, b);
+        }
+    }
+
+    // Number the groups consecutively, in order of the lowest sector index.
+    _groups.resize(sectorCount);
+    for (int i = 0; i < sectorCount; ++i)
+    {
+        const int root = findRoot(i);
+        _groups[i] = (root == i? _groupCount++ : _groups[root]);
     }
 
-    M_Free(secGroups);
+    // Search the visible sectors from each sector.
+    const dsize count = dsize(sectorCount);
+    _rowWords = (count + 31) / 32;
+    _visible  = List<duint32>(count * _rowWords, 0);
 
-    return matrix;
+    List<int> groupSizes(_groupCount, 0);
+    for (int g : _groups) groupSizes[g]++;
+
+    List<char> approximated(count, 0);
+    TaskPool::parallelFor(0, count, [&] (dsize begin, dsize end)
+    {
+        RejectPortalFlow search(portals, geometry.lineCount * 2);
+        for (dsize i = begin; i < end; ++i)
+        {
+            if (!search.search(int(i), groupSizes[_groups[i]], &_visible[i * _rowWords]))
+            {
+                approximated[i] = true;
+            }
+        }
+    });
+
+    auto setVisible = [this] (dsize a, dsize b)
+    {
+        _visible[a * _rowWords + (b >> 5)] |= 1u << (b & 31);
+    };
+    for (dsize a = 0; a < count; ++a)
+    {
+        if (!approximated[a]) continue;
+        _approximatedCount++;
+        for (dsize b = 0; b < count; ++b)
+        {
+            if (_groups[a] == _groups[b]) setVisible(a, b);
+        }
+    }
+
+    // Sight lines work both ways.
+    for (dsize a = 0; a < count; ++a)
+    {
+        for (dsize b = a + 1; b < count; ++b)
+        {
+            if (isVisible(int(a), int(b)) || isVisible(int(b), int(a)))
+            {
+                setVisible(a, b);
+                setVisible(b, a);
+            }
+        }
+    }
+}
+
+double SectorVisibility::visibleFraction() const
+{
+    const dsize count = dsize(sectorCount());
+    if (!count) return 0;
+    dsize visible = 0;
+    for (duint32 word : _visible)
+    {
+        for (; word; word &= word - 1) visible++;
+    }
+    return double(visible) / double(count * count);
 }
-#endif
+
+} // namespace world
@@ -34,6 +34,7 @@
 #include "doomsday/defs/mapinfo.h"
 #include "doomsday/res/mapmanifests.h"
 #include "doomsday/res/resources.h"
+#include "doomsday/filesys/lumpcache.h"
 #include "doomsday/filesys/lumpindex.h"
 #include "doomsday/doomsdayapp.h"
 #include "doomsday/busymode.h"
@@ -232,6 +233,10 @@ DE_PIMPL(World)
 
         LOG_MSG("Loading map \"%s\"...") << mapManifest->composeUri().path();
 
+        // Lumps cached during the map load should be unlocked once they have been
+        // read, so that they are subject to the lump cache budget.
+        const dsize lockedBytesBefore = LumpCache::statistics().lockedBytes;
+
         // A new map is about to be set up.
         World::ddMapSetup = true;
 
@@ -262,6 +267,14 @@ DE_PIMPL(World)
         // Output a human-readable report of any issues encountered during conversion.
         reporter.writeLog();
 
+        const dsize lockedBytes = LumpCache::statistics().lockedBytes;
+        if (lockedBytes > lockedBytesBefore)
+        {
+            LOGDEV_RES_WARNING("%i KB of cached lump data was left locked by the map load "
+                               "(see \"lumpcachestats\")")
+                << int((lockedBytes - lockedBytesBefore) >> 10);
+        }
+
         return bool(map);
     }
 
@@ -23,6 +23,7 @@
 #define LIBCOMMON_ACS_INTERPRETER_H
 
 #if __cplusplus
+#  include <de/list.h>
 #  include "acs/script.h"
 #  include "mapstatereader.h"
 #  include "mapstatewriter.h"
@@ -60,7 +61,7 @@ struct Interpreter
         void drop();
     } locals;
     int args[ACS_INTERPRETER_MAX_SCRIPT_ARGS];
-    const int *pcodePtr;
+    const Module::Word *pcodePtr;
 
     System &scriptSys() const;
 
@@ -71,6 +72,14 @@ struct Interpreter
 
     void think();
 
+    /**
+     * Executes instructions starting from the current position until the script
+     * stops (e.g., suspends or waits) or terminates.
+     *
+     * @return  @c true, if the script terminated.
+     */
+    bool execute();
+
     /**
      * Deserialize the thinker using the given data reader @msr.
      */
@@ -94,6 +103,21 @@ struct Interpreter
         struct mobj_s *activator = nullptr, Line *line = nullptr, int side = 0,
         int delayCount = 0);
 
+    /**
+     * Resolves the instruction handlers of a pre-decoded @a program. The code is
+     * followed from the @a entryPoints through all branches, so operands are never
+     * mistaken for instructions. Common pairs of push and operation instructions
+     * are combined into single handlers.
+     *
+     * Jump targets are converted to distances relative to the jump operand.
+     *
+     * @param program      Pre-decoded program of a Module.
+     * @param entryPoints  Program positions where the scripts begin.
+     */
+    static void resolveCommands(de::List<Module::Word> &program, const de::List<int> &entryPoints);
+
+    static void consoleRegister();
+
     static int currentScriptNumber;
 };
 
@@ -30,8 +30,15 @@
 
 namespace acs {
 
+struct Interpreter;
+
 /**
  * Models a loadable code module for the ACS scripting system.
+ *
+ * The bytecode is pre-decoded for the Interpreter when the module is loaded. The
+ * decoded program has one Word for each 32-bit word of the bytecode, so positions
+ * in the program correspond directly to byte offsets in the original bytecode
+ * (which are used, e.g., in saved games).
  */
 class Module
 {
@@ -48,12 +55,34 @@ public:
     /// Required/referenced (script) entry point data is missing. @ingroup errors
     DE_ERROR(MissingEntryPointError);
 
+    /**
+     * Executes one instruction of the program. The interpreter's program counter
+     * points to the first operand of the instruction.
+     *
+     * @return  Interpreter command result (continue, stop, or terminate).
+     */
+    typedef int (*Command)(Interpreter &);
+
+    /**
+     * Pre-decoded word of the program.
+     */
+    struct Word
+    {
+        /// Handler of the instruction starting at this word. Words that are not
+        /// the start of a valid instruction have a handler that raises an error.
+        Command command = nullptr;
+
+        /// Value of the word in native byte order. For jump targets, this is the
+        /// distance from the word to the target word.
+        de::dint32 value = 0;
+    };
+
     /**
      * Stores information about an ACS script entry point.
      */
     struct EntryPoint
     {
-        const int *pcodePtr       = nullptr;
+        const Word *pcodePtr      = nullptr;
         bool startWhenMapBegins   = false;
         de::dint32 scriptNumber   = 0;
         de::dint32 scriptArgCount = 0;
@@ -107,6 +136,17 @@ public:
      */
     const de::Block &pcode() const;
 
+    /**
+     * Returns the word of the pre-decoded program at byte offset @a pcodeOffset of the
+     * original bytecode.
+     */
+    const Word *wordAt(int pcodeOffset) const;
+
+    /**
+     * Returns the byte offset of program @a word in the original bytecode.
+     */
+    int pcodeOffset(const Word *word) const;
+
 private:
     Module();
 
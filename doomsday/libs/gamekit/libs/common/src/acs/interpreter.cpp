@@ -46,10 +46,10 @@ namespace internal
         Terminate
     };
 
-    typedef CommandResult (*CommandFunc) (acs::Interpreter &);
+    typedef acs::Module::Command CommandFunc;
 
 /// Helper macro for declaring ACScript command functions.
-#define ACS_COMMAND(Name) CommandResult cmd##Name(acs::Interpreter &interp)
+#define ACS_COMMAND(Name) int cmd##Name(acs::Interpreter &interp)
 
     static String printBuffer;
 
@@ -76,13 +76,13 @@ namespace internal
 
     ACS_COMMAND(PushNumber)
     {
-        interp.locals.push(DD_LONG(*interp.pcodePtr++));
+        interp.locals.push(interp.pcodePtr++->value);
         return Continue;
     }
 
     ACS_COMMAND(LSpec1)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
         specArgs[0] = interp.locals.pop();
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side, interp.activator);
 
@@ -91,7 +91,7 @@ namespace internal
 
     ACS_COMMAND(LSpec2)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
         specArgs[1] = interp.locals.pop();
         specArgs[0] = interp.locals.pop();
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side, interp.activator);
@@ -101,7 +101,7 @@ namespace internal
 
     ACS_COMMAND(LSpec3)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
         specArgs[2] = interp.locals.pop();
         specArgs[1] = interp.locals.pop();
         specArgs[0] = interp.locals.pop();
@@ -112,7 +112,7 @@ namespace internal
 
     ACS_COMMAND(LSpec4)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
         specArgs[3] = interp.locals.pop();
         specArgs[2] = interp.locals.pop();
         specArgs[1] = interp.locals.pop();
@@ -124,7 +124,7 @@ namespace internal
 
     ACS_COMMAND(LSpec5)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
         specArgs[4] = interp.locals.pop();
         specArgs[3] = interp.locals.pop();
         specArgs[2] = interp.locals.pop();
@@ -138,8 +138,8 @@ namespace internal
 
     ACS_COMMAND(LSpec1Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
+        specArgs[0] = interp.pcodePtr++->value;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -148,9 +148,9 @@ namespace internal
 
     ACS_COMMAND(LSpec2Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
+        specArgs[0] = interp.pcodePtr++->value;
+        specArgs[1] = interp.pcodePtr++->value;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -159,10 +159,10 @@ namespace internal
 
     ACS_COMMAND(LSpec3Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
-        specArgs[2] = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
+        specArgs[0] = interp.pcodePtr++->value;
+        specArgs[1] = interp.pcodePtr++->value;
+        specArgs[2] = interp.pcodePtr++->value;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -171,11 +171,11 @@ namespace internal
 
     ACS_COMMAND(LSpec4Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
-        specArgs[2] = DD_LONG(*interp.pcodePtr++);
-        specArgs[3] = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
+        specArgs[0] = interp.pcodePtr++->value;
+        specArgs[1] = interp.pcodePtr++->value;
+        specArgs[2] = interp.pcodePtr++->value;
+        specArgs[3] = interp.pcodePtr++->value;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -184,12 +184,12 @@ namespace internal
 
     ACS_COMMAND(LSpec5Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
-        specArgs[2] = DD_LONG(*interp.pcodePtr++);
-        specArgs[3] = DD_LONG(*interp.pcodePtr++);
-        specArgs[4] = DD_LONG(*interp.pcodePtr++);
+        int special = interp.pcodePtr++->value;
+        specArgs[0] = interp.pcodePtr++->value;
+        specArgs[1] = interp.pcodePtr++->value;
+        specArgs[2] = interp.pcodePtr++->value;
+        specArgs[3] = interp.pcodePtr++->value;
+        specArgs[4] = interp.pcodePtr++->value;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -271,169 +271,169 @@ namespace internal
 
     ACS_COMMAND(AssignScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] = interp.locals.pop();
+        interp.args[interp.pcodePtr++->value] = interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AssignMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] = interp.locals.pop();
+        interp.scriptSys().mapVars[interp.pcodePtr++->value] = interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AssignWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] = interp.locals.pop();
+        interp.scriptSys().worldVars[interp.pcodePtr++->value] = interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(PushScriptVar)
     {
-        interp.locals.push(interp.args[DD_LONG(*interp.pcodePtr++)]);
+        interp.locals.push(interp.args[interp.pcodePtr++->value]);
         return Continue;
     }
 
     ACS_COMMAND(PushMapVar)
     {
-        interp.locals.push(interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)]);
+        interp.locals.push(interp.scriptSys().mapVars[interp.pcodePtr++->value]);
         return Continue;
     }
 
     ACS_COMMAND(PushWorldVar)
     {
-        interp.locals.push(interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)]);
+        interp.locals.push(interp.scriptSys().worldVars[interp.pcodePtr++->value]);
         return Continue;
     }
 
     ACS_COMMAND(AddScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] += interp.locals.pop();
+        interp.args[interp.pcodePtr++->value] += interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AddMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] += interp.locals.pop();
+        interp.scriptSys().mapVars[interp.pcodePtr++->value] += interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AddWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] += interp.locals.pop();
+        interp.scriptSys().worldVars[interp.pcodePtr++->value] += interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(SubScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] -= interp.locals.pop();
+        interp.args[interp.pcodePtr++->value] -= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(SubMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] -= interp.locals.pop();
+        interp.scriptSys().mapVars[interp.pcodePtr++->value] -= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(SubWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] -= interp.locals.pop();
+        interp.scriptSys().worldVars[interp.pcodePtr++->value] -= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(MulScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] *= interp.locals.pop();
+        interp.args[interp.pcodePtr++->value] *= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(MulMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] *= interp.locals.pop();
+        interp.scriptSys().mapVars[interp.pcodePtr++->value] *= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(MulWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] *= interp.locals.pop();
+        interp.scriptSys().worldVars[interp.pcodePtr++->value] *= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(DivScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] /= interp.locals.pop();
+        interp.args[interp.pcodePtr++->value] /= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(DivMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] /= interp.locals.pop();
+        interp.scriptSys().mapVars[interp.pcodePtr++->value] /= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(DivWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] /= interp.locals.pop();
+        interp.scriptSys().worldVars[interp.pcodePtr++->value] /= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(ModScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] %= interp.locals.pop();
+        interp.args[interp.pcodePtr++->value] %= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(ModMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] %= interp.locals.pop();
+        interp.scriptSys().mapVars[interp.pcodePtr++->value] %= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(ModWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] %= interp.locals.pop();
+        interp.scriptSys().worldVars[interp.pcodePtr++->value] %= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(IncScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)]++;
+        interp.args[interp.pcodePtr++->value]++;
         return Continue;
     }
 
     ACS_COMMAND(IncMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)]++;
+        interp.scriptSys().mapVars[interp.pcodePtr++->value]++;
         return Continue;
     }
 
     ACS_COMMAND(IncWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)]++;
+        interp.scriptSys().worldVars[interp.pcodePtr++->value]++;
         return Continue;
     }
 
     ACS_COMMAND(DecScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)]--;
+        interp.args[interp.pcodePtr++->value]--;
         return Continue;
     }
 
     ACS_COMMAND(DecMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)]--;
+        interp.scriptSys().mapVars[interp.pcodePtr++->value]--;
         return Continue;
     }
 
     ACS_COMMAND(DecWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)]--;
+        interp.scriptSys().worldVars[interp.pcodePtr++->value]--;
         return Continue;
     }
 
     ACS_COMMAND(Goto)
     {
-        interp.pcodePtr = (const int *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+        interp.pcodePtr += interp.pcodePtr->value;
         return Continue;
     }
 
@@ -441,7 +441,7 @@ namespace internal
     {
         if(interp.locals.pop())
         {
-            interp.pcodePtr = (const int *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+            interp.pcodePtr += interp.pcodePtr->value;
         }
         else
         {
@@ -464,7 +464,7 @@ namespace internal
 
     ACS_COMMAND(DelayDirect)
     {
-        interp.delayCount = DD_LONG(*interp.pcodePtr++);
+        interp.delayCount = interp.pcodePtr++->value;
         return Stop;
     }
 
@@ -478,8 +478,8 @@ namespace internal
 
     ACS_COMMAND(RandomDirect)
     {
-        int low  = DD_LONG(*interp.pcodePtr++);
-        int high = DD_LONG(*interp.pcodePtr++);
+        int low  = interp.pcodePtr++->value;
+        int high = interp.pcodePtr++->value;
         interp.locals.push(low + (P_Random() % (high - low + 1)));
         return Continue;
     }
@@ -498,8 +498,8 @@ namespace internal
 
     ACS_COMMAND(ThingCountDirect)
     {
-        int type = DD_LONG(*interp.pcodePtr++);
-        int tid  = DD_LONG(*interp.pcodePtr++);
+        int type = interp.pcodePtr++->value;
+        int tid  = interp.pcodePtr++->value;
         // Anything to count?
         if(type + tid)
         {
@@ -516,7 +516,7 @@ namespace internal
 
     ACS_COMMAND(TagWaitDirect)
     {
-        interp.script().waitForSector(DD_LONG(*interp.pcodePtr++));
+        interp.script().waitForSector(interp.pcodePtr++->value);
         return Stop;
     }
 
@@ -528,7 +528,7 @@ namespace internal
 
     ACS_COMMAND(PolyWaitDirect)
     {
-        interp.script().waitForPolyobj(DD_LONG(*interp.pcodePtr++));
+        interp.script().waitForPolyobj(interp.pcodePtr++->value);
         return Stop;
     }
 
@@ -559,9 +559,9 @@ namespace internal
 
     ACS_COMMAND(ChangeFloorDirect)
     {
-        int tag = DD_LONG(*interp.pcodePtr++);
+        int tag = interp.pcodePtr++->value;
 
-        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(DD_LONG(*interp.pcodePtr++))));
+        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(interp.pcodePtr++->value)));
         uri_s *uri = Uri_NewWithPath3("Flats", Str_Text(path));
 
         world_Material *mat = (world_Material *) P_ToPtr(DMU_MATERIAL, Materials_ResolveUri(uri));
@@ -609,9 +609,9 @@ namespace internal
 
     ACS_COMMAND(ChangeCeilingDirect)
     {
-        int tag = DD_LONG(*interp.pcodePtr++);
+        int tag = interp.pcodePtr++->value;
 
-        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(DD_LONG(*interp.pcodePtr++))));
+        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(interp.pcodePtr++->value)));
         uri_s *uri = Uri_NewWithPath3("Flats", Str_Text(path));
 
         world_Material *mat = (world_Material *) P_ToPtr(DMU_MATERIAL, Materials_ResolveUri(uri));
@@ -702,7 +702,7 @@ namespace internal
         }
         else
         {
-            interp.pcodePtr = (const int *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+            interp.pcodePtr += interp.pcodePtr->value;
         }
         return Continue;
     }
@@ -721,7 +721,7 @@ namespace internal
 
     ACS_COMMAND(ScriptWaitDirect)
     {
-        interp.script().waitForScript(DD_LONG(*interp.pcodePtr++));
+        interp.script().waitForScript(interp.pcodePtr++->value);
         return Stop;
     }
 
@@ -736,9 +736,9 @@ namespace internal
 
     ACS_COMMAND(CaseGoto)
     {
-        if(interp.locals.top() == DD_LONG(*interp.pcodePtr++))
+        if(interp.locals.top() == interp.pcodePtr++->value)
         {
-            interp.pcodePtr = (const int *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+            interp.pcodePtr += interp.pcodePtr->value;
             interp.locals.drop();
         }
         else
@@ -1026,40 +1026,191 @@ namespace internal
         return Continue;
     }
 
-    static const CommandFunc &findCommand(int name)
+    ACS_COMMAND(Invalid)
     {
-        static CommandFunc const cmds[] =
+        /// @throw Error  The program counter is not at the start of a valid instruction.
+        throw Error("acs::Interpreter", "Invalid instruction at pcode offset " +
+                    String::asText(interp.scriptSys().module().pcodeOffset(interp.pcodePtr - 1)));
+    }
+
+    struct CommandInfo
+    {
+        CommandFunc func;
+        int operandCount;
+    };
+
+    static const CommandInfo commands[] =
+    {
+        { cmdNOP,                 0 },
+        { cmdTerminate,           0 },
+        { cmdSuspend,             0 },
+        { cmdPushNumber,          1 },
+        { cmdLSpec1,              1 },
+        { cmdLSpec2,              1 },
+        { cmdLSpec3,              1 },
+        { cmdLSpec4,              1 },
+        { cmdLSpec5,              1 },
+        { cmdLSpec1Direct,        2 },
+        { cmdLSpec2Direct,        3 },
+        { cmdLSpec3Direct,        4 },
+        { cmdLSpec4Direct,        5 },
+        { cmdLSpec5Direct,        6 },
+        { cmdAdd,                 0 },
+        { cmdSubtract,            0 },
+        { cmdMultiply,            0 },
+        { cmdDivide,              0 },
+        { cmdModulus,             0 },
+        { cmdEQ,                  0 },
+        { cmdNE,                  0 },
+        { cmdLT,                  0 },
+        { cmdGT,                  0 },
+        { cmdLE,                  0 },
+        { cmdGE,                  0 },
+        { cmdAssignScriptVar,     1 },
+        { cmdAssignMapVar,        1 },
+        { cmdAssignWorldVar,      1 },
+        { cmdPushScriptVar,       1 },
+        { cmdPushMapVar,          1 },
+        { cmdPushWorldVar,        1 },
+        { cmdAddScriptVar,        1 },
+        { cmdAddMapVar,           1 },
+        { cmdAddWorldVar,         1 },
+        { cmdSubScriptVar,        1 },
+        { cmdSubMapVar,           1 },
+        { cmdSubWorldVar,         1 },
+        { cmdMulScriptVar,        1 },
+        { cmdMulMapVar,           1 },
+        { cmdMulWorldVar,         1 },
+        { cmdDivScriptVar,        1 },
+        { cmdDivMapVar,           1 },
+        { cmdDivWorldVar,         1 },
+        { cmdModScriptVar,        1 },
+        { cmdModMapVar,           1 },
+        { cmdModWorldVar,         1 },
+        { cmdIncScriptVar,        1 },
+        { cmdIncMapVar,           1 },
+        { cmdIncWorldVar,         1 },
+        { cmdDecScriptVar,        1 },
+        { cmdDecMapVar,           1 },
+        { cmdDecWorldVar,         1 },
+        { cmdGoto,                1 },
+        { cmdIfGoto,              1 },
+        { cmdDrop,                0 },
+        { cmdDelay,               0 },
+        { cmdDelayDirect,         1 },
+        { cmdRandom,              0 },
+        { cmdRandomDirect,        2 },
+        { cmdThingCount,          0 },
+        { cmdThingCountDirect,    2 },
+        { cmdTagWait,             0 },
+        { cmdTagWaitDirect,       1 },
+        { cmdPolyWait,            0 },
+        { cmdPolyWaitDirect,      1 },
+        { cmdChangeFloor,         0 },
+        { cmdChangeFloorDirect,   2 },
+        { cmdChangeCeiling,       0 },
+        { cmdChangeCeilingDirect, 2 },
+        { cmdRestart,             0 },
+        { cmdAndLogical,          0 },
+        { cmdOrLogical,           0 },
+        { cmdAndBitwise,          0 },
+        { cmdOrBitwise,           0 },
+        { cmdEorBitwise,          0 },
+        { cmdNegateLogical,       0 },
+        { cmdLShift,              0 },
+        { cmdRShift,              0 },
+        { cmdUnaryMinus,          0 },
+        { cmdIfNotGoto,           1 },
+        { cmdLineSide,            0 },
+        { cmdScriptWait,          0 },
+        { cmdScriptWaitDirect,    1 },
+        { cmdClearLineSpecial,    0 },
+        { cmdCaseGoto,            2 },
+        { cmdBeginPrint,          0 },
+        { cmdEndPrint,            0 },
+        { cmdPrintString,         0 },
+        { cmdPrintNumber,         0 },
+        { cmdPrintCharacter,      0 },
+        { cmdPlayerCount,         0 },
+        { cmdGameType,            0 },
+        { cmdGameSkill,           0 },
+        { cmdTimer,               0 },
+        { cmdSectorSound,         0 },
+        { cmdAmbientSound,        0 },
+        { cmdSoundSequence,       0 },
+        { cmdSetLineTexture,      0 },
+        { cmdSetLineBlocking,     0 },
+        { cmdSetLineSpecial,      0 },
+        { cmdThingSound,          0 },
+        { cmdEndPrintBold,        0 }
+    };
+
+    static const int numCommands = sizeof(commands) / sizeof(commands[0]);
+
+    /**
+     * Pushes a value and then executes the following instruction, without returning
+     * to the dispatch loop in between. @a Push must always continue.
+     */
+    template <CommandFunc Push, CommandFunc Next>
+    ACS_COMMAND(Combined)
+    {
+        Push(interp);
+        interp.pcodePtr++; // Opcode of the next instruction.
+        return Next(interp);
+    }
+
+#define ACS_COMBINED(Push, Next) { cmd##Push, cmd##Next, cmdCombined<cmd##Push, cmd##Next> }
+
+    /// Superinstructions for the most common push/operation pairs.
+    static const struct { CommandFunc push; CommandFunc next; CommandFunc combined; } combinedCommands[] =
+    {
+        ACS_COMBINED(PushNumber, Add),
+        ACS_COMBINED(PushNumber, Subtract),
+        ACS_COMBINED(PushNumber, EQ),
+        ACS_COMBINED(PushNumber, NE),
+        ACS_COMBINED(PushNumber, LT),
+        ACS_COMBINED(PushNumber, GT),
+        ACS_COMBINED(PushNumber, LE),
+        ACS_COMBINED(PushNumber, GE),
+        ACS_COMBINED(PushNumber, AssignScriptVar),
+        ACS_COMBINED(PushNumber, AssignMapVar),
+        ACS_COMBINED(PushNumber, AssignWorldVar),
+        ACS_COMBINED(PushNumber, LSpec1),
+        ACS_COMBINED(PushNumber, LSpec2),
+        ACS_COMBINED(PushNumber, LSpec3),
+        ACS_COMBINED(PushNumber, LSpec4),
+        ACS_COMBINED(PushNumber, LSpec5),
+        ACS_COMBINED(PushScriptVar, PushNumber),
+        ACS_COMBINED(PushScriptVar, IfGoto),
+        ACS_COMBINED(PushScriptVar, IfNotGoto),
+        ACS_COMBINED(PushMapVar, PushNumber),
+        ACS_COMBINED(PushWorldVar, PushNumber),
+    };
+
+#undef ACS_COMBINED
+
+    static CommandFunc combinedCommand(CommandFunc push, CommandFunc next)
+    {
+        for(const auto &comb : combinedCommands)
         {
-            cmdNOP, cmdTerminate, cmdSuspend, cmdPushNumber, cmdLSpec1, cmdLSpec2,
-            cmdLSpec3, cmdLSpec4, cmdLSpec5, cmdLSpec1Direct, cmdLSpec2Direct,
-            cmdLSpec3Direct, cmdLSpec4Direct, cmdLSpec5Direct, cmdAdd,
-            cmdSubtract, cmdMultiply, cmdDivide, cmdModulus, cmdEQ, cmdNE,
-            cmdLT, cmdGT, cmdLE, cmdGE, cmdAssignScriptVar, cmdAssignMapVar,
-            cmdAssignWorldVar, cmdPushScriptVar, cmdPushMapVar,
-            cmdPushWorldVar, cmdAddScriptVar, cmdAddMapVar, cmdAddWorldVar,
-            cmdSubScriptVar, cmdSubMapVar, cmdSubWorldVar, cmdMulScriptVar,
-            cmdMulMapVar, cmdMulWorldVar, cmdDivScriptVar, cmdDivMapVar,
-            cmdDivWorldVar, cmdModScriptVar, cmdModMapVar, cmdModWorldVar,
-            cmdIncScriptVar, cmdIncMapVar, cmdIncWorldVar, cmdDecScriptVar,
-            cmdDecMapVar, cmdDecWorldVar, cmdGoto, cmdIfGoto, cmdDrop,
-            cmdDelay, cmdDelayDirect, cmdRandom, cmdRandomDirect,
-            cmdThingCount, cmdThingCountDirect, cmdTagWait, cmdTagWaitDirect,
-            cmdPolyWait, cmdPolyWaitDirect, cmdChangeFloor,
-            cmdChangeFloorDirect, cmdChangeCeiling, cmdChangeCeilingDirect,
-            cmdRestart, cmdAndLogical, cmdOrLogical, cmdAndBitwise,
-            cmdOrBitwise, cmdEorBitwise, cmdNegateLogical, cmdLShift,
-            cmdRShift, cmdUnaryMinus, cmdIfNotGoto, cmdLineSide, cmdScriptWait,
-            cmdScriptWaitDirect, cmdClearLineSpecial, cmdCaseGoto,
-            cmdBeginPrint, cmdEndPrint, cmdPrintString, cmdPrintNumber,
-            cmdPrintCharacter, cmdPlayerCount, cmdGameType, cmdGameSkill,
-            cmdTimer, cmdSectorSound, cmdAmbientSound, cmdSoundSequence,
-            cmdSetLineTexture, cmdSetLineBlocking, cmdSetLineSpecial,
-            cmdThingSound, cmdEndPrintBold
-        };
-        static const int numCmds = sizeof(cmds) / sizeof(cmds[0]);
-        if(name >= 0 && name < numCmds) return cmds[name];
-        /// @throw Error  Invalid command name specified.
-        throw Error("acs::Interpreter::findCommand", "Unknown command #" + String::asText(name));
+            if(comb.push == push && comb.next == next) return comb.combined;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Returns the index of the jump target operand of an instruction, or -1.
+     */
+    static int jumpOperand(CommandFunc func)
+    {
+        if(func == cmdGoto || func == cmdIfGoto || func == cmdIfNotGoto) return 0;
+        if(func == cmdCaseGoto) return 1;
+        return -1;
+    }
+
+    static bool continuesToNext(CommandFunc func)
+    {
+        return func != cmdTerminate && func != cmdGoto && func != cmdRestart;
     }
 
 #endif  // __JHEXEN__
@@ -1096,10 +1247,88 @@ thinker_t *Interpreter::newThinker(Script &script, const Script::Args &scriptArg
     return &th->thinker;
 }
 
+void Interpreter::resolveCommands(List<Module::Word> &program, const List<int> &entryPoints)
+{
+#ifdef __JHEXEN__
+    const int size = program.sizei();
+    for(auto &word : program)
+    {
+        word.command = cmdInvalid;
+    }
+
+    // Follow the code from the entry points and all jump targets.
+    List<int> pending = entryPoints;
+    List<int> starts;
+    while(!pending.isEmpty())
+    {
+        int pos = pending.takeLast();
+        while(pos >= 0 && pos < size && program[pos].command == cmdInvalid)
+        {
+            const int opcode = program[pos].value;
+            if(opcode < 0 || opcode >= numCommands) break;
+
+            const CommandInfo &info = commands[opcode];
+            if(pos + info.operandCount >= size) break;
+
+            const int jump = jumpOperand(info.func);
+            if(jump >= 0)
+            {
+                // Jump targets are byte offsets in the bytecode.
+                Module::Word &operand = program[pos + 1 + jump];
+                const dint32 offset = operand.value;
+                if(offset < 0 || offset % dint32(sizeof(dint32)) ||
+                   offset / dint32(sizeof(dint32)) >= size)
+                {
+                    break;
+                }
+                const int target = offset / dint32(sizeof(dint32));
+                operand.value = target - (pos + 1 + jump);
+                pending << target;
+            }
+
+            program[pos].command = info.func;
+            starts << pos;
+
+            if(!continuesToNext(info.func)) break;
+            pos += 1 + info.operandCount;
+        }
+    }
+
+    // Combine instruction pairs.
+    for(int pos : starts)
+    {
+        const int opcode = program[pos].value;
+        const int next   = pos + 1 + commands[opcode].operandCount;
+        if(next < size && program[next].command != cmdInvalid)
+        {
+            if(CommandFunc combined = combinedCommand(commands[opcode].func,
+                                                      commands[program[next].value].func))
+            {
+                program[pos].command = combined;
+            }
+        }
+    }
+#else
+    DE_UNUSED(program, entryPoints);
+#endif
+}
+
+bool Interpreter::execute()
+{
+#ifdef __JHEXEN__
+    int action;
+    while((action = pcodePtr++->command(*this)) == Continue)
+    {}
+    return action == Terminate;
+#else
+    return true;
+#endif
+}
+
 void Interpreter::think()
 {
 #ifdef __JHEXEN__
-    int action = (script().state() == Script::Terminating? Terminate : Continue);
+    bool terminated = (script().state() == Script::Terminating);
 
     if(script().isRunning())
     {
@@ -1110,14 +1339,11 @@ void Interpreter::think()
         }
 
         currentScriptNumber = script().entryPoint().scriptNumber;
-
-        while((action = findCommand(DD_LONG(*pcodePtr++))(*this)) == Continue)
-        {}
-
+        terminated = execute();
         currentScriptNumber = -1;
     }
 
-    if(action == Terminate)
+    if(terminated)
     {
         // This script has now finished - notify interested parties.
         /// @todo Use a de::Observers -based mechanism for this.
@@ -1203,7 +1429,7 @@ void Interpreter::write(MapStateWriter *msw) const
     {
         Writer_WriteInt32(writer, args[i]);
     }
-    Writer_WriteInt32(writer, ((const dbyte *)pcodePtr) - (const dbyte *)scriptSys().module().pcode().constData());
+    Writer_WriteInt32(writer, scriptSys().module().pcodeOffset(pcodePtr));
 }
 
 int Interpreter::read(MapStateReader *msr)
@@ -1258,7 +1484,7 @@ int Interpreter::read(MapStateReader *msr)
             args[i] = Reader_ReadInt32(reader);
         }
 
-        pcodePtr = (const int *) (scriptSys().module().pcode().constData() + Reader_ReadInt32(reader));
+        pcodePtr = scriptSys().module().wordAt(Reader_ReadInt32(reader));
     }
     else
     {
@@ -1298,7 +1524,7 @@ int Interpreter::read(MapStateReader *msr)
             args[i] = Reader_ReadInt32(reader);
         }
 
-        pcodePtr = (const int *) (scriptSys().module().pcode().constData() + Reader_ReadInt32(reader));
+        pcodePtr = scriptSys().module().wordAt(Reader_ReadInt32(reader));
     }
 
     thinker.function = (thinkfunc_t) acs_Interpreter_Think;
@@ -0,0 +1,379 @@
+/** @file interpreterbench.cpp  Action Code Script (ACS), interpreter self-test.
+ *
+ * Runs a synthetic module through the pre-decoded program and through a
+ * reference interpreter that dispatches the original bytecode with a command
+ * table lookup, like the interpreter did before the bytecode was pre-decoded.
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "common.h"
+#include "acs/interpreter.h"
+
+#include <de/log.h>
+#include <de/time.h>
+#include <de/writer.h>
+#include "acs/module.h"
+#include "acs/script.h"
+
+#include <array>
+#include <memory>
+
+using namespace de;
+
+#ifdef __JHEXEN__
+
+namespace acs {
+
+/// Opcodes used by the synthetic module.
+enum BenchOpcode
+{
+    BenchTerminate       = 1,
+    BenchSuspend         = 2,
+    BenchPushNumber      = 3,
+    BenchAdd             = 14,
+    BenchMultiply        = 16,
+    BenchModulus         = 18,
+    BenchEQ              = 19,
+    BenchLT              = 21,
+    BenchAssignScriptVar = 25,
+    BenchPushScriptVar   = 28,
+    BenchAddScriptVar    = 31,
+    BenchIncScriptVar    = 46,
+    BenchGoto            = 52,
+    BenchIfGoto          = 53,
+    BenchAndBitwise      = 72,
+    BenchIfNotGoto       = 79,
+    BenchOpcodeCount     = 102
+};
+
+/// Script variables of the synthetic script.
+enum BenchVariable
+{
+    BenchCounter,      ///< Loop counter.
+    BenchSum,          ///< Checksum of the loop iterations.
+    BenchEvenCount,    ///< Number of even counter values.
+    BenchIterations,   ///< Number of loop iterations (argument).
+    BenchSuspendAt,    ///< Counter value where the script suspends (argument).
+    BenchVariableCount
+};
+
+static const int BENCH_SCRIPT_NUMBER = 1;
+
+/**
+ * Composes the bytecode of a module with one script. The script loops over a
+ * counter, doing arithmetic, comparisons, and conditional and unconditional
+ * jumps. It suspends once in the middle of the loop, and leaves two values on
+ * the stack when it terminates.
+ */
+static Block benchModuleBytecode()
+{
+    List<dint32> code;
+    code << 0 << 0; // Magic and script info offset.
+
+    auto op = [&code] (dint32 opcode, std::initializer_list<dint32> operands)
+    {
+        code << opcode;
+        for (dint32 operand : operands) code << operand;
+    };
+    auto here = [&code] () { return dint32(code.size() * sizeof(dint32)); };
+    auto jump = [&code, &op] (dint32 opcode) // Returns the index of the target operand.
+    {
+        op(opcode, {0});
+        return code.sizei() - 1;
+    };
+    auto land = [&code, &here] (int jumpOperand) { code[jumpOperand] = here(); };
+
+    const dint32 start = here();
+    op(BenchPushNumber, {0}); op(BenchAssignScriptVar, {BenchCounter});
+    op(BenchPushNumber, {0}); op(BenchAssignScriptVar, {BenchSum});
+    op(BenchPushNumber, {0}); op(BenchAssignScriptVar, {BenchEvenCount});
+
+    const dint32 loop = here();
+    op(BenchPushScriptVar, {BenchCounter}); op(BenchPushScriptVar, {BenchIterations});
+    op(BenchLT, {});
+    const int toEnd = jump(BenchIfNotGoto);
+
+    // sum = (sum + counter * 3) % 65521
+    op(BenchPushScriptVar, {BenchSum}); op(BenchPushScriptVar, {BenchCounter});
+    op(BenchPushNumber, {3}); op(BenchMultiply, {}); op(BenchAdd, {});
+    op(BenchPushNumber, {65521}); op(BenchModulus, {});
+    op(BenchAssignScriptVar, {BenchSum});
+
+    // if ((counter & 1) == 0) evenCount += 1
+    op(BenchPushScriptVar, {BenchCounter}); op(BenchPushNumber, {1});
+    op(BenchAndBitwise, {}); op(BenchPushNumber, {0}); op(BenchEQ, {});
+    const int toOdd = jump(BenchIfNotGoto);
+    op(BenchPushNumber, {1}); op(BenchAddScriptVar, {BenchEvenCount});
+    land(toOdd);
+
+    // if (counter == suspendAt) suspend
+    op(BenchPushScriptVar, {BenchCounter}); op(BenchPushScriptVar, {BenchSuspendAt});
+    op(BenchEQ, {}); op(BenchPushNumber, {0}); op(BenchEQ, {});
+    const int toNext = jump(BenchIfGoto);
+    op(BenchSuspend, {});
+    land(toNext);
+
+    op(BenchIncScriptVar, {BenchCounter});
+    op(BenchGoto, {loop});
+
+    land(toEnd);
+    op(BenchPushScriptVar, {BenchSum}); op(BenchPushScriptVar, {BenchEvenCount});
+    op(BenchTerminate, {});
+
+    // Script info.
+    code[1] = here();
+    code << 1 << BENCH_SCRIPT_NUMBER << start << BenchVariableCount;
+    code << 0; // No constants.
+
+    Block bytecode;
+    Writer writer(bytecode);
+    for (dint32 word : code) writer << word;
+    bytecode.data()[0] = 'A';
+    bytecode.data()[1] = 'C';
+    bytecode.data()[2] = 'S';
+    bytecode.data()[3] = 0;
+    return bytecode;
+}
+
+/**
+ * Interprets the original bytecode, converting the byte order of every word and
+ * dispatching the opcodes through a command table.
+ */
+struct ReferenceInterpreter
+{
+    const dint32 *pcode;    ///< Beginning of the bytecode.
+    const dint32 *pcodePtr;
+    int args[ACS_INTERPRETER_MAX_SCRIPT_ARGS];
+    Interpreter::Stack locals;
+    bool suspended;
+
+    enum Result { Continue, Stop, Terminate };
+    typedef Result (*Command)(ReferenceInterpreter &);
+
+    int operand() { return DD_LONG(*pcodePtr++); }
+
+    void jump() { pcodePtr = (const dint32 *) ((const dbyte *) pcode + DD_LONG(*pcodePtr)); }
+
+    static Result cmdTerminate(ReferenceInterpreter &) { return Terminate; }
+    static Result cmdSuspend(ReferenceInterpreter &in) { in.suspended = true; return Stop; }
+    static Result cmdPushNumber(ReferenceInterpreter &in) { in.locals.push(in.operand()); return Continue; }
+    static Result cmdAdd(ReferenceInterpreter &in) { in.locals.push(in.locals.pop() + in.locals.pop()); return Continue; }
+    static Result cmdMultiply(ReferenceInterpreter &in) { in.locals.push(in.locals.pop() * in.locals.pop()); return Continue; }
+    static Result cmdModulus(ReferenceInterpreter &in)
+    {
+        int operand2 = in.locals.pop();
+        in.locals.push(in.locals.pop() % operand2);
+        return Continue;
+    }
+    static Result cmdEQ(ReferenceInterpreter &in) { in.locals.push(in.locals.pop() == in.locals.pop()); return Continue; }
+    static Result cmdLT(ReferenceInterpreter &in)
+    {
+        int operand2 = in.locals.pop();
+        in.locals.push(in.locals.pop() < operand2);
+        return Continue;
+    }
+    static Result cmdAssignScriptVar(ReferenceInterpreter &in) { in.args[in.operand()] = in.locals.pop(); return Continue; }
+    static Result cmdPushScriptVar(ReferenceInterpreter &in) { in.locals.push(in.args[in.operand()]); return Continue; }
+    static Result cmdAddScriptVar(ReferenceInterpreter &in) { in.args[in.operand()] += in.locals.pop(); return Continue; }
+    static Result cmdIncScriptVar(ReferenceInterpreter &in) { in.args[in.operand()]++; return Continue; }
+    static Result cmdGoto(ReferenceInterpreter &in) { in.jump(); return Continue; }
+    static Result cmdIfGoto(ReferenceInterpreter &in)
+    {
+        if (in.locals.pop()) in.jump(); else in.pcodePtr++;
+        return Continue;
+    }
+    static Result cmdAndBitwise(ReferenceInterpreter &in) { in.locals.push(in.locals.pop() & in.locals.pop()); return Continue; }
+    static Result cmdIfNotGoto(ReferenceInterpreter &in)
+    {
+        if (!in.locals.pop()) in.jump(); else in.pcodePtr++;
+        return Continue;
+    }
+
+    static Command findCommand(int name)
+    {
+        static const std::array<Command, BenchOpcodeCount> cmds = [] ()
+        {
+            std::array<Command, BenchOpcodeCount> c;
+            c.fill(nullptr);
+            c[BenchTerminate]       = cmdTerminate;
+            c[BenchSuspend]         = cmdSuspend;
+            c[BenchPushNumber]      = cmdPushNumber;
+            c[BenchAdd]             = cmdAdd;
+            c[BenchMultiply]        = cmdMultiply;
+            c[BenchModulus]         = cmdModulus;
+            c[BenchEQ]              = cmdEQ;
+            c[BenchLT]              = cmdLT;
+            c[BenchAssignScriptVar] = cmdAssignScriptVar;
+            c[BenchPushScriptVar]   = cmdPushScriptVar;
+            c[BenchAddScriptVar]    = cmdAddScriptVar;
+            c[BenchIncScriptVar]    = cmdIncScriptVar;
+            c[BenchGoto]            = cmdGoto;
+            c[BenchIfGoto]          = cmdIfGoto;
+            c[BenchAndBitwise]      = cmdAndBitwise;
+            c[BenchIfNotGoto]       = cmdIfNotGoto;
+            return c;
+        }();
+        if (name >= 0 && name < BenchOpcodeCount && cmds[name]) return cmds[name];
+        /// @throw Error  Invalid command name specified.
+        throw Error("acs::ReferenceInterpreter::findCommand", "Unknown command #" + String::asText(name));
+    }
+
+    /// @return @c true, if the script terminated.
+    bool execute()
+    {
+        Result action;
+        while ((action = findCommand(DD_LONG(*pcodePtr++))(*this)) == Continue)
+        {}
+        return action == Terminate;
+    }
+};
+
+/**
+ * Compares the state of the interpreters after they have stopped.
+ */
+static bool compareBenchState(const Module &module, const Interpreter &interp,
+                              const ReferenceInterpreter &ref, const char *when)
+{
+    bool same = (interp.locals.height == ref.locals.height);
+    for (int i = 0; same && i < interp.locals.height; ++i)
+    {
+        same = (interp.locals.values[i] == ref.locals.values[i]);
+    }
+    for (int i = 0; same && i < BenchVariableCount; ++i)
+    {
+        same = (interp.args[i] == ref.args[i]);
+    }
+    const int offset    = module.pcodeOffset(interp.pcodePtr);
+    const int refOffset = int((ref.pcodePtr - ref.pcode) * sizeof(dint32));
+    if (!same || offset != refOffset)
+    {
+        LOG_SCR_ERROR("Interpreters differ %s: counter %i/%i, sum %i/%i, stack height %i/%i, "
+                      "pcode offset %i/%i")
+            << when << interp.args[BenchCounter] << ref.args[BenchCounter]
+            << interp.args[BenchSum] << ref.args[BenchSum]
+            << interp.locals.height << ref.locals.height << offset << refOffset;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Runs the synthetic script with both interpreters, comparing their state when
+ * the script suspends and when it terminates. The decoded interpreter resumes
+ * from the program position restored from the serialized pcode offset, like
+ * when a saved game is loaded.
+ *
+ * @return @c true, if the interpreters agree.
+ */
+static bool runBenchScript(const Module &module, int iterations, TimeSpan &decodedTime,
+                           TimeSpan &referenceTime)
+{
+    const Module::EntryPoint &ep = module.entryPoint(BENCH_SCRIPT_NUMBER);
+    Script script(ep);
+
+    Interpreter interp;
+    de::zap(interp);
+    interp._script = &script;
+    interp.pcodePtr = ep.pcodePtr;
+    interp.args[BenchIterations] = iterations;
+    interp.args[BenchSuspendAt]  = iterations / 2;
+
+    ReferenceInterpreter ref;
+    de::zap(ref);
+    ref.pcode    = reinterpret_cast<const dint32 *>(module.pcode().constData());
+    ref.pcodePtr = ref.pcode + module.pcodeOffset(ep.pcodePtr) / sizeof(dint32);
+    ref.args[BenchIterations] = iterations;
+    ref.args[BenchSuspendAt]  = iterations / 2;
+
+    for (int run = 0; run < 2; ++run)
+    {
+        script.setState(Script::Running);
+        Time startedAt;
+        const bool terminated = interp.execute();
+        decodedTime += startedAt.since();
+
+        startedAt = Time();
+        const bool refTerminated = ref.execute();
+        referenceTime += startedAt.since();
+
+        const bool suspended = (script.state() == Script::Suspended);
+        if (terminated != refTerminated || suspended != ref.suspended ||
+            terminated == (run == 0) || suspended == (run == 1))
+        {
+            LOG_SCR_ERROR("Interpreters stopped differently (run %i)") << run;
+            return false;
+        }
+        if (!compareBenchState(module, interp, ref, run? "after terminating" : "after suspending"))
+        {
+            return false;
+        }
+
+        // Round trip through the serialized position.
+        interp.pcodePtr = module.wordAt(module.pcodeOffset(interp.pcodePtr));
+        ref.suspended = false;
+    }
+    return true;
+}
+
+D_CMD(BenchmarkACS)
+{
+    DE_UNUSED(src);
+
+    const int iterations = (argc > 1? de::max(2, String(argv[1]).toInt()) : 100000);
+    const int rounds     = (argc > 2? de::max(1, String(argv[2]).toInt()) : 20);
+
+    std::unique_ptr<Module> module;
+    try
+    {
+        module.reset(Module::newFromBytecode(benchModuleBytecode()));
+    }
+    catch (const Error &er)
+    {
+        LOG_SCR_ERROR("Failed to load the synthetic module: %s") << er.asText();
+        return false;
+    }
+
+    TimeSpan decodedTime, referenceTime;
+    for (int i = 0; i < rounds; ++i)
+    {
+        if (!runBenchScript(*module, iterations, decodedTime, referenceTime))
+        {
+            return false;
+        }
+    }
+
+    LOG_SCR_MSG("ACS interpreters agree: %i rounds of %i iterations") << rounds << iterations;
+    const ddouble decoded   = decodedTime;
+    const ddouble reference = referenceTime;
+    LOG_SCR_MSG("  Decoded program:    %.3f s") << decoded;
+    LOG_SCR_MSG("  Reference bytecode: %.3f s (%.2fx)")
+        << reference << (decoded > 0? reference / decoded : 0.0);
+    return true;
+}
+
+void Interpreter::consoleRegister()  // static
+{
+    C_CMD("benchacs", nullptr, BenchmarkACS);
+}
+
+}  // namespace acs
+
+#else // !__JHEXEN__
+
+void acs::Interpreter::consoleRegister()  // static
+{}
+
+#endif // __JHEXEN__
@@ -35,10 +35,21 @@ namespace acs {
 DE_PIMPL_NOREF(Module)
 {
     Block                  pcode;
+    List<Word>             program;
     List<EntryPoint>       entryPoints;
     KeyMap<int, EntryPoint *> epByScriptNumberLut;
     List<String>           constants;
 
+    void decodeProgram()
+    {
+        const auto *words = reinterpret_cast<const dint32 *>(pcode.constData());
+        program.resize(pcode.size() / sizeof(dint32));
+        for (dsize i = 0; i < program.size(); ++i)
+        {
+            program[i].value = DD_LONG(words[i]);
+        }
+    }
+
     void buildEntryPointLut()
     {
         epByScriptNumberLut.clear();
@@ -76,6 +87,7 @@ Module *Module::newFromBytecode(const Block &bytecode)  // static
     // Copy the complete bytecode data into a local buffer (we'll be randomly
     // accessing this frequently).
     module->d->pcode = bytecode;
+    module->d->decodeProgram();
 
     de::Reader from(module->d->pcode);
     dint32 magic, scriptInfoOffset;
@@ -86,6 +98,7 @@ Module *Module::newFromBytecode(const Block &bytecode)  // static
     dint32 numEntryPoints;
     from >> numEntryPoints;
     module->d->entryPoints.reserve(numEntryPoints);
+    List<int> entryPointWords;
     for(dint32 i = 0; i < numEntryPoints; ++i)
     {
 #define OPEN_SCRIPTS_BASE 1000
@@ -101,11 +114,13 @@ Module *Module::newFromBytecode(const Block &bytecode)  // static
 
         dint32 offset;
         from >> offset;
-        if(offset > dint32(module->d->pcode.size()))
+        if(offset < 0 || offset % sizeof(dint32) ||
+           dsize(offset) >= module->d->program.size() * sizeof(dint32))
         {
             throw FormatError("acs::Module", "Invalid script entrypoint offset");
         }
-        ep.pcodePtr = reinterpret_cast<const int *>(module->d->pcode.constData() + offset);
+        ep.pcodePtr = module->wordAt(offset);
+        entryPointWords << int(offset / sizeof(dint32));
 
         from >> ep.scriptArgCount;
         if(ep.scriptArgCount > ACS_INTERPRETER_MAX_SCRIPT_ARGS)
@@ -122,6 +137,9 @@ Module *Module::newFromBytecode(const Block &bytecode)  // static
     // Prepare a script-number => EntryPoint LUT.
     module->d->buildEntryPointLut();
 
+    // Resolve the instruction handlers of the scripts.
+    Interpreter::resolveCommands(module->d->program, entryPointWords);
+
     // Read constant (string-)values.
     dint32 numConstants;
     from >> numConstants;
@@ -200,4 +218,21 @@ const Block &Module::pcode() const
     return d->pcode;
 }
 
+const Module::Word *Module::wordAt(int pcodeOffset) const
+{
+    const dsize index = dsize(pcodeOffset) / sizeof(dint32);
+    if(pcodeOffset >= 0 && index < d->program.size())
+    {
+        return &d->program[index];
+    }
+    /// @throw FormatError  Offset is outside the bytecode.
+    throw FormatError("acs::Module::wordAt", "Invalid pcode offset " + String::asText(pcodeOffset));
+}
+
+int Module::pcodeOffset(const Word *word) const
+{
+    DE_ASSERT(word >= d->program.data() && word <= d->program.data() + d->program.size());
+    return int(word - d->program.data()) * int(sizeof(dint32));
+}
+
 } // namespace acs
@@ -24,6 +24,7 @@
 #include <de/iserializable.h>
 #include <de/log.h>
 #include <de/nativepath.h>
+#include "acs/interpreter.h"
 #include "acs/module.h"
 #include "acs/script.h"
 #include "gamesession.h"
@@ -398,6 +399,8 @@ void System::consoleRegister()  // static
     /* Alias */ C_CMD("scriptinfo", "i", InspectACScript);
     C_CMD("listacscripts",          "",  ListACScripts);
     /* Alias */ C_CMD("scriptinfo", "",  ListACScripts);
+
+    Interpreter::consoleRegister();
 }
 
 }  // namespace acs
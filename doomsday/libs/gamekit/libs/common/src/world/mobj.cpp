@@ -1167,8 +1167,8 @@ void Mobj_RunScriptOnDeath(mobj_t *mob, mobj_t *killer)
     }
 
     // Check Thing definition for an onDeath script.
-    const auto &thingDef = DED_Definitions()->things[mob->type];
-    if (const String onDeathSrc = thingDef.gets(DE_STR("onDeath")))
+    const char *onDeathSrc = DED_Definitions()->getThingOnDeath(mob->type);
+    if (onDeathSrc[0])
     {
         LOG_AS("Mobj_RunScriptOnDeath");
 
@@ -1203,8 +1203,8 @@ dd_bool Mobj_RunScriptOnTouch(mobj_t *mob, mobj_t *special, enum mobjtouchresult
     }
 
     // Check Thing definition for an onTouch script.
-    const auto &thingDef = DED_Definitions()->things[special->type];
-    if (const String onTouchSrc = thingDef.gets(DE_STR("onTouch")))
+    const char *onTouchSrc = DED_Definitions()->getThingOnTouch(special->type);
+    if (onTouchSrc[0])
     {
         LOG_AS("Mobj_RunScriptOnTouch");
 
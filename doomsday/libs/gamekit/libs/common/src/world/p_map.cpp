@@ -235,8 +235,8 @@ dd_bool P_TeleportMove(mobj_t *mobj, coord_t x, coord_t y, dd_bool alwaysStomp)
     mobj->origin[VY] = parm.location[VY];
     P_MobjLink(mobj);
 
-    mobj->floorZ     = P_GetDoublep(Mobj_Sector(mobj), DMU_FLOOR_HEIGHT);
-    mobj->ceilingZ   = P_GetDoublep(Mobj_Sector(mobj), DMU_CEILING_HEIGHT);
+    mobj->floorZ     = Sector_FloorHeight(Mobj_Sector(mobj));
+    mobj->ceilingZ   = Sector_CeilingHeight(Mobj_Sector(mobj));
 #if !__JHEXEN__
     mobj->dropOffZ   = mobj->floorZ;
 #endif
@@ -276,11 +276,11 @@ static int PIT_CrossLine(Line *line, void *context)
 {
     pit_crossline_params_t &parm = *static_cast<pit_crossline_params_t *>(context);
 
-    if((P_GetIntp(line, DMU_FLAGS) & DDLF_BLOCKING) ||
+    if((Line_Flags(line) & DDLF_BLOCKING) ||
        (P_ToXLine(line)->flags & ML_BLOCKMONSTERS) ||
-       (!P_GetPtrp(line, DMU_FRONT_SECTOR) || !P_GetPtrp(line, DMU_BACK_SECTOR)))
+       (!Line_FrontSector(line) || !Line_BackSector(line)))
     {
-        AABoxd *aaBox = (AABoxd *)P_GetPtrp(line, DMU_BOUNDING_BOX);
+        const AABoxd *aaBox = Line_Bounds(line);
 
         if(!(parm.crossAABox.minX > aaBox->maxX ||
              parm.crossAABox.maxX < aaBox->minX ||
@@ -346,7 +346,7 @@ static int untouched(Line *line, mobj_t *mobj)
     const coord_t x      = mobj->origin[VX];
     const coord_t y      = mobj->origin[VY];
     const coord_t radius = mobj->radius;
-    const AABoxd *ldBox  = (AABoxd *)P_GetPtrp(line, DMU_BOUNDING_BOX);
+    const AABoxd *ldBox  = Line_Bounds(line);
     AABoxd moBox;
 
     if(((moBox.minX = x - radius) >= ldBox->maxX) ||
@@ -948,7 +948,7 @@ static int PIT_CheckThing(mobj_t *thing, void * /*context*/)
  */
 static int PIT_CheckLine(Line *ld, void * /*context*/)
 {
-    const AABoxd *aaBox = (AABoxd *)P_GetPtrp(ld, DMU_BOUNDING_BOX);
+    const AABoxd *aaBox = Line_Bounds(ld);
     if(tmBox.minX >= aaBox->maxX || tmBox.minY >= aaBox->maxY ||
        tmBox.maxX <= aaBox->minX || tmBox.maxY <= aaBox->minY)
     {
@@ -989,7 +989,7 @@ static int PIT_CheckLine(Line *ld, void * /*context*/)
     }
 #endif
 
-    if(!P_GetPtrp(ld, DMU_BACK_SECTOR)) // One sided line.
+    if(!Line_BackSector(ld)) // One sided line.
     {
 #if __JHEXEN__
         if(tmThing->flags2 & MF2_BLASTED)
@@ -1002,7 +1002,7 @@ static int PIT_CheckLine(Line *ld, void * /*context*/)
 #else
         coord_t d1[2];
 
-        P_GetDoublepv(ld, DMU_DXY, d1);
+        Line_Direction(ld, d1);
 
         /**
          * $unstuck: allow player to move out of 1s wall, to prevent
@@ -1026,7 +1026,7 @@ static int PIT_CheckLine(Line *ld, void * /*context*/)
     /// @todo Will never pass this test due to above. Is the previous check
     ///       supposed to qualify player mobjs only?
 #if __JHERETIC__
-    if(!P_GetPtrp(ld, DMU_BACK_SECTOR)) // one sided line
+    if(!Line_BackSector(ld)) // one sided line
     {
         // Missiles can trigger impact specials
         if((tmThing->flags & MF_MISSILE) && xline->special)
@@ -1040,7 +1040,7 @@ static int PIT_CheckLine(Line *ld, void * /*context*/)
     if(!(tmThing->flags & MF_MISSILE))
     {
         // Explicitly blocking everything?
-        if(P_GetIntp(ld, DMU_FLAGS) & DDLF_BLOCKING)
+        if(Line_Flags(ld) & DDLF_BLOCKING)
         {
 #if __JHEXEN__
             if(tmThing->flags2 & MF2_BLASTED)
@@ -1148,10 +1148,10 @@ dd_bool P_CheckPositionXYZ(mobj_t *thing, coord_t x, coord_t y, coord_t z)
     Sector *newSector = Sector_AtPoint_FixedPrecision(tm);
 
     tmCeilingLine   = tmFloorLine = 0;
-    tmFloorZ        = tmDropoffZ = P_GetDoublep(newSector, DMU_FLOOR_HEIGHT);
-    tmCeilingZ      = P_GetDoublep(newSector, DMU_CEILING_HEIGHT);
+    tmFloorZ        = tmDropoffZ = Sector_FloorHeight(newSector);
+    tmCeilingZ      = Sector_CeilingHeight(newSector);
 #if __JHEXEN__
-    tmFloorMaterial = (world_Material *)P_GetPtrp(newSector, DMU_FLOOR_MATERIAL);
+    tmFloorMaterial = Sector_FloorMaterial(newSector);
 #else
     tmBlockingLine  = 0;
     tmUnstuck       = Mobj_IsPlayer(thing) && !Mobj_IsVoodooDoll(thing);
@@ -1286,7 +1286,7 @@ static dd_bool P_TryMove2(mobj_t *thing, coord_t x, coord_t y, dd_bool dropoff)
             goto pushline;
         }
         else if(tmBlockingMobj->origin[VZ] + tmBlockingMobj->height - thing->origin[VZ] > 24 ||
-                (P_GetDoublep(Mobj_Sector(tmBlockingMobj), DMU_CEILING_HEIGHT) -
+                (Sector_CeilingHeight(Mobj_Sector(tmBlockingMobj)) -
                  (tmBlockingMobj->origin[VZ] + tmBlockingMobj->height) < thing->height) ||
                 (tmCeilingZ - (tmBlockingMobj->origin[VZ] + tmBlockingMobj->height) <
                  thing->height))
@@ -1468,7 +1468,7 @@ static dd_bool P_TryMove2(mobj_t *thing, coord_t x, coord_t y, dd_bool dropoff)
 #if __JHEXEN__
         // Must stay within a sector of a certain floor type?
         if((thing->flags2 & MF2_CANTLEAVEFLOORPIC) &&
-           (tmFloorMaterial != P_GetPtrp(Mobj_Sector(thing), DMU_FLOOR_MATERIAL) ||
+           (tmFloorMaterial != Sector_FloorMaterial(Mobj_Sector(thing)) ||
             !FEQUAL(tmFloorZ, thing->origin[VZ])))
         {
             return false;
@@ -1505,7 +1505,7 @@ static dd_bool P_TryMove2(mobj_t *thing, coord_t x, coord_t y, dd_bool dropoff)
     {
         thing->floorClip = 0;
 
-        if(FEQUAL(thing->origin[VZ], P_GetDoublep(Mobj_Sector(thing), DMU_FLOOR_HEIGHT)))
+        if(FEQUAL(thing->origin[VZ], Sector_FloorHeight(Mobj_Sector(thing))))
         {
             const terraintype_t *tt = P_MobjFloorTerrain(thing);
             if(tt->flags & TTF_FLOORCLIP)
@@ -0,0 +1,216 @@
+/**
+ * @file main.cpp
+ *
+ * FlatIdMap tests and benchmark. @ingroup tests
+ *
+ * Compares the flat map against a fixed-size chained hash like the one that was
+ * used for the server's mobj register.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include <de/flatidmap.h>
+#include <de/time.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace de;
+using namespace std;
+
+/// Payload roughly the size of a registered mobj.
+struct Payload
+{
+    duint16 id;
+    dbyte data[400];
+};
+
+/// 1024-bucket chained hash with individually allocated nodes.
+class ChainedHash
+{
+public:
+    struct Node
+    {
+        Node *next, *prev;
+        Payload value;
+    };
+
+    ChainedHash() { std::memset(_buckets, 0, sizeof(_buckets)); }
+
+    ~ChainedHash()
+    {
+        for (auto &b : _buckets)
+        {
+            for (Node *n = b.first, *next; n; n = next) { next = n->next; free(n); }
+        }
+    }
+
+    Payload *find(duint16 id)
+    {
+        for (Node *n = _buckets[id & 0x3ff].first; n; n = n->next)
+        {
+            if (n->value.id == id) return &n->value;
+        }
+        return nullptr;
+    }
+
+    Payload &insert(duint16 id)
+    {
+        if (Payload *found = find(id)) return *found;
+        Bucket &b = _buckets[id & 0x3ff];
+        Node *n = static_cast<Node *>(calloc(1, sizeof(Node)));
+        n->value.id = id;
+        if (b.last) { b.last->next = n; n->prev = b.last; }
+        b.last = n;
+        if (!b.first) b.first = n;
+        return n->value;
+    }
+
+    void remove(duint16 id)
+    {
+        Bucket &b = _buckets[id & 0x3ff];
+        for (Node *n = b.first; n; n = n->next)
+        {
+            if (n->value.id != id) continue;
+            if (b.last  == n) b.last  = n->prev;
+            if (b.first == n) b.first = n->next;
+            if (n->next) n->next->prev = n->prev;
+            if (n->prev) n->prev->next = n->next;
+            free(n);
+            return;
+        }
+    }
+
+private:
+    struct Bucket { Node *first, *last; };
+    Bucket _buckets[1024];
+};
+
+static void check(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << what << endl;
+        exit(1);
+    }
+}
+
+static void verify()
+{
+    FlatIdMap<duint16, int> map;
+    std::map<duint16, int> reference;
+    srand(1);
+    for (int i = 0; i < 200000; ++i)
+    {
+        const duint16 id = duint16(1 + rand() % 60000);
+        switch (rand() % 3)
+        {
+        case 0:
+            map.insert(id) = i;
+            reference[id] = i;
+            break;
+
+        case 1: {
+            const bool removed  = map.remove(id);
+            const bool expected = reference.erase(id) > 0;
+            check(removed == expected, "remove() reports whether the ID was present");
+            break; }
+
+        default: {
+            const int *found = map.find(id);
+            auto ref = reference.find(id);
+            check((found != nullptr) == (ref != reference.end()), "find() locates present IDs");
+            check(!found || *found == ref->second, "find() returns the inserted value");
+            break; }
+        }
+    }
+    check(map.size() == reference.size(), "size() matches the number of entries");
+    for (dsize i = 0; i < map.size(); ++i)
+    {
+        auto ref = reference.find(map.idAt(i));
+        check(ref != reference.end() && ref->second == map.valueAt(i),
+              "iterated entries match the inserted values");
+    }
+    cout << "Verified against std::map: " << map.size() << " entries, index size "
+         << map.indexSize() << endl;
+}
+
+template <typename Container>
+static void benchmark(const char *name, const std::vector<duint16> &ids)
+{
+    Container map;
+    const int rounds = 20;
+
+    Time startedAt;
+    for (auto id : ids) map.insert(id).id = id;
+    const double insertTime = startedAt.since();
+
+    startedAt = Time();
+    duint64 sum = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (auto id : ids) sum += map.find(id)->id;
+    }
+    const double findTime = startedAt.since();
+
+    startedAt = Time();
+    for (auto id : ids) map.remove(id);
+    const double removeTime = startedAt.since();
+
+    const double n = double(ids.size());
+    cout << "  " << name << ": insert " << int(n / insertTime / 1.0e3) << " k/s, lookup "
+         << int(n * rounds / findTime / 1.0e3) << " k/s, remove "
+         << int(n / removeTime / 1.0e3) << " k/s (checksum " << sum << ")" << endl;
+}
+
+int main(int, char **)
+{
+    init_Foundation();
+    try
+    {
+        verify();
+
+        for (int count : {1000, 10000, 50000})
+        {
+            // Mobj IDs are handed out sequentially but become fragmented
+            // as mobjs are destroyed and created.
+            std::vector<duint16> ids;
+            srand(count);
+            for (int i = 1; int(ids.size()) < count; ++i)
+            {
+                if (rand() % 8) ids.push_back(duint16(i));
+            }
+            for (dsize i = ids.size() - 1; i > 0; --i)
+            {
+                std::swap(ids[i], ids[rand() % (i + 1)]);
+            }
+
+            cout << count << " mobjs:" << endl;
+            benchmark<ChainedHash>("Chained hash", ids);
+            benchmark<FlatIdMap<duint16, Payload>>("FlatIdMap   ", ids);
+        }
+    }
+    catch (const Error &err)
+    {
+        err.warnPlainText();
+        deinit_Foundation();
+        return 1;
+    }
+    deinit_Foundation();
+    return 0;
+}
@@ -25,8 +25,22 @@
 #include <de/numbervalue.h>
 #include <de/variable.h>
 #include <de/json.h>
+#include <de/scripting/process.h>
+#include <de/scripting/script.h>
+#include <cstdlib>
+#include <iostream>
 
 using namespace de;
+using namespace std;
+
+static void check(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << what << endl;
+        exit(1);
+    }
+}
 
 int main(int argc, char **argv)
 {
@@ -75,6 +89,50 @@ int main(int argc, char **argv)
         LOG_MSG("Copied:\n") << copied;
 
         LOG_MSG("...and as JSON:\n") << composeJSON(copied);
+
+        // Large records have an index for looking up members.
+        Record large;
+        for (int i = 0; i < 100; ++i)
+        {
+            large.set(Stringf("member%i", i), i);
+        }
+        for (int i = 0; i < 100; i += 3)
+        {
+            delete large.remove(Stringf("member%i", i));
+        }
+        for (int i = 0; i < 100; ++i)
+        {
+            check(large.has(Stringf("member%i", i)) == (i % 3 != 0),
+                  "large record has exactly the members that were not removed");
+            check(i % 3 == 0 || large.geti(Stringf("member%i", i)) == i,
+                  "large record members keep their values after removals");
+        }
+        Record preserved = large;
+        large.assignPreservingVariables(copied);
+        check(large.size() == copied.size(), "assignPreservingVariables copies the members");
+        check(!large.has("member1"), "assignPreservingVariables drops the old members");
+        LOG_MSG("Large record had %i members, %i after assigning") << preserved.size() << large.size();
+
+        // Cached name lookups must notice super-records modified in place.
+        const Script script("record A; A.value = 'A'\n"
+                            "record B; B.value = 'B'\n"
+                            "record obj; obj.__super__ = [A]\n"
+                            "def lookup()\n"
+                            "    return obj.value\n"
+                            "end\n"
+                            "first = lookup()\n"
+                            "obj.__super__ += [B]\n"
+                            "second = lookup()\n"
+                            "obj.__super__[1] = A\n"
+                            "third = lookup()\n");
+        Process proc(script);
+        proc.execute();
+        check(proc.globals().gets("first")  == "A", "lookup through the initial super-record");
+        check(proc.globals().gets("second") == "B", "lookup after appending a super-record");
+        check(proc.globals().gets("third")  == "A", "lookup after replacing a super-record");
+        LOG_MSG("Lookups through modified super-records: %s %s %s")
+            << proc.globals().gets("first") << proc.globals().gets("second")
+            << proc.globals().gets("third");
     }
     catch (const Error &err)
     {
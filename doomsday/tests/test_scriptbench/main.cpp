@@ -0,0 +1,112 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Benchmarks the evaluation of Doomsday Script.
+ *
+ * Each workload in workloads.ds is run both by traversing the expression trees
+ * and with compiled bytecode, and the results are checked to be identical.
+ * One op is one iteration of the workload's loop. The hit rate of the name
+ * lookup caches is reported for the bytecode run.
+ *
+ * - test_scriptbench [iterations]
+ */
+
+#include <de/textapp.h>
+#include <de/commandline.h>
+#include <de/filesystem.h>
+#include <de/logbuffer.h>
+#include <de/time.h>
+#include <de/scripting/bytecode.h>
+#include <de/scripting/nameexpression.h>
+#include <de/scripting/process.h>
+#include <de/scripting/script.h>
+#include <de/variable.h>
+
+using namespace de;
+
+/**
+ * Runs a workload function and returns its result as text.
+ */
+static String runWorkload(Process &proc, const char *name, int count, bool useBytecode,
+                          double &seconds)
+{
+    Bytecode::setEnabled(useBytecode);
+    NameExpression::resetCacheStats();
+
+    const Script call(Stringf("result = %s(%i)", name, count));
+    Time startedAt;
+    proc.run(call);
+    proc.execute();
+    seconds = startedAt.since();
+
+    if (!proc.globals().has("result"))
+    {
+        throw Error("runWorkload", Stringf("Workload \"%s\" failed", name));
+    }
+    const String result = proc.globals()["result"].value().asText();
+    delete proc.globals().remove("result");
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    init_Foundation();
+    int result = 0;
+    try
+    {
+        TextApp app(makeList(argc, argv));
+        LogBuffer::get().enableStandardOutput();
+        app.initSubsystems();
+
+        const int count = (app.commandLine().count() > 1?
+                           de::max(1, app.commandLine().at(1).toInt()) : 100000);
+
+        const Script workloads(app.fileSystem().find("workloads.ds"));
+        Process proc(workloads);
+        proc.execute();
+
+        LOG_MSG("%i iterations per workload") << count;
+        for (const char *name : {"arithmetic", "calls", "members", "arrays", "logic", "text"})
+        {
+            double treeTime, bytecodeTime;
+            const String treeResult     = runWorkload(proc, name, count, false, treeTime);
+            const String bytecodeResult = runWorkload(proc, name, count, true,  bytecodeTime);
+            const bool identical = (treeResult == bytecodeResult);
+
+            const auto lookups = NameExpression::cacheStats();
+            const duint64 total = lookups.hits + lookups.misses;
+
+            LOG_MSG("%-10s tree %9.0f ops/s  bytecode %9.0f ops/s  (%.2fx) %s  "
+                    "name cache %.1f%% of %llu")
+                << name << count / treeTime << count / bytecodeTime
+                << treeTime / bytecodeTime << (identical? "identical" : "MISMATCH")
+                << (total? 100.0 * lookups.hits / total : 0.0) << total;
+            if (!identical) result = 1;
+        }
+        Bytecode::setEnabled(true);
+    }
+    catch (const Error &err)
+    {
+        err.warnPlainText();
+        result = 1;
+    }
+    deinit_Foundation();
+    return result;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file main.cpp
+ *
+ * TaskPool tests and benchmark. @ingroup tests
+ *
+ * Measures the overhead of dispatching small tasks and the scaling of
+ * parallelFor() compared to a serial loop.
+ *
+ * @authors Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include <de/error.h>
+#include <de/taskpool.h>
+#include <de/time.h>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace de;
+using namespace std;
+
+static void check(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        cerr << "FAILED: " << what << endl;
+        exit(1);
+    }
+}
+
+static void benchmarkDispatch(int count, TaskPool::Priority priority)
+{
+    atomic_int done(0);
+    Time startedAt;
+    {
+        TaskPool pool;
+        for (int i = 0; i < count; ++i)
+        {
+            pool.start([&done] () { done++; }, priority);
+        }
+        pool.waitForDone();
+    }
+    const double elapsed = startedAt.since();
+    check(done == count, "all tasks were run");
+    cout << "  " << count << " empty tasks: "
+         << elapsed * 1.0e6 / count << " usec/task" << endl;
+}
+
+static double work(dsize i)
+{
+    return std::sqrt(double(i)) * std::sin(double(i));
+}
+
+static void benchmarkParallelFor(dsize count)
+{
+    vector<double> serialResult(count);
+    vector<double> parallelResult(count);
+
+    Time startedAt;
+    for (dsize i = 0; i < count; ++i)
+    {
+        serialResult[i] = work(i);
+    }
+    const double serial = startedAt.since();
+
+    startedAt = Time();
+    TaskPool::parallelFor(0, count, [&parallelResult] (dsize begin, dsize end) {
+        for (dsize i = begin; i < end; ++i)
+        {
+            parallelResult[i] = work(i);
+        }
+    });
+    const double parallel = startedAt.since();
+
+    check(serialResult == parallelResult, "parallelFor computes the same results");
+    cout << "  " << count << " items: serial " << serial * 1000 << " ms, parallel "
+         << parallel * 1000 << " ms, speedup " << serial / parallel << "x" << endl;
+}
+
+int main(int, char **)
+{
+    init_Foundation();
+
+    cout << "Worker threads: " << TaskPool::workerCount() << endl;
+
+    cout << "Dispatch overhead:" << endl;
+    benchmarkDispatch(10000, TaskPool::LowPriority);
+    benchmarkDispatch(100000, TaskPool::HighPriority);
+
+    // Tasks started from pooled threads go to the threads' own queues.
+    {
+        atomic_int done(0);
+        TaskPool outer;
+        for (int i = 0; i < 100; ++i)
+        {
+            outer.start([&done] () {
+                TaskPool inner;
+                for (int k = 0; k < 100; ++k)
+                {
+                    inner.start([&done] () { done++; });
+                }
+                inner.waitForDone();
+            });
+        }
+        outer.waitForDone();
+        check(done == 10000, "nested tasks were run");
+    }
+
+    cout << "parallelFor scaling:" << endl;
+    benchmarkParallelFor(10000);
+    benchmarkParallelFor(1000000);
+    benchmarkParallelFor(10000000);
+
+    // Partial results are combined in order.
+    {
+        const string text = TaskPool::parallelReduce(0, 1000, string(),
+            [] (dsize begin, dsize end) {
+                string part;
+                for (dsize i = begin; i < end; ++i) part += char('a' + i % 26);
+                return part;
+            },
+            [] (const string &a, const string &b) { return a + b; }, 7);
+        bool inOrder = (text.size() == 1000);
+        for (dsize i = 0; inOrder && i < 1000; ++i)
+        {
+            inOrder = (text[i] == char('a' + i % 26));
+        }
+        check(inOrder, "parallelReduce combines in order");
+    }
+
+    // Each chunk has its own partial result, even if they are bools.
+    {
+        int trueCount = 0;
+        TaskPool::parallelReduce(0, 100000, false,
+            [] (dsize begin, dsize) { return (begin / 10) % 2 == 0; },
+            [&trueCount] (bool, bool value) { if (value) trueCount++; return value; }, 10);
+        check(trueCount == 5000, "parallelReduce keeps every bool partial result");
+    }
+
+    // Exceptions are passed to the calling thread.
+    {
+        bool caught = false;
+        try
+        {
+            TaskPool::parallelFor(0, 1000, [] (dsize begin, dsize) {
+                if (begin == 500) throw Error("test", "chunk failed");
+            }, 10);
+        }
+        catch (const Error &)
+        {
+            caught = true;
+        }
+        check(caught, "parallelFor rethrows exceptions");
+    }
+
+    TaskPool::deleteThreadPool();
+    deinit_Foundation();
+    cout << "Exiting main()..." << endl;
+    return 0;
+}
@@ -0,0 +1,394 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Benchmarks the blockmap.
+ *
+ * Elements are linked to random positions in a blockmap, moved around randomly,
+ * and the surroundings of each element are queried like when checking for
+ * collisions. The same is done with the quadtree blockmap that was used before
+ * the cells were stored in a flat grid, and the results of the queries are checked
+ * to be identical.
+ *
+ * - blockmapbench [elements] [map size]
+ */
+
+#include <doomsday/world/blockmap.h>
+
+#include <de/commandline.h>
+#include <de/legacy/memoryzone.h>
+#include <de/liblegacy.h>
+#include <de/logbuffer.h>
+#include <de/math.h>
+#include <de/textapp.h>
+#include <de/time.h>
+
+#include <functional>
+#include <list>
+#include <vector>
+
+using namespace de;
+using namespace world;
+
+/// Largest radius of a mobj (DDMOBJ_RADIUS_MAX).
+static const ddouble MOBJ_RADIUS_MAX = 32;
+
+static const duint CELL_SIZE = 128;
+
+/**
+ * The blockmap that was used before the cells were stored in a flat grid: a quadtree
+ * of cells whose elements are in rings of zone-allocated nodes.
+ */
+class BaselineBlockmap
+{
+public:
+    BaselineBlockmap(const AABoxd &bounds, duint cellSize)
+        : _bounds(bounds)
+        , _cellSize(cellSize)
+        , _dimensions(Vec2ui(de::ceil((bounds.maxX - bounds.minX) / cellSize),
+                             de::ceil((bounds.maxY - bounds.minY) / cellSize)))
+    {
+        _nodes.emplace_back(BlockmapCell(0, 0), ceilPow2(de::max(_dimensions.x, _dimensions.y)));
+    }
+
+    ~BaselineBlockmap()
+    {
+        for (Node &node : _nodes)
+        {
+            if (!node.isLeaf() || !node.leafData) continue;
+            for (RingNode *ring = node.leafData->ringNodes; ring; )
+            {
+                RingNode *next = ring->next;
+                Z_Free(ring);
+                ring = next;
+            }
+            Z_Free(node.leafData);
+        }
+    }
+
+    void link(const BlockmapCell &cell, void *elem)
+    {
+        if (CellData *data = cellData(cell, true))
+        {
+            RingNode *node = data->ringNodes;
+            if (!node)
+            {
+                node = newRingNode(nullptr);
+                data->ringNodes = node;
+            }
+            else
+            {
+                // Reuse an available node in the ring, or add a new one.
+                while (node->next && node->elem) node = node->next;
+                if (node->elem)
+                {
+                    node->next = newRingNode(node);
+                    node = node->next;
+                }
+            }
+            node->elem = elem;
+        }
+    }
+
+    void unlink(const BlockmapCell &cell, void *elem)
+    {
+        if (CellData *data = cellData(cell))
+        {
+            for (RingNode *node = data->ringNodes; node; node = node->next)
+            {
+                if (node->elem == elem)
+                {
+                    node->elem = nullptr;
+                    return;
+                }
+            }
+        }
+    }
+
+    LoopResult forAllInBox(const AABoxd &box, std::function<LoopResult (void *)> func)
+    {
+        const BlockmapCell min = toCell(Vec2d(box.minX, box.minY));
+        BlockmapCell max = toCell(Vec2d(box.maxX, box.maxY)) + Vec2ui(1, 1);
+        max.x = de::min(max.x, _dimensions.x);
+        max.y = de::min(max.y, _dimensions.y);
+
+        BlockmapCell cell;
+        for (cell.y = min.y; cell.y < max.y; ++cell.y)
+        for (cell.x = min.x; cell.x < max.x; ++cell.x)
+        {
+            if (CellData *data = cellData(cell))
+            {
+                for (RingNode *node = data->ringNodes; node; )
+                {
+                    RingNode *next = node->next;
+                    if (node->elem)
+                    {
+                        if (auto result = func(node->elem)) return result;
+                    }
+                    node = next;
+                }
+            }
+        }
+        return LoopContinue;
+    }
+
+    BlockmapCell toCell(const Vec2d &point) const
+    {
+        const ddouble x = de::min(de::max(point.x, _bounds.minX), _bounds.maxX - 1);
+        const ddouble y = de::min(de::max(point.y, _bounds.minY), _bounds.maxY - 1);
+        return BlockmapCell(duint((x - _bounds.minX) / _cellSize),
+                            duint((y - _bounds.minY) / _cellSize));
+    }
+
+private:
+    struct RingNode
+    {
+        void *elem;
+        RingNode *prev;
+        RingNode *next;
+    };
+
+    struct CellData
+    {
+        RingNode *ringNodes;
+    };
+
+    struct Node
+    {
+        BlockmapCell cell;
+        duint size;
+        union {
+            Node *children[4];
+            CellData *leafData;
+        };
+
+        Node(const BlockmapCell &cell, duint size) : cell(cell), size(size)
+        {
+            zap(children);
+        }
+
+        bool isLeaf() const { return size == 1; }
+
+        int quadrant(const BlockmapCell &point) const
+        {
+            const duint subSize = size >> 1;
+            return (point.x < cell.x + subSize? 0 : 1) + (point.y < cell.y + subSize? 0 : 2);
+        }
+    };
+
+    static RingNode *newRingNode(RingNode *prev)
+    {
+        auto *node = reinterpret_cast<RingNode *>(Z_Malloc(sizeof(RingNode), PU_APPSTATIC, nullptr));
+        node->elem = nullptr;
+        node->prev = prev;
+        node->next = nullptr;
+        return node;
+    }
+
+    Node *findLeaf(Node *node, const BlockmapCell &at, bool canSubdivide)
+    {
+        if (node->isLeaf()) return node;
+
+        const int q = node->quadrant(at);
+        if (!node->children[q])
+        {
+            if (!canSubdivide) return nullptr;
+
+            const duint subSize = node->size >> 1;
+            _nodes.emplace_back(BlockmapCell(node->cell.x + (q & 1? subSize : 0),
+                                             node->cell.y + (q & 2? subSize : 0)), subSize);
+            node->children[q] = &_nodes.back();
+        }
+        return findLeaf(node->children[q], at, canSubdivide);
+    }
+
+    CellData *cellData(const BlockmapCell &cell, bool canCreate = false)
+    {
+        if (cell.x >= _dimensions.x || cell.y >= _dimensions.y) return nullptr;
+
+        if (Node *node = findLeaf(&_nodes.front(), cell, canCreate))
+        {
+            if (!node->leafData && canCreate)
+            {
+                node->leafData = reinterpret_cast<CellData *>(
+                    Z_Calloc(sizeof(CellData), PU_APPSTATIC, nullptr));
+            }
+            return node->leafData;
+        }
+        return nullptr;
+    }
+
+    AABoxd _bounds;
+    duint _cellSize;
+    BlockmapCell _dimensions;
+    std::list<Node> _nodes;
+};
+
+/// Durations of the blockmap benchmark steps, in seconds.
+struct BlockmapBenchmark
+{
+    ddouble linkTime  = 0;
+    ddouble moveTime  = 0;
+    ddouble queryTime = 0;
+    dsize found = 0;
+};
+
+/**
+ * Links @a count elements to random positions in @a bmap, moves them around for
+ * @a tics, and queries the surroundings of each element on each tic.
+ *
+ * @param query  Called with a box and the number of elements found so far.
+ */
+template <typename BlockmapType, typename QueryFunc>
+static BlockmapBenchmark benchmarkBlockmap(BlockmapType &bmap, const AABoxd &bounds,
+                                           dint count, dint tics, QueryFunc query)
+{
+    // Deterministic pseudorandom numbers in [0, 1).
+    duint32 seed = 1;
+    auto random = [&seed] () {
+        seed = seed * 1664525 + 1013904223;
+        return (seed >> 8) / ddouble(1 << 24);
+    };
+
+    std::vector<Vec2d> elems(count);
+    for (auto &pos : elems)
+    {
+        pos = Vec2d(bounds.minX + random() * (bounds.maxX - bounds.minX),
+                    bounds.minY + random() * (bounds.maxY - bounds.minY));
+    }
+
+    BlockmapBenchmark bench;
+    Time startedAt;
+    for (auto &pos : elems)
+    {
+        bmap.link(bmap.toCell(pos), &pos);
+    }
+    bench.linkTime = startedAt.since();
+
+    startedAt = Time();
+    for (dint tic = 0; tic < tics; ++tic)
+    {
+        for (auto &pos : elems)
+        {
+            bmap.unlink(bmap.toCell(pos), &pos);
+            pos += Vec2d(random() * 16 - 8, random() * 16 - 8);
+            bmap.link(bmap.toCell(pos), &pos);
+        }
+    }
+    bench.moveTime = startedAt.since();
+
+    startedAt = Time();
+    for (dint tic = 0; tic < tics; ++tic)
+    {
+        for (const auto &pos : elems)
+        {
+            query(AABoxd(pos.x - MOBJ_RADIUS_MAX * 2, pos.y - MOBJ_RADIUS_MAX * 2,
+                         pos.x + MOBJ_RADIUS_MAX * 2, pos.y + MOBJ_RADIUS_MAX * 2),
+                  bench.found);
+        }
+    }
+    bench.queryTime = startedAt.since();
+    return bench;
+}
+
+static void benchmark(dint count, ddouble size, int &result)
+{
+    const dint tics = 100;
+    const AABoxd bounds(0, 0, size, size);
+
+    BlockmapBenchmark grid, function, baseline;
+    {
+        Blockmap bmap(bounds, CELL_SIZE);
+        grid = benchmarkBlockmap(bmap, bounds, count, tics, [&bmap] (const AABoxd &box, dsize &found) {
+            bmap.forEachInBox(box, [&found] (void *) {
+                found++;
+                return LoopContinue;
+            });
+        });
+    }
+    {
+        Blockmap bmap(bounds, CELL_SIZE);
+        function = benchmarkBlockmap(bmap, bounds, count, tics, [&bmap] (const AABoxd &box, dsize &found) {
+            bmap.forAllInBox(box, [&found] (void *) {
+                found++;
+                return LoopContinue;
+            });
+        });
+    }
+    {
+        BaselineBlockmap bmap(bounds, CELL_SIZE);
+        baseline = benchmarkBlockmap(bmap, bounds, count, tics, [&bmap] (const AABoxd &box, dsize &found) {
+            bmap.forAllInBox(box, [&found] (void *) {
+                found++;
+                return LoopContinue;
+            });
+        });
+    }
+    const bool identical = (grid.found == baseline.found && function.found == baseline.found);
+    if (!identical) result = 1;
+
+    const ddouble ops = ddouble(count) * tics;
+    LOG_MSG("Blockmap %.0fx%.0f, %i elements, %i tics: %s")
+        << size << size << count << tics << (identical? "identical" : "MISMATCH");
+    LOG_MSG("  Link:  %6.2f M/s (quadtree %6.2f M/s, %.1fx)")
+        << count / grid.linkTime / 1.0e6 << count / baseline.linkTime / 1.0e6
+        << baseline.linkTime / grid.linkTime;
+    LOG_MSG("  Move:  %6.2f M/s (quadtree %6.2f M/s, %.1fx; unlink + link)")
+        << ops / grid.moveTime / 1.0e6 << ops / baseline.moveTime / 1.0e6
+        << baseline.moveTime / grid.moveTime;
+    LOG_MSG("  Query: %6.2f M/s (quadtree %6.2f M/s, %.1fx; %.1f elements per query)")
+        << ops / grid.queryTime / 1.0e6 << ops / baseline.queryTime / 1.0e6
+        << baseline.queryTime / grid.queryTime << grid.found / ops;
+    LOG_MSG("  Query with std::function: %6.2f M/s")
+        << ops / function.queryTime / 1.0e6;
+}
+
+int main(int argc, char **argv)
+{
+    init_Foundation();
+    int result = 0;
+    try
+    {
+        TextApp app(makeList(argc, argv));
+        {
+            Record &amd = app.metadata();
+            amd.set(App::APP_NAME, "Blockmap Benchmark Utility");
+            amd.set(App::CONFIG_PATH, "");
+        }
+        LogBuffer::get().enableStandardOutput();
+        app.initSubsystems(App::DisablePersistentData);
+        Libdeng_Init(); // The quadtree blockmap uses the memory zone.
+
+        const CommandLine &args = app.commandLine();
+        const dint count  = (args.count() > 1? de::max(1, args.at(1).toInt()) : 2000);
+        const ddouble size = (args.count() > 2? de::max(CELL_SIZE, duint(args.at(2).toInt())) : 8192);
+
+        benchmark(count, size, result);
+        benchmark(count * 4, size, result);
+
+        Libdeng_Shutdown();
+    }
+    catch (const Error &er)
+    {
+        er.warnPlainText();
+        result = 1;
+    }
+    deinit_Foundation();
+    return result;
+}
@@ -0,0 +1,305 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Benchmarks the BSP partitioner with synthetic maps.
+ *
+ * Each map is a grid of square rooms, optionally rotated and with an octagonal
+ * pillar in each room. The BSP of each map is built both serially and with the
+ * concurrent partitioner, and the resulting trees are checked to be identical.
+ *
+ * - bspbench [grid size]...
+ */
+
+#include <doomsday/world/bsp/partitioner.h>
+#include <doomsday/world/bspleaf.h>
+#include <doomsday/world/convexsubspace.h>
+#include <doomsday/world/factory.h>
+#include <doomsday/world/line.h>
+#include <doomsday/world/sector.h>
+#include <doomsday/world/vertex.h>
+#include <doomsday/mesh/face.h>
+#include <doomsday/mesh/hedge.h>
+
+#include <de/commandline.h>
+#include <de/logbuffer.h>
+#include <de/math.h>
+#include <de/taskpool.h>
+#include <de/textapp.h>
+#include <de/time.h>
+#include <de/writer.h>
+
+#include <cmath>
+
+using namespace de;
+using namespace world;
+
+static const double CELL_SIZE = 128;
+
+struct SyntheticMap
+{
+    mesh::Mesh     mesh;
+    List<Sector *> sectors;
+    List<Line *>   lines;
+    BspTree *      tree = nullptr;
+
+    /**
+     * @param size     Number of rooms on each side of the grid.
+     * @param angle    Rotation of the grid (radians).
+     * @param pillars  Add a pillar in the middle of each room.
+     */
+    SyntheticMap(int size, double angle, bool pillars)
+    {
+        const double c = std::cos(angle);
+        const double s = std::sin(angle);
+        auto newVertex = [this, c, s] (double x, double y) -> Vertex & {
+            return *mesh.newVertex(Vec2d(x * c - y * s, x * s + y * c));
+        };
+        auto sectorAt = [this, size] (int i, int j) -> Sector * {
+            if (i < 0 || j < 0 || i >= size || j >= size) return nullptr;
+            return sectors.at(j * size + i);
+        };
+
+        for (int i = 0; i < size * size; ++i)
+        {
+            auto *sector = new Sector(1.f, Vec3f(1.f));
+            sector->setIndexInMap(i);
+            sectors << sector;
+        }
+
+        List<Vertex *> grid;
+        for (int j = 0; j <= size; ++j)
+        {
+            for (int i = 0; i <= size; ++i)
+            {
+                grid << &newVertex(i * CELL_SIZE, j * CELL_SIZE);
+            }
+        }
+        auto gridAt = [&grid, size] (int i, int j) -> Vertex & {
+            return *grid.at(j * (size + 1) + i);
+        };
+
+        // Walls between the rooms (the front side is on the right).
+        for (int j = 0; j <= size; ++j)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                addLine(gridAt(i, j), gridAt(i + 1, j), sectorAt(i, j - 1), sectorAt(i, j));
+            }
+        }
+        for (int i = 0; i <= size; ++i)
+        {
+            for (int j = 0; j < size; ++j)
+            {
+                addLine(gridAt(i, j), gridAt(i, j + 1), sectorAt(i, j), sectorAt(i - 1, j));
+            }
+        }
+
+        if (pillars)
+        {
+            for (int j = 0; j < size; ++j)
+            {
+                for (int i = 0; i < size; ++i)
+                {
+                    // Counterclockwise, so the room is on the right.
+                    const double turn = degreeToRadian(5.0 * ((i + j) % 8));
+                    List<Vertex *> corners;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        const double a = turn + k * PI / 4;
+                        corners << &newVertex((i + .5 + .2 * std::cos(a)) * CELL_SIZE,
+                                              (j + .5 + .2 * std::sin(a)) * CELL_SIZE);
+                    }
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        addLine(*corners.at(k), *corners.at((k + 1) % 8), sectorAt(i, j), nullptr);
+                    }
+                }
+            }
+        }
+    }
+
+    ~SyntheticMap()
+    {
+        if (tree)
+        {
+            tree->traversePostOrder([] (BspTree &subtree, void *) {
+                if (subtree.isLeaf() && subtree.userData())
+                {
+                    delete subtree.userData()->as<BspLeaf>().subspacePtr();
+                }
+                delete subtree.userData();
+                subtree.setUserData(nullptr);
+                return 0;
+            });
+            delete tree;
+        }
+        deleteAll(lines);
+        deleteAll(sectors);
+    }
+
+    void addLine(Vertex &from, Vertex &to, Sector *right, Sector *left)
+    {
+        Line *line = (right? Factory::newLine(from, to, 0, right, left)
+                           : Factory::newLine(to, from, 0, left, right));
+        line->setIndexInMap(lines.sizei());
+        lines << line;
+    }
+
+    /**
+     * Builds the BSP and returns the time taken in seconds.
+     */
+    double build(bool concurrent)
+    {
+        bsp::Partitioner partitioner;
+        partitioner.setConcurrent(concurrent);
+        Time startedAt;
+        tree = partitioner.makeBspTree(compose<Set<Line *>>(lines.begin(), lines.end()), mesh);
+        return startedAt.since();
+    }
+
+    /**
+     * Hash of the built geometry: the BSP nodes, the leaf polygons, and all
+     * the vertices in the order they were created.
+     */
+    Block hash() const
+    {
+        Block data;
+        Writer writer(data);
+        for (const Vertex *vertex : mesh.vertices())
+        {
+            writer << vertex->origin().x << vertex->origin().y;
+        }
+        if (tree) writeTree(writer, *tree);
+        return data.md5Hash();
+    }
+
+    static void writeTree(Writer &writer, const BspTree &tree)
+    {
+        if (tree.isLeaf())
+        {
+            const auto &leaf = tree.userData()->as<BspLeaf>();
+            writer << dint32(leaf.sectorPtr()? leaf.sectorPtr()->indexInMap() : -1);
+            if (leaf.hasSubspace())
+            {
+                const mesh::Face &poly = leaf.subspace().poly();
+                writer << dint32(poly.hedgeCount());
+                const mesh::HEdge *hedge = poly.hedge();
+                do
+                {
+                    writer << hedge->origin().x << hedge->origin().y;
+                }
+                while ((hedge = &hedge->next()) != poly.hedge());
+            }
+            return;
+        }
+        const auto &node = tree.userData()->as<BspNode>();
+        writer << node.origin.x << node.origin.y << node.direction.x << node.direction.y
+               << dbyte(tree.hasRight()) << dbyte(tree.hasLeft());
+        if (tree.hasRight()) writeTree(writer, *tree.rightPtr());
+        if (tree.hasLeft())  writeTree(writer, *tree.leftPtr());
+    }
+};
+
+static void useBaseConstructors()
+{
+    Factory::setVertexConstructor([] (mesh::Mesh &m, const Vec2d &p) {
+        return new Vertex(m, p);
+    });
+    Factory::setLineConstructor([] (Vertex &s, Vertex &t, int flg, Sector *fs, Sector *bs) {
+        return new Line(s, t, flg, fs, bs);
+    });
+    Factory::setLineSideConstructor([] (Line &ln, Sector *s) {
+        return new LineSide(ln, s);
+    });
+    Factory::setLineSideSegmentConstructor([] (LineSide &ls, mesh::HEdge &he) {
+        return new LineSideSegment(ls, he);
+    });
+    Factory::setConvexSubspaceConstructor([] (mesh::Face &f, BspLeaf *bl) {
+        return new ConvexSubspace(f, bl);
+    });
+}
+
+static bool benchmark(const char *label, int size, double angle, bool pillars)
+{
+    double serialTime, concurrentTime;
+    Block serialHash, concurrentHash;
+    int lineCount;
+    {
+        SyntheticMap map(size, angle, pillars);
+        lineCount  = map.lines.sizei();
+        serialTime = map.build(false);
+        serialHash = map.hash();
+    }
+    {
+        SyntheticMap map(size, angle, pillars);
+        concurrentTime = map.build(true);
+        concurrentHash = map.hash();
+    }
+    const bool identical = (serialHash == concurrentHash);
+
+    LOG_MSG("%-8s %3ix%-3i %6i lines  serial %7.3f s  concurrent %7.3f s  (%.2fx) %s")
+        << label << size << size << lineCount << serialTime << concurrentTime
+        << serialTime / concurrentTime << (identical? "identical" : "MISMATCH");
+    return identical;
+}
+
+int main(int argc, char **argv)
+{
+    init_Foundation();
+    int result = 0;
+    try
+    {
+        TextApp app(makeList(argc, argv));
+        {
+            Record &amd = app.metadata();
+            amd.set(App::APP_NAME, "BSP Benchmark Utility");
+            amd.set(App::CONFIG_PATH, "");
+        }
+        LogBuffer::get().enableStandardOutput();
+        app.initSubsystems(App::DisablePersistentData);
+        useBaseConstructors();
+
+        List<int> sizes;
+        const CommandLine &args = app.commandLine();
+        for (int i = 1; i < args.count(); ++i)
+        {
+            sizes << de::max(1, args.at(i).toInt());
+        }
+        if (sizes.isEmpty())
+        {
+            sizes << 16 << 32 << 48;
+        }
+
+        LOG_MSG("%i pooled threads") << TaskPool::workerCount();
+        for (int size : sizes)
+        {
+            if (!benchmark("Grid",    size, 0.0, false)) result = 1;
+            if (!benchmark("Rotated", size, 0.3, false)) result = 1;
+            if (!benchmark("Pillars", size, 0.3, true))  result = 1;
+        }
+    }
+    catch (const Error &er)
+    {
+        er.warnPlainText();
+        result = 1;
+    }
+    deinit_Foundation();
+    return result;
+}
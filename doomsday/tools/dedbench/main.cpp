@@ -0,0 +1,308 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Benchmarks loading DED definitions into Records.
+ *
+ * The given DED files and everything they include are parsed from a native folder.
+ * The parsing time, the number of records and members created, and the number and
+ * total size of the C++ heap allocations made during parsing are reported. Then
+ * member lookups with Record::has() and Record::operator[] are timed on all the
+ * loaded records. Finally, state, thing, and sprite lookups by ID are timed before
+ * and after the definitions are frozen into runtime lookup tables. Last, the
+ * definitions are serialized and restored like DEDCache does, and the restoring time
+ * is compared with the parsing time.
+ *
+ * Only the public Record API is used, so the results of different versions of
+ * libcore can be compared with each other.
+ *
+ * - dedbench (defs folder) (file.ded) [file.ded...]
+ *
+ * For example: dedbench libs/gamekit/libs/doom/defs doom1.ded
+ */
+
+#include <doomsday/defs/ded.h>
+#include <doomsday/defs/dedcache.h>
+#include <doomsday/defs/dedfile.h>
+#include <doomsday/defs/definition.h>
+
+#include <de/arrayvalue.h>
+#include <de/commandline.h>
+#include <de/directoryfeed.h>
+#include <de/filesystem.h>
+#include <de/logbuffer.h>
+#include <de/recordvalue.h>
+#include <de/textapp.h>
+#include <de/time.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace de;
+
+static std::atomic<duint64> allocationCount;
+static std::atomic<duint64> allocatedBytes;
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+static void collectRecords(const Value &value, List<const Record *> &records);
+
+static void collectRecords(const Record &record, List<const Record *> &records)
+{
+    records << &record;
+    for (const auto &i : record.members())
+    {
+        collectRecords(i.second->value(), records);
+    }
+}
+
+static void collectRecords(const Value &value, List<const Record *> &records)
+{
+    if (const auto *recValue = maybeAs<RecordValue>(value))
+    {
+        // Only owned records; others are references.
+        if (recValue->record() && recValue->hasOwnership())
+        {
+            collectRecords(*recValue->record(), records);
+        }
+    }
+    else if (const auto *array = maybeAs<ArrayValue>(value))
+    {
+        for (const Value *element : array->elements())
+        {
+            collectRecords(*element, records);
+        }
+    }
+}
+
+/**
+ * Looks up every state, thing, and sprite by ID, and the action of every state.
+ *
+ * @param results  Receives the found indices.
+ * @return Duration of the lookups.
+ */
+static TimeSpan lookUpStates(const ded_t &defs, const StringList &stateIds,
+                             const StringList &thingIds, const StringList &spriteIds,
+                             int rounds, List<int> &results)
+{
+    results.clear();
+    Time startedAt;
+    for (int round = 0; round < rounds; ++round)
+    {
+        int sum = 0;
+        for (const String &id : stateIds)
+        {
+            const int num = defs.getStateNum(id);
+            sum += num + (num >= 0? int(defs.getStateAction(num)[0]) : 0);
+            if (!round) results << num;
+        }
+        for (const String &id : thingIds)
+        {
+            const int num = defs.getMobjNum(id);
+            sum += num;
+            if (!round) results << num;
+        }
+        for (const String &id : spriteIds)
+        {
+            const int num = defs.getSpriteNum(id);
+            sum += num;
+            if (!round) results << num;
+        }
+        if (!round) results << sum;
+    }
+    return startedAt.since();
+}
+
+static void benchmark(CommandLine &args)
+{
+    args.makeAbsolutePath(1);
+    FS::get().makeFolderWithFeed("/defs", new DirectoryFeed(args.at(1)));
+    FS::waitForIdle();
+
+    // Parse the definitions.
+    ded_t defs;
+    const duint64 countBefore = allocationCount;
+    const duint64 bytesBefore = allocatedBytes;
+    Time startedAt;
+    for (int i = 2; i < args.count(); ++i)
+    {
+        Def_ReadProcessDED(&defs, String("/defs") / args.at(i));
+    }
+    const double parseTime = startedAt.since();
+    const duint64 allocs = allocationCount - countBefore;
+    const duint64 bytes  = allocatedBytes - bytesBefore;
+
+    List<const Record *> records;
+    collectRecords(defs.names, records);
+    List<StringList> names;
+    dsize memberCount = 0;
+    for (const Record *rec : records)
+    {
+        StringList recNames;
+        for (const auto &i : rec->members()) recNames << i.first;
+        memberCount += recNames.size();
+        names << recNames;
+    }
+
+    LOG_MSG("Parsed in %.1f ms: %i states, %i things, %i materials, %i models")
+        << parseTime * 1000 << defs.states.size() << defs.things.size()
+        << defs.materials.size() << defs.models.size();
+    LOG_MSG("%i records with %i members (%.1f per record)")
+        << records.size() << memberCount << double(memberCount) / records.size();
+    LOG_MSG("%i allocations, %.1f KB (%.1f allocations, %.0f bytes per record)")
+        << allocs << bytes / 1024.0 << double(allocs) / records.size()
+        << double(bytes) / records.size();
+
+    // Look up every member of every record, and one missing member.
+    const String missing = "nonexistentMember";
+    const int rounds = 10;
+    dsize lookups = 0;
+    dsize found = 0;
+    startedAt = Time();
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (dsize i = 0; i < records.size(); ++i)
+        {
+            const Record &rec = *records[i];
+            for (const String &name : names[i])
+            {
+                if (rec.has(name) && !rec[name].value().isFalse()) found++;
+            }
+            if (rec.has(missing)) found++;
+            lookups += names[i].size() * 2 + 1;
+        }
+    }
+    const double lookupTime = startedAt.since();
+    LOG_MSG("%i lookups in %.1f ms: %.1f ns per lookup (%i non-false)")
+        << lookups << lookupTime * 1000 << lookupTime * 1.0e9 / lookups << found;
+
+    // Look up states, things, and sprites by ID, with and without the frozen tables.
+    // The IDs are in upper case like the ones given by the game.
+    StringList stateIds, thingIds, spriteIds;
+    for (int i = 0; i < defs.states.size(); ++i)
+    {
+        stateIds << defs.states[i].gets(defn::Definition::VAR_ID).upper();
+    }
+    for (int i = 0; i < defs.things.size(); ++i)
+    {
+        thingIds << defs.things[i].gets(defn::Definition::VAR_ID).upper();
+    }
+    for (int i = 0; i < defs.sprites.size(); ++i)
+    {
+        spriteIds << String(defs.sprites[i].id).upper();
+    }
+    stateIds << missing;
+    const int stateRounds = 100;
+    const dsize stateLookups = dsize(stateRounds) * (stateIds.size() + thingIds.size() + spriteIds.size());
+
+    List<int> registerResults;
+    const double registerTime = lookUpStates(defs, stateIds, thingIds, spriteIds,
+                                             stateRounds, registerResults);
+    startedAt = Time();
+    defs.freeze();
+    const double freezeTime = startedAt.since();
+    List<int> frozenResults;
+    const double frozenTime = lookUpStates(defs, stateIds, thingIds, spriteIds,
+                                           stateRounds, frozenResults);
+    if (frozenResults != registerResults)
+    {
+        throw Error("benchmark", "Frozen lookups do not match the registers");
+    }
+    LOG_MSG("Froze definitions in %.2f ms") << freezeTime * 1000;
+    LOG_MSG("%i state/thing/sprite lookups: registers %.1f ns, frozen %.1f ns per lookup")
+        << stateLookups << registerTime * 1.0e9 / stateLookups
+        << frozenTime * 1.0e9 / stateLookups;
+
+    // Serialize the definitions and restore them, as done by the definition cache.
+    startedAt = Time();
+    const Block data = DEDCache::serialize(defs);
+    const double serializeTime = startedAt.since();
+    const Block compressed = data.compressed();
+    startedAt = Time();
+    ded_t restored;
+    DEDCache::deserialize(restored, compressed.decompressed());
+    const double restoreTime = startedAt.since();
+    if (DEDCache::digest(restored) != DEDCache::digest(defs))
+    {
+        throw Error("benchmark", "Restored definitions do not match the parsed ones");
+    }
+    LOG_MSG("Serialized in %.1f ms: %.1f KB (%.1f KB compressed)")
+        << serializeTime * 1000 << data.size() / 1024.0 << compressed.size() / 1024.0;
+    LOG_MSG("Restored in %.1f ms: %.1fx faster than parsing")
+        << restoreTime * 1000 << parseTime / restoreTime;
+}
+
+int main(int argc, char **argv)
+{
+    init_Foundation();
+    int result = 0;
+    try
+    {
+        TextApp app(makeList(argc, argv));
+        {
+            Record &amd = app.metadata();
+            amd.set(App::APP_NAME, "DED Benchmark Utility");
+            amd.set(App::CONFIG_PATH, "");
+        }
+        LogBuffer::get().enableStandardOutput();
+        app.initSubsystems(App::DisablePersistentData);
+
+        if (app.commandLine().count() < 3)
+        {
+            LOG_MSG("Usage: dedbench (defs folder) (file.ded) [file.ded...]");
+            result = 1;
+        }
+        else
+        {
+            benchmark(app.commandLine());
+        }
+    }
+    catch (const Error &er)
+    {
+        er.warnPlainText();
+        result = 1;
+    }
+    deinit_Foundation();
+    return result;
+}
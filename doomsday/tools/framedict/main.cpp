@@ -0,0 +1,204 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Trains and benchmarks preset dictionaries for compressing server frames.
+ *
+ * Frames are captured on a server with the "captureframes" console command. The
+ * trained dictionary goes to "network/frames.dict" in the net.dengine.base package.
+ *
+ * - framedict train (capture) (output) [size]
+ * - framedict bench (capture) [dictionary]
+ */
+
+#include <de/commandline.h>
+#include <de/deflatedictionary.h>
+#include <de/huffman.h>
+#include <de/logbuffer.h>
+#include <de/nativefile.h>
+#include <de/reader.h>
+#include <de/textapp.h>
+#include <de/time.h>
+
+#include <functional>
+#include <memory>
+
+using namespace de;
+
+// Message size limits of Socket.
+static const dsize MAX_SIZE_SMALL  = 127;
+static const dsize MAX_SIZE_MEDIUM = 4095;
+
+static Block readFile(const NativePath &path)
+{
+    std::unique_ptr<NativeFile> file(NativeFile::newStandalone(path));
+    return Block(*file);
+}
+
+static List<Block> readCapture(const NativePath &path)
+{
+    const Block data = readFile(path);
+    List<Block> frames;
+    Reader reader(data);
+    while (!reader.atEnd())
+    {
+        Block frame;
+        reader >> frame;
+        frames << frame;
+    }
+    return frames;
+}
+
+/**
+ * Size of the message when sent by Socket without a dictionary (including header).
+ */
+static dsize legacyMessageSize(const Block &frame, const Block &huff)
+{
+    if (huff.size() <= MAX_SIZE_SMALL)
+    {
+        return 1 + huff.size();
+    }
+    const Block deflated = frame.compressed(1);
+    if (huff.size() <= deflated.size() && huff.size() <= MAX_SIZE_MEDIUM)
+    {
+        return 2 + huff.size();
+    }
+    return (deflated.size() <= MAX_SIZE_MEDIUM? 2 : 3) + deflated.size();
+}
+
+static dsize legacyMessageSize(const Block &frame)
+{
+    return legacyMessageSize(frame, codec::huffmanEncode(frame));
+}
+
+/**
+ * Size of the message when sent by Socket with a dictionary (including header).
+ */
+static dsize dictionaryMessageSize(const Block &frame, const DeflateDictionary &dict)
+{
+    const Block huff     = codec::huffmanEncode(frame);
+    const Block deflated = dict.compress(frame);
+    const bool smallHuff = huff.size() <= MAX_SIZE_SMALL;
+
+    if (deflated.size() <= MAX_SIZE_MEDIUM && deflated.size() + (smallHuff? 1 : 0) < huff.size())
+    {
+        return 2 + deflated.size();
+    }
+    if (smallHuff)
+    {
+        return 1 + huff.size();
+    }
+    return legacyMessageSize(frame, huff);
+}
+
+static void benchmark(const String &label, const List<Block> &frames,
+                      const std::function<dsize (const Block &)> &encode)
+{
+    dsize inputBytes = 0;
+    dsize outputBytes = 0;
+    Time startedAt;
+    for (const Block &frame : frames)
+    {
+        inputBytes  += frame.size();
+        outputBytes += encode(frame);
+    }
+    const double elapsed = startedAt.since();
+
+    LOG_MSG("%-12s %8i bytes  ratio %5.3f  %7.2f usec/packet")
+        << label << outputBytes << double(outputBytes) / double(inputBytes)
+        << elapsed * 1.0e6 / frames.size();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) return -1;
+    init_Foundation();
+    try
+    {
+        TextApp app(makeList(argc, argv));
+        {
+            Record &amd = app.metadata();
+            amd.set(App::APP_NAME, "Frame Dictionary Utility");
+            amd.set(App::CONFIG_PATH, "");
+        }
+        LogBuffer::get().enableStandardOutput();
+        app.initSubsystems(App::DisablePersistentData);
+
+        const CommandLine &args = app.commandLine();
+        const String command = args.at(1);
+        const List<Block> frames = readCapture(args.at(2));
+        if (frames.isEmpty())
+        {
+            throw Error("main", "No frames in " + args.at(2));
+        }
+
+        if (command == "train" && args.count() >= 4)
+        {
+            const dsize size = (args.count() >= 5? dsize(args.at(4).toInt())
+                                                 : DeflateDictionary::DEFAULT_SIZE);
+            const DeflateDictionary dict = DeflateDictionary::train(frames, size);
+
+            std::unique_ptr<NativeFile> out(NativeFile::newStandalone(args.at(3)));
+            out->setMode(File::Write);
+            out->clear();
+            *out << dict.data();
+
+            LOG_MSG("Trained dictionary %08x (%i bytes) from %i frames")
+                << dict.id() << dict.data().size() << frames.size();
+        }
+        else if (command == "bench")
+        {
+            dsize total = 0;
+            for (const Block &frame : frames) total += frame.size();
+            LOG_MSG("%i frames, %i bytes (average %.1f bytes/frame)")
+                << frames.size() << total << double(total) / frames.size();
+
+            benchmark("Legacy", frames, [] (const Block &frame) {
+                return legacyMessageSize(frame);
+            });
+
+            if (args.count() >= 4)
+            {
+                const auto &dict = DeflateDictionary::registerDictionary(readFile(args.at(3)));
+                LOG_MSG("Dictionary %08x (%i bytes)") << dict.id() << dict.data().size();
+                benchmark("Dictionary", frames, [&dict] (const Block &frame) {
+                    return dictionaryMessageSize(frame, dict);
+                });
+
+                for (const Block &frame : frames)
+                {
+                    if (DeflateDictionary::decompress(dict.compress(frame)) != frame)
+                    {
+                        throw Error("main", "Frame did not survive the round trip");
+                    }
+                }
+            }
+        }
+        else
+        {
+            throw Error("main", "Unknown command: " + command);
+        }
+    }
+    catch (const Error &er)
+    {
+        er.warnPlainText();
+    }
+    deinit_Foundation();
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2020 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Benchmarks nearest color lookups in color palettes.
+ *
+ * Random colors are quantized to synthetic palettes using the lookup table of
+ * res::ColorPalette and with an exhaustive search of the palette. The times are
+ * reported, and the results are checked to be identical.
+ *
+ * - palettebench [number of colors]
+ */
+
+#include <doomsday/res/colorpalette.h>
+
+#include <de/commandline.h>
+#include <de/logbuffer.h>
+#include <de/textapp.h>
+#include <de/time.h>
+
+#include <limits>
+#include <random>
+
+using namespace de;
+
+/// Palette of 16 ramps of 16 shades from black to a bright color, like in the games.
+static List<Vec3ub> rampPalette()
+{
+    List<Vec3ub> colors;
+    for (int ramp = 0; ramp < 16; ++ramp)
+    {
+        const int low = (ramp & 8? 128 : 32);
+        const Vec3i hue(ramp & 1? 255 : low, ramp & 2? 255 : low, ramp & 4? 255 : low);
+        for (int shade = 0; shade < 16; ++shade)
+        {
+            colors << Vec3ub(dbyte(hue.x * (16 - shade) / 16),
+                             dbyte(hue.y * (16 - shade) / 16),
+                             dbyte(hue.z * (16 - shade) / 16));
+        }
+    }
+    return colors;
+}
+
+static List<Vec3ub> randomPalette(std::mt19937 &gen, int count)
+{
+    std::uniform_int_distribution<int> component(0, 255);
+    List<Vec3ub> colors;
+    for (int i = 0; i < count; ++i)
+    {
+        colors << Vec3ub(dbyte(component(gen)), dbyte(component(gen)), dbyte(component(gen)));
+    }
+    return colors;
+}
+
+/// Reference implementation: checks every color of the palette.
+static int exhaustiveNearestIndex(const List<Vec3ub> &colors, const Vec3ub &rgb)
+{
+    int nearest = 0;
+    int smallestDiff = std::numeric_limits<int>::max();
+    for (int i = 0; i < colors.sizei(); ++i)
+    {
+        const int dr = int(colors[i].x) - rgb.x;
+        const int dg = int(colors[i].y) - rgb.y;
+        const int db = int(colors[i].z) - rgb.z;
+        const int diff = dr * dr + dg * dg + db * db;
+        if (diff < smallestDiff)
+        {
+            smallestDiff = diff;
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+static bool benchmark(const char *label, const List<Vec3ub> &colors, const List<Vec3ub> &input)
+{
+    res::ColorPalette palette(colors);
+    List<int> tableResult(input.size()), exhaustiveResult(input.size());
+
+    // The first lookup builds the table.
+    Time startedAt;
+    palette.nearestIndex(Vec3ub());
+    const double buildTime = startedAt.since();
+
+    startedAt = Time();
+    for (dsize i = 0; i < input.size(); ++i)
+    {
+        tableResult[i] = palette.nearestIndex(input[i]);
+    }
+    const double tableTime = startedAt.since();
+
+    startedAt = Time();
+    for (dsize i = 0; i < input.size(); ++i)
+    {
+        exhaustiveResult[i] = exhaustiveNearestIndex(colors, input[i]);
+    }
+    const double exhaustiveTime = startedAt.since();
+
+    const bool identical = (tableResult == exhaustiveResult);
+    const double megaColors = input.size() / 1.0e6;
+    LOG_MSG("%-8s %3i colors  table built in %6.1f ms  table %7.1f Mcolors/s  "
+            "exhaustive %6.1f Mcolors/s  (%.1fx) %s")
+        << label << colors.sizei() << buildTime * 1000
+        << megaColors / tableTime << megaColors / exhaustiveTime
+        << exhaustiveTime / tableTime << (identical? "identical" : "MISMATCH");
+    return identical;
+}
+
+int main(int argc, char **argv)
+{
+    init_Foundation();
+    int result = 0;
+    try
+    {
+        TextApp app(makeList(argc, argv));
+        {
+            Record &amd = app.metadata();
+            amd.set(App::APP_NAME, "Palette Benchmark Utility");
+            amd.set(App::CONFIG_PATH, "");
+        }
+        LogBuffer::get().enableStandardOutput();
+        app.initSubsystems(App::DisablePersistentData);
+
+        const CommandLine &args = app.commandLine();
+        const int count = (args.count() > 1? de::max(1, args.at(1).toInt()) : 4000000);
+
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<int> component(0, 255);
+        List<Vec3ub> input;
+        for (int i = 0; i < count; ++i)
+        {
+            input << Vec3ub(dbyte(component(gen)), dbyte(component(gen)), dbyte(component(gen)));
+        }
+
+        if (!benchmark("Ramps",  rampPalette(),           input)) result = 1;
+        if (!benchmark("Random", randomPalette(gen, 256), input)) result = 1;
+        if (!benchmark("Random", randomPalette(gen, 16),  input)) result = 1;
+    }
+    catch (const Error &er)
+    {
+        er.warnPlainText();
+        result = 1;
+    }
+    deinit_Foundation();
+    return result;
+}